@@ -0,0 +1,187 @@
+/**
+ * @file fn_cal.c
+ *
+ * @brief   DAC correction table fitted from a loopback measurement
+ *
+ * Output of every DAC code is measured through an ADC. Readings at either end that sit at the ADC floor or ceiling
+ * are dropped, a least squares line through the rest gives offset, gain and INL. Remaining readings are smoothed by
+ * isotonic regression (pool adjacent violators), which only averages neighbours that run backwards, so real INL is
+ * kept while noise can't make the response non-monotonic. Clipped codes are extrapolated along the line. Inverting
+ * the monotonic response gives, for each ideal code, the real code closest to its voltage. Nothing here touches
+ * hardware, so the fit runs on host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_cal.h"
+#include <math.h>
+#include <stdlib.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+// Scratch of the fit, too big for the stack of tasks calibration is started from
+typedef struct _fn_cal_scratch_t
+{
+    float    response[FN_CAL_CODES]; // Smoothed output of each code in mV
+    float    level[FN_CAL_CODES];    // Mean of each pooled block
+    uint16_t width[FN_CAL_CODES];    // Number of codes in each pooled block
+} fn_cal_scratch_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Fits non-decreasing response to readings of codes first to last by pooling adjacent violators
+ *
+ * @param p_measured_mV Readings
+ * @param first First code
+ * @param last Last code
+ * @param p_scratch Scratch, response of the codes is written to it
+ */
+static void _fit_monotonic(const int16_t *p_measured_mV, int first, int last, fn_cal_scratch_t *p_scratch);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+bool fn_cal_fit(const int16_t *p_measured_mV, int vdd_mV, uint8_t *p_lut, fn_cal_result_t *p_result)
+{
+    int low  = p_measured_mV[0];
+    int high = p_measured_mV[0];
+    for(int k = 1; k < FN_CAL_CODES; k++)
+    {
+        low  = (p_measured_mV[k] < low) ? p_measured_mV[k] : low;
+        high = (p_measured_mV[k] > high) ? p_measured_mV[k] : high;
+    }
+
+    // Clipped codes are the runs stuck at the floor and ceiling at either end of the sweep
+    int first = 0;
+    while((first < FN_CAL_CODES - 1) && (p_measured_mV[first] <= low + FN_CAL_CLIP_MV))
+    {
+        first++;
+    }
+    int last = FN_CAL_CODES - 1;
+    while((last > first) && (p_measured_mV[last] >= high - FN_CAL_CLIP_MV))
+    {
+        last--;
+    }
+    if(last - first + 1 < FN_CAL_MIN_SPAN)
+    {
+        return false;
+    }
+
+    // Least squares line through unclipped codes
+    double n   = last - first + 1;
+    double sx  = 0;
+    double sy  = 0;
+    double sxx = 0;
+    double sxy = 0;
+    for(int k = first; k <= last; k++)
+    {
+        sx += k;
+        sy += p_measured_mV[k];
+        sxx += (double)k * k;
+        sxy += (double)k * p_measured_mV[k];
+    }
+    double slope     = (n * sxy - sx * sy) / (n * sxx - sx * sx);
+    double intercept = (sy - slope * sx) / n;
+    if(slope * 1000 < FN_CAL_MIN_SLOPE_UV)
+    {
+        return false;
+    }
+
+    fn_cal_scratch_t *p_scratch = malloc(sizeof(*p_scratch));
+    if(NULL == p_scratch)
+    {
+        return false;
+    }
+    float *p_response = p_scratch->response;
+
+    _fit_monotonic(p_measured_mV, first, last, p_scratch);
+    for(int k = 0; k < first; k++)
+    {
+        p_response[k] = p_response[first] - (float)(slope * (first - k));
+    }
+    for(int k = last + 1; k < FN_CAL_CODES; k++)
+    {
+        p_response[k] = p_response[last] + (float)(slope * (k - last));
+    }
+
+    float max_inl = 0;
+    for(int k = first; k <= last; k++)
+    {
+        float inl = fabsf(p_response[k] - (float)(intercept + slope * k));
+        max_inl   = (inl > max_inl) ? inl : max_inl;
+    }
+
+    // Targets and response both rise, so the closest code only ever moves up
+    int code = 0;
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        float target = (float)k * vdd_mV / (FN_CAL_CODES - 1);
+        while((code < FN_CAL_CODES - 1) && (fabsf(p_response[code + 1] - target) <= fabsf(p_response[code] - target)))
+        {
+            code++;
+        }
+        p_lut[k] = (uint8_t)code;
+    }
+    free(p_scratch);
+
+    if(NULL != p_result)
+    {
+        p_result->first_code    = first;
+        p_result->last_code     = last;
+        p_result->offset_mV     = (int)lround(intercept);
+        p_result->full_scale_mV = (int)lround(intercept + slope * (FN_CAL_CODES - 1));
+        p_result->max_inl_mV    = (int)lroundf(max_inl);
+    }
+    return true;
+}
+
+void fn_cal_identity(uint8_t *p_lut)
+{
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        p_lut[k] = (uint8_t)k;
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _fit_monotonic(const int16_t *p_measured_mV, int first, int last, fn_cal_scratch_t *p_scratch)
+{
+    int blocks = 0;
+
+    for(int k = first; k <= last; k++)
+    {
+        p_scratch->level[blocks] = p_measured_mV[k];
+        p_scratch->width[blocks] = 1;
+        blocks++;
+
+        // Newest block below the one before it pulls both to their common mean, which may cascade back
+        while((blocks > 1) && (p_scratch->level[blocks - 2] > p_scratch->level[blocks - 1]))
+        {
+            float    *p_level = &p_scratch->level[blocks - 2];
+            uint16_t *p_width = &p_scratch->width[blocks - 2];
+
+            p_level[0] = (p_level[0] * p_width[0] + p_level[1] * p_width[1]) / (p_width[0] + p_width[1]);
+            p_width[0] += p_width[1];
+            blocks--;
+        }
+    }
+
+    int k = first;
+    for(int b = 0; b < blocks; b++)
+    {
+        for(int i = 0; i < p_scratch->width[b]; i++)
+        {
+            p_scratch->response[k++] = p_scratch->level[b];
+        }
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
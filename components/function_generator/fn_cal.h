@@ -0,0 +1,65 @@
+/**
+ * @file fn_cal.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_CAL_H__
+#define __FN_CAL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define FN_CAL_CODES        (256)  // Number of DAC codes, every one is measured
+#define FN_CAL_CLIP_MV      (15)   // Readings this close to the lowest or highest one are taken as ADC clipping
+#define FN_CAL_MIN_SPAN     (64)   // Fewest unclipped codes a fit is made from
+#define FN_CAL_MIN_SLOPE_UV (2000) // Smallest DAC step in uV the fit accepts, anything flatter isn't a loopback
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _fn_cal_result_t
+{
+    int first_code;    // Lowest code measured without clipping
+    int last_code;     // Highest code measured without clipping
+    int offset_mV;     // Output at code 0 on the best fit line
+    int full_scale_mV; // Output at code 255 on the best fit line
+    int max_inl_mV;    // Largest distance of the measured response from the best fit line
+} fn_cal_result_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Builds correction table from output measured at every DAC code. Entry k of the table is the code whose
+ * output is closest to k * vdd_mV / 255, so writing lut[code] instead of code gives the output the ideal DAC would.
+ * Codes the ADC clipped are extrapolated along the best fit line, measurement noise is smoothed by forcing the
+ * response to rise monotonically.
+ *
+ * @param p_measured_mV Output measured at each of FN_CAL_CODES codes
+ * @param vdd_mV Output of the ideal DAC at code 255
+ * @param p_lut Correction table of FN_CAL_CODES codes, only written if true is returned
+ * @param p_result Fit summary, NULL if not needed
+ * @return true if measurements rise across at least FN_CAL_MIN_SPAN unclipped codes
+ */
+bool fn_cal_fit(const int16_t *p_measured_mV, int vdd_mV, uint8_t *p_lut, fn_cal_result_t *p_result);
+
+/**
+ * @brief Fills correction table that leaves codes as they are
+ *
+ * @param p_lut Correction table of FN_CAL_CODES codes
+ */
+void fn_cal_identity(uint8_t *p_lut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_CAL_H__
@@ -0,0 +1,84 @@
+/**
+ * @file fn_cw.c
+ *
+ * @brief   Settings solver for the DAC cosine waveform generator
+ *
+ * The generator adds step to a 16 bit phase accumulator on every RTC8M clock cycle, so frequency comes in steps of
+ * clk / 2^16, about 130 Hz. Swing can only be full scale divided by a power of two. Nothing here touches hardware,
+ * so the model can be checked on host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_cw.h"
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+uint32_t fn_cw_step(uint32_t clk_Hz, uint32_t frequency_Hz)
+{
+    uint64_t step = (((uint64_t)frequency_Hz << FN_CW_STEP_BITS) + clk_Hz / 2) / clk_Hz;
+    return (step > UINT32_MAX) ? UINT32_MAX : (uint32_t)step;
+}
+
+uint32_t fn_cw_actual_mHz(uint32_t clk_Hz, uint32_t step)
+{
+    return (uint32_t)(((uint64_t)clk_Hz * step * 1000) >> FN_CW_STEP_BITS);
+}
+
+uint32_t fn_cw_error_ppm(uint32_t clk_Hz, uint32_t frequency_Hz)
+{
+    uint64_t wanted_mHz = (uint64_t)frequency_Hz * 1000;
+    uint64_t actual_mHz = fn_cw_actual_mHz(clk_Hz, fn_cw_step(clk_Hz, frequency_Hz));
+    uint64_t error_mHz  = (actual_mHz > wanted_mHz) ? actual_mHz - wanted_mHz : wanted_mHz - actual_mHz;
+
+    return (0 == wanted_mHz) ? UINT32_MAX : (uint32_t)(error_mHz * 1000000 / wanted_mHz);
+}
+
+bool fn_cw_solve(uint32_t clk_Hz, int frequency_Hz, int amplitude_dac, fn_cw_params_t *p_params)
+{
+    if((0 == clk_Hz) || (frequency_Hz <= 0))
+    {
+        return false;
+    }
+
+    uint32_t step = fn_cw_step(clk_Hz, frequency_Hz);
+    if((0 == step) || (step > FN_CW_STEP_MAX) || (fn_cw_error_ppm(clk_Hz, frequency_Hz) > FN_CW_MAX_FREQ_ERR_PPM))
+    {
+        return false;
+    }
+
+    for(int shift = 0; shift < FN_CW_SCALE_NUMBER; shift++)
+    {
+        int swing = FN_CW_FULL_SCALE >> shift;
+        int diff  = amplitude_dac - swing;
+
+        if((diff >= -FN_CW_AMPLITUDE_TOL) && (diff <= FN_CW_AMPLITUDE_TOL))
+        {
+            p_params->step        = (uint16_t)step;
+            p_params->actual_mHz  = fn_cw_actual_mHz(clk_Hz, step);
+            p_params->scale_shift = (uint8_t)shift;
+            // Driver truncates, so the frequency given to it is rounded up to land exactly on step
+            p_params->freq_Hz = (uint32_t)((((uint64_t)step * clk_Hz) + (1 << FN_CW_STEP_BITS) - 1) >> FN_CW_STEP_BITS);
+            // DDS swings from 0 to amplitude, so centre is moved down from mid scale
+            p_params->offset = (int8_t)(swing / 2 - FN_CW_MID_SCALE);
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,86 @@
+/**
+ * @file fn_cw.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_CW_H__
+#define __FN_CW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define FN_CW_STEP_BITS        (16)     // Generator phase accumulator width, frequency is clk * step / 2^16
+#define FN_CW_STEP_MAX         (0xFFFF) // Largest phase step the generator takes
+#define FN_CW_SCALE_NUMBER     (4)      // Output swing can be divided by 1, 2, 4 and 8
+#define FN_CW_FULL_SCALE       (255)    // Peak to peak swing at scale 1 in DAC codes
+#define FN_CW_MID_SCALE        (128)    // DAC code generator oscillates around without offset
+#define FN_CW_AMPLITUDE_TOL    (1)      // Largest amplitude difference in DAC codes CW output is used with
+#define FN_CW_MAX_FREQ_ERR_PPM (5000)   // Largest frequency error CW output is used with
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _fn_cw_params_t
+{
+    uint32_t freq_Hz;     // Frequency to give to the driver, it truncates it to step
+    uint32_t actual_mHz;  // Frequency generator outputs
+    uint16_t step;        // Phase step per generator clock cycle
+    uint8_t  scale_shift; // Swing is FN_CW_FULL_SCALE >> scale_shift
+    int8_t   offset;      // Centre of the swing relative to FN_CW_MID_SCALE in DAC codes
+} fn_cw_params_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Returns phase step closest to frequency
+ *
+ * @param clk_Hz Generator clock
+ * @param frequency_Hz Wanted frequency
+ * @return uint32_t Phase step, may be 0 or above FN_CW_STEP_MAX if frequency is out of range
+ */
+uint32_t fn_cw_step(uint32_t clk_Hz, uint32_t frequency_Hz);
+
+/**
+ * @brief Returns frequency generator outputs at phase step
+ *
+ * @param clk_Hz Generator clock
+ * @param step Phase step
+ * @return uint32_t Frequency in mHz
+ */
+uint32_t fn_cw_actual_mHz(uint32_t clk_Hz, uint32_t step);
+
+/**
+ * @brief Returns error of the closest frequency generator can output
+ *
+ * @param clk_Hz Generator clock
+ * @param frequency_Hz Wanted frequency
+ * @return uint32_t Absolute error in parts per million of wanted frequency
+ */
+uint32_t fn_cw_error_ppm(uint32_t clk_Hz, uint32_t frequency_Hz);
+
+/**
+ * @brief Checks if sine fits generator's step and scale granularity and computes its settings. Sine swings from 0
+ * to amplitude, same as DDS output.
+ *
+ * @param clk_Hz Generator clock
+ * @param frequency_Hz Sine frequency
+ * @param amplitude_dac Peak to peak amplitude in DAC codes
+ * @param p_params Generator settings, only valid if true is returned
+ * @return true if generator can output the sine
+ */
+bool fn_cw_solve(uint32_t clk_Hz, int frequency_Hz, int amplitude_dac, fn_cw_params_t *p_params);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_CW_H__
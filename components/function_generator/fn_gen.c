@@ -11,7 +11,6 @@
 #include "fn_gen.h"
 #include "esp_log.h"
 #include <stdlib.h>
-#include <math.h>
 #include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -23,21 +22,62 @@
 
 #include "dac.h"
 #include "timer.h"
+#include "gate.h"
+#include "pwm.h"
+#include "fn_wavetable.h"
+#include "fn_render.h"
+#include "fn_noise.h"
+#include "fn_cw.h"
+#include "fn_pwm.h"
+#include "fn_timing.h"
+#include "profiler.h"
+#include "sched.h"
+#include "fn_level.h"
+#include "sdkconfig.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "esp_attr.h"
 //---------------------------------- MACROS -----------------------------------
+#if !CONFIG_GPTIMER_ISR_IRAM_SAFE
+#warning "DDS output stalls during every flash write unless CONFIG_GPTIMER_ISR_IRAM_SAFE is set"
+#endif
+
 #define FN_GEN_DEFAULT_SIGNAL FN_SIGNAL_SINE
 #define FN_GEN_DEFAULT_FREQ   (1000)
 #define FN_GEN_DEFAULT_AMPL   (1000)
+#define FN_GEN_DEFAULT_OFFSET (0)
 #define FN_GEN_DEFAULT_DUTY   (30)   // *10%
 
-#define OUTPUT_POINT_NUM(freq)   (int)(1000000 / (FN_GEN_TIMER_INTR_US * (freq)) + 0.5) // The number of output wave points.
-#define APLITUDE_VOLTS_TO_DAC(v) (int)(255 * (v) / VDD)                                 // Turns amplitude in volts to dac input
-#define CONST_PERIOD_2_PI        6.2832
+#define APLITUDE_VOLTS_TO_DAC(v) (int)(255 * (v) / VDD)                                    // Turns amplitude in volts to dac input
+#define DEGREES_TO_PHASE(deg)    (uint32_t)(((uint64_t)(deg) << 32) / 360)                 // Phase accumulator value of angle
+
+#define BURST_MAX_IDLE_MS (60000) // Longest idle time between bursts
+
+#define CAL_SETTLE_US (100) // Wait between DAC code change and its measurement
+
+#define TIMING_NOMINAL_CYCLES (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * FN_GEN_TIMER_INTR_US) // Cycle count between samples
+
+#define CHANNEL_NOISE_SEED(ch) (0x9E3779B9u * ((ch) + 1)) // Seeds far apart keep noise of the channels uncorrelated
 
 #define _THREAD_STACK_SIZE (2048u)
 #define _THREAD_PRIORITY   (tskIDLE_PRIORITY + 2u)
 
+#define SEQ_TASK_STACK_SIZE (4096u) // Steps build DDS banks, which keep a period of int32_t on stack
+
 //-------------------------------- DATA TYPES ---------------------------------
 
+typedef struct _fn_gen_seq_t
+{
+    fn_gen_seq_step_t *p_steps;     // Own copy of the steps
+    int                step_count;
+    int                loop_count;  // FN_GEN_SEQ_LOOP_FOREVER or number of loops
+    int                step;        // Step being output
+    int                loop;        // Loops done
+    int64_t            deadline_us; // esp_timer time the current step ends at
+    bool               is_running;
+} fn_gen_seq_t;
+
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
 /**
  * @brief Timer callback function, used for precise time management in signal generation
@@ -45,25 +85,121 @@
  * @param timer timer handle
  * @param edata
  * @param user_data
+ * @return true if a higher priority task was woken
+ */
+static bool _on_timer_alarm_cb(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data);
+
+/**
+ * @brief Checks if config can be generated on channel
+ *
+ * @param channel Output channel
+ * @param p_config Config to check
+ * @return fn_gen_error_t
+ */
+static fn_gen_error_t _check_config(fn_channel_t channel, const fn_signal_config_t *p_config);
+
+/**
+ * @brief Checks if channel 2 config can follow channel 1 phase
+ *
+ * @param p_config Channel 2 config
+ * @return fn_gen_error_t
+ */
+static fn_gen_error_t _check_lock(const fn_signal_config_t *p_config);
+
+/**
+ * @brief Prepares config in the bank ISR isn't using and swaps it in. Phase accumulators are kept so the output
+ * stays phase continuous. Must be called with config protect mutex taken.
+ *
+ * @param channel Output channel
+ * @param p_config Config to apply
+ * @return fn_gen_error_t
+ */
+static fn_gen_error_t _set_config_locked(fn_channel_t channel, const fn_signal_config_t *p_config);
+
+/**
+ * @brief Tells change callback about a successful config or preset change. Must be called without config protect
+ * mutex taken, so the callback can read configs back.
+ *
+ * @param err Result of the change
+ * @return fn_gen_error_t err, passed through
+ */
+static fn_gen_error_t _notify_change(fn_gen_error_t err);
+
+/**
+ * @brief Checks if config can be output by LEDC. LEDC output is digital, so only a continuous unmodulated square
+ * swinging from 0 to VDD fits, and locked channels need DDS phase accumulators.
+ *
+ * @param p_config Signal config
+ * @return true if LEDC can output config
+ */
+static bool _is_pwm_capable(const fn_signal_config_t *p_config);
+
+/**
+ * @brief Picks backend for channel config. Hardware cosine generator is used for plain sine that fits its frequency
+ * and amplitude granularity, LEDC for full amplitude square, everything else is rendered by DDS.
+ *
+ * @param channel Output channel
+ * @param p_config Signal config
+ * @param p_cw Cosine generator settings, filled if FN_BACKEND_CW is returned
+ * @param p_pwm LEDC settings, filled if FN_BACKEND_PWM is returned
+ * @return fn_gen_backend_t
+ */
+static fn_gen_backend_t _select_backend(fn_channel_t channel, const fn_signal_config_t *p_config, fn_cw_params_t *p_cw,
+                                        fn_pwm_params_t *p_pwm);
+
+/**
+ * @brief Sets lock and rebuilds both channels, channel 2 for its new frequency and both for backends lock allows.
+ * Must be called with config protect mutex taken.
+ *
+ * @param is_locked True to lock channel 2 to channel 1
+ * @param lock_phase Phase of channel 2 ahead of channel 1
+ * @return fn_gen_error_t
+ */
+static fn_gen_error_t _set_lock_locked(bool is_locked, uint32_t lock_phase);
+
+/**
+ * @brief Starts and stops cosine generator, LEDC and timer so they match started state, enabled channels and their
+ * backends. Must be called with config protect mutex taken.
+ *
+ * @return fn_gen_error_t FN_GEN_ERR_CREATE if LEDC failed for a channel above FN_GEN_MAX_FREQ_HZ, which is stopped
+ */
+static fn_gen_error_t _update_outputs_locked(void);
+
+/**
+ * @brief Gate input edge callback
+ *
+ * @param is_asserted New gate level
+ * @param p_arg Channel the gate belongs to
  */
-static void _on_timer_alarm_cb(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data);
+static void _on_gate_edge(bool is_asserted, void *p_arg);
 
 /**
- * @brief Outputs values to DAC in timer intervals
+ * @brief Sequence timer callback, wakes the sequencer task. Runs in the esp_timer task, so it doesn't wait for the
+ * config protect mutex itself.
  *
- * @param pvParameters
+ * @param p_arg Unused
  */
-void _singal_generator_task(void *pvParameters);
+static void _on_seq_timer(void *p_arg);
 
 /**
- * @brief Fills raw value array with a period of the signal
+ * @brief Sequencer task, swaps in the next step when the current one is due and arms the timer for its deadline
  *
- * @param pnt_num Number of array fields used based on freq
- * @param signal Signal type
- * @param amplitude Signal amplitude
- * @param duty_cycle Duty cycle for square wave
+ * @param p_arg Unused
  */
-static void _prepare_data(int pnt_num, fn_signal_type_t signal, int amplitude, int duty_cycle);
+static void _seq_task(void *p_arg);
+
+/**
+ * @brief Outputs current sequence step and arms the timer for the end of its dwell time. Must be called with config
+ * protect mutex taken.
+ *
+ */
+static void _seq_output_locked(void);
+
+/**
+ * @brief Stops sequence timer and frees the steps. Must be called with config protect mutex taken.
+ *
+ */
+static void _seq_stop_locked(void);
 
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 
@@ -71,11 +207,44 @@ static fn_generator_t     _fn;
 static fn_signal_config_t _config_default = { .signal                = FN_GEN_DEFAULT_SIGNAL,
                                               .frequency_Hz          = FN_GEN_DEFAULT_FREQ,
                                               .amplitude_mV          = FN_GEN_DEFAULT_AMPL,
-                                              .duty_cycle_percentage = FN_GEN_DEFAULT_DUTY };
+                                              .offset_mV             = FN_GEN_DEFAULT_OFFSET,
+                                              .duty_cycle_percentage = FN_GEN_DEFAULT_DUTY,
+                                              .modulation            = { .type = FN_MOD_NONE },
+                                              .trigger               = { .mode = FN_TRIG_CONTINUOUS, .gate_pin = GATE_PIN_NONE } };
+
+// DAC driven by each channel, read by the sample ISR so it stays reachable while flash is written
+static DRAM_ATTR const dac_channel_t _dac_channel[FN_CHANNEL_COUNT] = {
+    [FN_CHANNEL_1] = ESP_DAC_CHAN_1,
+    [FN_CHANNEL_2] = ESP_DAC_CHAN_2,
+};
 
+// GPIO driven by each channel
+static const int _out_pin[FN_CHANNEL_COUNT] = {
+    [FN_CHANNEL_1] = ESP_DAC_CHAN_1_GPIO,
+    [FN_CHANNEL_2] = ESP_DAC_CHAN_2_GPIO,
+};
+
+// Backend names for logs
+static const char *const _backend_name[FN_BACKEND_COUNT] = {
+    [FN_BACKEND_DDS] = "DDS",
+    [FN_BACKEND_CW]  = "cosine generator",
+    [FN_BACKEND_PWM] = "LEDC",
+};
 
 static SemaphoreHandle_t _config_protect_mutex = NULL;
 
+static fn_gen_change_cb_t _change_cb = NULL; // Told about config and preset changes
+
+static fn_gen_seq_t       _seq;
+static esp_timer_handle_t _seq_timer       = NULL; // Single one-shot timer, re-armed for every step
+static TaskHandle_t       _seq_task_handle = NULL; // Woken by the timer, applies the steps
+
+#if CONFIG_FN_GEN_TIMING_TRACE
+// Cycle count of each output update
+static uint32_t         _timing_stamps[CONFIG_FN_GEN_TIMING_RING_LEN];
+static fn_timing_ring_t _timing;
+#endif
+
 static const char *TAG = "function_generator";
 
 //------------------------------- GLOBAL DATA ---------------------------------
@@ -84,9 +253,10 @@ static const char *TAG = "function_generator";
 
 void fn_gen_init()
 {
-    _fn._config       = _config_default;
-    _fn._period_index = 0;
-    memset(_fn._raw_val, 0, FN_GEN_POINT_ARR_LEN * sizeof(int));
+    _fn._is_locked        = false;
+    _fn._lock_phase       = 0;
+    _fn._is_running       = false;
+    _fn._is_timer_running = false;
 
     // Initialize all presets to default config
     for(int i = 0; i < FN_GEN_PRESET_NUMBER; i++)
@@ -94,6 +264,32 @@ void fn_gen_init()
         _fn.presets[i] = _config_default;
     }
 
+    fn_wavetable_init();
+
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        fn_gen_channel_t *p_ch = &_fn._channel[i];
+
+        p_ch->_config      = _config_default;
+        p_ch->_phase       = 0;
+        p_ch->_lfo_phase   = 0;
+        p_ch->_burst_cycle = 0;
+        p_ch->_idle_left   = 0;
+        p_ch->_gate        = false;
+        p_ch->_is_enabled  = (FN_CHANNEL_1 == i);
+        p_ch->_backend     = FN_BACKEND_DDS;
+        p_ch->_output      = FN_BACKEND_DDS;
+        p_ch->_noise_left  = 0;
+        fn_noise_init(&p_ch->_noise, CHANNEL_NOISE_SEED(i));
+        fn_cal_identity(p_ch->_lut);
+        p_ch->_is_calibrated = false;
+
+        fn_render_prepare(&p_ch->_bank[0], &p_ch->_config, p_ch->_lut);
+        p_ch->_p_active   = &p_ch->_bank[0];
+        p_ch->_p_rendered = p_ch->_p_active;
+        p_ch->_backend    = _select_backend(i, &p_ch->_config, &p_ch->_cw, &p_ch->_pwm);
+    }
+
     // Create mutexes
     if(NULL == _config_protect_mutex)
     {
@@ -106,151 +302,262 @@ void fn_gen_init()
         }
     }
 
+#if CONFIG_FN_GEN_TIMING_TRACE
+    fn_timing_ring_init(&_timing, _timing_stamps, CONFIG_FN_GEN_TIMING_RING_LEN);
+#endif
+
+    if(NULL == _seq_timer)
+    {
+        const esp_timer_create_args_t seq_timer_args = { .callback = _on_seq_timer, .name = "fn_seq" };
+        if(ESP_OK != esp_timer_create(&seq_timer_args, &_seq_timer))
+        {
+            ESP_LOGE(TAG, "Failed to create sequence timer");
+        }
+    }
+    if((NULL != _seq_timer) && (NULL == _seq_task_handle) &&
+       (SCHED_ERR_NONE != sched_task_create(SCHED_TASK_SEQ, _seq_task, SEQ_TASK_STACK_SIZE, NULL, &_seq_task_handle)))
+    {
+        // Sequences can't be started without the task that steps them
+        esp_timer_delete(_seq_timer);
+        _seq_timer = NULL;
+    }
+
     timer_init(FN_GEN_TIMER_INTR_US, _on_timer_alarm_cb);
-    dac_init();
+    dac_init(_dac_channel[FN_CHANNEL_1]);
 
     ESP_LOGI(TAG, "Initailized function generator");
 }
 
 fn_gen_error_t fn_gen_set_signal_config(fn_signal_config_t config)
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    return fn_gen_set_channel_config(FN_CHANNEL_1, config);
+}
 
-    // Checks parameters
-    if(config.signal >= FN_SIGNAL_COUNT)
+fn_gen_error_t fn_gen_set_channel_config(fn_channel_t channel, fn_signal_config_t config)
+{
+    if(channel >= FN_CHANNEL_COUNT)
     {
-        ESP_LOGE(TAG, "Unknown signal type!");
-        return FN_GEN_ERR_UNKNOWN_SIGNAL;
+        ESP_LOGE(TAG, "Channel %d doesn't exist!", channel);
+        return FN_GEN_ERR_CREATE;
     }
-    if(OUTPUT_POINT_NUM(config.frequency_Hz) >= FN_GEN_POINT_ARR_LEN)
+
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+    fn_gen_error_t err = _set_config_locked(channel, &config);
+    xSemaphoreGive(_config_protect_mutex);
+
+    if(FN_GEN_ERR_NONE == err)
     {
-        ESP_LOGE(TAG, "The frequency is too low and using too long buffer.");
-        return FN_GEN_ERR_CREATE;
+        ESP_LOGI(TAG, "Set signal config of channel %d", channel + 1);
     }
-    if(config.amplitude_mV > VDD)
+    return _notify_change(err);
+}
+
+fn_gen_error_t fn_gen_get_channel_config(fn_channel_t channel, fn_signal_config_t *p_config)
+{
+    if(channel >= FN_CHANNEL_COUNT)
     {
-        ESP_LOGE(TAG, "Amplitude is higher than VDD");
+        ESP_LOGE(TAG, "Channel %d doesn't exist!", channel);
         return FN_GEN_ERR_CREATE;
     }
-    if((config.duty_cycle_percentage > 100) || (config.duty_cycle_percentage < 0))
+
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+    *p_config = _fn._channel[channel]._config;
+    xSemaphoreGive(_config_protect_mutex);
+
+    return FN_GEN_ERR_NONE;
+}
+
+fn_gen_error_t fn_gen_set_channel_enabled(fn_channel_t channel, bool is_enabled)
+{
+    if(channel >= FN_CHANNEL_COUNT)
     {
-        ESP_LOGE(TAG, "Duty cycle is not a whole percentage between 0 and 100");
+        ESP_LOGE(TAG, "Channel %d doesn't exist!", channel);
         return FN_GEN_ERR_CREATE;
     }
 
-    xSemaphoreTakeFromISR(_config_protect_mutex, portMAX_DELAY);
-
-    ESP_LOGI(TAG, "CONFIG: took semaphore");
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
 
-    _fn._config       = config;
-    _fn._period_index = 0;
-    _prepare_data(OUTPUT_POINT_NUM(_fn._config.frequency_Hz),
-                  _fn._config.signal,
-                  APLITUDE_VOLTS_TO_DAC(_fn._config.amplitude_mV),
-                  _fn._config.duty_cycle_percentage);
+    fn_gen_error_t    err  = FN_GEN_ERR_NONE;
+    fn_gen_channel_t *p_ch = &_fn._channel[channel];
+    if(is_enabled != p_ch->_is_enabled)
+    {
+        if(is_enabled)
+        {
+            dac_init(_dac_channel[channel]);
+            p_ch->_is_enabled = true;
 
-    xSemaphoreGiveFromISR(_config_protect_mutex, &xHigherPriorityTaskWoken);
-    ESP_LOGI(TAG, "CONFIG: released semaphore");
+            // Backend is picked again, other channel may have taken the cosine generator meanwhile
+            err = _set_config_locked(channel, &p_ch->_config);
+        }
+        else
+        {
+            // Locked channel 2 would freeze without channel 1 phase
+            if(_fn._is_locked)
+            {
+                _set_lock_locked(false, 0);
+            }
+            p_ch->_is_enabled = false;
+            _update_outputs_locked();
+            dac_deinit(_dac_channel[channel]);
+        }
+    }
 
-    ESP_LOGI(TAG, "Set signal config");
+    xSemaphoreGive(_config_protect_mutex);
 
-    return FN_GEN_ERR_NONE;
+    ESP_LOGI(TAG, "Channel %d %s", channel + 1, is_enabled ? "enabled" : "disabled");
+    return err;
 }
 
-fn_gen_error_t fn_gen_set_signal_type(fn_signal_type_t type)
+fn_gen_error_t fn_gen_set_lock(bool is_locked, int phase_offset_deg)
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    if((phase_offset_deg < 0) || (phase_offset_deg >= 360))
+    {
+        ESP_LOGE(TAG, "Phase offset is not between 0 and 359 degrees");
+        return FN_GEN_ERR_CREATE;
+    }
+
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    fn_gen_channel_t *p_ch2 = &_fn._channel[FN_CHANNEL_2];
+    fn_gen_error_t    err   = FN_GEN_ERR_NONE;
 
-    // Checks parameters
-    if(type >= FN_SIGNAL_COUNT)
+    if(is_locked && !(_fn._channel[FN_CHANNEL_1]._is_enabled && p_ch2->_is_enabled))
     {
-        ESP_LOGE(TAG, "Unknown signal type!");
-        return FN_GEN_ERR_UNKNOWN_SIGNAL;
+        ESP_LOGE(TAG, "Lock needs both channels enabled");
+        err = FN_GEN_ERR_CREATE;
+    }
+    else if(is_locked)
+    {
+        err = _check_lock(&p_ch2->_config);
     }
 
-    // Protect from signal generating task
-    xSemaphoreTakeFromISR(_config_protect_mutex, portMAX_DELAY);
+    if(FN_GEN_ERR_NONE == err)
+    {
+        err = _set_lock_locked(is_locked, DEGREES_TO_PHASE(phase_offset_deg));
+    }
 
-    _fn._config.signal = type;
-    _fn._period_index  = 0;
-    _prepare_data(OUTPUT_POINT_NUM(_fn._config.frequency_Hz),
-                  _fn._config.signal,
-                  APLITUDE_VOLTS_TO_DAC(_fn._config.amplitude_mV),
-                  _fn._config.duty_cycle_percentage);
-    xSemaphoreGiveFromISR(_config_protect_mutex, &xHigherPriorityTaskWoken);
-    return FN_GEN_ERR_NONE;
+    xSemaphoreGive(_config_protect_mutex);
+
+    if(FN_GEN_ERR_NONE == err)
+    {
+        ESP_LOGI(TAG, "Channels %s, phase offset %d degrees", is_locked ? "locked" : "unlocked", phase_offset_deg);
+    }
+    return err;
 }
 
-fn_gen_error_t fn_gen_set_frequency(int frequency_Hz)
+fn_gen_error_t fn_gen_set_signal_type(fn_signal_type_t type)
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    // Protect from other config writers
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
 
-    // Checks parameters
-    if(OUTPUT_POINT_NUM(frequency_Hz) >= FN_GEN_POINT_ARR_LEN)
-    {
-        ESP_LOGE(TAG, "The frequency is too low and using too long buffer.");
-        return FN_GEN_ERR_CREATE;
-    }
+    fn_signal_config_t config = _fn._channel[FN_CHANNEL_1]._config;
+    config.signal             = type;
+    fn_gen_error_t err        = _set_config_locked(FN_CHANNEL_1, &config);
 
-    // Protect from signal generating task
-    xSemaphoreTakeFromISR(_config_protect_mutex, portMAX_DELAY);
+    xSemaphoreGive(_config_protect_mutex);
+    return _notify_change(err);
+}
 
-    _fn._config.frequency_Hz = frequency_Hz;
-    _fn._period_index        = 0;
-    _prepare_data(OUTPUT_POINT_NUM(_fn._config.frequency_Hz),
-                  _fn._config.signal,
-                  APLITUDE_VOLTS_TO_DAC(_fn._config.amplitude_mV),
-                  _fn._config.duty_cycle_percentage);
-    xSemaphoreGiveFromISR(_config_protect_mutex, &xHigherPriorityTaskWoken);
-    return FN_GEN_ERR_NONE;
+fn_gen_error_t fn_gen_set_frequency(int frequency_Hz)
+{
+    // Protect from other config writers
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    fn_signal_config_t config = _fn._channel[FN_CHANNEL_1]._config;
+    config.frequency_Hz       = frequency_Hz;
+    fn_gen_error_t err        = _set_config_locked(FN_CHANNEL_1, &config);
+
+    xSemaphoreGive(_config_protect_mutex);
+    return _notify_change(err);
 }
 
 fn_gen_error_t fn_gen_set_amplitude(int amplitude_mV_pp)
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    // Protect from other config writers
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    fn_signal_config_t config = _fn._channel[FN_CHANNEL_1]._config;
+    config.amplitude_mV       = amplitude_mV_pp;
+    fn_gen_error_t err        = _set_config_locked(FN_CHANNEL_1, &config);
 
-    // Checks parameters
-    if(amplitude_mV_pp > VDD)
+    xSemaphoreGive(_config_protect_mutex);
+    return _notify_change(err);
+}
+
+fn_gen_error_t fn_gen_set_offset(int offset_mV)
+{
+    // Protect from other config writers
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    fn_signal_config_t config = _fn._channel[FN_CHANNEL_1]._config;
+    config.offset_mV          = offset_mV;
+    fn_gen_error_t err        = _set_config_locked(FN_CHANNEL_1, &config);
+
+    xSemaphoreGive(_config_protect_mutex);
+    return _notify_change(err);
+}
+
+uint8_t fn_gen_get_clip(fn_channel_t channel)
+{
+    if(channel >= FN_CHANNEL_COUNT)
     {
-        ESP_LOGE(TAG, "Amplitude is higher than VDD");
-        return FN_GEN_ERR_CREATE;
+        return 0;
     }
 
-    // Protect from signal generating task
-    xSemaphoreTakeFromISR(_config_protect_mutex, portMAX_DELAY);
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+    fn_level_t level;
+    uint8_t    clip = fn_level_solve(_fn._channel[channel]._config.amplitude_mV, _fn._channel[channel]._config.offset_mV,
+                                     VDD, &level);
+    xSemaphoreGive(_config_protect_mutex);
 
-    _fn._config.amplitude_mV = amplitude_mV_pp;
-    _fn._period_index        = 0;
-
-    _prepare_data(OUTPUT_POINT_NUM(_fn._config.frequency_Hz),
-                  _fn._config.signal,
-                  APLITUDE_VOLTS_TO_DAC(_fn._config.amplitude_mV),
-                  _fn._config.duty_cycle_percentage);
-    xSemaphoreGiveFromISR(_config_protect_mutex, &xHigherPriorityTaskWoken);
-    return FN_GEN_ERR_NONE;
+    return clip;
 }
 
 fn_gen_error_t fn_gen_set_duty_cycle(int duty_cycle_percentage)
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    // Protect from other config writers
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    fn_signal_config_t config    = _fn._channel[FN_CHANNEL_1]._config;
+    config.duty_cycle_percentage = duty_cycle_percentage;
+    fn_gen_error_t err           = _set_config_locked(FN_CHANNEL_1, &config);
+
+    xSemaphoreGive(_config_protect_mutex);
+    return _notify_change(err);
+}
+
+fn_gen_error_t fn_gen_set_modulation(fn_mod_config_t modulation)
+{
+    // Protect from other config writers
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
 
-    // Checks parameters
-    if((duty_cycle_percentage > 100) || (duty_cycle_percentage < 0))
+    fn_signal_config_t config = _fn._channel[FN_CHANNEL_1]._config;
+    config.modulation         = modulation;
+    fn_gen_error_t err        = _set_config_locked(FN_CHANNEL_1, &config);
+
+    xSemaphoreGive(_config_protect_mutex);
+    return _notify_change(err);
+}
+
+fn_gen_error_t fn_gen_set_trigger(fn_trig_config_t trigger)
+{
+    // Protect from other config writers
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    fn_signal_config_t config = _fn._channel[FN_CHANNEL_1]._config;
+    config.trigger            = trigger;
+    fn_gen_error_t err        = _set_config_locked(FN_CHANNEL_1, &config);
+
+    xSemaphoreGive(_config_protect_mutex);
+    return _notify_change(err);
+}
+
+void fn_gen_set_gate(bool is_asserted)
+{
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
     {
-        ESP_LOGE(TAG, "Duty cycle is not a whole percentage between 0 and 100");
-        return FN_GEN_ERR_CREATE;
+        _fn._channel[i]._gate = is_asserted;
     }
-    // Protect from signal generating task
-    xSemaphoreTakeFromISR(_config_protect_mutex, portMAX_DELAY);
-
-    _fn._config.duty_cycle_percentage = duty_cycle_percentage;
-    _fn._period_index                 = 0;
-    _prepare_data(OUTPUT_POINT_NUM(_fn._config.frequency_Hz),
-                  _fn._config.signal,
-                  APLITUDE_VOLTS_TO_DAC(_fn._config.amplitude_mV),
-                  _fn._config.duty_cycle_percentage);
-    xSemaphoreGiveFromISR(_config_protect_mutex, &xHigherPriorityTaskWoken);
-    return FN_GEN_ERR_NONE;
 }
 
 fn_gen_error_t fn_gen_set_preset(fn_signal_config_t config, int preset_num)
@@ -264,7 +571,7 @@ fn_gen_error_t fn_gen_set_preset(fn_signal_config_t config, int preset_num)
 
     _fn.presets[preset_num] = config;
 
-    return FN_GEN_ERR_NONE;
+    return _notify_change(FN_GEN_ERR_NONE);
 }
 
 fn_gen_error_t fn_gen_get_preset(fn_signal_config_t *conf, int preset_num)
@@ -287,65 +594,789 @@ fn_gen_error_t fn_gen_load_preset(int preset_num)
 
 fn_gen_error_t fn_gen_signal_start_task()
 {
-    timer_start();
-    ESP_LOGI(TAG, "Starting signal timer");
-    return FN_GEN_ERR_NONE;
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+    _fn._is_running    = true;
+    fn_gen_error_t err = _update_outputs_locked();
+    xSemaphoreGive(_config_protect_mutex);
+
+    ESP_LOGI(TAG, "Starting signal output");
+    return err;
 }
 
 fn_gen_error_t fn_gen_signal_stop_task()
 {
-    timer_stop();
-    ESP_LOGI(TAG, "Stopping signal timer");
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+    _fn._is_running = false;
+    _update_outputs_locked();
+    xSemaphoreGive(_config_protect_mutex);
+
+    ESP_LOGI(TAG, "Stopping signal output");
+    return FN_GEN_ERR_NONE;
+}
+
+fn_gen_error_t fn_gen_seq_start(const fn_gen_seq_step_t *p_steps, int step_count, int loop_count)
+{
+    if((NULL == _seq_timer) || (NULL == p_steps) || (step_count <= 0) || (loop_count < 0))
+    {
+        ESP_LOGE(TAG, "Invalid sequence");
+        return FN_GEN_ERR;
+    }
+
+    fn_gen_seq_step_t *p_copy = malloc(step_count * sizeof(*p_copy));
+    if(NULL == p_copy)
+    {
+        ESP_LOGE(TAG, "No memory for %d sequence steps", step_count);
+        return FN_GEN_ERR;
+    }
+    memcpy(p_copy, p_steps, step_count * sizeof(*p_copy));
+
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    // Whole sequence is checked up front so it can't stop halfway on a bad step
+    for(int i = 0; i < step_count; i++)
+    {
+        fn_gen_error_t err = _check_config(FN_CHANNEL_1, &p_copy[i].config);
+        if((FN_GEN_ERR_NONE != err) || (p_copy[i].dwell_ms < FN_GEN_SEQ_MIN_DWELL_MS))
+        {
+            xSemaphoreGive(_config_protect_mutex);
+            free(p_copy);
+            ESP_LOGE(TAG, "Sequence step %d is invalid", i);
+            return (FN_GEN_ERR_NONE != err) ? err : FN_GEN_ERR;
+        }
+    }
+
+    _seq_stop_locked();
+    _seq.p_steps     = p_copy;
+    _seq.step_count  = step_count;
+    _seq.loop_count  = loop_count;
+    _seq.step        = 0;
+    _seq.loop        = 0;
+    _seq.deadline_us = esp_timer_get_time();
+    _seq.is_running  = true;
+    _seq_output_locked();
+
+    xSemaphoreGive(_config_protect_mutex);
+
+    ESP_LOGI(TAG, "Sequence of %d steps started", step_count);
+    return FN_GEN_ERR_NONE;
+}
+
+void fn_gen_seq_stop(void)
+{
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+    _seq_stop_locked();
+    xSemaphoreGive(_config_protect_mutex);
+}
+
+bool fn_gen_seq_is_running(void)
+{
+    return _seq.is_running;
+}
+
+fn_gen_error_t fn_gen_calibrate(fn_channel_t channel, fn_gen_cal_read_t read_mV, void *p_arg, fn_cal_result_t *p_result)
+{
+    if((channel >= FN_CHANNEL_COUNT) || (NULL == read_mV))
+    {
+        ESP_LOGE(TAG, "Invalid calibration of channel %d", channel + 1);
+        return FN_GEN_ERR_CREATE;
+    }
+
+    int16_t *p_measured = malloc(FN_CAL_CODES * sizeof(*p_measured));
+    if(NULL == p_measured)
+    {
+        ESP_LOGE(TAG, "No memory for calibration");
+        return FN_GEN_ERR;
+    }
+
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    if(_fn._is_locked || _seq.is_running)
+    {
+        xSemaphoreGive(_config_protect_mutex);
+        free(p_measured);
+        ESP_LOGE(TAG, "Calibration needs unlocked channels and no sequence running");
+        return FN_GEN_ERR;
+    }
+
+    // Channel is taken off its backend, so nothing but the sweep drives its DAC
+    fn_gen_channel_t *p_ch        = &_fn._channel[channel];
+    bool              was_enabled = p_ch->_is_enabled;
+
+    p_ch->_is_enabled = false;
+    _update_outputs_locked();
+    if(!was_enabled)
+    {
+        dac_init(_dac_channel[channel]);
+    }
+
+    fn_gen_error_t  err = FN_GEN_ERR_NONE;
+    fn_cal_result_t result;
+    for(int code = 0; (code < FN_CAL_CODES) && (FN_GEN_ERR_NONE == err); code++)
+    {
+        dac_output(_dac_channel[channel], (uint8_t)code);
+        esp_rom_delay_us(CAL_SETTLE_US);
+
+        int mV = read_mV(channel, p_arg);
+        if(mV < 0)
+        {
+            ESP_LOGE(TAG, "Calibration read failed at code %d", code);
+            err = FN_GEN_ERR;
+        }
+        p_measured[code] = (int16_t)mV;
+    }
+
+    if((FN_GEN_ERR_NONE == err) && fn_cal_fit(p_measured, VDD, p_ch->_lut, &result))
+    {
+        p_ch->_is_calibrated = true;
+    }
+    else if(FN_GEN_ERR_NONE == err)
+    {
+        ESP_LOGE(TAG, "Channel %d output doesn't show up on the loopback", channel + 1);
+        err = FN_GEN_ERR;
+    }
+
+    if(!was_enabled)
+    {
+        dac_deinit(_dac_channel[channel]);
+    }
+    p_ch->_is_enabled = was_enabled;
+
+    // Bank is rebuilt through the new table, which also restarts the output
+    _set_config_locked(channel, &p_ch->_config);
+
+    xSemaphoreGive(_config_protect_mutex);
+    free(p_measured);
+
+    if(FN_GEN_ERR_NONE == err)
+    {
+        ESP_LOGI(TAG, "Calibrated channel %d: %d mV to %d mV, INL %d mV over codes %d to %d", channel + 1, result.offset_mV,
+                 result.full_scale_mV, result.max_inl_mV, result.first_code, result.last_code);
+        if(NULL != p_result)
+        {
+            *p_result = result;
+        }
+    }
+    return err;
+}
+
+fn_gen_error_t fn_gen_set_calibration(fn_channel_t channel, const uint8_t *p_lut)
+{
+    if(channel >= FN_CHANNEL_COUNT)
+    {
+        ESP_LOGE(TAG, "Channel %d doesn't exist!", channel);
+        return FN_GEN_ERR_CREATE;
+    }
+
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+    fn_gen_channel_t *p_ch = &_fn._channel[channel];
+    if(NULL == p_lut)
+    {
+        fn_cal_identity(p_ch->_lut);
+    }
+    else
+    {
+        memcpy(p_ch->_lut, p_lut, sizeof(p_ch->_lut));
+    }
+    p_ch->_is_calibrated = (NULL != p_lut);
+    fn_gen_error_t err   = _set_config_locked(channel, &p_ch->_config);
+
+    xSemaphoreGive(_config_protect_mutex);
+    return err;
+}
+
+bool fn_gen_get_calibration(fn_channel_t channel, uint8_t *p_lut)
+{
+    if(channel >= FN_CHANNEL_COUNT)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+    memcpy(p_lut, _fn._channel[channel]._lut, sizeof(_fn._channel[channel]._lut));
+    bool is_calibrated = _fn._channel[channel]._is_calibrated;
+    xSemaphoreGive(_config_protect_mutex);
+
+    return is_calibrated;
+}
+
+void fn_gen_set_change_cb(fn_gen_change_cb_t cb)
+{
+    _change_cb = cb;
+}
+
+fn_gen_error_t fn_gen_timing_capture(bool is_on)
+{
+#if CONFIG_FN_GEN_TIMING_TRACE
+    _timing.is_on = false;
+    if(is_on)
+    {
+        // Wait out an ISR that may still be adding a stamp
+        esp_rom_delay_us(FN_GEN_TIMER_INTR_US);
+        _timing.count = 0;
+        _timing.head  = 0;
+        _timing.is_on = true;
+    }
     return FN_GEN_ERR_NONE;
+#else
+    ESP_LOGE(TAG, "Timing trace is disabled in config");
+    return FN_GEN_ERR_CREATE;
+#endif
+}
+
+uint32_t fn_gen_timing_copy(uint32_t *p_stamps, uint32_t max_count)
+{
+#if CONFIG_FN_GEN_TIMING_TRACE
+    bool was_on = _timing.is_on;
+
+    // Ring is paused while it is copied so head and count stay consistent
+    _timing.is_on = false;
+    esp_rom_delay_us(FN_GEN_TIMER_INTR_US);
+    uint32_t count = fn_timing_ring_copy(&_timing, p_stamps, max_count);
+    _timing.is_on  = was_on;
+
+    return count;
+#else
+    return 0;
+#endif
+}
+
+uint32_t fn_gen_timing_nominal(void)
+{
+    return TIMING_NOMINAL_CYCLES;
 }
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
 
-static void _prepare_data(int pnt_num, fn_signal_type_t signal, int amplitude, int duty_cycle)
+static inline int _gate_pin(const fn_signal_config_t *p_config)
+{
+    return (FN_TRIG_GATED == p_config->trigger.mode) ? p_config->trigger.gate_pin : GATE_PIN_NONE;
+}
+
+static fn_gen_error_t _check_config(fn_channel_t channel, const fn_signal_config_t *p_config)
 {
-    for(int i = 0; i < pnt_num; i++)
+    const fn_mod_config_t *p_mod = &p_config->modulation;
+
+    if(p_config->signal >= FN_SIGNAL_COUNT)
     {
-        switch(signal)
+        ESP_LOGE(TAG, "Unknown signal type!");
+        return FN_GEN_ERR_UNKNOWN_SIGNAL;
+    }
+    if((p_config->frequency_Hz <= 0) || (p_config->frequency_Hz > FN_GEN_MAX_PWM_FREQ_HZ))
+    {
+        ESP_LOGE(TAG, "Frequency is not between 1 Hz and %d Hz", FN_GEN_MAX_PWM_FREQ_HZ);
+        return FN_GEN_ERR_CREATE;
+    }
+    if(p_config->amplitude_mV > VDD)
+    {
+        ESP_LOGE(TAG, "Amplitude is higher than VDD");
+        return FN_GEN_ERR_CREATE;
+    }
+    if((p_config->offset_mV < -VDD) || (p_config->offset_mV > VDD))
+    {
+        ESP_LOGE(TAG, "Offset is not between -%d mV and %d mV", VDD, VDD);
+        return FN_GEN_ERR_CREATE;
+    }
+    if((p_config->frequency_Hz > FN_GEN_MAX_FREQ_HZ) && !_is_pwm_capable(p_config))
+    {
+        ESP_LOGE(TAG, "Above %d Hz only continuous unmodulated square at VDD amplitude without offset can be output",
+                 FN_GEN_MAX_FREQ_HZ);
+        return FN_GEN_ERR_CREATE;
+    }
+    if((p_config->duty_cycle_percentage > 100) || (p_config->duty_cycle_percentage < 0))
+    {
+        ESP_LOGE(TAG, "Duty cycle is not a whole percentage between 0 and 100");
+        return FN_GEN_ERR_CREATE;
+    }
+    fn_pwm_params_t pwm;
+    if((p_config->frequency_Hz > FN_GEN_MAX_FREQ_HZ) &&
+       !fn_pwm_solve(PWM_CLK_HZ, p_config->frequency_Hz, p_config->duty_cycle_percentage, &pwm))
+    {
+        ESP_LOGE(TAG, "LEDC can't output %d Hz and DDS only goes up to %d Hz", p_config->frequency_Hz,
+                 FN_GEN_MAX_FREQ_HZ);
+        return FN_GEN_ERR_CREATE;
+    }
+
+    if(p_config->trigger.mode >= FN_TRIG_COUNT)
+    {
+        ESP_LOGE(TAG, "Unknown trigger mode!");
+        return FN_GEN_ERR_CREATE;
+    }
+    if(FN_TRIG_BURST == p_config->trigger.mode)
+    {
+        if(p_config->trigger.burst_cycles < 1)
+        {
+            ESP_LOGE(TAG, "Burst needs at least one period");
+            return FN_GEN_ERR_CREATE;
+        }
+        if((p_config->trigger.burst_idle_ms < 0) || (p_config->trigger.burst_idle_ms > BURST_MAX_IDLE_MS))
+        {
+            ESP_LOGE(TAG, "Burst idle time is not between 0 ms and %d ms", BURST_MAX_IDLE_MS);
+            return FN_GEN_ERR_CREATE;
+        }
+    }
+    if((GATE_PIN_NONE != _gate_pin(p_config)) && !GPIO_IS_VALID_GPIO(_gate_pin(p_config)))
+    {
+        ESP_LOGE(TAG, "Gate GPIO%d doesn't exist", _gate_pin(p_config));
+        return FN_GEN_ERR_CREATE;
+    }
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        int pin = _gate_pin(p_config);
+        if((i != channel) && (GATE_PIN_NONE != pin) && (pin == _gate_pin(&_fn._channel[i]._config)))
         {
-            case FN_SIGNAL_SINE:
-                _fn._raw_val[i] = (int)((sin(i * CONST_PERIOD_2_PI / pnt_num) + 1) * (double)(amplitude) / 2 + 0.5);
-                break;
-            case FN_SIGNAL_TRIANGLE:
-                _fn._raw_val[i] = (i > (pnt_num / 2)) ? (2 * amplitude * (pnt_num - i) / pnt_num) : (2 * amplitude * i / pnt_num);
-                break;
-            case FN_SIGNAL_SAWTOOTH:
-                _fn._raw_val[i] = (i == pnt_num) ? 0 : (i * amplitude / pnt_num);
-                break;
-            case FN_SIGNAL_SQUARE:
-                _fn._raw_val[i] = (i < (pnt_num * duty_cycle / 100)) ? amplitude : 0;
-                break;
-            default:
-                break;
+            ESP_LOGE(TAG, "Gate GPIO%d is used by channel %d", pin, i + 1);
+            return FN_GEN_ERR_CREATE;
         }
     }
+    if((FN_CHANNEL_2 == channel) && _fn._is_locked && (FN_GEN_ERR_NONE != _check_lock(p_config)))
+    {
+        return FN_GEN_ERR_CREATE;
+    }
+
+    if(FN_MOD_NONE == p_mod->type)
+    {
+        return FN_GEN_ERR_NONE;
+    }
+    if((p_mod->type >= FN_MOD_COUNT) || (p_mod->shape >= FN_SIGNAL_COUNT))
+    {
+        ESP_LOGE(TAG, "Unknown modulation!");
+        return FN_GEN_ERR_UNKNOWN_MOD;
+    }
+    if(fn_render_is_noise(p_config->signal))
+    {
+        ESP_LOGE(TAG, "Noise can't be modulated");
+        return FN_GEN_ERR_UNKNOWN_MOD;
+    }
+    if(fn_render_is_noise(p_mod->shape))
+    {
+        ESP_LOGE(TAG, "Noise can't be used as modulation waveform");
+        return FN_GEN_ERR_UNKNOWN_MOD;
+    }
+    if((p_mod->rate_Hz <= 0) || (p_mod->rate_Hz > FN_GEN_MAX_FREQ_HZ))
+    {
+        ESP_LOGE(TAG, "Modulation rate is not between 1 Hz and %d Hz", FN_GEN_MAX_FREQ_HZ);
+        return FN_GEN_ERR_CREATE;
+    }
+    if(p_mod->depth < 0)
+    {
+        ESP_LOGE(TAG, "Modulation depth is negative");
+        return FN_GEN_ERR_CREATE;
+    }
+
+    switch(p_mod->type)
+    {
+        case FN_MOD_AM:
+            if(p_mod->depth > 100)
+            {
+                ESP_LOGE(TAG, "AM depth is higher than 100%%");
+                return FN_GEN_ERR_CREATE;
+            }
+            break;
+        case FN_MOD_FM:
+            if(p_mod->depth > FN_GEN_MAX_FREQ_HZ)
+            {
+                ESP_LOGE(TAG, "FM deviation is higher than %d Hz", FN_GEN_MAX_FREQ_HZ);
+                return FN_GEN_ERR_CREATE;
+            }
+            // Burst counts periods on accumulator wraps, phase running backwards would fake them
+            if((FN_TRIG_BURST == p_config->trigger.mode) && (p_mod->depth > p_config->frequency_Hz))
+            {
+                ESP_LOGE(TAG, "Burst FM deviation is higher than carrier frequency");
+                return FN_GEN_ERR_CREATE;
+            }
+            break;
+        case FN_MOD_PM:
+            if(p_mod->depth > 180)
+            {
+                ESP_LOGE(TAG, "PM deviation is higher than 180 degrees");
+                return FN_GEN_ERR_CREATE;
+            }
+            break;
+        case FN_MOD_PWM:
+            if(FN_SIGNAL_SQUARE != p_config->signal)
+            {
+                ESP_LOGE(TAG, "PWM needs square carrier");
+                return FN_GEN_ERR_CREATE;
+            }
+            if(p_mod->depth > 100)
+            {
+                ESP_LOGE(TAG, "PWM depth is higher than 100%%");
+                return FN_GEN_ERR_CREATE;
+            }
+            break;
+        default:
+            break;
+    }
+    return FN_GEN_ERR_NONE;
 }
-//---------------------------- INTERRUPT HANDLERS -----------------------------
 
-/* Timer interrupt service routine */
-static void IRAM_ATTR _on_timer_alarm_cb(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data)
+static fn_gen_error_t _check_lock(const fn_signal_config_t *p_config)
 {
+    if((FN_MOD_FM == p_config->modulation.type) || (FN_TRIG_CONTINUOUS != p_config->trigger.mode))
+    {
+        ESP_LOGE(TAG, "Locked channel 2 can't use FM, burst or gated output");
+        return FN_GEN_ERR_CREATE;
+    }
+    return FN_GEN_ERR_NONE;
+}
 
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+static fn_gen_error_t _set_config_locked(fn_channel_t channel, const fn_signal_config_t *p_config)
+{
+    fn_gen_channel_t *p_ch = &_fn._channel[channel];
 
-    // Used to protect data when changing config
-    if(NULL != _config_protect_mutex)
+    fn_gen_error_t err = _check_config(channel, p_config);
+    if(FN_GEN_ERR_NONE != err)
     {
+        return err;
+    }
 
-        xSemaphoreTakeFromISR(_config_protect_mutex, portMAX_DELAY);
+    // Last swap has to reach the ISR before the other bank can be overwritten
+    while(_fn._is_timer_running && (p_ch->_p_rendered != p_ch->_p_active))
+    {
+        vTaskDelay(1);
+    }
 
-        // Reached end of period
-        if(_fn._period_index >= OUTPUT_POINT_NUM(_fn._config.frequency_Hz))
+    // Move gate interrupt to new pin, pin is only claimed in gated mode. Both channels can hold a gate, so the old one
+    // is freed first and claimed back if the new pin fails, config isn't changed then.
+    int old_pin = _gate_pin(&p_ch->_config);
+    int new_pin = _gate_pin(p_config);
+    if(new_pin != old_pin)
+    {
+        if(GATE_PIN_NONE != old_pin)
+        {
+            gate_deinit(old_pin);
+        }
+        if(GATE_PIN_NONE != new_pin)
         {
-            _fn._period_index = 0;
+            if(ESP_OK != gate_init(new_pin, _on_gate_edge, p_ch))
+            {
+                if((GATE_PIN_NONE != old_pin) && (ESP_OK == gate_init(old_pin, _on_gate_edge, p_ch)))
+                {
+                    p_ch->_gate = gate_is_asserted(old_pin);
+                }
+                else if(GATE_PIN_NONE != old_pin)
+                {
+                    ESP_LOGE(TAG, "Channel %d lost its gate on GPIO%d", channel + 1, old_pin);
+                }
+                return FN_GEN_ERR_CREATE;
+            }
+            p_ch->_gate = gate_is_asserted(new_pin);
         }
+    }
 
-        dac_output(_fn._raw_val[_fn._period_index]);
-        _fn._period_index++;
+    // Locked channel 2 runs at channel 1 frequency, so its tables are band-limited for it
+    fn_signal_config_t bank_config = *p_config;
+    if((FN_CHANNEL_2 == channel) && _fn._is_locked)
+    {
+        bank_config.frequency_Hz = _fn._channel[FN_CHANNEL_1]._config.frequency_Hz;
+    }
 
-        xSemaphoreGiveFromISR(_config_protect_mutex, &xHigherPriorityTaskWoken);
+    fn_gen_bank_t *p_bank = (p_ch->_p_active == &p_ch->_bank[0]) ? &p_ch->_bank[1] : &p_ch->_bank[0];
+    fn_render_prepare(p_bank, &bank_config, p_ch->_lut);
+
+    // New trigger mode starts with a fresh burst
+    if(p_config->trigger.mode != p_ch->_config.trigger.mode)
+    {
+        p_ch->_burst_cycle = 0;
+        p_ch->_idle_left   = 0;
     }
+
+    p_ch->_config   = *p_config;
+    p_ch->_p_active = p_bank;
+
+    fn_gen_backend_t backend = _select_backend(channel, p_config, &p_ch->_cw, &p_ch->_pwm);
+    if(backend != p_ch->_backend)
+    {
+        ESP_LOGI(TAG, "Channel %d output from %s", channel + 1, _backend_name[backend]);
+    }
+    p_ch->_backend = backend;
+    err            = _update_outputs_locked();
+
+    if((FN_GEN_ERR_NONE == err) && (FN_CHANNEL_1 == channel) && _fn._is_locked)
+    {
+        return _set_config_locked(FN_CHANNEL_2, &_fn._channel[FN_CHANNEL_2]._config);
+    }
+    return err;
+}
+
+static fn_gen_error_t _notify_change(fn_gen_error_t err)
+{
+    if((FN_GEN_ERR_NONE == err) && (NULL != _change_cb))
+    {
+        _change_cb();
+    }
+    return err;
+}
+
+static void _on_seq_timer(void *p_arg)
+{
+    (void)p_arg;
+
+    xTaskNotifyGive(_seq_task_handle);
+}
+
+static void _seq_task(void *p_arg)
+{
+    (void)p_arg;
+
+    for(;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        xSemaphoreTake(_config_protect_mutex, portMAX_DELAY);
+
+        // Sequence may have been stopped or restarted while the wake up was pending, then its step isn't due yet
+        if(_seq.is_running && (esp_timer_get_time() >= _seq.deadline_us))
+        {
+            if(++_seq.step >= _seq.step_count)
+            {
+                _seq.step = 0;
+                _seq.loop++;
+            }
+
+            if((FN_GEN_SEQ_LOOP_FOREVER != _seq.loop_count) && (_seq.loop >= _seq.loop_count))
+            {
+                _seq_stop_locked();
+                ESP_LOGI(TAG, "Sequence done");
+            }
+            else
+            {
+                _seq_output_locked();
+            }
+        }
+
+        xSemaphoreGive(_config_protect_mutex);
+    }
+}
+
+static void _seq_output_locked(void)
+{
+    const fn_gen_seq_step_t *p_step = &_seq.p_steps[_seq.step];
+
+    // Lock may have changed since the sequence was checked, the step is skipped then
+    if(FN_GEN_ERR_NONE != _set_config_locked(FN_CHANNEL_1, &p_step->config))
+    {
+        ESP_LOGW(TAG, "Sequence step %d skipped", _seq.step);
+    }
+
+    // Deadlines are absolute, time spent swapping configs doesn't delay later steps
+    _seq.deadline_us += (int64_t)p_step->dwell_ms * 1000;
+
+    int64_t delay_us = _seq.deadline_us - esp_timer_get_time();
+    esp_timer_start_once(_seq_timer, (delay_us > 0) ? delay_us : 0);
+}
+
+static void _seq_stop_locked(void)
+{
+    if(NULL != _seq_timer)
+    {
+        esp_timer_stop(_seq_timer);
+    }
+    free(_seq.p_steps);
+    _seq.p_steps    = NULL;
+    _seq.is_running = false;
+}
+
+static bool _is_pwm_capable(const fn_signal_config_t *p_config)
+{
+    return (FN_SIGNAL_SQUARE == p_config->signal) && (FN_MOD_NONE == p_config->modulation.type) &&
+           (FN_TRIG_CONTINUOUS == p_config->trigger.mode) && (AMP_DAC == APLITUDE_VOLTS_TO_DAC(p_config->amplitude_mV)) &&
+           (0 == APLITUDE_VOLTS_TO_DAC(p_config->offset_mV)) && !_fn._is_locked;
+}
+
+static fn_gen_backend_t _select_backend(fn_channel_t channel, const fn_signal_config_t *p_config, fn_cw_params_t *p_cw,
+                                        fn_pwm_params_t *p_pwm)
+{
+    // _check_config() only lets configs above FN_GEN_MAX_FREQ_HZ through if LEDC has settings for them
+    if(_is_pwm_capable(p_config))
+    {
+        return fn_pwm_solve(PWM_CLK_HZ, p_config->frequency_Hz, p_config->duty_cycle_percentage, p_pwm) ? FN_BACKEND_PWM
+                                                                                                         : FN_BACKEND_DDS;
+    }
+
+    // Locked channels need DDS phase accumulators, cosine generator output can't be corrected
+    if((FN_SIGNAL_SINE != p_config->signal) || (FN_MOD_NONE != p_config->modulation.type) ||
+       (FN_TRIG_CONTINUOUS != p_config->trigger.mode) || _fn._is_locked || _fn._channel[channel]._is_calibrated)
+    {
+        return FN_BACKEND_DDS;
+    }
+
+    // Generator only adds offset to its cosine, it can't flatten the swing at the rails
+    fn_cw_params_t cw;
+    fn_level_t     level;
+    if((0 != fn_level_solve(p_config->amplitude_mV, p_config->offset_mV, VDD, &level)) ||
+       !fn_cw_solve(dac_cw_clock_hz(), p_config->frequency_Hz, level.amplitude, &cw) ||
+       (cw.offset + level.offset > INT8_MAX))
+    {
+        return FN_BACKEND_DDS;
+    }
+    cw.offset += level.offset;
+
+    // There is only one generator, other enabled channel can share it only at the same frequency
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        const fn_gen_channel_t *p_other = &_fn._channel[i];
+        if((i != channel) && p_other->_is_enabled && (FN_BACKEND_CW == p_other->_backend) && (p_other->_cw.step != cw.step))
+        {
+            return FN_BACKEND_DDS;
+        }
+    }
+
+    *p_cw = cw;
+    return FN_BACKEND_CW;
+}
+
+static fn_gen_error_t _set_lock_locked(bool is_locked, uint32_t lock_phase)
+{
+    _fn._lock_phase = lock_phase;
+    _fn._is_locked  = is_locked;
+
+    // Locked channel 1 rebuilds channel 2 as well
+    fn_gen_error_t err = _set_config_locked(FN_CHANNEL_1, &_fn._channel[FN_CHANNEL_1]._config);
+    if((FN_GEN_ERR_NONE != err) && is_locked)
+    {
+        // Configs don't fit the lock, e.g. one is above DDS range, so channels go back to running unlocked
+        _fn._is_locked = false;
+        _set_config_locked(FN_CHANNEL_1, &_fn._channel[FN_CHANNEL_1]._config);
+    }
+    if(!_fn._is_locked)
+    {
+        fn_gen_error_t ch2_err = _set_config_locked(FN_CHANNEL_2, &_fn._channel[FN_CHANNEL_2]._config);
+        err                    = (FN_GEN_ERR_NONE == err) ? ch2_err : err;
+    }
+    return err;
+}
+
+static fn_gen_error_t _update_outputs_locked(void)
+{
+    fn_gen_error_t err             = FN_GEN_ERR_NONE;
+    bool           is_timer_needed = false;
+
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        fn_gen_channel_t *p_ch   = &_fn._channel[i];
+        bool              is_on  = _fn._is_running && p_ch->_is_enabled;
+        fn_gen_backend_t  wanted = is_on ? p_ch->_backend : FN_BACKEND_DDS;
+
+        // Release hardware the channel no longer uses, the pin goes back to direct DAC output
+        if((FN_BACKEND_CW == p_ch->_output) && (FN_BACKEND_CW != wanted))
+        {
+            dac_cw_stop(_dac_channel[i], p_ch->_p_active->idle);
+        }
+        else if((FN_BACKEND_PWM == p_ch->_output) && (FN_BACKEND_PWM != wanted))
+        {
+            pwm_stop(i, _out_pin[i]);
+            dac_init(_dac_channel[i]);
+            dac_output(_dac_channel[i], p_ch->_p_active->idle);
+        }
+
+        // Restarted on every change, settings may differ
+        if(FN_BACKEND_CW == wanted)
+        {
+            fn_cw_params_t *p_cw = &p_ch->_cw;
+            if(ESP_OK != dac_cw_start(_dac_channel[i], p_cw->freq_Hz, p_cw->scale_shift, p_cw->offset))
+            {
+                ESP_LOGW(TAG, "Cosine generator failed, channel %d falls back to DDS", i + 1);
+                p_ch->_backend = FN_BACKEND_DDS;
+                wanted         = FN_BACKEND_DDS;
+            }
+        }
+        else if(FN_BACKEND_PWM == wanted)
+        {
+            fn_pwm_params_t *p_pwm = &p_ch->_pwm;
+            if(FN_BACKEND_PWM != p_ch->_output)
+            {
+                dac_deinit(_dac_channel[i]);
+            }
+            if(ESP_OK != pwm_start(i, _out_pin[i], p_pwm->divider, p_pwm->resolution_bits, p_pwm->duty))
+            {
+                pwm_stop(i, _out_pin[i]);
+                dac_init(_dac_channel[i]);
+                wanted = FN_BACKEND_DDS;
+                if(p_ch->_config.frequency_Hz > FN_GEN_MAX_FREQ_HZ)
+                {
+                    // DDS would alias to a wrong frequency, so the pin holds idle level and the ISR skips the channel
+                    // until LEDC starts on a later update
+                    ESP_LOGE(TAG, "LEDC failed, channel %d is stopped, DDS only goes up to %d Hz", i + 1,
+                             FN_GEN_MAX_FREQ_HZ);
+                    dac_output(_dac_channel[i], p_ch->_p_active->idle);
+                    err = FN_GEN_ERR_CREATE;
+                }
+                else
+                {
+                    ESP_LOGW(TAG, "LEDC failed, channel %d falls back to DDS", i + 1);
+                    p_ch->_backend = FN_BACKEND_DDS;
+                }
+            }
+            else if(p_pwm->duty_err_ppm > FN_PWM_MAX_DUTY_ERR_PPM)
+            {
+                // Timer counts too few steps per period at this frequency, DDS can't go there either
+                ESP_LOGW(TAG, "Channel %d duty cycle is %d.%02d%% off, LEDC has only %d bits at %d Hz", i + 1,
+                         (int)(p_pwm->duty_err_ppm / 10000), (int)(p_pwm->duty_err_ppm / 100 % 100),
+                         p_pwm->resolution_bits, p_ch->_config.frequency_Hz);
+            }
+        }
+        p_ch->_output = wanted;
+
+        is_timer_needed |= is_on && (FN_BACKEND_DDS == p_ch->_backend);
+    }
+
+    // Timer only runs while there is something to render
+    if(is_timer_needed != _fn._is_timer_running)
+    {
+        if(is_timer_needed)
+        {
+            timer_start();
+        }
+        else
+        {
+            timer_stop();
+        }
+        _fn._is_timer_running = is_timer_needed;
+    }
+    return err;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
+
+static void IRAM_ATTR _on_gate_edge(bool is_asserted, void *p_arg)
+{
+    fn_gen_channel_t *p_ch = p_arg;
+
+    PROFILER_COUNT(PROFILER_PROBE_GATE_ISR);
+    p_ch->_gate = is_asserted;
+}
+
+/* Timer interrupt service routine */
+static bool IRAM_ATTR _on_timer_alarm_cb(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_data)
+{
+#if CONFIG_FN_GEN_TIMING_TRACE
+    // Stamped before rendering so render time doesn't show up as jitter
+    fn_timing_ring_add(&_timing, esp_cpu_get_cycle_count());
+#endif
+    PROFILER_BEGIN(PROFILER_PROBE_DDS_ISR);
+
+    // Locked channel 2 phase is taken before channel 1 advances, so both render the same instant
+    if(_fn._is_locked)
+    {
+        _fn._channel[FN_CHANNEL_2]._phase = _fn._channel[FN_CHANNEL_1]._phase + _fn._lock_phase;
+    }
+
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        fn_gen_channel_t *p_ch = &_fn._channel[i];
+
+        // Bank pointer is read once, config swaps happen between samples. Swaps on channels that aren't rendered are
+        // acknowledged too, so config writers never wait for them.
+        const fn_gen_bank_t *p_bank = p_ch->_p_active;
+
+        if(p_ch->_is_enabled && (FN_BACKEND_DDS == p_ch->_backend))
+        {
+            dac_output(_dac_channel[i], p_bank->tick(p_ch, p_bank));
+        }
+        p_ch->_p_rendered = (fn_gen_bank_t *)p_bank;
+    }
+
+    PROFILER_END(PROFILER_PROBE_DDS_ISR);
+    return false;
 }
@@ -17,10 +17,22 @@ extern "C" {
 //--------------------------------- INCLUDES ----------------------------------
 #include <stdint.h>
 #include <stdbool.h>
+#include "fn_noise.h"
+#include "fn_cw.h"
+#include "fn_pwm.h"
+#include "fn_timing.h"
+#include "fn_cal.h"
+#include "fn_level.h"
 //---------------------------------- MACROS -----------------------------------
-#define FN_GEN_POINT_ARR_LEN 200 // Length of points array
-#define FN_GEN_TIMER_INTR_US 30  // Execution time of each ISR interval in micro-seconds
-#define FN_GEN_PRESET_NUMBER 5   // Number of signal presets
+#define FN_GEN_POINT_ARR_BITS   8                                // Wavetable index width in bits
+#define FN_GEN_POINT_ARR_LEN    (1 << FN_GEN_POINT_ARR_BITS)     // Length of points array, one period of the wavetable
+#define FN_GEN_TIMER_INTR_US    30                               // Execution time of each ISR interval in micro-seconds
+#define FN_GEN_SAMPLE_RATE_HZ   (1000000 / FN_GEN_TIMER_INTR_US) // DAC update rate
+#define FN_GEN_MAX_FREQ_HZ      (FN_GEN_SAMPLE_RATE_HZ / 2)      // Highest frequency DDS can output
+#define FN_GEN_MAX_PWM_FREQ_HZ  (10000000)                       // Highest frequency of full amplitude square from LEDC
+#define FN_GEN_PRESET_NUMBER    5                                // Number of signal presets
+#define FN_GEN_SEQ_LOOP_FOREVER 0                                // Sequence loop count that never ends
+#define FN_GEN_SEQ_MIN_DWELL_MS 10                               // Shortest time a sequence step is output for
 
 #define VDD     3300 // VDD is 3.3V, 3300mV
 #define AMP_DAC 255  // Amplitude of DAC voltage. If it's more than 256 will causes dac_output_voltage() output 0.
@@ -34,6 +46,7 @@ typedef enum
     FN_GEN_ERR                = -1,
     FN_GEN_ERR_UNKNOWN_SIGNAL = -2,
     FN_GEN_ERR_CREATE         = -3,
+    FN_GEN_ERR_UNKNOWN_MOD    = -4,
 } fn_gen_error_t;
 
 typedef enum
@@ -42,26 +55,162 @@ typedef enum
     FN_SIGNAL_SQUARE,
     FN_SIGNAL_TRIANGLE,
     FN_SIGNAL_SAWTOOTH,
+    FN_SIGNAL_NOISE_WHITE,    // Uniform white noise, frequency only sets burst period
+    FN_SIGNAL_NOISE_PINK,     // 1/f noise, frequency only sets burst period
+    FN_SIGNAL_NOISE_GAUSSIAN, // White noise with normal distribution, amplitude spans +-4 sigma
 
     FN_SIGNAL_COUNT
 } fn_signal_type_t;
 
+typedef enum
+{
+    FN_MOD_NONE,
+    FN_MOD_AM,  // Amplitude modulation, depth is envelope swing in % of amplitude
+    FN_MOD_FM,  // Frequency modulation, depth is peak deviation in Hz
+    FN_MOD_PM,  // Phase modulation, depth is peak deviation in degrees
+    FN_MOD_PWM, // Pulse width modulation of square carrier, depth is peak duty cycle swing in %
+
+    FN_MOD_COUNT
+} fn_mod_type_t;
+
+typedef struct _fn_mod_config_t
+{
+    fn_mod_type_t    type;
+    fn_signal_type_t shape;   // Waveform of the modulating LFO
+    int              rate_Hz; // Frequency of the modulating LFO
+    int              depth;   // Meaning depends on type, see fn_mod_type_t
+} fn_mod_config_t;
+
+typedef enum
+{
+    FN_TRIG_CONTINUOUS, // Output runs all the time
+    FN_TRIG_BURST,      // Outputs burst_cycles periods, then idles for burst_idle_ms
+    FN_TRIG_GATED,      // Outputs only while gate is asserted, each gate starts at phase 0
+
+    FN_TRIG_COUNT
+} fn_trig_mode_t;
+
+typedef struct _fn_trig_config_t
+{
+    fn_trig_mode_t mode;
+    int            burst_cycles;  // Number of whole periods in a burst
+    int            burst_idle_ms; // Idle time between bursts
+    int            gate_pin;      // GPIO used as gate input, -1 to control gate with fn_gen_set_gate() only
+} fn_trig_config_t;
+
+typedef enum
+{
+    FN_CHANNEL_1, // DAC1, GPIO25
+    FN_CHANNEL_2, // DAC2, GPIO26
+
+    FN_CHANNEL_COUNT
+} fn_channel_t;
+
+typedef enum
+{
+    FN_BACKEND_DDS, // Timer ISR renders samples to the DAC
+    FN_BACKEND_CW,  // DAC cosine waveform generator, no CPU cost
+    FN_BACKEND_PWM, // LEDC square wave on the DAC pin, no CPU cost
+
+    FN_BACKEND_COUNT
+} fn_gen_backend_t;
+
+typedef void (*fn_gen_change_cb_t)(void);
+
+/**
+ * @brief Measures output of channel during calibration
+ *
+ * @param channel Channel being calibrated
+ * @param p_arg Argument given to fn_gen_calibrate()
+ * @return int Voltage on channel's pin in mV, negative if it couldn't be read
+ */
+typedef int (*fn_gen_cal_read_t)(fn_channel_t channel, void *p_arg);
+
 typedef struct _fn_signal_config_t
 {
     fn_signal_type_t signal;
     int              frequency_Hz;
     int              amplitude_mV; // Peak to peak
+    int              offset_mV;    // Voltage of the bottom of the swing, output saturates outside of 0 V to VDD
     int              duty_cycle_percentage;
+    fn_mod_config_t  modulation;
+    fn_trig_config_t trigger;
 } fn_signal_config_t;
 
+typedef struct _fn_gen_seq_step_t
+{
+    fn_signal_config_t config;
+    uint32_t           dwell_ms; // Time config is output for before the next step
+} fn_gen_seq_step_t;
+
+struct _fn_gen_bank_t;
+struct _fn_gen_channel_t;
+
+/**
+ * @brief Produces next DAC value and advances channel's phase accumulators, selected per config so the ISR never
+ * branches on modulation type
+ *
+ */
+typedef uint8_t (*fn_gen_render_t)(struct _fn_gen_channel_t *p_ch, const struct _fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Everything the ISR needs to render a config. Built outside of ISR and swapped in at once.
+ *
+ */
+typedef struct _fn_gen_bank_t
+{
+    uint8_t         table[FN_GEN_POINT_ARR_LEN]; // One period of carrier in DAC values, ramp over the swing for noise
+    uint32_t        tuning_word;                 // Carrier phase increment per sample
+    const int16_t  *p_lfo;                       // Modulator unit wavetable
+    uint32_t        lfo_tuning_word;             // Modulator phase increment per sample
+    int32_t         mod_depth;                   // Modulation depth, scaled so it multiplies Q15 LFO sample
+    int32_t         mod_bias;                    // Modulated parameter's value when LFO sample is 0
+    uint8_t         mid;                         // Carrier centre in DAC values
+    uint8_t         high;                        // Square high level in DAC values
+    uint8_t         low;                         // Square low level in DAC values
+    uint8_t         idle;                        // Output between bursts and while gate is off, level at phase 0
+    uint32_t        burst_cycles;                // Periods per burst
+    uint32_t        burst_idle_samples;          // Samples of idle output between bursts
+    fn_gen_render_t render;                      // Renders the signal, depends on modulation
+    fn_gen_render_t tick;                        // Called by ISR, depends on trigger mode
+    fn_noise_fill_t noise_fill;                  // Refills noise block, NULL for periodic signals
+} fn_gen_bank_t;
+
+/**
+ * @brief One DAC output with its own config and phase accumulators
+ *
+ */
+typedef struct _fn_gen_channel_t
+{
+    fn_signal_config_t        _config;
+    fn_gen_bank_t             _bank[2];                         // Config being output and the one being prepared
+    fn_gen_bank_t *volatile   _p_active;                        // Bank ISR renders from
+    fn_gen_bank_t *volatile   _p_rendered;                      // Bank ISR rendered last sample from
+    uint32_t                  _phase;                           // Carrier phase accumulator
+    uint32_t                  _lfo_phase;                       // Modulator phase accumulator
+    uint32_t                  _burst_cycle;                     // Periods output in current burst
+    uint32_t                  _idle_left;                       // Idle samples left before next burst
+    volatile bool             _gate;                            // True while gate is asserted
+    volatile bool             _is_enabled;                      // True if channel drives its DAC
+    volatile fn_gen_backend_t _backend;                         // Backend config is output with
+    fn_cw_params_t            _cw;                              // Cosine generator settings for FN_BACKEND_CW
+    fn_pwm_params_t           _pwm;                             // LEDC settings for FN_BACKEND_PWM
+    fn_gen_backend_t          _output;                          // Backend hardware currently driving the pin
+    fn_noise_t                _noise;                           // Noise generator state
+    int16_t                   _noise_block[FN_NOISE_BLOCK_LEN]; // Noise samples not output yet
+    uint32_t                  _noise_left;                      // Number of samples left in noise block
+    uint8_t                   _lut[FN_CAL_CODES];               // Code written for each ideal DAC code
+    bool                      _is_calibrated;                   // False while _lut is identity
+} fn_gen_channel_t;
+
 typedef struct _fn_generator_t
 {
-    fn_signal_config_t _config;
-    int                _raw_val[FN_GEN_POINT_ARR_LEN];  // Used to store raw values
-    int                _volt_val[FN_GEN_POINT_ARR_LEN]; // Used to store voltage values(in mV)
-    int                _period_index;                   // Time point in window frame of signal
-    bool               _is_running;                     // True if the timer is running
-    fn_signal_config_t presets[FN_GEN_PRESET_NUMBER];   // Signal presets
+    fn_gen_channel_t   _channel[FN_CHANNEL_COUNT];
+    volatile bool      _is_locked;                    // Channel 2 takes its phase from channel 1
+    volatile uint32_t  _lock_phase;                   // Phase of channel 2 ahead of channel 1 in locked mode
+    bool               _is_running;                   // True if output is started
+    bool               _is_timer_running;             // True if the timer is running, only while a channel uses DDS
+    fn_signal_config_t presets[FN_GEN_PRESET_NUMBER]; // Signal presets
 } fn_generator_t;
 
 //---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
@@ -73,7 +222,7 @@ typedef struct _fn_generator_t
 void fn_gen_init();
 
 /**
- * @brief Sets parameters of signal to be generated
+ * @brief Sets parameters of signal to be generated on channel 1
  *
  * @param config Signal parameters
  * @return fn_gen_err_t
@@ -81,7 +230,45 @@ void fn_gen_init();
 fn_gen_error_t fn_gen_set_signal_config(fn_signal_config_t config);
 
 /**
- * @brief Sets signal's type
+ * @brief Sets parameters of signal to be generated on any channel
+ *
+ * @param channel Output channel
+ * @param config Signal parameters
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_set_channel_config(fn_channel_t channel, fn_signal_config_t config);
+
+/**
+ * @brief Returns parameters of signal generated on channel
+ *
+ * @param channel Output channel
+ * @param p_config Pointer to place the config
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_get_channel_config(fn_channel_t channel, fn_signal_config_t *p_config);
+
+/**
+ * @brief Turns channel's DAC output on or off. Channel 1 is on and channel 2 is off after init. Turning either
+ * channel off releases the lock.
+ *
+ * @param channel Output channel
+ * @param is_enabled True to output the signal
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_set_channel_enabled(fn_channel_t channel, bool is_enabled);
+
+/**
+ * @brief Locks channel 2 to channel 1. Locked channel 2 runs at channel 1 frequency and its phase is channel 1 phase
+ * plus the offset at every sample, so it can't use FM, burst or gated output. Both channels have to be enabled.
+ *
+ * @param is_locked True to lock, false to run channels independently
+ * @param phase_offset_deg Phase of channel 2 ahead of channel 1 in degrees, 90 gives quadrature
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_set_lock(bool is_locked, int phase_offset_deg);
+
+/**
+ * @brief Sets signal's type on channel 1
  *
  * @param type enum type fn_signal_type_t
  * @return fn_gen_error_t
@@ -89,15 +276,16 @@ fn_gen_error_t fn_gen_set_signal_config(fn_signal_config_t config);
 fn_gen_error_t fn_gen_set_signal_type(fn_signal_type_t type);
 
 /**
- * @brief Sets signal's frequency
+ * @brief Sets signal's frequency on channel 1
  *
- * @param frequency_Hz frequency in Hz from 0 to 3000 Hz
+ * @param frequency_Hz frequency in Hz from 1 Hz to FN_GEN_MAX_FREQ_HZ, or up to FN_GEN_MAX_PWM_FREQ_HZ for a
+ * continuous unmodulated square at VDD amplitude
  * @return fn_gen_error_t
  */
 fn_gen_error_t fn_gen_set_frequency(int frequency_Hz);
 
 /**
- * @brief Sets signal's amplitude
+ * @brief Sets signal's amplitude on channel 1
  *
  * @param amplitude_mV_pp Aplitude in mV from 0 to 3300 mV
  * @return fn_gen_error_t
@@ -105,7 +293,24 @@ fn_gen_error_t fn_gen_set_frequency(int frequency_Hz);
 fn_gen_error_t fn_gen_set_amplitude(int amplitude_mV_pp);
 
 /**
- * @brief Sets square wave's duty cycle
+ * @brief Sets DC offset of signal on channel 1, the swing goes from offset to offset plus amplitude. Parts of the swing
+ * outside of 0 V to VDD are flattened at the rail, see fn_gen_get_clip().
+ *
+ * @param offset_mV Offset in mV from -3300 to 3300 mV
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_set_offset(int offset_mV);
+
+/**
+ * @brief Returns which rails signal on channel saturates at
+ *
+ * @param channel Output channel
+ * @return uint8_t FN_LEVEL_CLIP_x flags, 0 if the whole swing is output
+ */
+uint8_t fn_gen_get_clip(fn_channel_t channel);
+
+/**
+ * @brief Sets square wave's duty cycle on channel 1
  *
  * @param duty_cycle_percentage from 0% to 100%
  * @return fn_gen_error_t
@@ -113,6 +318,29 @@ fn_gen_error_t fn_gen_set_amplitude(int amplitude_mV_pp);
 
 fn_gen_error_t fn_gen_set_duty_cycle(int duty_cycle_percentage);
 
+/**
+ * @brief Sets modulation of the signal on channel 1, FN_MOD_NONE turns it off
+ *
+ * @param modulation Modulation type, LFO waveform, rate and depth
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_set_modulation(fn_mod_config_t modulation);
+
+/**
+ * @brief Sets trigger mode of channel 1 output: continuous, burst or gated
+ *
+ * @param trigger Trigger mode with burst length and gate input
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_set_trigger(fn_trig_config_t trigger);
+
+/**
+ * @brief Asserts or releases the gate of both channels from software, used in FN_TRIG_GATED mode
+ *
+ * @param is_asserted True to output the signal
+ */
+void fn_gen_set_gate(bool is_asserted);
+
 /**
  * @brief Saves config for preset number preset_num
  *
@@ -132,7 +360,7 @@ fn_gen_error_t fn_gen_set_preset(fn_signal_config_t config, int preset_num);
 fn_gen_error_t fn_gen_get_preset(fn_signal_config_t *conf, int preset_num);
 
 /**
- * @brief Sets signal config to preset with the index of preset_num
+ * @brief Sets channel 1 signal config to preset with the index of preset_num
  *
  * @param preset_num
  * @return fn_gen_error_t
@@ -153,6 +381,97 @@ fn_gen_error_t fn_gen_signal_start_task();
  */
 fn_gen_error_t fn_gen_signal_stop_task();
 
+/**
+ * @brief Steps channel 1 through configs, each output for its dwell time. Steps are swapped in the same phase
+ * continuous way as any config change and are scheduled by one esp_timer against absolute deadlines, so dwell errors
+ * don't add up. The timer only wakes the sequencer task, which builds and swaps in the step. Output stays at the last
+ * step when the sequence ends. Steps aren't reported to the change callback.
+ *
+ * @param p_steps Steps, copied so the array doesn't have to outlive the call
+ * @param step_count Number of steps
+ * @param loop_count Number of times steps are run, FN_GEN_SEQ_LOOP_FOREVER to repeat until stopped
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_seq_start(const fn_gen_seq_step_t *p_steps, int step_count, int loop_count);
+
+/**
+ * @brief Stops sequence, output stays at the current step
+ *
+ */
+void fn_gen_seq_stop(void);
+
+/**
+ * @brief Returns true while a sequence is running
+ *
+ * @return bool
+ */
+bool fn_gen_seq_is_running(void);
+
+/**
+ * @brief Calibrates channel's DAC through a loopback into an ADC. Channel stops while all codes are stepped through
+ * and measured, then the fitted correction table is applied to every config from now on. Correction is folded into
+ * the tables built on config change, so output costs the same per sample. Calibrated channel doesn't use the cosine
+ * generator, its output can't be corrected. Channels have to be unlocked and no sequence may be running.
+ *
+ * @param channel Output channel
+ * @param read_mV Measures the channel's pin, called once per code
+ * @param p_arg Argument passed to read_mV
+ * @param p_result Fit summary, NULL if not needed
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_calibrate(fn_channel_t channel, fn_gen_cal_read_t read_mV, void *p_arg, fn_cal_result_t *p_result);
+
+/**
+ * @brief Sets correction table of channel, e.g. one restored from storage
+ *
+ * @param channel Output channel
+ * @param p_lut Table of FN_CAL_CODES codes as built by fn_gen_calibrate(), NULL to go back to uncorrected output
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_set_calibration(fn_channel_t channel, const uint8_t *p_lut);
+
+/**
+ * @brief Copies correction table of channel
+ *
+ * @param channel Output channel
+ * @param p_lut Table of FN_CAL_CODES codes
+ * @return true if channel is calibrated, table is identity otherwise
+ */
+bool fn_gen_get_calibration(fn_channel_t channel, uint8_t *p_lut);
+
+/**
+ * @brief Registers callback called after every successful signal config or preset change, e.g. to persist them.
+ * Callback runs in the caller's context and may read configs back.
+ *
+ * @param cb Callback, NULL to remove it
+ */
+void fn_gen_set_change_cb(fn_gen_change_cb_t cb);
+
+/**
+ * @brief Clears timestamp ring and starts or stops stamping output updates with the CPU cycle counter. Needs
+ * CONFIG_FN_GEN_TIMING_TRACE.
+ *
+ * @param is_on True to start capture
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t fn_gen_timing_capture(bool is_on);
+
+/**
+ * @brief Copies captured timestamps, oldest first. Capture is paused while they are copied.
+ *
+ * @param p_stamps Copied cycle counts
+ * @param max_count Number of timestamps p_stamps holds
+ * @return uint32_t Number of copied timestamps, 0 without CONFIG_FN_GEN_TIMING_TRACE
+ */
+uint32_t fn_gen_timing_copy(uint32_t *p_stamps, uint32_t max_count);
+
+/**
+ * @brief Returns CPU cycles between output updates at nominal sample rate
+ *
+ * @return uint32_t Nominal period in cycles
+ */
+uint32_t fn_gen_timing_nominal(void);
+
 #ifdef __cplusplus
 }
 #endif
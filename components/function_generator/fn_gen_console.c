@@ -0,0 +1,128 @@
+/**
+ * @file fn_gen_console.c
+ *
+ * @brief   Console commands of the function generator
+ *
+ * fn_timing start|stop   - clears timestamp ring and starts or stops capture
+ * fn_timing [stats]      - prints period statistics of captured output updates
+ * fn_timing dump         - prints captured timestamps, output can be replayed with tools/timing_replay.c
+ *
+ * Timing commands need CONFIG_FN_GEN_TIMING_TRACE. Other components register their commands once the console runs.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_gen_console.h"
+#include "fn_gen.h"
+#include "fn_timing.h"
+#include "sched.h"
+#include "sdkconfig.h"
+#include "esp_console.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define CONSOLE_PROMPT "fn>"
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+#if CONFIG_FN_GEN_TIMING_TRACE
+/**
+ * @brief Handles fn_timing command
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int 0 on success
+ */
+static int _cmd_timing(int argc, char **argv);
+#endif
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "fn_gen_console";
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+void fn_gen_console_start(void)
+{
+    esp_console_repl_t           *p_repl      = NULL;
+    esp_console_repl_config_t     repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+
+    repl_config.prompt        = CONSOLE_PROMPT;
+    repl_config.task_priority = SCHED_PRIO_HOUSEKEEPING; // Long commands like calibration never delay a redraw
+    if(ESP_OK != esp_console_new_repl_uart(&uart_config, &repl_config, &p_repl))
+    {
+        ESP_LOGE(TAG, "Failed to create console");
+        return;
+    }
+
+#if CONFIG_FN_GEN_TIMING_TRACE
+    const esp_console_cmd_t timing_cmd = {
+        .command = "fn_timing",
+        .help    = "Sample output timing: start, stop, stats or dump",
+        .hint    = "[start|stop|stats|dump]",
+        .func    = _cmd_timing,
+    };
+    esp_console_cmd_register(&timing_cmd);
+#endif
+
+    if(ESP_OK != esp_console_start_repl(p_repl))
+    {
+        ESP_LOGE(TAG, "Failed to start console");
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+#if CONFIG_FN_GEN_TIMING_TRACE
+
+static int _cmd_timing(int argc, char **argv)
+{
+    const char *p_arg = (argc > 1) ? argv[1] : "stats";
+
+    if((0 == strcmp(p_arg, "start")) || (0 == strcmp(p_arg, "stop")))
+    {
+        return (FN_GEN_ERR_NONE == fn_gen_timing_capture(0 == strcmp(p_arg, "start"))) ? 0 : 1;
+    }
+    if((0 != strcmp(p_arg, "stats")) && (0 != strcmp(p_arg, "dump")))
+    {
+        printf("Unknown argument %s\n", p_arg);
+        return 1;
+    }
+
+    // Second half is scratch for sorting periods
+    uint32_t *p_stamps = malloc(2 * CONFIG_FN_GEN_TIMING_RING_LEN * sizeof(uint32_t));
+    if(NULL == p_stamps)
+    {
+        printf("Out of memory\n");
+        return 1;
+    }
+
+    uint32_t count = fn_gen_timing_copy(p_stamps, CONFIG_FN_GEN_TIMING_RING_LEN);
+    if(0 == strcmp(p_arg, "dump"))
+    {
+        printf("# nominal %lu\n", (unsigned long)fn_gen_timing_nominal());
+        for(uint32_t i = 0; i < count; i++)
+        {
+            printf("%lu\n", (unsigned long)p_stamps[i]);
+        }
+    }
+    else
+    {
+        fn_timing_stats_t stats;
+        fn_timing_stats(p_stamps, count, fn_gen_timing_nominal(), p_stamps + CONFIG_FN_GEN_TIMING_RING_LEN, &stats);
+        fn_timing_print(&stats);
+    }
+
+    free(p_stamps);
+    return 0;
+}
+#endif
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
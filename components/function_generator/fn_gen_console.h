@@ -0,0 +1,36 @@
+/**
+ * @file fn_gen_console.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_GEN_CONSOLE_H__
+#define __FN_GEN_CONSOLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Starts UART console REPL with function generator commands, commands of other components can be registered
+ * with esp_console_cmd_register() after it
+ *
+ */
+void fn_gen_console_start(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_GEN_CONSOLE_H__
@@ -0,0 +1,51 @@
+/**
+ * @file fn_level.c
+ *
+ * @brief   Output levels of a swing shifted by DC offset
+ *
+ * Amplitude keeps the truncating conversion it always had, so configs without offset give the same codes as before.
+ * Offset is rounded to the nearest code, so a few mV either side of a rail don't count as clipping. Clipping is
+ * decided on codes, the same ones the tables are built from, so the flags always match what is output.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_level.h"
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+uint8_t fn_level_solve(int amplitude_mV, int offset_mV, int vdd_mV, fn_level_t *p_level)
+{
+    int64_t scaled = (int64_t)FN_LEVEL_MAX_CODE * offset_mV;
+    int64_t half   = (scaled < 0) ? -vdd_mV / 2 : vdd_mV / 2;
+
+    p_level->amplitude = (int)((int64_t)FN_LEVEL_MAX_CODE * amplitude_mV / vdd_mV);
+    p_level->offset    = (int)((scaled + half) / vdd_mV);
+    p_level->clip      = 0;
+
+    if(p_level->offset < 0)
+    {
+        p_level->clip |= FN_LEVEL_CLIP_LOW;
+    }
+    if(p_level->offset + p_level->amplitude > FN_LEVEL_MAX_CODE)
+    {
+        p_level->clip |= FN_LEVEL_CLIP_HIGH;
+    }
+    return p_level->clip;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,65 @@
+/**
+ * @file fn_level.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_LEVEL_H__
+#define __FN_LEVEL_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define FN_LEVEL_MAX_CODE  (255)    // Highest DAC code, output at VDD
+#define FN_LEVEL_CLIP_LOW  (1 << 0) // Part of the swing would go below 0 V
+#define FN_LEVEL_CLIP_HIGH (1 << 1) // Part of the swing would go above VDD
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _fn_level_t
+{
+    int     amplitude; // Swing in DAC codes
+    int     offset;    // Code the bottom of the swing sits at, outside of DAC range if clipped
+    uint8_t clip;      // FN_LEVEL_CLIP_x flags
+} fn_level_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Turns amplitude and DC offset into DAC codes and finds which rails the swing runs into
+ *
+ * @param amplitude_mV Peak to peak swing
+ * @param offset_mV Voltage of the bottom of the swing, may be negative
+ * @param vdd_mV Output at FN_LEVEL_MAX_CODE
+ * @param p_level Levels in DAC codes
+ * @return uint8_t FN_LEVEL_CLIP_x flags, 0 if the whole swing fits
+ */
+uint8_t fn_level_solve(int amplitude_mV, int offset_mV, int vdd_mV, fn_level_t *p_level);
+
+/**
+ * @brief Moves code of the unshifted swing by offset, saturating at the DAC rails
+ *
+ * @param p_level Levels from fn_level_solve()
+ * @param code Code between 0 and amplitude
+ * @return uint8_t DAC code
+ */
+static inline uint8_t fn_level_code(const fn_level_t *p_level, int code)
+{
+    code += p_level->offset;
+    return (uint8_t)((code < 0) ? 0 : (code > FN_LEVEL_MAX_CODE) ? FN_LEVEL_MAX_CODE : code);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_LEVEL_H__
@@ -0,0 +1,100 @@
+/**
+ * @file fn_noise.c
+ *
+ * @brief   Noise generators for the function generator
+ *
+ * All generators draw from one xorshift32. White noise is its output, pink noise is the Voss-McCartney sum of rows
+ * updated at octave spaced rates and Gaussian noise maps uniform bits through an inverse CDF table generated at
+ * build time. Samples are made a block at a time from the timer ISR, so everything here is in IRAM.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_noise.h"
+#include "fn_wavetable_data.h"
+#include "esp_attr.h"
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define NOISE_DEFAULT_SEED (0x2545F491u)
+
+// Each pink row and the white term are 12 bit, so sum of all of them fits Q15
+#define PINK_ROW_SHIFT (20)
+
+_Static_assert(((FN_NOISE_PINK_ROWS + 1) << (32 - PINK_ROW_SHIFT)) <= (1 << 16), "Pink noise sum doesn't fit Q15");
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Advances xorshift32 generator
+ *
+ * @param p_noise Noise generator
+ * @return uint32_t Next uniformly distributed random word
+ */
+static inline uint32_t _next(fn_noise_t *p_noise);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+void fn_noise_init(fn_noise_t *p_noise, uint32_t seed)
+{
+    memset(p_noise, 0, sizeof(*p_noise));
+    p_noise->seed = (0 == seed) ? NOISE_DEFAULT_SEED : seed;
+}
+
+void IRAM_ATTR fn_noise_white_fill(fn_noise_t *p_noise, int16_t *p_out, int len)
+{
+    for(int i = 0; i < len; i++)
+    {
+        p_out[i] = (int16_t)(_next(p_noise) >> 16);
+    }
+}
+
+void IRAM_ATTR fn_noise_pink_fill(fn_noise_t *p_noise, int16_t *p_out, int len)
+{
+    for(int i = 0; i < len; i++)
+    {
+        uint32_t random = _next(p_noise);
+
+        // Row k is redrawn every 2^(k+1) samples, rows beyond the last one are never due
+        int row = __builtin_ctz(++p_noise->counter | (1u << FN_NOISE_PINK_ROWS));
+        if(row < FN_NOISE_PINK_ROWS)
+        {
+            int16_t value = (int16_t)((int32_t)random >> PINK_ROW_SHIFT);
+            p_noise->pink_sum += value - p_noise->pink_rows[row];
+            p_noise->pink_rows[row] = value;
+        }
+
+        // White term from the other bits of the same word flattens the top octave
+        p_out[i] = (int16_t)(p_noise->pink_sum + ((int32_t)(random << 12) >> PINK_ROW_SHIFT));
+    }
+}
+
+void IRAM_ATTR fn_noise_gaussian_fill(fn_noise_t *p_noise, int16_t *p_out, int len)
+{
+    for(int i = 0; i < len; i++)
+    {
+        p_out[i] = fn_wt_data_gauss_icdf[_next(p_noise) >> (32 - FN_WT_DATA_ICDF_BITS)];
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static inline uint32_t _next(fn_noise_t *p_noise)
+{
+    uint32_t x = p_noise->seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    p_noise->seed = x;
+    return x;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
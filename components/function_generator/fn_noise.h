@@ -0,0 +1,81 @@
+/**
+ * @file fn_noise.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_NOISE_H__
+#define __FN_NOISE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define FN_NOISE_BLOCK_LEN (32) // Samples generated per refill
+#define FN_NOISE_PINK_ROWS (15) // Voss-McCartney rows, pink spectrum spans this many octaves
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _fn_noise_t
+{
+    uint32_t seed;                          // Xorshift state, never 0
+    uint32_t counter;                       // Pink sample counter, its trailing zeros pick the row to update
+    int32_t  pink_sum;                      // Sum of all pink rows
+    int16_t  pink_rows[FN_NOISE_PINK_ROWS]; // Random values held for 2^row samples
+} fn_noise_t;
+
+/**
+ * @brief Generates block of signed Q15 noise samples
+ *
+ */
+typedef void (*fn_noise_fill_t)(fn_noise_t *p_noise, int16_t *p_out, int len);
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Initializes noise generator state
+ *
+ * @param p_noise Noise generator
+ * @param seed Random seed, 0 is replaced with a fixed seed
+ */
+void fn_noise_init(fn_noise_t *p_noise, uint32_t seed);
+
+/**
+ * @brief Fills block with uniform white noise over whole Q15 range
+ *
+ * @param p_noise Noise generator
+ * @param p_out Output samples
+ * @param len Number of samples
+ */
+void fn_noise_white_fill(fn_noise_t *p_noise, int16_t *p_out, int len);
+
+/**
+ * @brief Fills block with pink noise, power falls 3 dB per octave
+ *
+ * @param p_noise Noise generator
+ * @param p_out Output samples
+ * @param len Number of samples
+ */
+void fn_noise_pink_fill(fn_noise_t *p_noise, int16_t *p_out, int len);
+
+/**
+ * @brief Fills block with Gaussian noise, standard deviation is FN_WT_DATA_GAUSS_SIGMA
+ *
+ * @param p_noise Noise generator
+ * @param p_out Output samples
+ * @param len Number of samples
+ */
+void fn_noise_gaussian_fill(fn_noise_t *p_noise, int16_t *p_out, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_NOISE_H__
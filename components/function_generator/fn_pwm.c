@@ -0,0 +1,129 @@
+/**
+ * @file fn_pwm.c
+ *
+ * @brief   Settings solver for the LEDC square wave backend
+ *
+ * LEDC timer divides its source clock by a 10.8 fixed point divider and counts 2^resolution of the divided cycles
+ * per period. More resolution bits mean finer duty steps, so the solver takes the most bits that still leave the
+ * divider at 1.0 or above, unless the divider's 8 fraction bits then miss frequency by too much. Nothing here
+ * touches hardware, so the model can be checked on host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_pwm.h"
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Returns timer clock divider closest to frequency at resolution
+ *
+ * @param clk_Hz Timer source clock
+ * @param frequency_Hz Wanted frequency
+ * @param resolution_bits Duty resolution
+ * @return uint32_t Divider with FN_PWM_DIV_FRAC_BITS fraction bits
+ */
+static uint32_t _divider(uint32_t clk_Hz, uint32_t frequency_Hz, int resolution_bits);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+bool fn_pwm_solve(uint32_t clk_Hz, uint32_t frequency_Hz, int duty_cycle_percentage, fn_pwm_params_t *p_params)
+{
+    if((0 == frequency_Hz) || (duty_cycle_percentage < 0) || (duty_cycle_percentage > 100))
+    {
+        return false;
+    }
+
+    int      best_res     = 0;
+    uint32_t best_divider = 0;
+    uint64_t best_cost    = UINT64_MAX;
+
+    for(int res = FN_PWM_RES_MAX; res >= FN_PWM_RES_MIN; res--)
+    {
+        uint32_t divider = _divider(clk_Hz, frequency_Hz, res);
+        if(divider < FN_PWM_DIV_MIN)
+        {
+            continue;
+        }
+        if(divider > FN_PWM_DIV_MAX)
+        {
+            // Dividers only grow with fewer bits
+            break;
+        }
+
+        // Fewer bits leave more divider fraction bits in use, so frequency gets closer, but duty gets coarser. Each
+        // error is weighed by its limit, so neither one is given up for a small gain in the other.
+        uint32_t err      = fn_pwm_error_ppm(clk_Hz, frequency_Hz, divider, res);
+        uint32_t duty_err = fn_pwm_duty_error_ppm(duty_cycle_percentage, res);
+        uint64_t cost     = (uint64_t)err * FN_PWM_MAX_DUTY_ERR_PPM + (uint64_t)duty_err * FN_PWM_MAX_FREQ_ERR_PPM;
+        if(cost < best_cost)
+        {
+            best_res     = res;
+            best_divider = divider;
+            best_cost    = cost;
+        }
+        if((err <= FN_PWM_MAX_FREQ_ERR_PPM) && (duty_err <= FN_PWM_MAX_DUTY_ERR_PPM))
+        {
+            best_res     = res;
+            best_divider = divider;
+            break;
+        }
+    }
+    if(0 == best_res)
+    {
+        return false;
+    }
+
+    p_params->divider         = best_divider;
+    p_params->resolution_bits = (uint8_t)best_res;
+    p_params->duty            = (uint32_t)((((uint64_t)duty_cycle_percentage << best_res) + 50) / 100);
+    p_params->duty_err_ppm    = fn_pwm_duty_error_ppm(duty_cycle_percentage, best_res);
+    p_params->actual_mHz      = fn_pwm_actual_mHz(clk_Hz, best_divider, best_res);
+    return true;
+}
+
+uint32_t fn_pwm_error_ppm(uint32_t clk_Hz, uint32_t frequency_Hz, uint32_t divider, int resolution_bits)
+{
+    uint64_t wanted_mHz = (uint64_t)frequency_Hz * 1000;
+    uint64_t actual_mHz = fn_pwm_actual_mHz(clk_Hz, divider, resolution_bits);
+    uint64_t error_mHz  = (actual_mHz > wanted_mHz) ? actual_mHz - wanted_mHz : wanted_mHz - actual_mHz;
+
+    return (0 == wanted_mHz) ? UINT32_MAX : (uint32_t)(error_mHz * 1000000 / wanted_mHz);
+}
+
+uint32_t fn_pwm_duty_error_ppm(int duty_cycle_percentage, int resolution_bits)
+{
+    // Same rounding as the duty given to the timer, difference is in units of 1 / (100 * 2^resolution_bits) of period
+    uint64_t duty      = (((uint64_t)duty_cycle_percentage << resolution_bits) + 50) / 100;
+    int64_t  error     = (int64_t)(duty * 100) - ((int64_t)duty_cycle_percentage << resolution_bits);
+    uint64_t error_abs = (error < 0) ? -error : error;
+
+    return (uint32_t)((error_abs * 10000) >> resolution_bits);
+}
+
+uint64_t fn_pwm_actual_mHz(uint32_t clk_Hz, uint32_t divider, int resolution_bits)
+{
+    return (((uint64_t)clk_Hz * 1000) << FN_PWM_DIV_FRAC_BITS) / ((uint64_t)divider << resolution_bits);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static uint32_t _divider(uint32_t clk_Hz, uint32_t frequency_Hz, int resolution_bits)
+{
+    // Rounded the same way as the driver does it
+    uint64_t period  = (uint64_t)frequency_Hz << resolution_bits;
+    uint64_t divider = (((uint64_t)clk_Hz << FN_PWM_DIV_FRAC_BITS) + period / 2) / period;
+
+    return (divider > UINT32_MAX) ? UINT32_MAX : (uint32_t)divider;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
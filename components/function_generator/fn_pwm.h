@@ -0,0 +1,91 @@
+/**
+ * @file fn_pwm.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_PWM_H__
+#define __FN_PWM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define FN_PWM_DIV_FRAC_BITS    (8)                         // Timer clock divider is fixed point with this many fraction bits
+#define FN_PWM_DIV_MIN          (1 << FN_PWM_DIV_FRAC_BITS) // Divider 1.0
+#define FN_PWM_DIV_MAX          ((1 << 18) - 1)             // Divider 1023.996
+#define FN_PWM_RES_MIN          (1)                         // Fewest duty resolution bits
+#define FN_PWM_RES_MAX          (20)                        // Most duty resolution bits
+#define FN_PWM_MAX_FREQ_ERR_PPM (1000)                      // Largest frequency error finer duty resolution is kept with
+#define FN_PWM_MAX_DUTY_ERR_PPM (5000)                      // Largest duty error in ppm of period, 0.5 % of duty cycle
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _fn_pwm_params_t
+{
+    uint32_t divider;         // Timer clock divider, FN_PWM_DIV_FRAC_BITS fraction bits
+    uint8_t  resolution_bits; // Timer counts 2^resolution_bits clock cycles per period
+    uint32_t duty;            // Timer counts output is high for
+    uint32_t duty_err_ppm;    // Difference between duty output and wanted one in ppm of period
+    uint64_t actual_mHz;      // Frequency timer outputs
+} fn_pwm_params_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Picks timer divider and duty resolution for frequency. Frequency is clk / (divider * 2^resolution_bits).
+ * The finest resolution within FN_PWM_MAX_FREQ_ERR_PPM and FN_PWM_MAX_DUTY_ERR_PPM is taken. If none is that close,
+ * which happens at high frequencies where the timer counts only a few steps per period, the one with the least sum
+ * of both errors relative to their limits is taken and duty_err_ppm tells how far off duty is.
+ *
+ * @param clk_Hz Timer source clock
+ * @param frequency_Hz Square frequency
+ * @param duty_cycle_percentage Duty cycle from 0% to 100%
+ * @param p_params Timer settings, only valid if true is returned
+ * @return true if timer can output the frequency
+ */
+bool fn_pwm_solve(uint32_t clk_Hz, uint32_t frequency_Hz, int duty_cycle_percentage, fn_pwm_params_t *p_params);
+
+/**
+ * @brief Returns error of frequency timer outputs with divider and resolution
+ *
+ * @param clk_Hz Timer source clock
+ * @param frequency_Hz Wanted frequency
+ * @param divider Timer clock divider, FN_PWM_DIV_FRAC_BITS fraction bits
+ * @param resolution_bits Duty resolution
+ * @return uint32_t Absolute error in parts per million of wanted frequency
+ */
+uint32_t fn_pwm_error_ppm(uint32_t clk_Hz, uint32_t frequency_Hz, uint32_t divider, int resolution_bits);
+
+/**
+ * @brief Returns error of duty cycle timer outputs at resolution
+ *
+ * @param duty_cycle_percentage Wanted duty cycle from 0% to 100%
+ * @param resolution_bits Duty resolution
+ * @return uint32_t Absolute error in parts per million of period
+ */
+uint32_t fn_pwm_duty_error_ppm(int duty_cycle_percentage, int resolution_bits);
+
+/**
+ * @brief Returns frequency timer outputs with divider and resolution
+ *
+ * @param clk_Hz Timer source clock
+ * @param divider Timer clock divider, FN_PWM_DIV_FRAC_BITS fraction bits
+ * @param resolution_bits Duty resolution
+ * @return uint64_t Frequency in mHz
+ */
+uint64_t fn_pwm_actual_mHz(uint32_t clk_Hz, uint32_t divider, int resolution_bits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_PWM_H__
@@ -0,0 +1,390 @@
+/**
+ * @file fn_render.c
+ *
+ * @brief   Sample rendering of the DDS backend
+ *
+ * Config is prepared into a bank: one period of the carrier in DAC codes with level, offset and correction folded in,
+ * tuning words, modulation parameters and the functions that render it. Timer ISR calls the bank's tick function once
+ * per sample, so it never branches on modulation type or trigger mode. Nothing here touches hardware, so rendering is
+ * benchmarked and tested on host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_render.h"
+#include "fn_wavetable.h"
+#include "fn_noise.h"
+#include "fn_level.h"
+#include "esp_attr.h"
+#include <stddef.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define DEGREES_TO_PHASE(deg) (uint32_t)(((uint64_t)(deg) << 32) / 360) // Phase accumulator value of angle
+
+#define PWM_PHASE_SHIFT (8) // PWM compares phase in 24 bits so full duty range fits into int32_t
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Returns highest phase increment per sample config reaches, used to pick band-limited wavetable
+ *
+ * @param p_config Signal config
+ * @return uint32_t Peak tuning word
+ */
+static uint32_t _peak_tuning_word(const fn_signal_config_t *p_config);
+
+/**
+ * @brief Returns next LFO sample and advances its phase
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return int32_t Q15 LFO sample
+ */
+static inline int32_t _lfo_next(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Renders unmodulated signal
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return uint8_t DAC value
+ */
+static uint8_t _render_plain(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Renders amplitude modulated signal
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return uint8_t DAC value
+ */
+static uint8_t _render_am(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Renders frequency modulated signal
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return uint8_t DAC value
+ */
+static uint8_t _render_fm(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Renders phase modulated signal
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return uint8_t DAC value
+ */
+static uint8_t _render_pm(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Renders pulse width modulated square signal
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return uint8_t DAC value
+ */
+static uint8_t _render_pwm(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Renders noise from block of pre-generated samples, refills the block when it runs out
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return uint8_t DAC value
+ */
+static uint8_t _render_noise(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Burst output, counts periods on phase accumulator wrap and idles after the last one
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return uint8_t DAC value
+ */
+static uint8_t _tick_burst(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+/**
+ * @brief Gated output, renders only while gate is asserted
+ *
+ * @param p_ch Channel being rendered
+ * @param p_bank Active bank
+ * @return uint8_t DAC value
+ */
+static uint8_t _tick_gated(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+// Render function for each modulation type
+static const fn_gen_render_t _mod_render[FN_MOD_COUNT] = {
+    [FN_MOD_NONE] = _render_plain,
+    [FN_MOD_AM]   = _render_am,
+    [FN_MOD_FM]   = _render_fm,
+    [FN_MOD_PM]   = _render_pm,
+    [FN_MOD_PWM]  = _render_pwm,
+};
+
+// ISR tick function for each trigger mode
+static const fn_gen_render_t _trig_tick[FN_TRIG_COUNT] = {
+    [FN_TRIG_CONTINUOUS] = NULL, // ISR calls render directly
+    [FN_TRIG_BURST]      = _tick_burst,
+    [FN_TRIG_GATED]      = _tick_gated,
+};
+
+// Noise generator for each signal type, NULL for periodic signals
+static const fn_noise_fill_t _noise_fill[FN_SIGNAL_COUNT] = {
+    [FN_SIGNAL_NOISE_WHITE]    = fn_noise_white_fill,
+    [FN_SIGNAL_NOISE_PINK]     = fn_noise_pink_fill,
+    [FN_SIGNAL_NOISE_GAUSSIAN] = fn_noise_gaussian_fill,
+};
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+void fn_render_prepare(fn_gen_bank_t *p_bank, const fn_signal_config_t *p_config, const uint8_t *p_lut)
+{
+    const fn_mod_config_t *p_mod     = &p_config->modulation;
+    const uint32_t         tw_peak   = _peak_tuning_word(p_config);
+    const int              duty      = FN_GEN_POINT_ARR_LEN * p_config->duty_cycle_percentage / 100;
+
+    fn_level_t level;
+    fn_level_solve(p_config->amplitude_mV, p_config->offset_mV, VDD, &level);
+    const int amplitude = level.amplitude;
+
+    if(NULL != _noise_fill[p_config->signal])
+    {
+        // Noise isn't periodic, table is a ramp over the swing indexed by the top bits of the sample. It goes through
+        // offset and correction below like any other waveform, so noise runs flat into a rail the same way.
+        for(int i = 0; i < FN_GEN_POINT_ARR_LEN; i++)
+        {
+            p_bank->table[i] = (i * amplitude + (FN_GEN_POINT_ARR_LEN - 1) / 2) / (FN_GEN_POINT_ARR_LEN - 1);
+        }
+    }
+    else if(FN_SIGNAL_SQUARE == p_config->signal)
+    {
+        // Band-limited pulse is difference of two saws shifted by duty cycle. Ringing overshoots the ideal levels, so
+        // it's scaled by its own extremes, clamping would bring the harmonics back.
+        const int16_t *p_saw = fn_wavetable_get(FN_SIGNAL_SAWTOOTH, tw_peak);
+        int32_t        pulse[FN_GEN_POINT_ARR_LEN];
+        int32_t        low  = INT32_MAX;
+        int32_t        high = INT32_MIN;
+
+        for(int i = 0; i < FN_GEN_POINT_ARR_LEN; i++)
+        {
+            pulse[i] = p_saw[(i - duty) & (FN_GEN_POINT_ARR_LEN - 1)] - p_saw[i];
+            low      = (pulse[i] < low) ? pulse[i] : low;
+            high     = (pulse[i] > high) ? pulse[i] : high;
+        }
+
+        for(int i = 0; i < FN_GEN_POINT_ARR_LEN; i++)
+        {
+            if(high > low)
+            {
+                p_bank->table[i] = ((pulse[i] - low) * amplitude + (high - low) / 2) / (high - low);
+            }
+            else
+            {
+                // 0% and 100% duty give flat pulse
+                p_bank->table[i] = (duty > 0) ? amplitude : 0;
+            }
+        }
+    }
+    else
+    {
+        const int16_t *p_unit = fn_wavetable_get(p_config->signal, tw_peak);
+
+        for(int i = 0; i < FN_GEN_POINT_ARR_LEN; i++)
+        {
+            // Scale Q15 unit sample from [-1, 1] to [0, amplitude]
+            p_bank->table[i] = ((p_unit[i] + FN_WT_FULL_SCALE) * amplitude + FN_WT_FULL_SCALE) / (2 * FN_WT_FULL_SCALE);
+        }
+    }
+
+    // Offset, saturation and correction are folded into the table, so ISR output costs the same with or without them
+    for(int i = 0; i < FN_GEN_POINT_ARR_LEN; i++)
+    {
+        p_bank->table[i] = p_lut[fn_level_code(&level, p_bank->table[i])];
+    }
+
+    p_bank->tuning_word     = FN_RENDER_TUNING_WORD(p_config->frequency_Hz);
+    p_bank->mid             = p_lut[fn_level_code(&level, amplitude / 2)];
+    p_bank->high            = p_lut[fn_level_code(&level, amplitude)];
+    p_bank->low             = p_lut[fn_level_code(&level, 0)];
+    p_bank->p_lfo           = fn_wavetable_get(p_mod->shape, FN_RENDER_TUNING_WORD(p_mod->rate_Hz));
+    p_bank->lfo_tuning_word = FN_RENDER_TUNING_WORD(p_mod->rate_Hz);
+    p_bank->mod_depth       = 0;
+    p_bank->mod_bias        = 0;
+    p_bank->noise_fill      = _noise_fill[p_config->signal];
+    p_bank->render          = (NULL != p_bank->noise_fill) ? _render_noise : _mod_render[p_mod->type];
+    p_bank->idle            = (NULL != p_bank->noise_fill) ? p_bank->mid : p_bank->table[0];
+    p_bank->burst_cycles    = p_config->trigger.burst_cycles;
+
+    uint64_t idle_samples      = (uint64_t)p_config->trigger.burst_idle_ms * FN_GEN_SAMPLE_RATE_HZ / 1000;
+    p_bank->burst_idle_samples = (uint32_t)idle_samples;
+
+    // Continuous output goes straight to render so it pays nothing for trigger modes
+    p_bank->tick = (FN_TRIG_CONTINUOUS == p_config->trigger.mode) ? p_bank->render : _trig_tick[p_config->trigger.mode];
+
+    switch(p_mod->type)
+    {
+        case FN_MOD_AM:
+            // Gain in Q15 swings between (1 - depth) and 1
+            p_bank->mod_depth = (p_mod->depth << 15) / 200;
+            p_bank->mod_bias  = (1 << 15) - p_bank->mod_depth;
+            break;
+        case FN_MOD_FM:
+            // Pre-shifted so LFO sample times depth fits into int32_t
+            p_bank->mod_depth = (int32_t)(FN_RENDER_TUNING_WORD(p_mod->depth) >> 15);
+            break;
+        case FN_MOD_PM:
+            p_bank->mod_depth = (int32_t)(DEGREES_TO_PHASE(p_mod->depth) >> 15);
+            break;
+        case FN_MOD_PWM:
+        {
+            // Keep swing inside of [0%, 100%] duty cycle
+            int swing = p_mod->depth;
+            if(swing > p_config->duty_cycle_percentage)
+                swing = p_config->duty_cycle_percentage;
+            if(swing > 100 - p_config->duty_cycle_percentage)
+                swing = 100 - p_config->duty_cycle_percentage;
+
+            p_bank->mod_bias  = (int32_t)(((int64_t)p_config->duty_cycle_percentage << (32 - PWM_PHASE_SHIFT)) / 100);
+            p_bank->mod_depth = (int32_t)((((int64_t)swing << (32 - PWM_PHASE_SHIFT)) / 100) >> 15);
+            break;
+        }
+        default:
+            p_bank->lfo_tuning_word = 0;
+            break;
+    }
+}
+
+bool fn_render_is_noise(fn_signal_type_t type)
+{
+    return (type < FN_SIGNAL_COUNT) && (NULL != _noise_fill[type]);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static uint32_t _peak_tuning_word(const fn_signal_config_t *p_config)
+{
+    const fn_mod_config_t *p_mod = &p_config->modulation;
+    uint64_t               tw    = FN_RENDER_TUNING_WORD(p_config->frequency_Hz);
+
+    switch(p_mod->type)
+    {
+        case FN_MOD_FM:
+            tw += FN_RENDER_TUNING_WORD(p_mod->depth);
+            break;
+        case FN_MOD_PM:
+            // Peak frequency deviation of PM is deviation in radians times LFO rate
+            tw += FN_RENDER_TUNING_WORD((uint64_t)p_mod->depth * p_mod->rate_Hz * 314 / 18000);
+            break;
+        default:
+            break;
+    }
+    return (tw > UINT32_MAX) ? UINT32_MAX : (uint32_t)tw;
+}
+
+static inline int32_t _lfo_next(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    int32_t sample = p_bank->p_lfo[FN_WT_INDEX(p_ch->_lfo_phase)];
+    p_ch->_lfo_phase += p_bank->lfo_tuning_word;
+    return sample;
+}
+
+static uint8_t IRAM_ATTR _render_plain(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    uint8_t value = p_bank->table[FN_WT_INDEX(p_ch->_phase)];
+    p_ch->_phase += p_bank->tuning_word;
+    return value;
+}
+
+static uint8_t IRAM_ATTR _render_am(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    int32_t gain   = p_bank->mod_bias + ((_lfo_next(p_ch, p_bank) * p_bank->mod_depth) >> 15);
+    int32_t sample = p_bank->table[FN_WT_INDEX(p_ch->_phase)] - p_bank->mid;
+    p_ch->_phase += p_bank->tuning_word;
+    return (uint8_t)(p_bank->mid + ((sample * gain) >> 15));
+}
+
+static uint8_t IRAM_ATTR _render_fm(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    uint8_t value = p_bank->table[FN_WT_INDEX(p_ch->_phase)];
+    p_ch->_phase += p_bank->tuning_word + (uint32_t)(_lfo_next(p_ch, p_bank) * p_bank->mod_depth);
+    return value;
+}
+
+static uint8_t IRAM_ATTR _render_pm(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    uint8_t value = p_bank->table[FN_WT_INDEX(p_ch->_phase + (uint32_t)(_lfo_next(p_ch, p_bank) * p_bank->mod_depth))];
+    p_ch->_phase += p_bank->tuning_word;
+    return value;
+}
+
+static uint8_t IRAM_ATTR _render_pwm(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    int32_t threshold = p_bank->mod_bias + _lfo_next(p_ch, p_bank) * p_bank->mod_depth;
+    uint8_t value     = ((int32_t)(p_ch->_phase >> PWM_PHASE_SHIFT) < threshold) ? p_bank->high : p_bank->low;
+    p_ch->_phase += p_bank->tuning_word;
+    return value;
+}
+
+static uint8_t IRAM_ATTR _render_noise(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    // Generators run a block at a time so their loops stay tight, ISR mostly just takes the next sample
+    if(0 == p_ch->_noise_left)
+    {
+        p_bank->noise_fill(&p_ch->_noise, p_ch->_noise_block, FN_NOISE_BLOCK_LEN);
+        p_ch->_noise_left = FN_NOISE_BLOCK_LEN;
+    }
+    int32_t sample = p_ch->_noise_block[--p_ch->_noise_left];
+
+    // Phase doesn't shape noise, it only clocks burst periods
+    p_ch->_phase += p_bank->tuning_word;
+
+    // Q15 sample from [-1, 1) picks its DAC value from the ramp in the table
+    return p_bank->table[(uint16_t)(sample + (1 << 15)) >> (16 - FN_GEN_POINT_ARR_BITS)];
+}
+
+static uint8_t IRAM_ATTR _tick_burst(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    if(p_ch->_idle_left > 0)
+    {
+        p_ch->_idle_left--;
+        return p_bank->idle;
+    }
+
+    uint32_t phase = p_ch->_phase;
+    uint8_t  value = p_bank->render(p_ch, p_bank);
+
+    // Accumulator wrapped, one whole period is out
+    if(p_ch->_phase < phase)
+    {
+        p_ch->_burst_cycle++;
+        if(p_ch->_burst_cycle >= p_bank->burst_cycles)
+        {
+            // Drop the wrap remainder so every burst starts at phase 0
+            p_ch->_burst_cycle = 0;
+            p_ch->_idle_left   = p_bank->burst_idle_samples;
+            p_ch->_phase       = 0;
+        }
+    }
+    return value;
+}
+
+static uint8_t IRAM_ATTR _tick_gated(fn_gen_channel_t *p_ch, const fn_gen_bank_t *p_bank)
+{
+    if(!p_ch->_gate)
+    {
+        p_ch->_phase = 0;
+        return p_bank->idle;
+    }
+    return p_bank->render(p_ch, p_bank);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
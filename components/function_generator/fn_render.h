@@ -0,0 +1,51 @@
+/**
+ * @file fn_render.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_RENDER_H__
+#define __FN_RENDER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include "fn_gen.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define FN_RENDER_TUNING_WORD(f) (uint32_t)(((uint64_t)(f) << 32) / FN_GEN_SAMPLE_RATE_HZ) // Phase increment per sample for f Hz
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Fills bank with a period of the signal, tuning words and modulation parameters, and picks the functions
+ * that render it. Needs fn_wavetable_init() first.
+ *
+ * @param p_bank Bank to fill
+ * @param p_config Signal config
+ * @param p_lut Correction table all DAC values are passed through
+ */
+void fn_render_prepare(fn_gen_bank_t *p_bank, const fn_signal_config_t *p_config, const uint8_t *p_lut);
+
+/**
+ * @brief Tells if signal is noise, which isn't periodic and can't be modulated
+ *
+ * @param type Signal type
+ * @return true for noise
+ */
+bool fn_render_is_noise(fn_signal_type_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_RENDER_H__
@@ -0,0 +1,146 @@
+/**
+ * @file fn_timing.c
+ *
+ * @brief   Sample output timing statistics
+ *
+ * Timer ISR stamps each output update with the CPU cycle counter into a ring. Differences of consecutive stamps are
+ * periods, which are summarized as min, max, mean, a percentile and a histogram of deviation from the nominal period.
+ * Nothing here touches hardware, so recorded timestamps can be replayed through it on host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Orders periods ascending for qsort
+ *
+ * @param p_a First period
+ * @param p_b Second period
+ * @return int Negative, zero or positive
+ */
+static int _compare_periods(const void *p_a, const void *p_b);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+void fn_timing_ring_init(fn_timing_ring_t *p_ring, uint32_t *p_stamps, uint32_t len)
+{
+    p_ring->p_stamps = p_stamps;
+    p_ring->len      = len;
+    p_ring->head     = 0;
+    p_ring->count    = 0;
+    p_ring->is_on    = false;
+}
+
+uint32_t fn_timing_ring_copy(const fn_timing_ring_t *p_ring, uint32_t *p_out, uint32_t max_count)
+{
+    uint32_t count = (p_ring->count < max_count) ? p_ring->count : max_count;
+    // Oldest copied stamp is count places behind head
+    uint32_t index = (p_ring->head + p_ring->len - count) % p_ring->len;
+
+    for(uint32_t i = 0; i < count; i++)
+    {
+        p_out[i] = p_ring->p_stamps[index];
+        index    = (index + 1 == p_ring->len) ? 0 : index + 1;
+    }
+    return count;
+}
+
+void fn_timing_stats(const uint32_t *p_stamps, uint32_t count, uint32_t nominal, uint32_t *p_scratch,
+                     fn_timing_stats_t *p_stats)
+{
+    memset(p_stats, 0, sizeof(*p_stats));
+    p_stats->nominal   = nominal;
+    p_stats->bin_width = (nominal >> FN_TIMING_BIN_SHIFT) ? (nominal >> FN_TIMING_BIN_SHIFT) : 1;
+
+    if(count < 2)
+    {
+        return;
+    }
+
+    uint64_t sum = 0;
+    p_stats->periods = count - 1;
+    p_stats->min     = UINT32_MAX;
+
+    for(uint32_t i = 0; i < p_stats->periods; i++)
+    {
+        // Unsigned difference stays right across counter wrap
+        uint32_t period = p_stamps[i + 1] - p_stamps[i];
+
+        p_scratch[i] = period;
+        sum += period;
+        p_stats->min = (period < p_stats->min) ? period : p_stats->min;
+        p_stats->max = (period > p_stats->max) ? period : p_stats->max;
+
+        // Deviation is floored to bins, so nominal period sits on the border of the two middle bins
+        int64_t dev = (int64_t)period - nominal;
+        int64_t w   = p_stats->bin_width;
+        int64_t bin = ((dev >= 0) ? dev / w : -((w - 1 - dev) / w)) + FN_TIMING_HIST_BINS / 2;
+        bin         = (bin < 0) ? 0 : bin;
+        bin = (bin >= FN_TIMING_HIST_BINS) ? FN_TIMING_HIST_BINS - 1 : bin;
+        p_stats->hist[bin]++;
+    }
+    p_stats->mean = (uint32_t)(sum / p_stats->periods);
+
+    // Nearest rank percentile
+    qsort(p_scratch, p_stats->periods, sizeof(uint32_t), _compare_periods);
+    uint32_t rank       = (uint32_t)(((uint64_t)p_stats->periods * FN_TIMING_PERCENTILE + 99) / 100);
+    p_stats->percentile = p_scratch[rank - 1];
+}
+
+void fn_timing_print(const fn_timing_stats_t *p_stats)
+{
+    printf("periods %lu nominal %lu\n", (unsigned long)p_stats->periods, (unsigned long)p_stats->nominal);
+    if(0 == p_stats->periods)
+    {
+        return;
+    }
+    printf("min %lu max %lu mean %lu p%d %lu\n", (unsigned long)p_stats->min, (unsigned long)p_stats->max,
+           (unsigned long)p_stats->mean, FN_TIMING_PERCENTILE, (unsigned long)p_stats->percentile);
+
+    for(int i = 0; i < FN_TIMING_HIST_BINS; i++)
+    {
+        // Bin edges relative to nominal period, outer bins are open ended
+        long from = ((long)i - FN_TIMING_HIST_BINS / 2) * (long)p_stats->bin_width;
+        long to   = from + (long)p_stats->bin_width;
+
+        if(0 == i)
+        {
+            printf("       < %+7ld: %lu\n", to, (unsigned long)p_stats->hist[i]);
+        }
+        else if(FN_TIMING_HIST_BINS - 1 == i)
+        {
+            printf("      >= %+7ld: %lu\n", from, (unsigned long)p_stats->hist[i]);
+        }
+        else
+        {
+            printf("%+7ld..%+7ld: %lu\n", from, to, (unsigned long)p_stats->hist[i]);
+        }
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static int _compare_periods(const void *p_a, const void *p_b)
+{
+    uint32_t a = *(const uint32_t *)p_a;
+    uint32_t b = *(const uint32_t *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,113 @@
+/**
+ * @file fn_timing.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_TIMING_H__
+#define __FN_TIMING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define FN_TIMING_HIST_BINS  (16) // Histogram bins, first and last also take everything beyond them
+#define FN_TIMING_BIN_SHIFT  (5)  // Bin width is nominal period / 2^FN_TIMING_BIN_SHIFT
+#define FN_TIMING_PERCENTILE (99) // Percentile of period reported besides min and max
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _fn_timing_ring_t
+{
+    uint32_t     *p_stamps; // Timestamp storage
+    uint32_t      len;      // Number of timestamps storage holds
+    uint32_t      head;     // Index next timestamp is written to
+    uint32_t      count;    // Number of valid timestamps, saturates at len
+    volatile bool is_on;    // Timestamps are only taken while true
+} fn_timing_ring_t;
+
+typedef struct _fn_timing_stats_t
+{
+    uint32_t periods;                   // Number of periods between timestamps
+    uint32_t nominal;                   // Expected period
+    uint32_t min;                       // Shortest period
+    uint32_t max;                       // Longest period
+    uint32_t mean;                      // Average period, rounded down
+    uint32_t percentile;                // FN_TIMING_PERCENTILE percentile period
+    uint32_t bin_width;                 // Width of a histogram bin
+    uint32_t hist[FN_TIMING_HIST_BINS]; // Period counts, bins are centred on nominal period
+} fn_timing_stats_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Initializes empty ring on storage, ring starts paused
+ *
+ * @param p_ring Timestamp ring
+ * @param p_stamps Storage for timestamps
+ * @param len Number of timestamps storage holds, at least 2
+ */
+void fn_timing_ring_init(fn_timing_ring_t *p_ring, uint32_t *p_stamps, uint32_t len);
+
+/**
+ * @brief Adds timestamp to ring, overwriting the oldest one when it is full. Called from ISR.
+ *
+ * @param p_ring Timestamp ring
+ * @param stamp Timestamp, free running counter that may wrap
+ */
+static inline void fn_timing_ring_add(fn_timing_ring_t *p_ring, uint32_t stamp)
+{
+    if(!p_ring->is_on)
+    {
+        return;
+    }
+    p_ring->p_stamps[p_ring->head] = stamp;
+    p_ring->head                   = (p_ring->head + 1 == p_ring->len) ? 0 : p_ring->head + 1;
+    if(p_ring->count < p_ring->len)
+    {
+        p_ring->count++;
+    }
+}
+
+/**
+ * @brief Copies timestamps out of ring, oldest first. Ring should be paused while it is copied.
+ *
+ * @param p_ring Timestamp ring
+ * @param p_out Copied timestamps
+ * @param max_count Number of timestamps p_out holds
+ * @return uint32_t Number of copied timestamps, the newest ones if there is more than max_count
+ */
+uint32_t fn_timing_ring_copy(const fn_timing_ring_t *p_ring, uint32_t *p_out, uint32_t max_count);
+
+/**
+ * @brief Computes period statistics of consecutive timestamps
+ *
+ * @param p_stamps Timestamps, oldest first
+ * @param count Number of timestamps
+ * @param nominal Expected period in timestamp units
+ * @param p_scratch Work buffer of count - 1 periods
+ * @param p_stats Statistics, periods is 0 if there are less than 2 timestamps
+ */
+void fn_timing_stats(const uint32_t *p_stamps, uint32_t count, uint32_t nominal, uint32_t *p_scratch,
+                     fn_timing_stats_t *p_stats);
+
+/**
+ * @brief Prints statistics to stdout, same format on target and host
+ *
+ * @param p_stats Statistics
+ */
+void fn_timing_print(const fn_timing_stats_t *p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_TIMING_H__
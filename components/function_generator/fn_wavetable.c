@@ -0,0 +1,95 @@
+/**
+ * @file fn_wavetable.c
+ *
+ * @brief   Unit amplitude wavetables shared by the carrier and the modulation LFO
+ *
+ * All tables are generated at build time by tools/gen_wavetables.py, so firmware doesn't need libm. Sine is stored as
+ * a quarter period and unfolded by symmetry at init. Square, triangle and sawtooth are band-limited, one table per
+ * octave, so harmonics above Nyquist never reach the DAC.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_wavetable.h"
+#include "fn_wavetable_data.h"
+#include <stddef.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define QUARTER_LEN (FN_GEN_POINT_ARR_LEN / 4)
+
+_Static_assert(FN_WT_DATA_LEN == FN_GEN_POINT_ARR_LEN, "Generated wavetables don't match FN_GEN_POINT_ARR_LEN");
+_Static_assert(FN_WT_DATA_LEVELS == FN_WT_MIP_LEVELS, "Generated wavetables don't match FN_WT_MIP_LEVELS");
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Picks band-limited table level for tuning word
+ *
+ * @param tuning_word Highest phase increment per sample the table will be played at
+ * @return int Mip level, level L holds 2^L harmonics
+ */
+static int _mip_level(uint32_t tuning_word);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static int16_t _sine[FN_GEN_POINT_ARR_LEN];
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+void fn_wavetable_init(void)
+{
+    const int16_t *p_quarter = fn_wt_data_sine_quarter;
+
+    for(int i = 0; i < QUARTER_LEN; i++)
+    {
+        _sine[i]                   = p_quarter[i];
+        _sine[i + QUARTER_LEN]     = p_quarter[QUARTER_LEN - i];
+        _sine[i + 2 * QUARTER_LEN] = -p_quarter[i];
+        _sine[i + 3 * QUARTER_LEN] = -p_quarter[QUARTER_LEN - i];
+    }
+}
+
+const int16_t *fn_wavetable_get(fn_signal_type_t type, uint32_t tuning_word)
+{
+    int level = _mip_level(tuning_word);
+
+    switch(type)
+    {
+        case FN_SIGNAL_SINE:
+            return _sine;
+        case FN_SIGNAL_SQUARE:
+            return fn_wt_data_square[level];
+        case FN_SIGNAL_TRIANGLE:
+            return fn_wt_data_triangle[level];
+        case FN_SIGNAL_SAWTOOTH:
+            return fn_wt_data_saw[level];
+        default:
+            return NULL;
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static int _mip_level(uint32_t tuning_word)
+{
+    if(0 == tuning_word)
+    {
+        return FN_WT_MIP_LEVELS - 1;
+    }
+
+    // Harmonic h is below Nyquist while h * tuning_word < 2^31, so each leading zero above the first doubles them
+    int level = __builtin_clz(tuning_word) - 1;
+
+    if(level < 0)
+        return 0;
+    if(level >= FN_WT_MIP_LEVELS)
+        return FN_WT_MIP_LEVELS - 1;
+    return level;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
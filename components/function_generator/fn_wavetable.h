@@ -0,0 +1,53 @@
+/**
+ * @file fn_wavetable.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __FN_WAVETABLE_H__
+#define __FN_WAVETABLE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include "fn_gen.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define FN_WT_FULL_SCALE   (32767)                                  // Peak value of a unit wavetable sample, Q15
+#define FN_WT_PHASE_SHIFT  (32 - FN_GEN_POINT_ARR_BITS)             // Phase accumulator to table index shift
+#define FN_WT_INDEX(phase) ((uint32_t)(phase) >> FN_WT_PHASE_SHIFT) // Table index of 32 bit phase
+#define FN_WT_MIP_LEVELS   (8)                                      // Band-limited tables per shape, one per octave of harmonics
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Unfolds generated quarter period sine into full period table shared by carrier and modulator
+ *
+ */
+void fn_wavetable_init(void);
+
+/**
+ * @brief Returns one period of unit amplitude waveform
+ *
+ * Samples are signed Q15 in range [-FN_WT_FULL_SCALE, FN_WT_FULL_SCALE], table is FN_GEN_POINT_ARR_LEN long.
+ * Square wave has 50% duty cycle. Returned table is band-limited so it doesn't alias when played at tuning_word.
+ *
+ * @param type Waveform type
+ * @param tuning_word Highest phase increment per sample the table will be played at
+ * @return const int16_t* Pointer to the table or NULL for unknown type
+ */
+const int16_t *fn_wavetable_get(fn_signal_type_t type, uint32_t tuning_word);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FN_WAVETABLE_H__
@@ -18,24 +18,64 @@ extern "C" {
 #include "driver/dac.h"
 //---------------------------------- MACROS -----------------------------------
 
-#define ESP_DAC_CHAN DAC_CHANNEL_1
+#define ESP_DAC_CHAN_1 DAC_CHANNEL_1 // GPIO25
+#define ESP_DAC_CHAN_2 DAC_CHANNEL_2 // GPIO26
+
+#define ESP_DAC_CHAN_1_GPIO (25)
+#define ESP_DAC_CHAN_2_GPIO (26)
 
 //-------------------------------- DATA TYPES ---------------------------------
 
 //---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
 
 /**
- * @brief Enables esp DAC peripheral
+ * @brief Enables esp DAC channel output
+ *
+ * @param channel DAC channel
+ */
+void dac_init(dac_channel_t channel);
+
+/**
+ * @brief Disables esp DAC channel output
  *
+ * @param channel DAC channel
  */
-void dac_init(void);
+void dac_deinit(dac_channel_t channel);
 
 /**
- * @brief Outputs 8 bit value to DAC
+ * @brief Outputs 8 bit value to DAC. In IRAM, so the sample ISR keeps running through flash writes
  *
+ * @param channel DAC channel
  * @param dac_value 8 bit value
  */
-void dac_output(uint8_t dac_value);
+void dac_output(dac_channel_t channel, uint8_t dac_value);
+
+/**
+ * @brief Returns clock of the cosine waveform generator
+ *
+ * @return uint32_t RTC8M clock frequency in Hz
+ */
+uint32_t dac_cw_clock_hz(void);
+
+/**
+ * @brief Outputs cosine from hardware generator on DAC channel. Generator is shared, so the last frequency set
+ * applies to all channels using it.
+ *
+ * @param channel DAC channel
+ * @param freq_Hz Frequency, truncated to generator's step
+ * @param scale_shift Swing is full scale divided by 2^scale_shift, 0 to 3
+ * @param offset DC offset in DAC codes
+ * @return esp_err_t
+ */
+esp_err_t dac_cw_start(dac_channel_t channel, uint32_t freq_Hz, int scale_shift, int8_t offset);
+
+/**
+ * @brief Returns DAC channel from cosine generator to direct output, generator is turned off with its last channel
+ *
+ * @param channel DAC channel
+ * @param dac_value Value to output after generator is released
+ */
+void dac_cw_stop(dac_channel_t channel, uint8_t dac_value);
 
 #ifdef __cplusplus
 }
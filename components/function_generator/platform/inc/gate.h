@@ -0,0 +1,66 @@
+/**
+ * @file gate.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __GATE_H__
+#define __GATE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdbool.h>
+#include "esp_err.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define GATE_PIN_NONE   (-1) // No gate input pin, gate is controlled from software only
+#define GATE_MAX_NUMBER (2)  // Number of gate inputs that can be used at once
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+/**
+ * @brief Called from GPIO ISR on every gate edge
+ *
+ * @param is_asserted New gate level
+ * @param p_arg Argument given to gate_init()
+ */
+typedef void (*gate_cb_t)(bool is_asserted, void *p_arg);
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Configures pin as active high gate input with interrupt on both edges
+ *
+ * @param pin GPIO number
+ * @param cb Edge callback
+ * @param p_arg Passed to callback
+ * @return esp_err_t ESP_ERR_INVALID_ARG if pin isn't a GPIO, ESP_ERR_NO_MEM if GATE_MAX_NUMBER gates are already used
+ */
+esp_err_t gate_init(int pin, gate_cb_t cb, void *p_arg);
+
+/**
+ * @brief Removes gate interrupt from pin
+ *
+ * @param pin GPIO number
+ */
+void gate_deinit(int pin);
+
+/**
+ * @brief Returns current gate level
+ *
+ * @param pin GPIO number
+ * @return true if gate is asserted
+ */
+bool gate_is_asserted(int pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __GATE_H__
@@ -0,0 +1,54 @@
+/**
+ * @file pwm.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __PWM_H__
+#define __PWM_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include "esp_err.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define PWM_CLK_HZ     (80000000) // APB clock LEDC timers run from
+#define PWM_MAX_NUMBER (2)        // Outputs, each uses its own LEDC timer and channel
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Starts square wave from LEDC on pin, or changes its settings if it is already running. Pin is taken from
+ * the DAC, so DAC has to be disabled on it first.
+ *
+ * @param index Output index, below PWM_MAX_NUMBER
+ * @param pin GPIO pin
+ * @param divider Timer clock divider with 8 fraction bits
+ * @param resolution_bits Duty resolution
+ * @param duty Timer counts output is high for
+ * @return esp_err_t
+ */
+esp_err_t pwm_start(int index, int pin, uint32_t divider, uint32_t resolution_bits, uint32_t duty);
+
+/**
+ * @brief Stops square wave and releases pin
+ *
+ * @param index Output index, below PWM_MAX_NUMBER
+ * @param pin GPIO pin
+ */
+void pwm_stop(int index, int pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PWM_H__
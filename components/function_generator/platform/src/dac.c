@@ -9,6 +9,10 @@
 
 //--------------------------------- INCLUDES ----------------------------------
 #include "dac.h"
+#include "clk_ctrl_os.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "hal/dac_ll.h"
 
 //---------------------------------- MACROS -----------------------------------
 
@@ -17,20 +21,78 @@
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
 
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const dac_cw_scale_t _cw_scale[] = { DAC_CW_SCALE_1, DAC_CW_SCALE_2, DAC_CW_SCALE_4, DAC_CW_SCALE_8 };
+
+static uint32_t _cw_clock_hz = 0; // Calibrated once, RTC8M clock stays on for the generator
+static uint32_t _cw_channels = 0; // Bit mask of channels driven by the generator
 
 //------------------------------- GLOBAL DATA ---------------------------------
+extern portMUX_TYPE rtc_spinlock; // Defined by IDF, its DAC driver takes it around the same registers
 
 //------------------------------ PUBLIC FUNCTIONS -----------------------------
 
-void dac_init(void)
+void dac_init(dac_channel_t channel)
+{
+    dac_output_enable(channel);
+}
+
+void dac_deinit(dac_channel_t channel)
 {
-    dac_output_enable(ESP_DAC_CHAN);
+    dac_output_disable(channel);
 }
 
-void dac_output(uint8_t dac_value)
+void IRAM_ATTR dac_output(dac_channel_t channel, uint8_t dac_value)
 {
-    dac_output_voltage(ESP_DAC_CHAN, dac_value);
+    // Same register write as dac_output_voltage(), which lives in flash and can't run while a flash write has cache
+    // disabled, while the sample ISR has to
+    portENTER_CRITICAL_SAFE(&rtc_spinlock);
+    dac_ll_update_output_value(channel, dac_value);
+    portEXIT_CRITICAL_SAFE(&rtc_spinlock);
 }
+uint32_t dac_cw_clock_hz(void)
+{
+    if(0 == _cw_clock_hz)
+    {
+        periph_rtc_dig_clk8m_enable();
+        _cw_clock_hz = periph_rtc_dig_clk8m_get_freq();
+    }
+    return _cw_clock_hz;
+}
+
+esp_err_t dac_cw_start(dac_channel_t channel, uint32_t freq_Hz, int scale_shift, int8_t offset)
+{
+    dac_cw_config_t cw = {
+        .en_ch  = channel,
+        .scale  = _cw_scale[scale_shift],
+        .phase  = DAC_CW_PHASE_0,
+        .freq   = freq_Hz,
+        .offset = offset,
+    };
+
+    esp_err_t esp_err = dac_cw_generator_config(&cw);
+    if(ESP_OK == esp_err)
+    {
+        esp_err = dac_cw_generator_enable();
+    }
+    if(ESP_OK == esp_err)
+    {
+        _cw_channels |= (1u << channel);
+    }
+    return esp_err;
+}
+
+void dac_cw_stop(dac_channel_t channel, uint8_t dac_value)
+{
+    // Direct output write also clears the channel's generator enable bit
+    dac_output_voltage(channel, dac_value);
+
+    _cw_channels &= ~(1u << channel);
+    if(0 == _cw_channels)
+    {
+        dac_cw_generator_disable();
+    }
+}
+
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
 
 //---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,137 @@
+/**
+ * @file gate.c
+ *
+ * @brief   GPIO gate input wrapper class
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "gate.h"
+#include <stdint.h>
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define ESP_INTR_FLAG_DEFAULT (0)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _gate_t
+{
+    int       pin;   // GPIO number, GATE_PIN_NONE if slot is free
+    gate_cb_t cb;    // Edge callback
+    void     *p_arg; // Callback argument
+} gate_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief GPIO interrupt handler, forwards gate level to registered callback
+ *
+ * @param p_arg Gate slot
+ */
+static void _gate_isr(void *p_arg);
+
+/**
+ * @brief Finds gate slot used by pin
+ *
+ * @param pin GPIO number, GATE_PIN_NONE finds free slot
+ * @return gate_t* Slot or NULL if there is none
+ */
+static gate_t *_find(int pin);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "gate";
+static gate_t      _gates[GATE_MAX_NUMBER] = { [0 ... GATE_MAX_NUMBER - 1] = { .pin = GATE_PIN_NONE } };
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+esp_err_t gate_init(int pin, gate_cb_t cb, void *p_arg)
+{
+    gate_t *p_gate = _find(GATE_PIN_NONE);
+
+    if(!GPIO_IS_VALID_GPIO(pin))
+    {
+        ESP_LOGE(TAG, "GPIO%d doesn't exist", pin);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(NULL == p_gate)
+    {
+        ESP_LOGE(TAG, "All %d gates are used", GATE_MAX_NUMBER);
+        return ESP_ERR_NO_MEM;
+    }
+
+    gpio_config_t io_conf = {
+        .pin_bit_mask = (1ULL << pin),
+        .mode         = GPIO_MODE_INPUT,
+        .pull_up_en   = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type    = GPIO_INTR_ANYEDGE,
+    };
+
+    // Slot is filled before the handler is added, first edge can come right after
+    p_gate->pin   = pin;
+    p_gate->cb    = cb;
+    p_gate->p_arg = p_arg;
+
+    esp_err_t esp_err = gpio_config(&io_conf);
+
+    if(ESP_OK == esp_err)
+    {
+        // Returns error if service is already installed by other module, that is fine
+        gpio_install_isr_service(ESP_INTR_FLAG_DEFAULT);
+        esp_err = gpio_isr_handler_add(pin, _gate_isr, p_gate);
+    }
+
+    if(ESP_OK != esp_err)
+    {
+        p_gate->pin = GATE_PIN_NONE;
+        ESP_LOGE(TAG, "Gate on GPIO%d not created: %s", pin, esp_err_to_name(esp_err));
+    }
+    return esp_err;
+}
+
+void gate_deinit(int pin)
+{
+    gate_t *p_gate = _find(pin);
+
+    gpio_isr_handler_remove(pin);
+    gpio_set_intr_type(pin, GPIO_INTR_DISABLE);
+
+    if(NULL != p_gate)
+    {
+        p_gate->pin = GATE_PIN_NONE;
+    }
+}
+
+bool gate_is_asserted(int pin)
+{
+    return (0 != gpio_get_level(pin));
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static gate_t *_find(int pin)
+{
+    for(int i = 0; i < GATE_MAX_NUMBER; i++)
+    {
+        if(pin == _gates[i].pin)
+        {
+            return &_gates[i];
+        }
+    }
+    return NULL;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
+
+static void IRAM_ATTR _gate_isr(void *p_arg)
+{
+    gate_t *p_gate = p_arg;
+
+    p_gate->cb(0 != gpio_get_level(p_gate->pin), p_gate->p_arg);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file pwm.c
+ *
+ * @brief   LEDC wrapper class
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "pwm.h"
+#include "driver/ledc.h"
+#include "driver/gpio.h"
+#include "driver/rtc_io.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define PWM_SPEED_MODE (LEDC_HIGH_SPEED_MODE) // Settings take effect without waiting for the period to end
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+esp_err_t pwm_start(int index, int pin, uint32_t divider, uint32_t resolution_bits, uint32_t duty)
+{
+    if((index < 0) || (index >= PWM_MAX_NUMBER))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Driver derives its own divider from frequency, it is overwritten with the exact one right after
+    ledc_timer_config_t timer_config = {
+        .speed_mode      = PWM_SPEED_MODE,
+        .duty_resolution = resolution_bits,
+        .timer_num       = LEDC_TIMER_0 + index,
+        .freq_hz         = (uint32_t)((((uint64_t)PWM_CLK_HZ << 8) / divider) >> resolution_bits),
+        .clk_cfg         = LEDC_USE_APB_CLK,
+    };
+    esp_err_t esp_err = ledc_timer_config(&timer_config);
+    if(ESP_OK == esp_err)
+    {
+        esp_err = ledc_timer_set(PWM_SPEED_MODE, timer_config.timer_num, divider, resolution_bits, LEDC_APB_CLK);
+    }
+    if(ESP_OK != esp_err)
+    {
+        return esp_err;
+    }
+
+    // DAC pads are left in RTC mux, LEDC reaches the pin through the digital GPIO matrix
+    if(rtc_gpio_is_valid_gpio(pin))
+    {
+        rtc_gpio_deinit(pin);
+    }
+
+    ledc_channel_config_t channel_config = {
+        .gpio_num   = pin,
+        .speed_mode = PWM_SPEED_MODE,
+        .channel    = LEDC_CHANNEL_0 + index,
+        .intr_type  = LEDC_INTR_DISABLE,
+        .timer_sel  = timer_config.timer_num,
+        .duty       = duty,
+        .hpoint     = 0,
+    };
+    return ledc_channel_config(&channel_config);
+}
+
+void pwm_stop(int index, int pin)
+{
+    if((index < 0) || (index >= PWM_MAX_NUMBER))
+    {
+        return;
+    }
+
+    ledc_stop(PWM_SPEED_MODE, LEDC_CHANNEL_0 + index, 0);
+    ledc_timer_pause(PWM_SPEED_MODE, LEDC_TIMER_0 + index);
+    // Detaches LEDC from the GPIO matrix, DAC takes the pad back when it is enabled
+    gpio_reset_pin(pin);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,278 @@
+/**
+ * @file test_fn_cal.c
+ *
+ * @brief   Host unit tests of the DAC correction fit against simulated DACs and ADCs
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_cal.h"
+#include "test_check.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define VDD_MV (3300)
+#define LSB_MV ((double)VDD_MV / (FN_CAL_CODES - 1))
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+// Output of code is offset + gain * ideal + bow * sin(pi * code / 255) + per code DNL, read by a noisy clipping ADC
+typedef struct
+{
+    double offset_mV;
+    double gain;
+    double bow_mV;
+    double dnl_mV; // Peak of the per code error
+    double noise_mV;
+    int    adc_floor_mV;
+    int    adc_ceiling_mV;
+} sim_dac_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Returns true output of code
+ *
+ * @param p_dac Simulated DAC
+ * @param code DAC code
+ * @return double Output in mV
+ */
+static double _output(const sim_dac_t *p_dac, int code);
+
+/**
+ * @brief Sweeps all codes through the simulated ADC
+ *
+ * @param p_dac Simulated DAC
+ * @param p_measured_mV Readings
+ */
+static void _measure(const sim_dac_t *p_dac, int16_t *p_measured_mV);
+
+/**
+ * @brief Returns uniform pseudo random number in [-1, 1]
+ *
+ * @return double
+ */
+static double _random(void);
+
+/**
+ * @brief Checks corrected output of every reachable ideal code is as close to ideal as the DAC allows
+ *
+ * @param p_dac Simulated DAC
+ * @param p_lut Correction table
+ * @param slack_mV Error allowed on top of half the local step, covers noise and smoothing
+ */
+static void _check_corrected(const sim_dac_t *p_dac, const uint8_t *p_lut, double slack_mV);
+
+static void _test_ideal(void);
+static void _test_offset_gain(void);
+static void _test_inl_noise_clipping(void);
+static void _test_non_monotonic(void);
+static void _test_rejects(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static uint32_t _seed = 12345;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    _test_ideal();
+    _test_offset_gain();
+    _test_inl_noise_clipping();
+    _test_non_monotonic();
+    _test_rejects();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static double _output(const sim_dac_t *p_dac, int code)
+{
+    // Per code error is a fixed hash of the code, same on every sweep like real DNL
+    uint32_t h   = (uint32_t)code * 2654435761u;
+    double   dnl = p_dac->dnl_mV * ((double)(h >> 16 & 0xFFFF) / 32767.5 - 1.0);
+
+    return p_dac->offset_mV + p_dac->gain * code * LSB_MV + p_dac->bow_mV * sin(M_PI * code / (FN_CAL_CODES - 1)) + dnl;
+}
+
+static void _measure(const sim_dac_t *p_dac, int16_t *p_measured_mV)
+{
+    for(int code = 0; code < FN_CAL_CODES; code++)
+    {
+        double mV = _output(p_dac, code) + p_dac->noise_mV * _random();
+        mV        = (mV < p_dac->adc_floor_mV) ? p_dac->adc_floor_mV : mV;
+        mV        = (mV > p_dac->adc_ceiling_mV) ? p_dac->adc_ceiling_mV : mV;
+
+        p_measured_mV[code] = (int16_t)lround(mV);
+    }
+}
+
+static double _random(void)
+{
+    _seed = _seed * 1103515245u + 12345u;
+    return (double)(_seed >> 8 & 0xFFFF) / 32767.5 - 1.0;
+}
+
+static void _check_corrected(const sim_dac_t *p_dac, const uint8_t *p_lut, double slack_mV)
+{
+    double lowest  = _output(p_dac, 0);
+    double highest = _output(p_dac, FN_CAL_CODES - 1);
+
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        CHECK((0 == k) || (p_lut[k] >= p_lut[k - 1]));
+
+        double target = k * LSB_MV;
+        double error  = fabs(_output(p_dac, p_lut[k]) - target);
+        if(target < lowest)
+        {
+            // Out of reach, closest the DAC gets is its bottom
+            CHECK(p_lut[k] <= 2);
+        }
+        else if(target > highest)
+        {
+            CHECK(p_lut[k] >= FN_CAL_CODES - 3);
+        }
+        else
+        {
+            // Best possible is half the step around the chosen code
+            int    code = p_lut[k];
+            double step = 0;
+            if(code > 0)
+                step = fmax(step, _output(p_dac, code) - _output(p_dac, code - 1));
+            if(code < FN_CAL_CODES - 1)
+                step = fmax(step, _output(p_dac, code + 1) - _output(p_dac, code));
+            CHECK(error <= step / 2 + slack_mV);
+        }
+    }
+}
+
+static void _test_ideal(void)
+{
+    sim_dac_t dac = { .gain = 1.0, .adc_floor_mV = -1000, .adc_ceiling_mV = 5000 };
+    int16_t   measured[FN_CAL_CODES];
+    uint8_t   lut[FN_CAL_CODES];
+
+    fn_cal_identity(lut);
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        CHECK(k == lut[k]);
+    }
+
+    // Ideal DAC needs no correction
+    memset(lut, 0, sizeof(lut));
+    _measure(&dac, measured);
+    fn_cal_result_t result;
+    CHECK(fn_cal_fit(measured, VDD_MV, lut, &result));
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        CHECK(k == lut[k]);
+    }
+    CHECK(abs(result.offset_mV) <= 1);
+    CHECK(abs(result.full_scale_mV - VDD_MV) <= 1);
+    CHECK(result.max_inl_mV <= 1);
+}
+
+static void _test_offset_gain(void)
+{
+    // Typical ESP32 DAC: starts above 0 V and falls short of VDD
+    sim_dac_t dac = { .offset_mV = 90, .gain = 0.93, .adc_floor_mV = -1000, .adc_ceiling_mV = 5000 };
+    int16_t   measured[FN_CAL_CODES];
+    uint8_t   lut[FN_CAL_CODES];
+
+    _measure(&dac, measured);
+    fn_cal_result_t result;
+    CHECK(fn_cal_fit(measured, VDD_MV, lut, &result));
+    CHECK(abs(result.offset_mV - 90) <= 1);
+    CHECK(abs(result.full_scale_mV - (int)lround(_output(&dac, FN_CAL_CODES - 1))) <= 1);
+    _check_corrected(&dac, lut, 0.5);
+
+    // Mid scale lands where the ideal DAC puts it
+    CHECK(fabs(_output(&dac, lut[128]) - 128 * LSB_MV) <= LSB_MV);
+}
+
+static void _test_inl_noise_clipping(void)
+{
+    // ADC reads nothing below ~100 mV and saturates near 3.1 V, bow and DNL are a few LSB
+    sim_dac_t dac = { .offset_mV      = 60,
+                      .gain           = 0.97,
+                      .bow_mV         = 40,
+                      .dnl_mV         = 4,
+                      .noise_mV       = 3,
+                      .adc_floor_mV   = 110,
+                      .adc_ceiling_mV = 3100 };
+    int16_t   measured[FN_CAL_CODES];
+    uint8_t   lut[FN_CAL_CODES];
+
+    _measure(&dac, measured);
+    fn_cal_result_t result;
+    CHECK(fn_cal_fit(measured, VDD_MV, lut, &result));
+    CHECK(result.first_code > 0);
+    CHECK(result.last_code < FN_CAL_CODES - 1);
+    // Bow is partly absorbed by the line, what remains is still several LSB
+    CHECK((result.max_inl_mV >= 20) && (result.max_inl_mV <= 40));
+
+    // Noise and extrapolation into clipped codes cost a little on top of the step
+    _check_corrected(&dac, lut, 8);
+
+    // Uncorrected output is off by tens of mV where the bow peaks
+    CHECK(fabs(_output(&dac, 128) - 128 * LSB_MV) > 30);
+    CHECK(fabs(_output(&dac, lut[128]) - 128 * LSB_MV) < LSB_MV);
+}
+
+static void _test_non_monotonic(void)
+{
+    // Large DNL makes some steps go backwards, table still only rises
+    sim_dac_t dac = { .gain = 1.0, .dnl_mV = 10, .adc_floor_mV = -1000, .adc_ceiling_mV = 5000 };
+    int16_t   measured[FN_CAL_CODES];
+    uint8_t   lut[FN_CAL_CODES];
+
+    _measure(&dac, measured);
+    CHECK(fn_cal_fit(measured, VDD_MV, lut, NULL));
+    for(int k = 1; k < FN_CAL_CODES; k++)
+    {
+        CHECK(lut[k] >= lut[k - 1]);
+    }
+}
+
+static void _test_rejects(void)
+{
+    int16_t measured[FN_CAL_CODES];
+    uint8_t lut[FN_CAL_CODES];
+    uint8_t untouched[FN_CAL_CODES];
+
+    memset(lut, 0xA5, sizeof(lut));
+    memcpy(untouched, lut, sizeof(lut));
+
+    // Nothing connected, input floats at one level
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        measured[k] = (int16_t)(1500 + (k & 1));
+    }
+    CHECK(!fn_cal_fit(measured, VDD_MV, lut, NULL));
+
+    // Falling output isn't a loopback of this DAC
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        measured[k] = (int16_t)(VDD_MV - k * 12);
+    }
+    CHECK(!fn_cal_fit(measured, VDD_MV, lut, NULL));
+
+    // Clipped almost everywhere
+    sim_dac_t dac = { .gain = 1.0, .adc_floor_mV = 1500, .adc_ceiling_mV = 1700 };
+    _measure(&dac, measured);
+    CHECK(!fn_cal_fit(measured, VDD_MV, lut, NULL));
+
+    CHECK(0 == memcmp(lut, untouched, sizeof(lut)));
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,197 @@
+/**
+ * @file test_fn_cw.c
+ *
+ * @brief   Host unit tests of the DAC cosine generator settings solver
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_cw.h"
+#include "test_check.h"
+#include <stdio.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define CLK_HZ      (8500000) // Nominal RTC8M clock
+#define FREQ_MAX_HZ (200000)  // Sweep end, above what DDS is configured for
+#define FULL_SCALE  (FN_CW_FULL_SCALE)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Returns error of frequency in ppm computed in double precision
+ *
+ * @param clk_Hz Generator clock
+ * @param frequency_Hz Wanted frequency
+ * @param step Phase step
+ * @return double Absolute error in ppm
+ */
+static double _error_ppm(uint32_t clk_Hz, int frequency_Hz, uint32_t step);
+
+static void _test_step(void);
+static void _test_error_ppm(void);
+static void _test_cutoff(void);
+static void _test_scale(void);
+static void _test_out_of_range(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+static const uint32_t _clocks[] = { 8000000, CLK_HZ, 8765432 };
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    _test_step();
+    _test_error_ppm();
+    _test_cutoff();
+    _test_scale();
+    _test_out_of_range();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _test_step(void)
+{
+    // Step is the nearest one, and the frequency handed to the truncating driver lands back on it
+    for(size_t c = 0; c < sizeof(_clocks) / sizeof(_clocks[0]); c++)
+    {
+        uint32_t clk = _clocks[c];
+        for(int f = 1; f <= FREQ_MAX_HZ; f += 7)
+        {
+            uint32_t step = fn_cw_step(clk, f);
+            CHECK(_error_ppm(clk, f, step) <= _error_ppm(clk, f, step + 1));
+            CHECK((0 == step) || (_error_ppm(clk, f, step) <= _error_ppm(clk, f, step - 1)));
+
+            fn_cw_params_t cw;
+            if(fn_cw_solve(clk, f, FULL_SCALE, &cw))
+            {
+                CHECK(cw.step == step);
+                CHECK((((uint64_t)cw.freq_Hz << FN_CW_STEP_BITS) / clk) == step);
+                CHECK(cw.actual_mHz == fn_cw_actual_mHz(clk, step));
+            }
+        }
+    }
+}
+
+static void _test_error_ppm(void)
+{
+    // Integer error matches double precision to within the mHz truncation of the actual frequency
+    for(size_t c = 0; c < sizeof(_clocks) / sizeof(_clocks[0]); c++)
+    {
+        uint32_t clk = _clocks[c];
+        for(int f = 1; f <= FREQ_MAX_HZ; f += 13)
+        {
+            double exact = _error_ppm(clk, f, fn_cw_step(clk, f));
+            double slack = 1e6 / (1000.0 * f) + 1.0;
+            CHECK((double)fn_cw_error_ppm(clk, f) <= exact + slack);
+            CHECK((double)fn_cw_error_ppm(clk, f) + slack >= exact);
+        }
+    }
+    CHECK(UINT32_MAX == fn_cw_error_ppm(CLK_HZ, 0));
+
+    // Frequency on a step is exact up to the mHz truncation
+    uint32_t on_step = (uint32_t)(((uint64_t)CLK_HZ * 1000) >> FN_CW_STEP_BITS);
+    CHECK(fn_cw_error_ppm(CLK_HZ, on_step) < 100);
+}
+
+static void _test_cutoff(void)
+{
+    // Solver takes exactly the frequencies within FN_CW_MAX_FREQ_ERR_PPM, so CW output is at most 0.5 % off
+    int    accepted  = 0;
+    int    lowest    = 0;
+    double worst_ppm = 0.0;
+
+    for(int f = 1; f <= FREQ_MAX_HZ; f++)
+    {
+        fn_cw_params_t cw;
+        uint32_t       step  = fn_cw_step(CLK_HZ, f);
+        uint32_t       err   = fn_cw_error_ppm(CLK_HZ, f);
+        bool           fits  = (step > 0) && (step <= FN_CW_STEP_MAX) && (err <= FN_CW_MAX_FREQ_ERR_PPM);
+        bool           taken = fn_cw_solve(CLK_HZ, f, FULL_SCALE, &cw);
+
+        CHECK(taken == fits);
+        if(taken)
+        {
+            double actual_err = _error_ppm(CLK_HZ, f, cw.step);
+            CHECK(actual_err <= FN_CW_MAX_FREQ_ERR_PPM + 1.0);
+            worst_ppm = (actual_err > worst_ppm) ? actual_err : worst_ppm;
+            lowest    = (0 == lowest) ? f : lowest;
+            accepted++;
+        }
+    }
+    printf("CW takes %d of %d frequencies from %d Hz, worst error %.0f ppm\n", accepted, FREQ_MAX_HZ, lowest, worst_ppm);
+
+    // Half a step is the worst rounding, it stays within the limit only above cutoff_Hz, about 13 kHz
+    double half_step_Hz = (double)CLK_HZ / (2 << FN_CW_STEP_BITS);
+    double cutoff_Hz    = half_step_Hz * 1e6 / FN_CW_MAX_FREQ_ERR_PPM;
+    for(int k = 1; (2 * k + 1) * half_step_Hz < 0.99 * cutoff_Hz; k++)
+    {
+        fn_cw_params_t cw;
+        int            f = (int)((2 * k + 1) * half_step_Hz + 0.5);
+        CHECK(!fn_cw_solve(CLK_HZ, f, FULL_SCALE, &cw));
+    }
+    for(int f = (int)(1.01 * cutoff_Hz); f <= FREQ_MAX_HZ; f++)
+    {
+        fn_cw_params_t cw;
+        CHECK(fn_cw_solve(CLK_HZ, f, FULL_SCALE, &cw));
+    }
+}
+
+static void _test_scale(void)
+{
+    // Swings the generator can make are taken within FN_CW_AMPLITUDE_TOL, and centred at half the swing like DDS
+    fn_cw_params_t cw;
+    int            f = 20000;
+
+    for(int amplitude = 0; amplitude <= FULL_SCALE; amplitude++)
+    {
+        bool fits = false;
+        int  fit  = 0;
+        for(int shift = 0; shift < FN_CW_SCALE_NUMBER; shift++)
+        {
+            int diff = amplitude - (FULL_SCALE >> shift);
+            if(!fits && (diff >= -FN_CW_AMPLITUDE_TOL) && (diff <= FN_CW_AMPLITUDE_TOL))
+            {
+                fits = true;
+                fit  = shift;
+            }
+        }
+
+        CHECK(fits == fn_cw_solve(CLK_HZ, f, amplitude, &cw));
+        if(fits)
+        {
+            CHECK(fit == cw.scale_shift);
+            CHECK(FN_CW_MID_SCALE + cw.offset == (FULL_SCALE >> fit) / 2);
+        }
+    }
+}
+
+static void _test_out_of_range(void)
+{
+    fn_cw_params_t cw;
+
+    CHECK(!fn_cw_solve(0, 1000, FULL_SCALE, &cw));
+    CHECK(!fn_cw_solve(CLK_HZ, 0, FULL_SCALE, &cw));
+    CHECK(!fn_cw_solve(CLK_HZ, -1000, FULL_SCALE, &cw));
+    // Above the largest step
+    CHECK(!fn_cw_solve(CLK_HZ, CLK_HZ, FULL_SCALE, &cw));
+    CHECK(fn_cw_step(CLK_HZ, CLK_HZ) > FN_CW_STEP_MAX);
+}
+
+static double _error_ppm(uint32_t clk_Hz, int frequency_Hz, uint32_t step)
+{
+    double actual = (double)clk_Hz * step / (1 << FN_CW_STEP_BITS);
+    double error  = (actual > frequency_Hz) ? actual - frequency_Hz : frequency_Hz - actual;
+    return error * 1e6 / frequency_Hz;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,146 @@
+/**
+ * @file test_fn_level.c
+ *
+ * @brief   Host unit tests of DC offset levels and clipping detection
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_level.h"
+#include "test_check.h"
+#include <stdio.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define VDD_MV (3300)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void _test_no_offset(void);
+static void _test_fits(void);
+static void _test_clip(void);
+static void _test_rounding(void);
+static void _test_code(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    _test_no_offset();
+    _test_fits();
+    _test_clip();
+    _test_rounding();
+    _test_code();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _test_no_offset(void)
+{
+    fn_level_t level;
+
+    // Without offset every amplitude fits and converts the way it did before offset existed
+    for(int mV = 0; mV <= VDD_MV; mV++)
+    {
+        CHECK(0 == fn_level_solve(mV, 0, VDD_MV, &level));
+        CHECK((int)(255 * mV / VDD_MV) == level.amplitude);
+        CHECK(0 == level.offset);
+    }
+}
+
+static void _test_fits(void)
+{
+    fn_level_t level;
+
+    // 1 V swing from 1 V to 2 V
+    CHECK(0 == fn_level_solve(1000, 1000, VDD_MV, &level));
+    CHECK(77 == level.amplitude);
+    CHECK(77 == level.offset);
+
+    // Swing that ends exactly at VDD
+    CHECK(0 == fn_level_solve(1650, 1650, VDD_MV, &level));
+    CHECK(level.offset + level.amplitude <= FN_LEVEL_MAX_CODE);
+
+    // Zero amplitude is a DC level anywhere in range
+    CHECK(0 == fn_level_solve(0, VDD_MV, VDD_MV, &level));
+    CHECK(FN_LEVEL_MAX_CODE == level.offset);
+}
+
+static void _test_clip(void)
+{
+    fn_level_t level;
+
+    CHECK(FN_LEVEL_CLIP_LOW == fn_level_solve(1000, -500, VDD_MV, &level));
+    CHECK(level.offset < 0);
+    CHECK(FN_LEVEL_CLIP_HIGH == fn_level_solve(2000, 1500, VDD_MV, &level));
+    CHECK(FN_LEVEL_CLIP_HIGH == fn_level_solve(VDD_MV, 100, VDD_MV, &level));
+
+    // Whole swing below 0 V or above VDD only runs into one rail
+    CHECK(FN_LEVEL_CLIP_LOW == fn_level_solve(1000, -VDD_MV, VDD_MV, &level));
+    CHECK(FN_LEVEL_CLIP_HIGH == fn_level_solve(1000, VDD_MV, VDD_MV, &level));
+
+    // Full scale swing runs into exactly one rail when moved either way
+    CHECK(FN_LEVEL_CLIP_LOW == fn_level_solve(VDD_MV, -200, VDD_MV, &level));
+    CHECK(FN_LEVEL_CLIP_HIGH == fn_level_solve(VDD_MV, 200, VDD_MV, &level));
+}
+
+static void _test_rounding(void)
+{
+    fn_level_t level;
+
+    // Offset under half a code either side of 0 V rounds to the rail and doesn't clip
+    CHECK(0 == fn_level_solve(1000, -6, VDD_MV, &level));
+    CHECK(0 == level.offset);
+    CHECK(0 == fn_level_solve(1000, 6, VDD_MV, &level));
+    CHECK(0 == level.offset);
+    CHECK(FN_LEVEL_CLIP_LOW == fn_level_solve(1000, -7, VDD_MV, &level));
+    CHECK(-1 == level.offset);
+    CHECK(0 == fn_level_solve(1000, 7, VDD_MV, &level));
+    CHECK(1 == level.offset);
+
+    // Rounding is symmetric around 0
+    for(int mV = 0; mV <= VDD_MV; mV++)
+    {
+        fn_level_t neg;
+        fn_level_solve(0, mV, VDD_MV, &level);
+        fn_level_solve(0, -mV, VDD_MV, &neg);
+        CHECK(level.offset == -neg.offset);
+    }
+}
+
+static void _test_code(void)
+{
+    fn_level_t level;
+
+    fn_level_solve(2000, 2000, VDD_MV, &level);
+    CHECK(level.offset == fn_level_code(&level, 0));
+    CHECK(FN_LEVEL_MAX_CODE == fn_level_code(&level, level.amplitude));
+
+    // Codes only rise with input, flattening at the rails
+    fn_level_solve(VDD_MV, -1000, VDD_MV, &level);
+    CHECK(0 == fn_level_code(&level, 0));
+    CHECK(0 == fn_level_code(&level, -level.offset));
+    CHECK(1 == fn_level_code(&level, -level.offset + 1));
+    for(int code = 1; code <= level.amplitude; code++)
+    {
+        CHECK(fn_level_code(&level, code) >= fn_level_code(&level, code - 1));
+    }
+
+    // Offset far beyond either rail pins every code to it
+    fn_level_solve(1000, -VDD_MV, VDD_MV, &level);
+    CHECK(0 == fn_level_code(&level, level.amplitude));
+    fn_level_solve(1000, VDD_MV, VDD_MV, &level);
+    CHECK(FN_LEVEL_MAX_CODE == fn_level_code(&level, 0));
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,345 @@
+/**
+ * @file test_fn_noise.c
+ *
+ * @brief   Host unit tests of the noise generators and of how noise is rendered into the DAC range
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_noise.h"
+#include "fn_render.h"
+#include "fn_wavetable.h"
+#include "fn_wavetable_data.h"
+#include "test_check.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define PI (3.14159265358979323846)
+
+#define FFT_BITS    (12)             // Spectrum is averaged over blocks of this many samples
+#define FFT_LEN     (1 << FFT_BITS)
+#define FFT_BLOCKS  (64)             // Blocks averaged, band power is then good to about 0.1 dB
+#define OCTAVE_LOW  (2)              // Octave bands [2^k, 2^(k+1)) bins checked, lower ones hold too few bins
+#define OCTAVE_HIGH (FFT_BITS - 2)  // Last octave ends at Nyquist
+
+#define WHITE_MAX_SLOPE_DB (0.3) // White noise band power density must not tilt more than this per octave
+#define PINK_SLOPE_DB      (-3.0103)
+#define PINK_MAX_SLOPE_ERR (0.3) // Allowed error of fitted pink slope per octave
+#define PINK_MAX_RIPPLE_DB (1.0) // Voss-McCartney ripples around the fitted line, no band may be further off
+
+#define HIST_SAMPLES   (1 << 20)
+#define HIST_BIN_SIGMA (0.5) // Histogram bin width in sigma
+#define HIST_BINS      (12)  // Bins span -3 to 3 sigma
+#define HIST_MAX_ERR   (0.004) // Allowed difference between bin probability and normal distribution
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Fills band power densities of noise averaged over FFT_BLOCKS blocks
+ *
+ * @param fill Noise generator
+ * @param p_band_db [out] Mean power per bin of octave bands in dB, indexed by octave
+ * @return double Slope of band power density in dB per octave fitted over OCTAVE_LOW to OCTAVE_HIGH
+ */
+static double _octave_bands(fn_noise_fill_t fill, double *p_band_db);
+
+/**
+ * @brief In place radix-2 FFT
+ *
+ * @param p_re Real parts
+ * @param p_im Imaginary parts
+ */
+static void _fft(double *p_re, double *p_im);
+
+static void _test_white(void);
+static void _test_pink(void);
+static void _test_gaussian(void);
+static void _test_render_clip(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+static double _re[FFT_LEN];
+static double _im[FFT_LEN];
+static double _power[FFT_LEN / 2];
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    fn_wavetable_init();
+
+    _test_white();
+    _test_pink();
+    _test_gaussian();
+    _test_render_clip();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _test_white(void)
+{
+    double band_db[FFT_BITS];
+    double slope = _octave_bands(fn_noise_white_fill, band_db);
+
+    printf("white slope %+.3f dB/octave\n", slope);
+    CHECK(fabs(slope) < WHITE_MAX_SLOPE_DB);
+
+    // Uniform over the whole Q15 range
+    fn_noise_t noise;
+    int16_t    block[FN_NOISE_BLOCK_LEN];
+    double     sum    = 0.0;
+    double     sum_sq = 0.0;
+    int        low    = 0;
+    int        high   = 0;
+
+    fn_noise_init(&noise, 1);
+    for(int n = 0; n < HIST_SAMPLES; n += FN_NOISE_BLOCK_LEN)
+    {
+        fn_noise_white_fill(&noise, block, FN_NOISE_BLOCK_LEN);
+        for(int i = 0; i < FN_NOISE_BLOCK_LEN; i++)
+        {
+            sum    += block[i];
+            sum_sq += (double)block[i] * block[i];
+            low     = (block[i] < low) ? block[i] : low;
+            high    = (block[i] > high) ? block[i] : high;
+        }
+    }
+    double mean  = sum / HIST_SAMPLES;
+    double sigma = sqrt(sum_sq / HIST_SAMPLES - mean * mean);
+    CHECK(fabs(mean) < 100.0);
+    CHECK(fabs(sigma / (32768.0 / sqrt(3.0)) - 1.0) < 0.01);
+    CHECK(low < -32700);
+    CHECK(high > 32700);
+}
+
+static void _test_pink(void)
+{
+    double band_db[FFT_BITS];
+    double slope = _octave_bands(fn_noise_pink_fill, band_db);
+
+    printf("pink slope %+.3f dB/octave\n", slope);
+    CHECK(fabs(slope - PINK_SLOPE_DB) < PINK_MAX_SLOPE_ERR);
+
+    // Every octave on the line through the middle one
+    const int mid = (OCTAVE_LOW + OCTAVE_HIGH) / 2;
+    for(int k = OCTAVE_LOW; k <= OCTAVE_HIGH; k++)
+    {
+        double expected = band_db[mid] + PINK_SLOPE_DB * (k - mid);
+        if(fabs(band_db[k] - expected) > PINK_MAX_RIPPLE_DB)
+        {
+            printf("FAIL pink octave %d is %.2f dB off\n", k, band_db[k] - expected);
+            _failures++;
+        }
+    }
+}
+
+static void _test_gaussian(void)
+{
+    // Table itself is symmetric and its tails stop inside Q15
+    for(int i = 0; i < FN_WT_DATA_ICDF_LEN; i++)
+    {
+        CHECK(fn_wt_data_gauss_icdf[i] == -fn_wt_data_gauss_icdf[FN_WT_DATA_ICDF_LEN - 1 - i]);
+        CHECK((0 == i) || (fn_wt_data_gauss_icdf[i] >= fn_wt_data_gauss_icdf[i - 1]));
+    }
+
+    fn_noise_t noise;
+    int16_t    block[FN_NOISE_BLOCK_LEN];
+    int        hist[HIST_BINS] = { 0 };
+    double     moments[5]      = { 0 };
+
+    fn_noise_init(&noise, 7);
+    for(int n = 0; n < HIST_SAMPLES; n += FN_NOISE_BLOCK_LEN)
+    {
+        fn_noise_gaussian_fill(&noise, block, FN_NOISE_BLOCK_LEN);
+        for(int i = 0; i < FN_NOISE_BLOCK_LEN; i++)
+        {
+            double x = (double)block[i] / FN_WT_DATA_GAUSS_SIGMA;
+            double p = 1.0;
+            for(int m = 0; m < 5; m++, p *= x)
+            {
+                moments[m] += p;
+            }
+            int bin = (int)floor(x / HIST_BIN_SIGMA) + HIST_BINS / 2;
+            if((bin >= 0) && (bin < HIST_BINS))
+            {
+                hist[bin]++;
+            }
+        }
+    }
+
+    double mean     = moments[1] / moments[0];
+    double variance = moments[2] / moments[0] - mean * mean;
+    double skew     = (moments[3] / moments[0]) / pow(variance, 1.5);
+    double kurtosis = (moments[4] / moments[0]) / (variance * variance);
+    printf("gaussian mean %+.4f sigma %.4f skew %+.4f kurtosis %.4f\n", mean, sqrt(variance), skew, kurtosis);
+
+    // Tails beyond the last table entry are cut, so sigma and kurtosis are a little below a true normal's
+    CHECK(fabs(mean) < 0.01);
+    CHECK(fabs(sqrt(variance) - 1.0) < 0.02);
+    CHECK(fabs(skew) < 0.02);
+    CHECK(fabs(kurtosis - 3.0) < 0.1);
+
+    for(int b = 0; b < HIST_BINS; b++)
+    {
+        double lo       = (b - HIST_BINS / 2) * HIST_BIN_SIGMA;
+        double expected = 0.5 * (erf((lo + HIST_BIN_SIGMA) / sqrt(2.0)) - erf(lo / sqrt(2.0)));
+        double measured = (double)hist[b] / HIST_SAMPLES;
+        if(fabs(measured - expected) > HIST_MAX_ERR)
+        {
+            printf("FAIL gaussian bin %+.1f sigma holds %.4f, normal %.4f\n", lo, measured, expected);
+            _failures++;
+        }
+    }
+}
+
+static void _test_render_clip(void)
+{
+    // Swing half above VDD, noise must run flat into the rail like the periodic waveforms do
+    static fn_gen_channel_t ch;
+    uint8_t                 lut[FN_CAL_CODES];
+    fn_signal_config_t      config = {
+             .signal = FN_SIGNAL_NOISE_WHITE, .frequency_Hz = 1000, .amplitude_mV = 2000, .offset_mV = 2300
+    };
+
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        lut[k] = (uint8_t)k;
+    }
+    memset(&ch, 0, sizeof(ch));
+    fn_noise_init(&ch._noise, 3);
+    fn_render_prepare(&ch._bank[0], &config, lut);
+
+    const fn_gen_bank_t *p_bank   = &ch._bank[0];
+    const int            bottom   = 2300 * 255 / VDD;
+    int                  at_rail  = 0;
+    int                  at_floor = 0;
+    int                  low      = 255;
+    for(int n = 0; n < HIST_SAMPLES; n++)
+    {
+        uint8_t value = p_bank->tick(&ch, p_bank);
+        at_rail      += (255 == value);
+        at_floor     += (value <= bottom + 1);
+        low           = (value < low) ? value : low;
+    }
+
+    // Part above VDD piles up at the rail instead of squeezing the whole swing under it
+    double expected = (2300.0 + 2000.0 - VDD) / 2000.0;
+    printf("noise at rail %.4f, expected %.4f\n", (double)at_rail / HIST_SAMPLES, expected);
+    CHECK(fabs((double)at_rail / HIST_SAMPLES - expected) < 0.01);
+    CHECK(abs(low - bottom) <= 1);
+    CHECK(at_floor > 0);
+    CHECK(p_bank->idle == p_bank->mid);
+}
+
+static double _octave_bands(fn_noise_fill_t fill, double *p_band_db)
+{
+    fn_noise_t noise;
+    int16_t    block[FN_NOISE_BLOCK_LEN];
+
+    fn_noise_init(&noise, 0);
+    memset(_power, 0, sizeof(_power));
+    for(int b = 0; b < FFT_BLOCKS; b++)
+    {
+        for(int i = 0; i < FFT_LEN; i += FN_NOISE_BLOCK_LEN)
+        {
+            fill(&noise, block, FN_NOISE_BLOCK_LEN);
+            for(int j = 0; j < FN_NOISE_BLOCK_LEN; j++)
+            {
+                // Hann window keeps leakage of the strong low bins out of the weak high ones
+                _re[i + j] = block[j] * (0.5 - 0.5 * cos(2.0 * PI * (i + j) / FFT_LEN));
+                _im[i + j] = 0.0;
+            }
+        }
+        _fft(_re, _im);
+        for(int k = 0; k < FFT_LEN / 2; k++)
+        {
+            _power[k] += _re[k] * _re[k] + _im[k] * _im[k];
+        }
+    }
+
+    // Least squares line through band densities
+    double sx  = 0.0;
+    double sy  = 0.0;
+    double sxx = 0.0;
+    double sxy = 0.0;
+    int    n   = 0;
+    for(int k = OCTAVE_LOW; k <= OCTAVE_HIGH; k++)
+    {
+        double sum = 0.0;
+        for(int bin = 1 << k; bin < (2 << k); bin++)
+        {
+            sum += _power[bin];
+        }
+        p_band_db[k] = 10.0 * log10(sum / (1 << k));
+
+        sx  += k;
+        sy  += p_band_db[k];
+        sxx += (double)k * k;
+        sxy += k * p_band_db[k];
+        n++;
+    }
+    return (n * sxy - sx * sy) / (n * sxx - sx * sx);
+}
+
+static void _fft(double *p_re, double *p_im)
+{
+    for(int i = 1, j = 0; i < FFT_LEN; i++)
+    {
+        int bit = FFT_LEN >> 1;
+        for(; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if(i < j)
+        {
+            double t = p_re[i];
+            p_re[i]  = p_re[j];
+            p_re[j]  = t;
+            t        = p_im[i];
+            p_im[i]  = p_im[j];
+            p_im[j]  = t;
+        }
+    }
+
+    for(int len = 2; len <= FFT_LEN; len <<= 1)
+    {
+        double w_re = cos(-2.0 * PI / len);
+        double w_im = sin(-2.0 * PI / len);
+        for(int i = 0; i < FFT_LEN; i += len)
+        {
+            double c_re = 1.0;
+            double c_im = 0.0;
+            for(int j = 0; j < len / 2; j++)
+            {
+                double *p_a_re = &p_re[i + j];
+                double *p_a_im = &p_im[i + j];
+                double  b_re   = p_re[i + j + len / 2] * c_re - p_im[i + j + len / 2] * c_im;
+                double  b_im   = p_re[i + j + len / 2] * c_im + p_im[i + j + len / 2] * c_re;
+
+                p_re[i + j + len / 2] = *p_a_re - b_re;
+                p_im[i + j + len / 2] = *p_a_im - b_im;
+                *p_a_re += b_re;
+                *p_a_im += b_im;
+
+                double t = c_re * w_re - c_im * w_im;
+                c_im     = c_re * w_im + c_im * w_re;
+                c_re     = t;
+            }
+        }
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
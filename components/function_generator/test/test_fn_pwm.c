@@ -0,0 +1,172 @@
+/**
+ * @file test_fn_pwm.c
+ *
+ * @brief   Host unit tests of the LEDC timer settings solver
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_pwm.h"
+#include "test_check.h"
+#include <math.h>
+#include <stdio.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define CLK_HZ      (80000000) // APB clock, same as PWM_CLK_HZ
+#define FREQ_MAX_HZ (10000000) // Same as FN_GEN_MAX_PWM_FREQ_HZ
+#define SWEEP_STEP  (1.003)    // Ratio between swept frequencies
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Returns fewest resolution bits that keep duty within FN_PWM_MAX_DUTY_ERR_PPM
+ *
+ * @param duty_cycle_percentage Duty cycle
+ * @return int Resolution bits
+ */
+static int _duty_bits(int duty_cycle_percentage);
+
+static void _test_duty_error(void);
+static void _test_sweep(void);
+static void _test_top(void);
+static void _test_invalid(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    _test_duty_error();
+    _test_sweep();
+    _test_top();
+    _test_invalid();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _test_duty_error(void)
+{
+    // Integer duty error against double precision, truncated to whole ppm
+    for(int res = FN_PWM_RES_MIN; res <= FN_PWM_RES_MAX; res++)
+    {
+        for(int pct = 0; pct <= 100; pct++)
+        {
+            double counts = floor(pct * (double)(1 << res) / 100.0 + 0.5);
+            double exact  = fabs(counts / (1 << res) - pct / 100.0) * 1e6;
+            CHECK(fabs(fn_pwm_duty_error_ppm(pct, res) - exact) < 1.0);
+        }
+    }
+    CHECK(0 == fn_pwm_duty_error_ppm(50, 1));
+    CHECK(0 == fn_pwm_duty_error_ppm(75, 2));
+    CHECK(50000 == fn_pwm_duty_error_ppm(30, 3));
+}
+
+static void _test_sweep(void)
+{
+    // Duty stays within FN_PWM_MAX_DUTY_ERR_PPM and frequency within FN_PWM_MAX_FREQ_ERR_PPM wherever the timer can
+    // count enough steps per period for them, above that the errors are reported
+    uint32_t worst_freq_ppm = 0;
+    uint32_t worst_duty_ppm = 0;
+    double   duty_limit_Hz  = FREQ_MAX_HZ;
+
+    for(double f = 1.0; f <= FREQ_MAX_HZ; f *= SWEEP_STEP)
+    {
+        uint32_t freq = (uint32_t)f;
+        for(int pct = 0; pct <= 100; pct++)
+        {
+            fn_pwm_params_t pwm;
+            if(!fn_pwm_solve(CLK_HZ, freq, pct, &pwm))
+            {
+                printf("FAIL no timer settings for %u Hz %d%%\n", freq, pct);
+                _failures++;
+                continue;
+            }
+
+            // Frequency is off by more than FN_PWM_MAX_FREQ_ERR_PPM only by the rounding of a divider step
+            uint32_t freq_ppm = fn_pwm_error_ppm(CLK_HZ, freq, pwm.divider, pwm.resolution_bits);
+            CHECK((freq_ppm <= FN_PWM_MAX_FREQ_ERR_PPM) || (freq_ppm <= 500000 / pwm.divider + 1));
+            CHECK(pwm.actual_mHz == fn_pwm_actual_mHz(CLK_HZ, pwm.divider, pwm.resolution_bits));
+            CHECK((pwm.divider >= FN_PWM_DIV_MIN) && (pwm.divider <= FN_PWM_DIV_MAX));
+            CHECK(pwm.duty <= (1u << pwm.resolution_bits));
+            CHECK(pwm.duty_err_ppm == fn_pwm_duty_error_ppm(pct, pwm.resolution_bits));
+
+            // Timer needs 2^bits clock cycles per period for duty resolution, and twice that leaves the divider enough
+            // fraction bits for the frequency. Above that errors are traded off and reported.
+            int    bits   = _duty_bits(pct);
+            double cycles = (double)CLK_HZ / freq;
+            if(cycles >= (double)(2 << bits))
+            {
+                CHECK(pwm.duty_err_ppm <= FN_PWM_MAX_DUTY_ERR_PPM);
+                CHECK(freq_ppm <= FN_PWM_MAX_FREQ_ERR_PPM);
+            }
+            else if(pwm.duty_err_ppm > FN_PWM_MAX_DUTY_ERR_PPM)
+            {
+                duty_limit_Hz = (f < duty_limit_Hz) ? f : duty_limit_Hz;
+            }
+
+            worst_freq_ppm = (freq_ppm > worst_freq_ppm) ? freq_ppm : worst_freq_ppm;
+            worst_duty_ppm = (pwm.duty_err_ppm > worst_duty_ppm) ? pwm.duty_err_ppm : worst_duty_ppm;
+        }
+    }
+    printf("worst frequency error %u ppm, duty error %u ppm, duty is off above %.0f Hz\n", worst_freq_ppm,
+           worst_duty_ppm, duty_limit_Hz);
+}
+
+static void _test_top(void)
+{
+    // At 10 MHz timer counts 8 steps, duty comes in 12.5 % steps and the rest is reported
+    fn_pwm_params_t pwm;
+
+    CHECK(fn_pwm_solve(CLK_HZ, FREQ_MAX_HZ, 50, &pwm));
+    CHECK(3 == pwm.resolution_bits);
+    CHECK(4 == pwm.duty);
+    CHECK(0 == pwm.duty_err_ppm);
+    CHECK(0 == fn_pwm_error_ppm(CLK_HZ, FREQ_MAX_HZ, pwm.divider, pwm.resolution_bits));
+
+    CHECK(fn_pwm_solve(CLK_HZ, FREQ_MAX_HZ, 30, &pwm));
+    CHECK(2 == pwm.duty);
+    CHECK(pwm.duty_err_ppm > FN_PWM_MAX_DUTY_ERR_PPM);
+
+    // Half the frequency doubles the steps
+    CHECK(fn_pwm_solve(CLK_HZ, FREQ_MAX_HZ / 2, 25, &pwm));
+    CHECK(4 == pwm.resolution_bits);
+    CHECK(0 == pwm.duty_err_ppm);
+
+    // Low frequency keeps the finest resolution
+    CHECK(fn_pwm_solve(CLK_HZ, 1000, 33, &pwm));
+    CHECK(pwm.duty_err_ppm <= FN_PWM_MAX_DUTY_ERR_PPM);
+    CHECK(pwm.resolution_bits >= 14);
+}
+
+static void _test_invalid(void)
+{
+    fn_pwm_params_t pwm;
+
+    CHECK(!fn_pwm_solve(CLK_HZ, 0, 50, &pwm));
+    CHECK(!fn_pwm_solve(CLK_HZ, 1000, -1, &pwm));
+    CHECK(!fn_pwm_solve(CLK_HZ, 1000, 101, &pwm));
+    // Above clock / 2 no resolution fits
+    CHECK(!fn_pwm_solve(CLK_HZ, CLK_HZ, 50, &pwm));
+}
+
+static int _duty_bits(int duty_cycle_percentage)
+{
+    int res = FN_PWM_RES_MIN;
+    while(fn_pwm_duty_error_ppm(duty_cycle_percentage, res) > FN_PWM_MAX_DUTY_ERR_PPM)
+    {
+        res++;
+    }
+    return res;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
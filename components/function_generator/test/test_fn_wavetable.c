@@ -0,0 +1,216 @@
+/**
+ * @file test_fn_wavetable.c
+ *
+ * @brief   Host unit tests of the unit wavetables the firmware builds from the generated data
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_wavetable.h"
+#include "fn_wavetable_data.h"
+#include "test_check.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define TWO_PI (6.283185307179586476925)
+
+#define SINE_MAX_ERR_LSB (0.5)  // Q15 samples are rounded to nearest, so no sample is further than half an LSB off
+#define ALIAS_MAX_LSB    (1.0)  // Amplitude of any harmonic a mip level must not hold, rounding noise stays far below
+#define LEN              (FN_GEN_POINT_ARR_LEN)
+#define NYQUIST_PHASE    (1ull << 31) // Phase increment per sample of a harmonic at Nyquist
+#define LEVEL_TW(l)      ((uint32_t)(NYQUIST_PHASE >> ((l) + 1))) // Tuning word the firmware serves level l for
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Returns amplitude of harmonic in one period of table
+ *
+ * @param p_table Table
+ * @param k Harmonic number
+ * @return double Amplitude in LSB
+ */
+static double _harmonic(const int16_t *p_table, int k);
+
+/**
+ * @brief Returns number of harmonics mip level holds
+ *
+ * @param level Mip level
+ * @return int Harmonics
+ */
+static int _level_harmonics(int level);
+
+/**
+ * @brief Returns mip level of table returned for shape
+ *
+ * @param type Waveform type
+ * @param p_table Returned table
+ * @return int Level, -1 if table is none of them
+ */
+static int _level_of(fn_signal_type_t type, const int16_t *p_table);
+
+static void _test_sine(void);
+static void _test_peak(void);
+static void _test_band_limit(void);
+static void _test_mip_select(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+static const fn_signal_type_t _mip_types[] = { FN_SIGNAL_SQUARE, FN_SIGNAL_TRIANGLE, FN_SIGNAL_SAWTOOTH };
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    fn_wavetable_init();
+
+    _test_sine();
+    _test_peak();
+    _test_band_limit();
+    _test_mip_select();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _test_sine(void)
+{
+    // Every sample of the unfolded period, whatever tuning word asks for it, against double precision sine
+    const uint32_t tws[] = { 0, 1, NYQUIST_PHASE - 1, UINT32_MAX };
+    double         worst = 0.0;
+
+    for(size_t t = 0; t < sizeof(tws) / sizeof(tws[0]); t++)
+    {
+        const int16_t *p_sine = fn_wavetable_get(FN_SIGNAL_SINE, tws[t]);
+        CHECK(NULL != p_sine);
+        for(int i = 0; (NULL != p_sine) && (i < LEN); i++)
+        {
+            double err = fabs(p_sine[i] - sin(TWO_PI * i / LEN) * FN_WT_FULL_SCALE);
+            worst      = (err > worst) ? err : worst;
+            if(err > SINE_MAX_ERR_LSB)
+            {
+                printf("FAIL sine sample %d is %d, %.3f LSB off\n", i, p_sine[i], err);
+                _failures++;
+            }
+        }
+    }
+    printf("sine worst error %.3f LSB, bound %.1f LSB\n", worst, SINE_MAX_ERR_LSB);
+
+    // Symmetry points are exact
+    const int16_t *p_sine = fn_wavetable_get(FN_SIGNAL_SINE, 0);
+    CHECK(0 == p_sine[0]);
+    CHECK(FN_WT_FULL_SCALE == p_sine[LEN / 4]);
+    CHECK(0 == p_sine[LEN / 2]);
+    CHECK(-FN_WT_FULL_SCALE == p_sine[3 * LEN / 4]);
+}
+
+static void _test_peak(void)
+{
+    // Every level is peak normalized and stays inside Q15
+    for(size_t t = 0; t < sizeof(_mip_types) / sizeof(_mip_types[0]); t++)
+    {
+        for(int level = 0; level < FN_WT_MIP_LEVELS; level++)
+        {
+            const int16_t *p_table = fn_wavetable_get(_mip_types[t], LEVEL_TW(level));
+            int            peak    = 0;
+            CHECK(level == _level_of(_mip_types[t], p_table));
+            for(int i = 0; i < LEN; i++)
+            {
+                CHECK(abs(p_table[i]) <= FN_WT_FULL_SCALE);
+                peak = (abs(p_table[i]) > peak) ? abs(p_table[i]) : peak;
+            }
+            CHECK(FN_WT_FULL_SCALE == peak);
+        }
+    }
+    CHECK(NULL == fn_wavetable_get(FN_SIGNAL_NOISE_WHITE, 0));
+}
+
+static void _test_band_limit(void)
+{
+    // Level L keeps its harmonics and holds nothing above them
+    for(size_t t = 0; t < sizeof(_mip_types) / sizeof(_mip_types[0]); t++)
+    {
+        for(int level = 0; level < FN_WT_MIP_LEVELS; level++)
+        {
+            const int16_t *p_table   = fn_wavetable_get(_mip_types[t], LEVEL_TW(level));
+            int            harmonics = _level_harmonics(level);
+
+            CHECK(_harmonic(p_table, 1) > FN_WT_FULL_SCALE / 2);
+            for(int k = harmonics + 1; k <= LEN / 2; k++)
+            {
+                double amplitude = _harmonic(p_table, k);
+                if(amplitude > ALIAS_MAX_LSB)
+                {
+                    printf("FAIL type %d level %d holds harmonic %d at %.2f LSB\n", _mip_types[t], level, k, amplitude);
+                    _failures++;
+                }
+            }
+        }
+    }
+}
+
+static void _test_mip_select(void)
+{
+    // Highest harmonic of the picked level stays below Nyquist, and the next level would alias unless it's the last
+    for(uint64_t tw = 1; tw <= UINT32_MAX; tw = tw * 3 / 2 + 1)
+    {
+        for(size_t t = 0; t < sizeof(_mip_types) / sizeof(_mip_types[0]); t++)
+        {
+            int level = _level_of(_mip_types[t], fn_wavetable_get(_mip_types[t], (uint32_t)tw));
+            CHECK(level >= 0);
+            if(level > 0)
+            {
+                CHECK((uint64_t)_level_harmonics(level) * tw < NYQUIST_PHASE);
+            }
+            if(level < FN_WT_MIP_LEVELS - 1)
+            {
+                CHECK((uint64_t)_level_harmonics(level + 1) * tw >= NYQUIST_PHASE);
+            }
+        }
+    }
+}
+
+static double _harmonic(const int16_t *p_table, int k)
+{
+    double re = 0.0;
+    double im = 0.0;
+
+    for(int i = 0; i < LEN; i++)
+    {
+        re += p_table[i] * cos(TWO_PI * k * i / LEN);
+        im += p_table[i] * sin(TWO_PI * k * i / LEN);
+    }
+    // Nyquist bin has no second half to add up with
+    return ((LEN / 2 == k) ? 1.0 : 2.0) * sqrt(re * re + im * im) / LEN;
+}
+
+static int _level_harmonics(int level)
+{
+    int harmonics = 1 << level;
+    return (harmonics < LEN / 2 - 1) ? harmonics : LEN / 2 - 1;
+}
+
+static int _level_of(fn_signal_type_t type, const int16_t *p_table)
+{
+    for(int level = 0; level < FN_WT_MIP_LEVELS; level++)
+    {
+        if(((FN_SIGNAL_SQUARE == type) && (p_table == fn_wt_data_square[level])) ||
+           ((FN_SIGNAL_TRIANGLE == type) && (p_table == fn_wt_data_triangle[level])) ||
+           ((FN_SIGNAL_SAWTOOTH == type) && (p_table == fn_wt_data_saw[level])))
+        {
+            return level;
+        }
+    }
+    return -1;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,140 @@
+#!/usr/bin/env python
+#
+# Generates band-limited unit wavetables for the function generator.
+#
+# COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+# All rights reserved.
+#
+# Sine is stored as a quarter period, firmware unfolds it by symmetry. Every other shape gets one table per octave
+# (mip level). Level L holds 2^L harmonics, so a tuning word whose highest harmonic is still below Nyquist always has
+# a matching level. Last level holds as many harmonics as the table length can represent. Tables are Q15 and peak
+# normalized. Gaussian noise comes from an inverse CDF table indexed by uniform random bits.
+
+import argparse
+import math
+import os
+import statistics
+
+FULL_SCALE = 32767
+ICDF_BITS = 10       # Inverse CDF table index width, tails reach 3.3 sigma
+GAUSS_SIGMA = 8192   # Standard deviation of Gaussian noise, +-4 sigma spans the Q15 range
+
+
+def lanczos(k, harmonics):
+    # Sigma factor, tames Gibbs ringing of truncated series
+    x = math.pi * k / (harmonics + 1)
+    return math.sin(x) / x
+
+
+def saw(x, harmonics):
+    # Rises from -1 at phase 0 to 1 at the end of the period
+    return sum(-2 / math.pi * math.sin(k * x) / k * lanczos(k, harmonics) for k in range(1, harmonics + 1))
+
+
+def triangle(x, harmonics):
+    # -1 at phase 0, 1 at half period
+    return sum(-8 / math.pi ** 2 * math.cos(k * x) / k ** 2 for k in range(1, harmonics + 1, 2))
+
+
+def square(x, harmonics):
+    # 1 in the first half of the period, -1 in the second
+    return sum(4 / math.pi * math.sin(k * x) / k * lanczos(k, harmonics) for k in range(1, harmonics + 1, 2))
+
+
+def build_sine_quarter(length):
+    # Quarter period including both ends, 0 and peak
+    return [int(round(math.sin(2 * math.pi * i / length) * FULL_SCALE)) for i in range(length // 4 + 1)]
+
+
+def build_gauss_icdf(bits):
+    # Entry i is inverse CDF at the middle of its probability bin, so every entry is equally likely
+    length = 1 << bits
+    dist = statistics.NormalDist(0, GAUSS_SIGMA)
+    return [int(round(dist.inv_cdf((i + 0.5) / length))) for i in range(length)]
+
+
+def check_gauss_icdf(table):
+    # Table is drawn uniformly, so its own moments are the moments of the noise. Tails are cut, sigma drops a bit.
+    mean = statistics.fmean(table)
+    sigma = statistics.pstdev(table)
+    if abs(mean) > 0.5 or abs(sigma - GAUSS_SIGMA) > 0.02 * GAUSS_SIGMA:
+        raise ValueError('Gaussian table has mean %f and sigma %f' % (mean, sigma))
+
+
+def build_level(shape, length, harmonics):
+    values = [shape(2 * math.pi * i / length, harmonics) for i in range(length)]
+    peak = max(abs(v) for v in values)
+    return [int(round(v / peak * FULL_SCALE)) for v in values]
+
+
+def format_array(values):
+    return ['        ' + ', '.join('%6d' % v for v in values[i:i + 12]) + ',' for i in range(0, len(values), 12)]
+
+
+def format_flat(name, size, values, attr=''):
+    lines = ['%sconst int16_t %s[%s] = {' % (attr, name, size)] + [line[4:] for line in format_array(values)]
+    return '\n'.join(lines + ['};'])
+
+
+def format_table(name, tables):
+    lines = ['DRAM_ATTR const int16_t %s[FN_WT_DATA_LEVELS][FN_WT_DATA_LEN] = {' % name]
+    for level, table in enumerate(tables):
+        lines.append('    // Level %d' % level)
+        lines.append('    {')
+        lines.extend(format_array(table))
+        lines.append('    },')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generates band-limited function generator wavetables')
+    parser.add_argument('--bits', type=int, required=True, help='table index width in bits')
+    parser.add_argument('--levels', type=int, required=True, help='number of mip levels')
+    parser.add_argument('--out-dir', required=True)
+    args = parser.parse_args()
+
+    length = 1 << args.bits
+    max_harmonics = length // 2 - 1
+    harmonics = [min(1 << level, max_harmonics) for level in range(args.levels)]
+
+    # Firmware unfolding of the quarter is checked against double precision sine by test/test_fn_wavetable.c
+    sine_quarter = build_sine_quarter(length)
+
+    gauss_icdf = build_gauss_icdf(ICDF_BITS)
+    check_gauss_icdf(gauss_icdf)
+
+    shapes = [('fn_wt_data_saw', saw), ('fn_wt_data_triangle', triangle), ('fn_wt_data_square', square)]
+
+    header = '\n'.join([
+        '// Generated by gen_wavetables.py, do not edit',
+        '#pragma once',
+        '#include <stdint.h>',
+        '',
+        '#define FN_WT_DATA_BITS   (%d)' % args.bits,
+        '#define FN_WT_DATA_LEN    (%d)' % length,
+        '#define FN_WT_DATA_LEVELS (%d)' % args.levels,
+        '',
+        '#define FN_WT_DATA_ICDF_BITS   (%d)' % ICDF_BITS,
+        '#define FN_WT_DATA_ICDF_LEN    (%d)' % len(gauss_icdf),
+        '#define FN_WT_DATA_GAUSS_SIGMA (%d)' % GAUSS_SIGMA,
+        '',
+        'extern const int16_t fn_wt_data_sine_quarter[FN_WT_DATA_LEN / 4 + 1];',
+        'extern const int16_t fn_wt_data_gauss_icdf[FN_WT_DATA_ICDF_LEN];',
+    ] + ['extern const int16_t %s[FN_WT_DATA_LEVELS][FN_WT_DATA_LEN];' % name for name, _ in shapes]) + '\n'
+
+    source = '\n\n'.join([
+        '// Generated by gen_wavetables.py, do not edit\n#include "fn_wavetable_data.h"\n#include "esp_attr.h"',
+        format_flat('fn_wt_data_sine_quarter', 'FN_WT_DATA_LEN / 4 + 1', sine_quarter),
+        # Tables the sample ISR reads (noise and modulation shapes) stay in DRAM, reachable while flash is written
+        format_flat('fn_wt_data_gauss_icdf', 'FN_WT_DATA_ICDF_LEN', gauss_icdf, 'DRAM_ATTR '),
+    ] + [format_table(name, [build_level(shape, length, h) for h in harmonics]) for name, shape in shapes]) + '\n'
+
+    with open(os.path.join(args.out_dir, 'fn_wavetable_data.h'), 'w') as f:
+        f.write(header)
+    with open(os.path.join(args.out_dir, 'fn_wavetable_data.c'), 'w') as f:
+        f.write(source)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,146 @@
+/**
+ * @file render_bench.c
+ *
+ * @brief   Host benchmark of the per-sample DDS render functions
+ *
+ * Every modulation type, noise type and trigger mode is prepared into a bank by fn_render_prepare() and its tick
+ * function is called the way the timer ISR calls it. Time per sample is printed in ns, and in host cycles if the host
+ * clock is given. Host numbers don't carry over to the ESP32, but their ratios show what a modulation costs compared
+ * with the plain carrier, and a change to a render function that makes it slower shows up here first.
+ *
+ * Built with the host tests by test/CMakeLists.txt in the project root, but not run by ctest:
+ *
+ *     ./render_bench [host_MHz]
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_render.h"
+#include "fn_wavetable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define BENCH_SAMPLES (4000000) // Samples rendered per case, a bit over two minutes of output
+#define BENCH_RUNS    (5)       // Runs per case, the fastest one is reported
+
+//-------------------------------- DATA TYPES ---------------------------------
+typedef struct
+{
+    const char        *p_name;
+    fn_signal_config_t config;
+} bench_case_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Renders samples of case and returns the fastest run
+ *
+ * @param p_case Case to render
+ * @param p_sum [out] Sum of samples, printed so the compiler can't drop rendering
+ * @return double ns per sample
+ */
+static double _run(const bench_case_t *p_case, uint32_t *p_sum);
+
+/**
+ * @brief Returns monotonic time
+ *
+ * @return double Time in ns
+ */
+static double _now_ns(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+#define CARRIER .frequency_Hz = 1000, .amplitude_mV = 3000, .offset_mV = 150, .duty_cycle_percentage = 50
+
+static const bench_case_t _cases[] = {
+    { "none", { FN_SIGNAL_SINE, CARRIER } },
+    { "AM", { FN_SIGNAL_SINE, CARRIER, .modulation = { FN_MOD_AM, FN_SIGNAL_SINE, 50, 80 } } },
+    { "FM", { FN_SIGNAL_SINE, CARRIER, .modulation = { FN_MOD_FM, FN_SIGNAL_SINE, 50, 500 } } },
+    { "PM", { FN_SIGNAL_SINE, CARRIER, .modulation = { FN_MOD_PM, FN_SIGNAL_TRIANGLE, 50, 90 } } },
+    { "PWM", { FN_SIGNAL_SQUARE, CARRIER, .modulation = { FN_MOD_PWM, FN_SIGNAL_SINE, 50, 40 } } },
+    { "white noise", { FN_SIGNAL_NOISE_WHITE, CARRIER } },
+    { "pink noise", { FN_SIGNAL_NOISE_PINK, CARRIER } },
+    { "gaussian noise", { FN_SIGNAL_NOISE_GAUSSIAN, CARRIER } },
+    { "burst", { FN_SIGNAL_SINE, CARRIER, .trigger = { FN_TRIG_BURST, 3, 1, -1 } } },
+    { "FM burst", { FN_SIGNAL_SINE, CARRIER, .modulation = { FN_MOD_FM, FN_SIGNAL_SINE, 50, 500 },
+                    .trigger = { FN_TRIG_BURST, 3, 1, -1 } } },
+};
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(int argc, char **argv)
+{
+    double host_MHz = (argc > 1) ? strtod(argv[1], NULL) : 0.0;
+
+    fn_wavetable_init();
+
+    printf("%-16s %10s", "case", "ns/sample");
+    if(host_MHz > 0.0)
+    {
+        printf(" %10s", "cycles");
+    }
+    printf(" %10s\n", "vs none");
+
+    double base = 0.0;
+    for(size_t i = 0; i < sizeof(_cases) / sizeof(_cases[0]); i++)
+    {
+        uint32_t sum;
+        double   ns = _run(&_cases[i], &sum);
+        base        = (0 == i) ? ns : base;
+
+        printf("%-16s %10.2f", _cases[i].p_name, ns);
+        if(host_MHz > 0.0)
+        {
+            printf(" %10.1f", ns * host_MHz / 1000.0);
+        }
+        printf(" %9.2fx   (sum %u)\n", ns / base, sum);
+    }
+    return 0;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static double _run(const bench_case_t *p_case, uint32_t *p_sum)
+{
+    static fn_gen_channel_t ch;
+    uint8_t                 lut[FN_CAL_CODES];
+    double                  best = 0.0;
+
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        lut[k] = (uint8_t)k;
+    }
+
+    memset(&ch, 0, sizeof(ch));
+    fn_noise_init(&ch._noise, 0x9E3779B9u);
+    fn_render_prepare(&ch._bank[0], &p_case->config, lut);
+
+    // Continuous output calls render straight from the ISR, tick is the same function then
+    const fn_gen_bank_t *p_bank = &ch._bank[0];
+    *p_sum                      = 0;
+    for(int run = 0; run < BENCH_RUNS; run++)
+    {
+        double start = _now_ns();
+        for(int s = 0; s < BENCH_SAMPLES; s++)
+        {
+            *p_sum += p_bank->tick(&ch, p_bank);
+        }
+        double ns = (_now_ns() - start) / BENCH_SAMPLES;
+        best      = ((0 == run) || (ns < best)) ? ns : best;
+    }
+    return best;
+}
+
+static double _now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,199 @@
+/**
+ * @file timing_replay.c
+ *
+ * @brief   Host harness replaying recorded output timestamps through the timing statistics
+ *
+ * Timestamps are captured on target with "fn_timing dump", one cycle count per line after a "# nominal <cycles>"
+ * header. Replaying them prints the same statistics as "fn_timing stats", so a saved dump and its output make a
+ * regression test for fn_timing.c. --check runs built-in cases with known results instead.
+ *
+ * Built with the host tests by test/CMakeLists.txt in the project root, which also runs --check.
+ *
+ *     ./timing_replay dump.txt [nominal_cycles]
+ *     ./timing_replay --check
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "fn_timing.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define CHECK_NOMINAL (4800) // 30 us at 160 MHz
+#define CHECK_LEN     (1001)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Prints statistics of timestamps in file
+ *
+ * @param p_path Dump file, "-" for stdin
+ * @param nominal Nominal period, 0 to take it from the dump header
+ * @return int Process exit code
+ */
+static int _replay(const char *p_path, uint32_t nominal);
+
+/**
+ * @brief Runs cases with known statistics
+ *
+ * @return int Process exit code
+ */
+static int _check(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static uint32_t _stamps[CHECK_LEN];
+static uint32_t _scratch[CHECK_LEN];
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(int argc, char **argv)
+{
+    if((argc > 1) && (0 == strcmp(argv[1], "--check")))
+    {
+        return _check();
+    }
+    if(argc < 2)
+    {
+        printf("usage: %s dump.txt|- [nominal_cycles]\n       %s --check\n", argv[0], argv[0]);
+        return 2;
+    }
+    return _replay(argv[1], (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 0);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static int _replay(const char *p_path, uint32_t nominal)
+{
+    FILE *p_file = (0 == strcmp(p_path, "-")) ? stdin : fopen(p_path, "r");
+    if(NULL == p_file)
+    {
+        perror(p_path);
+        return 2;
+    }
+
+    uint32_t *p_stamps = NULL;
+    uint32_t  count    = 0;
+    uint32_t  cap      = 0;
+    char      line[64];
+
+    while(NULL != fgets(line, sizeof(line), p_file))
+    {
+        unsigned long value;
+        if('#' == line[0])
+        {
+            if((0 == nominal) && (1 == sscanf(line, "# nominal %lu", &value)))
+            {
+                nominal = (uint32_t)value;
+            }
+            continue;
+        }
+        if(1 != sscanf(line, "%lu", &value))
+        {
+            continue;
+        }
+        if(count == cap)
+        {
+            cap      = cap ? 2 * cap : 1024;
+            p_stamps = realloc(p_stamps, 2 * cap * sizeof(uint32_t));
+            if(NULL == p_stamps)
+            {
+                return 2;
+            }
+        }
+        p_stamps[count++] = (uint32_t)value;
+    }
+    if(stdin != p_file)
+    {
+        fclose(p_file);
+    }
+
+    if(0 == nominal)
+    {
+        printf("Nominal period is neither in the dump nor given\n");
+        free(p_stamps);
+        return 2;
+    }
+
+    // Buffer holds twice the stamps, second half is scratch
+    fn_timing_stats_t stats;
+    fn_timing_stats(p_stamps, count, nominal, p_stamps + cap, &stats);
+    fn_timing_print(&stats);
+
+    free(p_stamps);
+    return 0;
+}
+
+static int _check(void)
+{
+    fn_timing_stats_t stats;
+
+    // Perfectly regular updates across counter wrap
+    for(uint32_t i = 0; i < CHECK_LEN; i++)
+    {
+        _stamps[i] = UINT32_MAX - 100000 + i * CHECK_NOMINAL;
+    }
+    fn_timing_stats(_stamps, CHECK_LEN, CHECK_NOMINAL, _scratch, &stats);
+    CHECK(CHECK_LEN - 1 == stats.periods);
+    CHECK((CHECK_NOMINAL == stats.min) && (CHECK_NOMINAL == stats.max) && (CHECK_NOMINAL == stats.mean));
+    CHECK(CHECK_NOMINAL == stats.percentile);
+    CHECK(CHECK_LEN - 1 == stats.hist[FN_TIMING_HIST_BINS / 2]);
+
+    // One late update in a hundred: late period and the shortened one after it
+    uint32_t late = 1000;
+    uint32_t t    = 0;
+    for(uint32_t i = 0; i < CHECK_LEN; i++)
+    {
+        _stamps[i] = t + (((i % 100) == 50) ? late : 0);
+        t += CHECK_NOMINAL;
+    }
+    fn_timing_stats(_stamps, CHECK_LEN, CHECK_NOMINAL, _scratch, &stats);
+    CHECK(CHECK_NOMINAL - late == stats.min);
+    CHECK(CHECK_NOMINAL + late == stats.max);
+    CHECK(CHECK_NOMINAL == stats.mean);
+    // 10 late of 1000 periods is exactly the top 1%, so p99 is still nominal
+    CHECK(CHECK_NOMINAL == stats.percentile);
+    // Bins are nominal / 32 = 150 cycles wide, +1000 floors to bin 8 + 6 and -1000 to bin 8 - 7
+    CHECK(10 == stats.hist[FN_TIMING_HIST_BINS / 2 + 6]);
+    CHECK(10 == stats.hist[FN_TIMING_HIST_BINS / 2 - 7]);
+    CHECK(980 == stats.hist[FN_TIMING_HIST_BINS / 2]);
+
+    // One stalled update pushes p99 onto the late period and lands in the open ended top bin
+    _stamps[CHECK_LEN - 1] += 100000;
+    fn_timing_stats(_stamps, CHECK_LEN, CHECK_NOMINAL, _scratch, &stats);
+    CHECK(CHECK_NOMINAL + late == stats.percentile);
+    CHECK(CHECK_NOMINAL + 100000 == stats.max);
+    CHECK(1 == stats.hist[FN_TIMING_HIST_BINS - 1]);
+
+    // Too few stamps
+    fn_timing_stats(_stamps, 1, CHECK_NOMINAL, _scratch, &stats);
+    CHECK(0 == stats.periods);
+
+    // Ring returns the newest stamps oldest first after wrapping
+    uint32_t         storage[8];
+    uint32_t         out[8];
+    fn_timing_ring_t ring;
+    fn_timing_ring_init(&ring, storage, 8);
+    fn_timing_ring_add(&ring, 1);
+    CHECK(0 == ring.count);
+    ring.is_on = true;
+    for(uint32_t i = 0; i < 11; i++)
+    {
+        fn_timing_ring_add(&ring, i);
+    }
+    CHECK(8 == fn_timing_ring_copy(&ring, out, 8));
+    CHECK((3 == out[0]) && (10 == out[7]));
+    CHECK(3 == fn_timing_ring_copy(&ring, out, 3));
+    CHECK((8 == out[0]) && (10 == out[2]));
+
+    return test_check_result();
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
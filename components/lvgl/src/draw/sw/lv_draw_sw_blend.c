@@ -14,10 +14,24 @@
 /*********************
  *      DEFINES
  *********************/
+/*Swapped RGB565 is blended two pixels at once, in 32 bit words*/
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    #define BLEND_565_SWAP  1
+#else
+    #define BLEND_565_SWAP  0
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if BLEND_565_SWAP
+/*A color channel of two pixels in one word, the first pixel's in the low 16 bits*/
+typedef struct {
+    uint32_t r;
+    uint32_t g;
+    uint32_t b;
+} lanes_565_t;
+#endif /*BLEND_565_SWAP*/
 
 /**********************
  *  STATIC PROTOTYPES
@@ -63,6 +77,20 @@ static inline lv_color_t color_blend_true_color_subtractive(lv_color_t fg, lv_co
 static inline lv_color_t color_blend_true_color_multiply(lv_color_t fg, lv_color_t bg, lv_opa_t opa);
 #endif /*LV_DRAW_COMPLEX*/
 
+#if BLEND_565_SWAP
+LV_ATTRIBUTE_FAST_MEM static void fill_opa_565_swap(lv_color_t * dest_buf, int32_t w, int32_t h, lv_coord_t dest_stride,
+                                                    lv_color_t color, lv_opa_t opa);
+LV_ATTRIBUTE_FAST_MEM static void map_opa_565_swap(lv_color_t * dest_buf, int32_t w, int32_t h, lv_coord_t dest_stride,
+                                                   const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa);
+LV_ATTRIBUTE_FAST_MEM static void mask_px4_565_swap(lv_color_t * dest_buf, const lv_color_t * src_buf,
+                                                    int32_t src_step, const lv_opa_t * mask);
+static inline void unpack_565_swap(uint32_t px2, lanes_565_t * lanes);
+static inline uint32_t pack_565_swap(const lanes_565_t * lanes);
+static inline void premult_565(lanes_565_t * lanes, uint32_t mix);
+static inline uint32_t div255_lanes(uint32_t x);
+static inline uint32_t mix2_565_swap(const lanes_565_t * fg_premult, uint32_t bg2, uint32_t mix_inv);
+#endif /*BLEND_565_SWAP*/
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -256,9 +284,6 @@ LV_ATTRIBUTE_FAST_MEM static void fill_normal(lv_color_t * dest_buf, const lv_ar
         }
         /*Has opacity*/
         else {
-            lv_color_t last_dest_color = lv_color_black();
-            lv_color_t last_res_color = lv_color_mix(color, last_dest_color, opa);
-
 #if LV_COLOR_MIX_ROUND_OFS == 0 && LV_COLOR_DEPTH == 16
             /*lv_color_mix work with an optimized algorithm with 16 bit color depth.
              *However, it introduces some rounded error on opa.
@@ -267,6 +292,12 @@ LV_ATTRIBUTE_FAST_MEM static void fill_normal(lv_color_t * dest_buf, const lv_ar
             opa = opa << 3;
 #endif
 
+#if BLEND_565_SWAP
+            fill_opa_565_swap(dest_buf, w, h, dest_stride, color, opa);
+#else
+            lv_color_t last_dest_color = lv_color_black();
+            lv_color_t last_res_color = lv_color_mix(color, last_dest_color, opa);
+
             uint16_t color_premult[3];
             lv_color_premult(color, opa, color_premult);
             lv_opa_t opa_inv = 255 - opa;
@@ -281,6 +312,7 @@ LV_ATTRIBUTE_FAST_MEM static void fill_normal(lv_color_t * dest_buf, const lv_ar
                 }
                 dest_buf += dest_stride;
             }
+#endif /*BLEND_565_SWAP*/
         }
     }
     /*Masked*/
@@ -321,10 +353,16 @@ LV_ATTRIBUTE_FAST_MEM static void fill_normal(lv_color_t * dest_buf, const lv_ar
                         mask += 4;
                     }
                     else if(mask32) {
+#if BLEND_565_SWAP
+                        mask_px4_565_swap(dest_buf, &color, 0, mask);
+                        dest_buf += 4;
+                        mask += 4;
+#else
                         FILL_NORMAL_MASK_PX(color)
                         FILL_NORMAL_MASK_PX(color)
                         FILL_NORMAL_MASK_PX(color)
                         FILL_NORMAL_MASK_PX(color)
+#endif
                     }
                     else {
                         mask += 4;
@@ -653,6 +691,9 @@ LV_ATTRIBUTE_FAST_MEM static void map_normal(lv_color_t * dest_buf, const lv_are
             }
         }
         else {
+#if BLEND_565_SWAP
+            map_opa_565_swap(dest_buf, w, h, dest_stride, src_buf, src_stride, opa);
+#else
             for(y = 0; y < h; y++) {
                 for(x = 0; x < w; x++) {
                     dest_buf[x] = lv_color_mix(src_buf[x], dest_buf[x], opa);
@@ -660,6 +701,7 @@ LV_ATTRIBUTE_FAST_MEM static void map_normal(lv_color_t * dest_buf, const lv_are
                 dest_buf += dest_stride;
                 src_buf += src_stride;
             }
+#endif
         }
     }
     /*Masked*/
@@ -689,11 +731,15 @@ LV_ATTRIBUTE_FAST_MEM static void map_normal(lv_color_t * dest_buf, const lv_are
                             dest_buf[x + 3] = src_buf[x + 3];
                         }
                         else {
+#if BLEND_565_SWAP
+                            mask_px4_565_swap(&dest_buf[x], &src_buf[x], 1, (const lv_opa_t *)mask32);
+#else
                             mask_tmp_x = (const lv_opa_t *)mask32;
                             MAP_NORMAL_MASK_PX(x)
                             MAP_NORMAL_MASK_PX(x + 1)
                             MAP_NORMAL_MASK_PX(x + 2)
                             MAP_NORMAL_MASK_PX(x + 3)
+#endif
                         }
                     }
                     mask32++;
@@ -1046,3 +1092,152 @@ static inline lv_color_t color_blend_true_color_multiply(lv_color_t fg, lv_color
 
 #endif
 
+#if BLEND_565_SWAP
+/*The kernels below give the same colors as `lv_color_mix` but mix two pixels at once.
+ *Each channel of two pixels is spread to the two 16 bit lanes of a word so one multiply mixes both and
+ *the division by 255 is done on both lanes with shifts and adds.
+ *The first and last pixel of a row are mixed one by one if they don't fill a 4 byte aligned word.*/
+
+LV_ATTRIBUTE_FAST_MEM static void fill_opa_565_swap(lv_color_t * dest_buf, int32_t w, int32_t h, lv_coord_t dest_stride,
+                                                    lv_color_t color, lv_opa_t opa)
+{
+    lanes_565_t fg;
+    unpack_565_swap(color.full | ((uint32_t)color.full << 16), &fg);
+    premult_565(&fg, opa);
+    uint32_t opa_inv = 255 - opa;
+
+    /*Buffer the result to avoid recalculating it for the same background*/
+    uint32_t last_dest2 = 0;
+    uint32_t last_res2 = mix2_565_swap(&fg, last_dest2, opa_inv);
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        x = 0;
+        if((lv_uintptr_t)dest_buf & 0x3) {
+            dest_buf[0] = lv_color_mix(color, dest_buf[0], opa);
+            x = 1;
+        }
+
+        uint32_t * dest2 = (uint32_t *)&dest_buf[x];
+        for(; x < w - 1; x += 2) {
+            if(*dest2 != last_dest2) {
+                last_dest2 = *dest2;
+                last_res2 = mix2_565_swap(&fg, last_dest2, opa_inv);
+            }
+            *dest2 = last_res2;
+            dest2++;
+        }
+
+        if(x < w) dest_buf[x] = lv_color_mix(color, dest_buf[x], opa);
+        dest_buf += dest_stride;
+    }
+}
+
+LV_ATTRIBUTE_FAST_MEM static void map_opa_565_swap(lv_color_t * dest_buf, int32_t w, int32_t h, lv_coord_t dest_stride,
+                                                   const lv_color_t * src_buf, lv_coord_t src_stride, lv_opa_t opa)
+{
+    uint32_t opa_inv = 255 - opa;
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        x = 0;
+        if((lv_uintptr_t)dest_buf & 0x3) {
+            dest_buf[0] = lv_color_mix(src_buf[0], dest_buf[0], opa);
+            x = 1;
+        }
+
+        /*The source can be unaligned to the destination so its pixels are read one by one*/
+        uint32_t * dest2 = (uint32_t *)&dest_buf[x];
+        for(; x < w - 1; x += 2) {
+            lanes_565_t fg;
+            unpack_565_swap(src_buf[x].full | ((uint32_t)src_buf[x + 1].full << 16), &fg);
+            premult_565(&fg, opa);
+            *dest2 = mix2_565_swap(&fg, *dest2, opa_inv);
+            dest2++;
+        }
+
+        if(x < w) dest_buf[x] = lv_color_mix(src_buf[x], dest_buf[x], opa);
+        dest_buf += dest_stride;
+        src_buf += src_stride;
+    }
+}
+
+/**
+ * Blend 4 pixels with their own mask values. Neighbors with the same mask value in an aligned word are mixed together.
+ * @param dest_buf  the first pixel to blend on
+ * @param src_buf   the first pixel to blend
+ * @param src_step  1 to blend 4 source pixels or 0 to blend the same one 4 times
+ * @param mask      the 4 mask values
+ */
+LV_ATTRIBUTE_FAST_MEM static void mask_px4_565_swap(lv_color_t * dest_buf, const lv_color_t * src_buf,
+                                                    int32_t src_step, const lv_opa_t * mask)
+{
+    int32_t i = 0;
+    if((lv_uintptr_t)dest_buf & 0x3) {
+        dest_buf[0] = lv_color_mix(src_buf[0], dest_buf[0], mask[0]);
+        i = 1;
+    }
+
+    for(; i < 3; i += 2) {
+        const lv_color_t * src = src_buf + i * src_step;
+        if(mask[i] != mask[i + 1]) {
+            dest_buf[i] = lv_color_mix(src[0], dest_buf[i], mask[i]);
+            dest_buf[i + 1] = lv_color_mix(src[src_step], dest_buf[i + 1], mask[i + 1]);
+        }
+        else if(mask[i] != LV_OPA_TRANSP) {
+            lanes_565_t fg;
+            unpack_565_swap(src[0].full | ((uint32_t)src[src_step].full << 16), &fg);
+            premult_565(&fg, mask[i]);
+            uint32_t * dest2 = (uint32_t *)&dest_buf[i];
+            *dest2 = mix2_565_swap(&fg, *dest2, 255 - mask[i]);
+        }
+    }
+
+    if(i == 3) dest_buf[3] = lv_color_mix(src_buf[3 * src_step], dest_buf[3], mask[3]);
+}
+
+static inline void unpack_565_swap(uint32_t px2, lanes_565_t * lanes)
+{
+    /*Undo the byte swap of both pixels*/
+    px2 = ((px2 & 0x00FF00FF) << 8) | ((px2 >> 8) & 0x00FF00FF);
+
+    lanes->r = (px2 >> 11) & 0x001F001F;
+    lanes->g = (px2 >> 5) & 0x003F003F;
+    lanes->b = px2 & 0x001F001F;
+}
+
+static inline uint32_t pack_565_swap(const lanes_565_t * lanes)
+{
+    uint32_t px2 = (lanes->r << 11) | (lanes->g << 5) | lanes->b;
+    return ((px2 & 0x00FF00FF) << 8) | ((px2 >> 8) & 0x00FF00FF);
+}
+
+/*Multiply with the mix ratio and add the rounding like `lv_color_premult` and `lv_color_mix`*/
+static inline void premult_565(lanes_565_t * lanes, uint32_t mix)
+{
+    lanes->r = lanes->r * mix + LV_COLOR_MIX_ROUND_OFS * 0x00010001;
+    lanes->g = lanes->g * mix + LV_COLOR_MIX_ROUND_OFS * 0x00010001;
+    lanes->b = lanes->b * mix + LV_COLOR_MIX_ROUND_OFS * 0x00010001;
+}
+
+/*`LV_UDIV255` on both lanes: (x + 1 + (x >> 8)) >> 8 is the same for every 16 bit x*/
+static inline uint32_t div255_lanes(uint32_t x)
+{
+    return ((x + 0x00010001 + ((x >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+}
+
+static inline uint32_t mix2_565_swap(const lanes_565_t * fg_premult, uint32_t bg2, uint32_t mix_inv)
+{
+    lanes_565_t res;
+    unpack_565_swap(bg2, &res);
+
+    /*At most 63 * 255 + 255 per lane, so the lanes don't overflow into each other*/
+    res.r = div255_lanes(fg_premult->r + res.r * mix_inv);
+    res.g = div255_lanes(fg_premult->g + res.g * mix_inv);
+    res.b = div255_lanes(fg_premult->b + res.b * mix_inv);
+
+    return pack_565_swap(&res);
+}
+#endif /*BLEND_565_SWAP*/
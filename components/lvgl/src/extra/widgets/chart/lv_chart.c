@@ -559,6 +559,20 @@ void lv_chart_set_next_value2(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_
     invalidate_point(obj, ser->start_point);
 }
 
+void lv_chart_set_values(lv_obj_t * obj, lv_chart_series_t * ser, const lv_coord_t values[], uint16_t cnt)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    LV_ASSERT_NULL(ser);
+    LV_ASSERT_NULL(values);
+
+    lv_chart_t * chart  = (lv_chart_t *)obj;
+    if(cnt > chart->point_cnt) cnt = chart->point_cnt;
+
+    if(ser->y_points != values) lv_memcpy(ser->y_points, values, cnt * sizeof(lv_coord_t));
+    ser->start_point = 0;
+    lv_obj_invalidate(obj);
+}
+
 void lv_chart_set_value_by_id(lv_obj_t * obj, lv_chart_series_t * ser, uint16_t id, lv_coord_t value)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
@@ -385,6 +385,17 @@ void lv_chart_set_next_value(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_t
  */
 void lv_chart_set_next_value2(lv_obj_t * obj, lv_chart_series_t * ser, lv_coord_t x_value, lv_coord_t y_value);
 
+/**
+ * Set the Y values of a series from an array, starting at the first point.
+ * The chart is invalidated once, so it's much cheaper than calling `lv_chart_set_next_value()` for every point.
+ * `values` may be the series' own (external) array to only redraw after it was written in place.
+ * @param obj       pointer to chart object
+ * @param ser       pointer to a data series on 'chart'
+ * @param values    the new Y values
+ * @param cnt       number of values, at most `point_count` are used. The rest of the points are kept.
+ */
+void lv_chart_set_values(lv_obj_t * obj, lv_chart_series_t * ser, const lv_coord_t values[], uint16_t cnt);
+
 /**
  * Set an individual point's y value of a chart's series directly based on its index
  * @param obj     pointer to a chart object
@@ -0,0 +1,275 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "../src/draw/sw/lv_draw_sw.h"
+
+#include "unity/unity.h"
+
+#include <time.h>
+
+#define BUF_W        37
+#define BUF_H        6
+
+#define BENCH_W      320
+#define BENCH_H      240
+#define BENCH_FRAMES 100
+
+/*Timings only mean something without the sanitizers of the default test builds*/
+#if defined(NDEBUG) && !defined(__SANITIZE_ADDRESS__)
+#define BENCH_OPTIMIZED 1
+#else
+#define BENCH_OPTIMIZED 0
+#endif
+
+static lv_color_t dest_buf[BUF_W * BUF_H];
+static lv_color_t bg_buf[BUF_W * BUF_H];
+static lv_color_t src_buf[BUF_W * BUF_H];
+static lv_opa_t mask_buf[BUF_W * BUF_H];
+static const lv_area_t buf_area = {0, 0, BUF_W - 1, BUF_H - 1};
+
+static uint32_t rnd_state;
+
+static uint32_t rnd(void)
+{
+    rnd_state = rnd_state * 1103515245 + 12345;
+    return rnd_state >> 8;
+}
+
+static lv_color_t rnd_color(void)
+{
+    return lv_color_make(rnd() & 0xff, rnd() & 0xff, rnd() & 0xff);
+}
+
+/*Random colors with runs of the same one, as on real screens*/
+static void fill_rnd_colors(lv_color_t * buf, uint32_t len)
+{
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        if(i > 0 && (rnd() & 0x3) == 0) buf[i] = buf[i - 1];
+        else buf[i] = rnd_color();
+    }
+}
+
+/*Random mask values with transparent, covering and repeated ones*/
+static void fill_rnd_mask(lv_opa_t * buf, uint32_t len)
+{
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        switch(rnd() % 5) {
+            case 0:
+                buf[i] = LV_OPA_TRANSP;
+                break;
+            case 1:
+                buf[i] = LV_OPA_COVER;
+                break;
+            case 2:
+                buf[i] = i > 0 ? buf[i - 1] : LV_OPA_50;
+                break;
+            default:
+                buf[i] = rnd() & 0xff;
+                break;
+        }
+    }
+}
+
+static void blend(lv_color_t * buf, const lv_area_t * area, const lv_area_t * blend_area, lv_color_t color,
+                  const lv_color_t * src, lv_opa_t opa, lv_opa_t * mask)
+{
+    lv_draw_ctx_t draw_ctx;
+    lv_memset_00(&draw_ctx, sizeof(draw_ctx));
+    draw_ctx.buf = buf;
+    draw_ctx.buf_area = area;
+    draw_ctx.clip_area = area;
+
+    lv_draw_sw_blend_dsc_t dsc;
+    lv_memset_00(&dsc, sizeof(dsc));
+    dsc.blend_area = blend_area;
+    dsc.src_buf = src;
+    dsc.color = color;
+    dsc.mask_buf = mask;
+    dsc.mask_res = mask ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+    dsc.mask_area = blend_area;
+    dsc.opa = opa;
+    dsc.blend_mode = LV_BLEND_MODE_NORMAL;
+
+    _lv_refr_set_disp_refreshing(lv_disp_get_default());
+    lv_draw_sw_blend_basic(&draw_ctx, &dsc);
+    _lv_refr_set_disp_refreshing(NULL);
+}
+
+/*What the generic blending gives for a pixel, `opa` already merged with the mask*/
+static lv_color_t expected_px(lv_color_t fg, lv_color_t bg, lv_opa_t opa, bool is_premult)
+{
+    if(opa == LV_OPA_COVER) return fg;
+    if(!is_premult) return lv_color_mix(fg, bg, opa);
+
+    uint16_t premult[3];
+    lv_color_premult(fg, opa, premult);
+    return lv_color_mix_premult(premult, bg, 255 - opa);
+}
+
+/*Blend on every start, width and height of the buffer to hit both word alignments at both ends*/
+static void check_blend(bool is_map, lv_opa_t opa, bool is_masked)
+{
+    lv_coord_t x1;
+    lv_coord_t w;
+    for(x1 = 0; x1 < 4; x1++) {
+        for(w = 1; w <= BUF_W - x1; w++) {
+            lv_area_t blend_area = {x1, 1, x1 + w - 1, BUF_H - 1};
+            lv_coord_t h = lv_area_get_height(&blend_area);
+            lv_color_t color = rnd_color();
+            fill_rnd_colors(bg_buf, BUF_W * BUF_H);
+            fill_rnd_colors(src_buf, w * h);
+            fill_rnd_mask(mask_buf, w * h);
+            lv_memcpy(dest_buf, bg_buf, sizeof(dest_buf));
+
+            blend(dest_buf, &buf_area, &blend_area, color, is_map ? src_buf : NULL, opa, is_masked ? mask_buf : NULL);
+
+            /*A fill with opacity only mixes its color premultiplied, and rounds the opacity like lv_color_mix does
+             *at 16 bit color depth without LV_COLOR_16_SWAP*/
+            lv_opa_t fill_opa = opa;
+            bool is_premult = !is_map && !is_masked && opa < LV_OPA_MAX;
+#if LV_COLOR_MIX_ROUND_OFS == 0 && LV_COLOR_DEPTH == 16
+            if(is_premult) fill_opa = ((opa + 4) >> 3) << 3;
+#endif
+            uint32_t i;
+            for(i = 0; i < BUF_W * BUF_H; i++) {
+                lv_point_t p = {i % BUF_W, i / BUF_W};
+                lv_color_t exp = bg_buf[i];
+                if(_lv_area_is_point_on(&blend_area, &p, 0)) {
+                    uint32_t j = (p.y - blend_area.y1) * w + p.x - blend_area.x1;
+                    lv_color_t fg = is_map ? src_buf[j] : color;
+                    lv_opa_t px_opa = is_masked ? mask_buf[j] : LV_OPA_COVER;
+                    if(px_opa && opa < LV_OPA_MAX) {
+                        /*The map takes the almost covering mask values as covering*/
+                        bool is_full = is_map ? px_opa >= LV_OPA_MAX : px_opa == LV_OPA_COVER;
+                        px_opa = is_full ? fill_opa : (px_opa * fill_opa) >> 8;
+                    }
+                    if(px_opa) exp = expected_px(fg, bg_buf[i], px_opa, is_premult);
+                }
+                if(exp.full != dest_buf[i].full) {
+                    char msg[128];
+                    lv_snprintf(msg, sizeof(msg), "map %d, opa %d, mask %d, x1 %d, w %d: pixel %d;%d", is_map, opa,
+                                is_masked, x1, w, p.x, p.y);
+                    TEST_ASSERT_EQUAL_HEX32_MESSAGE(exp.full, dest_buf[i].full, msg);
+                }
+            }
+        }
+    }
+}
+
+void setUp(void)
+{
+    rnd_state = 1;
+}
+
+void tearDown(void)
+{
+}
+
+void test_blend_fill_with_opa_should_match_color_mix(void)
+{
+    static const lv_opa_t opas[] = {LV_OPA_10, 77, LV_OPA_50, 129, LV_OPA_90, 252};
+    uint32_t i;
+    for(i = 0; i < sizeof(opas); i++) check_blend(false, opas[i], false);
+}
+
+void test_blend_fill_with_mask_should_match_color_mix(void)
+{
+    check_blend(false, LV_OPA_COVER, true);
+    check_blend(false, LV_OPA_70, true);
+}
+
+void test_blend_map_with_opa_should_match_color_mix(void)
+{
+    static const lv_opa_t opas[] = {LV_OPA_10, 77, LV_OPA_50, 129, LV_OPA_90, 252};
+    uint32_t i;
+    for(i = 0; i < sizeof(opas); i++) check_blend(true, opas[i], false);
+}
+
+void test_blend_map_with_mask_should_match_color_mix(void)
+{
+    check_blend(true, LV_OPA_COVER, true);
+    check_blend(true, LV_OPA_70, true);
+}
+
+void test_blend_map_should_match_color_mix_at_every_ratio(void)
+{
+    /*Colors at the extremes of every channel and random ones*/
+    lv_color_t dest[2];
+    uint32_t c;
+    for(c = 0; c < 64; c++) {
+        lv_color_t fg[2] = {rnd_color(), rnd_color()};
+        lv_color_t bg[2] = {rnd_color(), rnd_color()};
+        if(c < 8) {
+            fg[0] = lv_color_make(c & 1 ? 0xff : 0, c & 2 ? 0xff : 0, c & 4 ? 0xff : 0);
+            bg[0] = lv_color_make(c & 1 ? 0 : 0xff, c & 2 ? 0 : 0xff, c & 4 ? 0 : 0xff);
+        }
+
+        lv_area_t area = {0, 0, 1, 0};
+        uint32_t opa;
+        for(opa = 0; opa < LV_OPA_MAX; opa++) {
+            dest[0] = bg[0];
+            dest[1] = bg[1];
+            blend(dest, &area, &area, lv_color_black(), fg, opa, NULL);
+            TEST_ASSERT_EQUAL_HEX32(lv_color_mix(fg[0], bg[0], opa).full, dest[0].full);
+            TEST_ASSERT_EQUAL_HEX32(lv_color_mix(fg[1], bg[1], opa).full, dest[1].full);
+        }
+    }
+}
+
+/*Only reports the times in sanitized builds, optimized ones also check the kernels beat lv_color_mix*/
+void test_blend_benchmark(void)
+{
+    static lv_color_t bench_bg[BENCH_W * BENCH_H];
+    static lv_color_t bench_dest[BENCH_W * BENCH_H];
+    static lv_color_t bench_src[BENCH_W * BENCH_H];
+    lv_area_t area = {0, 0, BENCH_W - 1, BENCH_H - 1};
+    lv_color_t color = lv_color_make(0x5b, 0xc6, 0xca);
+    uint32_t px_cnt = BENCH_W * BENCH_H;
+    uint32_t us[4];
+    uint32_t i;
+    uint32_t f;
+    uint32_t k;
+
+    /*Random pixels so the fill can't reuse the previous result*/
+    for(i = 0; i < px_cnt; i++) {
+        bench_bg[i] = rnd_color();
+        bench_src[i] = rnd_color();
+    }
+
+    /*lv_color_mix on every pixel as the generic path does it, then the kernels for fill and map*/
+    for(k = 0; k < 4; k++) {
+        clock_t start = clock();
+        for(f = 0; f < BENCH_FRAMES; f++) {
+            lv_opa_t opa = 64 + f;
+            lv_memcpy(bench_dest, bench_bg, sizeof(bench_dest));
+            switch(k) {
+                case 0:
+                    for(i = 0; i < px_cnt; i++) bench_dest[i] = lv_color_mix(color, bench_dest[i], opa);
+                    break;
+                case 1:
+                    blend(bench_dest, &area, &area, color, NULL, opa, NULL);
+                    break;
+                case 2:
+                    for(i = 0; i < px_cnt; i++) bench_dest[i] = lv_color_mix(bench_src[i], bench_dest[i], opa);
+                    break;
+                default:
+                    blend(bench_dest, &area, &area, color, bench_src, opa, NULL);
+                    break;
+            }
+        }
+        us[k] = (uint32_t)((clock() - start) * 1000000 / CLOCKS_PER_SEC / BENCH_FRAMES);
+    }
+
+    char msg[160];
+    lv_snprintf(msg, sizeof(msg), "%dx%d with opacity, us per frame: fill %d with lv_color_mix, %d blended; "
+                "map %d with lv_color_mix, %d blended", BENCH_W, BENCH_H, us[0], us[1], us[2], us[3]);
+    TEST_MESSAGE(msg);
+
+#if BENCH_OPTIMIZED
+    TEST_ASSERT_LESS_THAN(us[0], us[1]);
+    TEST_ASSERT_LESS_THAN(us[2], us[3]);
+#endif
+}
+
+#endif
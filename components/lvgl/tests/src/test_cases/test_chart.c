@@ -0,0 +1,132 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#include <time.h>
+
+#define POINT_CNT    400
+#define BENCH_FRAMES 200
+
+static lv_obj_t * active_screen = NULL;
+static lv_obj_t * chart = NULL;
+static lv_chart_series_t * ser = NULL;
+static lv_coord_t frame[POINT_CNT];
+
+void setUp(void)
+{
+    active_screen = lv_scr_act();
+    chart = lv_chart_create(active_screen);
+    lv_obj_set_size(chart, 300, 200);
+    lv_chart_set_point_count(chart, POINT_CNT);
+    ser = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
+
+    uint32_t i;
+    for(i = 0; i < POINT_CNT; i++) {
+        frame[i] = (lv_coord_t)(i % 100);
+    }
+
+    /*Start every test with nothing waiting to be redrawn*/
+    lv_refr_now(NULL);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(active_screen);
+}
+
+void test_chart_set_values_should_copy_from_the_first_point(void)
+{
+    /*Move the start point so the copy has to reset it*/
+    lv_chart_set_next_value(chart, ser, 55);
+    lv_chart_set_next_value(chart, ser, 66);
+
+    lv_chart_set_values(chart, ser, frame, POINT_CNT);
+
+    TEST_ASSERT_EQUAL_UINT16(0, ser->start_point);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(frame, lv_chart_get_y_array(chart, ser), POINT_CNT);
+}
+
+void test_chart_set_values_should_keep_points_past_the_given_count(void)
+{
+    lv_chart_set_all_value(chart, ser, 7);
+    lv_chart_set_values(chart, ser, frame, 10);
+
+    lv_coord_t * y = lv_chart_get_y_array(chart, ser);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(frame, y, 10);
+    TEST_ASSERT_EQUAL_INT16(7, y[10]);
+    TEST_ASSERT_EQUAL_INT16(7, y[POINT_CNT - 1]);
+}
+
+void test_chart_set_values_should_clamp_to_the_point_count(void)
+{
+    static lv_coord_t values[POINT_CNT + 8];
+    lv_coord_t ext[POINT_CNT + 8];
+    uint32_t i;
+    for(i = 0; i < POINT_CNT + 8; i++) {
+        values[i] = (lv_coord_t)i;
+        ext[i] = -1;
+    }
+
+    lv_chart_set_ext_y_array(chart, ser, ext);
+    lv_chart_set_values(chart, ser, values, POINT_CNT + 8);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY(values, ext, POINT_CNT);
+    TEST_ASSERT_EQUAL_INT16(-1, ext[POINT_CNT]);
+    TEST_ASSERT_EQUAL_INT16(-1, ext[POINT_CNT + 7]);
+
+    /*Series must not point at the stack once the test returns*/
+    lv_obj_del(chart);
+}
+
+void test_chart_set_values_should_redraw_an_external_array_in_place(void)
+{
+    static lv_coord_t ext[POINT_CNT];
+    lv_chart_set_ext_y_array(chart, ser, ext);
+    lv_refr_now(NULL);
+
+    ext[3] = 42;
+    lv_chart_set_values(chart, ser, lv_chart_get_y_array(chart, ser), POINT_CNT);
+
+    TEST_ASSERT_EQUAL_INT16(42, lv_chart_get_y_array(chart, ser)[3]);
+    TEST_ASSERT_EQUAL(1, lv_disp_get_default()->inv_p);
+}
+
+void test_chart_set_values_should_invalidate_once(void)
+{
+    lv_chart_set_values(chart, ser, frame, POINT_CNT);
+    TEST_ASSERT_EQUAL(1, lv_disp_get_default()->inv_p);
+}
+
+/*Times are printed, not compared, clock() is too noisy under the sanitizers and parallel ctest*/
+void test_chart_set_values_benchmark(void)
+{
+    uint32_t f;
+    uint32_t i;
+
+    /*Only the cost of publishing a frame is measured, redrawing is the same either way.
+     *Point by point every value invalidates the chart on its own.*/
+    clock_t start = clock();
+    for(f = 0; f < BENCH_FRAMES; f++) {
+        for(i = 0; i < POINT_CNT; i++) {
+            lv_chart_set_next_value(chart, ser, frame[i]);
+        }
+        lv_disp_get_default()->inv_p = 0;
+    }
+    clock_t per_point = clock() - start;
+
+    start = clock();
+    for(f = 0; f < BENCH_FRAMES; f++) {
+        lv_chart_set_values(chart, ser, frame, POINT_CNT);
+        lv_disp_get_default()->inv_p = 0;
+    }
+    clock_t bulk = clock() - start;
+
+    char msg[128];
+    lv_snprintf(msg, sizeof(msg), "%d points per frame: %d us with lv_chart_set_next_value, %d us with lv_chart_set_values",
+                POINT_CNT, (int)(per_point * 1000000 / CLOCKS_PER_SEC / BENCH_FRAMES),
+                (int)(bulk * 1000000 / CLOCKS_PER_SEC / BENCH_FRAMES));
+    TEST_MESSAGE(msg);
+}
+
+#endif
@@ -13,7 +13,11 @@ void test_config(void)
     TEST_ASSERT_EQUAL(800, lv_disp_get_hor_res(NULL));
     TEST_ASSERT_EQUAL(480, LV_VER_RES);
     TEST_ASSERT_EQUAL(480, lv_disp_get_ver_res(NULL));
+#if LV_COLOR_16_SWAP
+    TEST_ASSERT_EQUAL(16, LV_COLOR_DEPTH);
+#else
     TEST_ASSERT_EQUAL(32, LV_COLOR_DEPTH);
+#endif
 }
 
 #endif
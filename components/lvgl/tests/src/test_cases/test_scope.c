@@ -0,0 +1,808 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "lv_scope.h"
+
+#include "unity/unity.h"
+
+#include <time.h>
+
+#define SCOPE_W      100
+#define SCOPE_H      80
+#define TEST_HOR_RES 800
+
+#define BENCH_W      320
+#define BENCH_H      180
+#define BENCH_POINTS 400
+#define BENCH_FRAMES 200
+
+/*Absolute times are only held to a bound in an optimized build without sanitizers, ratios hold in any build*/
+#if defined(NDEBUG) && !defined(__SANITIZE_ADDRESS__)
+#define BENCH_OPTIMIZED 1
+#else
+#define BENCH_OPTIMIZED 0
+#endif
+
+extern lv_color_t test_fb[];
+
+static lv_obj_t * active_screen = NULL;
+static void (*orig_flush_cb)(lv_disp_drv_t *, const lv_area_t *, lv_color_t *) = NULL;
+static lv_obj_t * scope = NULL;
+static lv_scope_trace_t * trace = NULL;
+
+static const lv_color_t bg_color = LV_COLOR_MAKE(0x00, 0x00, 0x00);
+static const lv_color_t line_color = LV_COLOR_MAKE(0x60, 0x60, 0x60);
+static const lv_color_t trace_color = LV_COLOR_MAKE(0xff, 0x00, 0x00);
+static const lv_color_t axis_color = LV_COLOR_MAKE(0xff, 0xff, 0xff);
+
+static void style_plain(lv_obj_t * obj)
+{
+    lv_obj_set_style_radius(obj, 0, LV_PART_MAIN);
+    lv_obj_set_style_border_width(obj, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(obj, 0, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(obj, bg_color, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_line_color(obj, line_color, LV_PART_MAIN);
+    lv_obj_set_style_line_opa(obj, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_line_width(obj, 1, LV_PART_ITEMS);
+}
+
+/*Whole screen is redrawn so the frame buffer holds it row by row*/
+static void redraw(void)
+{
+    lv_obj_invalidate(active_screen);
+    lv_refr_now(NULL);
+}
+
+static bool is_color(lv_coord_t x, lv_coord_t y, lv_color_t color)
+{
+    return test_fb[y * TEST_HOR_RES + x].full == color.full;
+}
+
+static bool column_has_trace(lv_coord_t x, lv_coord_t * top, lv_coord_t * bottom)
+{
+    *top = SCOPE_H;
+    *bottom = -1;
+    lv_coord_t y;
+    for(y = 0; y < SCOPE_H; y++) {
+        if(is_color(x, y, trace_color)) {
+            *top = LV_MIN(*top, y);
+            *bottom = LV_MAX(*bottom, y);
+        }
+    }
+    return *bottom >= 0;
+}
+
+void setUp(void)
+{
+    active_screen = lv_scr_act();
+    scope = lv_scope_create(active_screen);
+    style_plain(scope);
+    lv_obj_set_pos(scope, 0, 0);
+    lv_obj_set_size(scope, SCOPE_W, SCOPE_H);
+    lv_scope_set_range(scope, 0, 100);
+    lv_scope_set_div_count(scope, 4, 4);
+    trace = lv_scope_add_trace(scope, trace_color);
+
+    orig_flush_cb = lv_disp_get_default()->driver->flush_cb;
+}
+
+void tearDown(void)
+{
+    lv_disp_get_default()->driver->flush_cb = orig_flush_cb;
+    lv_obj_clean(active_screen);
+}
+
+void test_scope_should_draw_graticule(void)
+{
+    redraw();
+
+    /*Lines split the content into 4 x 4 divisions*/
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 4, 5, line_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2, 5, line_color));
+    TEST_ASSERT_TRUE(is_color(5, SCOPE_H / 4, line_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W - 1, SCOPE_H * 3 / 4, line_color));
+    TEST_ASSERT_TRUE(is_color(5, 5, bg_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 4 + 1, SCOPE_H / 4 + 1, bg_color));
+}
+
+void test_scope_should_draw_axes_only_with_tick_width(void)
+{
+    lv_scope_set_div_count(scope, 5, 5);
+    redraw();
+
+    /*Odd division count, nothing crosses the centre yet*/
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2, 5, bg_color));
+    TEST_ASSERT_TRUE(is_color(5, SCOPE_H / 2, bg_color));
+
+    lv_obj_set_style_line_color(scope, axis_color, LV_PART_TICKS);
+    lv_obj_set_style_line_width(scope, 1, LV_PART_TICKS);
+    redraw();
+
+    /*Centre axes cross the whole content*/
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2, 0, axis_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2, SCOPE_H - 1, axis_color));
+    TEST_ASSERT_TRUE(is_color(0, SCOPE_H / 2, axis_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W - 1, SCOPE_H / 2, axis_color));
+
+    /*Five ticks per division reach a couple of pixels to both sides of the axes, and only that far*/
+    lv_coord_t tick_x = SCOPE_W / 25;
+    lv_coord_t tick_y = SCOPE_H / 25;
+    TEST_ASSERT_TRUE(is_color(tick_x, SCOPE_H / 2 - 2, axis_color));
+    TEST_ASSERT_TRUE(is_color(tick_x, SCOPE_H / 2 + 2, axis_color));
+    TEST_ASSERT_TRUE(is_color(tick_x, SCOPE_H / 2 - 3, bg_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2 - 2, tick_y, axis_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2 + 2, tick_y, axis_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2 + 3, tick_y, bg_color));
+
+    /*Division lines keep their color away from the axes*/
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 5, 5, line_color));
+    TEST_ASSERT_TRUE(is_color(5, SCOPE_H / 5, line_color));
+    TEST_ASSERT_TRUE(is_color(5, 5, bg_color));
+}
+
+void test_scope_should_rebuild_graticule_on_color_change(void)
+{
+    redraw();
+
+    /*Colors don't affect the layout, so LVGL doesn't report them as a style change*/
+    lv_color_t new_color = LV_COLOR_MAKE(0x00, 0x80, 0x00);
+    lv_obj_set_style_line_color(scope, new_color, LV_PART_MAIN);
+    redraw();
+
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 4, 5, new_color));
+    TEST_ASSERT_TRUE(is_color(5, SCOPE_H / 4, new_color));
+}
+
+void test_scope_should_draw_trace_over_axes(void)
+{
+    lv_obj_set_style_line_color(scope, axis_color, LV_PART_TICKS);
+    lv_obj_set_style_line_width(scope, 1, LV_PART_TICKS);
+
+    lv_coord_t values[2] = {0, 100};
+    lv_scope_set_values(scope, trace, values, 2);
+    redraw();
+
+    lv_coord_t top;
+    lv_coord_t bottom;
+    TEST_ASSERT_TRUE(column_has_trace(SCOPE_W / 2, &top, &bottom));
+    TEST_ASSERT_INT_WITHIN(2, SCOPE_H / 2, top);
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2, 0, axis_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W / 2, SCOPE_H - 1, axis_color));
+}
+
+void test_scope_should_draw_level_on_one_row(void)
+{
+    lv_coord_t values[10] = {50, 50, 50, 50, 50, 50, 50, 50, 50, 50};
+    lv_scope_set_values(scope, trace, values, 10);
+    redraw();
+
+    lv_coord_t x;
+    for(x = 0; x < SCOPE_W; x++) {
+        lv_coord_t top;
+        lv_coord_t bottom;
+        TEST_ASSERT_TRUE(column_has_trace(x, &top, &bottom));
+        TEST_ASSERT_EQUAL(top, bottom);
+        TEST_ASSERT_INT_WITHIN(1, (SCOPE_H - 1) / 2, top);
+    }
+}
+
+void test_scope_should_connect_steep_edges(void)
+{
+    lv_coord_t values[4] = {0, 0, 100, 100};
+    lv_scope_set_values(scope, trace, values, 4);
+    redraw();
+
+    /*Every column is drawn and touches the next one, so the edge has no gaps*/
+    lv_coord_t prev_top = 0;
+    lv_coord_t prev_bottom = 0;
+    lv_coord_t x;
+    for(x = 0; x < SCOPE_W; x++) {
+        lv_coord_t top;
+        lv_coord_t bottom;
+        TEST_ASSERT_TRUE(column_has_trace(x, &top, &bottom));
+        if(x > 0) {
+            TEST_ASSERT_TRUE(top <= prev_bottom + 1 && bottom >= prev_top - 1);
+        }
+        prev_top = top;
+        prev_bottom = bottom;
+    }
+    TEST_ASSERT_TRUE(is_color(0, SCOPE_H - 1, trace_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W - 1, 0, trace_color));
+}
+
+void test_scope_should_keep_extremes_of_samples_sharing_a_column(void)
+{
+    /*Four samples per column, each column holds both levels*/
+    static lv_coord_t values[SCOPE_W * 4];
+    uint32_t i;
+    for(i = 0; i < SCOPE_W * 4; i++) {
+        values[i] = (i & 1) ? 90 : 10;
+    }
+    lv_scope_set_values(scope, trace, values, SCOPE_W * 4);
+    redraw();
+
+    lv_coord_t x;
+    for(x = 1; x < SCOPE_W - 1; x++) {
+        lv_coord_t top;
+        lv_coord_t bottom;
+        TEST_ASSERT_TRUE(column_has_trace(x, &top, &bottom));
+        TEST_ASSERT_INT_WITHIN(1, (SCOPE_H - 1) / 10, top);
+        TEST_ASSERT_INT_WITHIN(1, (SCOPE_H - 1) * 9 / 10, bottom);
+    }
+}
+
+void test_scope_should_stick_values_out_of_range_to_the_edge(void)
+{
+    lv_coord_t values[2] = {-500, 500};
+    lv_scope_set_values(scope, trace, values, 2);
+    redraw();
+
+    TEST_ASSERT_TRUE(is_color(0, SCOPE_H - 1, trace_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W - 1, 0, trace_color));
+}
+
+void test_scope_should_not_draw_hidden_trace(void)
+{
+    lv_coord_t values[2] = {50, 50};
+    lv_scope_set_values(scope, trace, values, 2);
+    lv_scope_hide_trace(scope, trace, true);
+    redraw();
+
+    lv_coord_t top;
+    lv_coord_t bottom;
+    TEST_ASSERT_FALSE(column_has_trace(SCOPE_W / 3, &top, &bottom));
+
+    lv_scope_hide_trace(scope, trace, false);
+    redraw();
+    TEST_ASSERT_TRUE(column_has_trace(SCOPE_W / 3, &top, &bottom));
+}
+
+void test_scope_should_follow_size_changes(void)
+{
+    lv_coord_t values[2] = {50, 50};
+    lv_scope_set_values(scope, trace, values, 2);
+    redraw();
+
+    lv_obj_set_size(scope, SCOPE_W / 2, SCOPE_H / 2);
+    redraw();
+
+    lv_coord_t top;
+    lv_coord_t bottom;
+    TEST_ASSERT_TRUE(column_has_trace(SCOPE_W / 2 - 1, &top, &bottom));
+    TEST_ASSERT_INT_WITHIN(1, (SCOPE_H / 2 - 1) / 2, top);
+    TEST_ASSERT_FALSE(column_has_trace(SCOPE_W / 2 + 1, &top, &bottom));
+}
+
+void test_scope_should_refuse_traces_past_the_maximum(void)
+{
+    uint32_t i;
+    for(i = 1; i < LV_SCOPE_TRACE_MAX; i++) {
+        TEST_ASSERT_NOT_NULL(lv_scope_add_trace(scope, trace_color));
+    }
+    TEST_ASSERT_NULL(lv_scope_add_trace(scope, trace_color));
+}
+
+void test_scope_view_should_spread_only_its_samples_across_the_width(void)
+{
+    static lv_coord_t values[101];
+    uint32_t i;
+    for(i = 0; i <= 100; i++) values[i] = (lv_coord_t)i;
+    lv_scope_set_values(scope, trace, values, 101);
+    lv_scope_set_view(scope, 50, 51);
+    redraw();
+
+    lv_coord_t top;
+    lv_coord_t bottom;
+    TEST_ASSERT_TRUE(column_has_trace(0, &top, &bottom));
+    TEST_ASSERT_INT_WITHIN(1, (SCOPE_H - 1) / 2, bottom);
+    TEST_ASSERT_TRUE(column_has_trace(SCOPE_W - 1, &top, &bottom));
+    TEST_ASSERT_EQUAL(0, top);
+
+    /*Back to all samples*/
+    lv_scope_set_view(scope, 0, 0);
+    redraw();
+    TEST_ASSERT_TRUE(column_has_trace(0, &top, &bottom));
+    TEST_ASSERT_INT_WITHIN(1, SCOPE_H - 1, bottom);
+}
+
+void test_scope_view_should_keep_extremes_of_a_long_record(void)
+{
+    static lv_coord_t values[1000];
+    uint32_t i;
+    for(i = 0; i < 1000; i++) values[i] = 50;
+    values[500] = 100;
+    lv_scope_set_values(scope, trace, values, 1000);
+    lv_scope_set_view(scope, 400, 300);
+    redraw();
+
+    /*Spike is one of several samples sharing its column*/
+    lv_coord_t top;
+    lv_coord_t bottom;
+    lv_coord_t x = (lv_coord_t)((SCOPE_W - 1) * 100 / 299);
+    TEST_ASSERT_TRUE(column_has_trace(x, &top, &bottom));
+    TEST_ASSERT_EQUAL(0, top);
+}
+
+void test_scope_view_may_reach_past_the_samples(void)
+{
+    lv_coord_t values[10] = {50, 50, 50, 50, 50, 50, 50, 50, 50, 50};
+    lv_scope_set_values(scope, trace, values, 10);
+    lv_scope_set_view(scope, -10, 20);
+    redraw();
+
+    lv_coord_t top;
+    lv_coord_t bottom;
+    TEST_ASSERT_FALSE(column_has_trace(5, &top, &bottom));
+    TEST_ASSERT_TRUE(column_has_trace(SCOPE_W / 2 + 2, &top, &bottom));
+    TEST_ASSERT_TRUE(column_has_trace(SCOPE_W - 1, &top, &bottom));
+
+    /*Lines into the view come from samples outside of it*/
+    lv_scope_set_view(scope, 5, 2);
+    redraw();
+    TEST_ASSERT_TRUE(column_has_trace(0, &top, &bottom));
+    TEST_ASSERT_TRUE(column_has_trace(SCOPE_W - 1, &top, &bottom));
+}
+
+/*Only the samples in view are visited, so the printed time doesn't grow with the length of the record*/
+void test_scope_view_pan_benchmark(void)
+{
+    static lv_coord_t values[20000];
+    int32_t i;
+    for(i = 0; i < 20000; i++) {
+        values[i] = (lv_coord_t)(1750 + 1500 * lv_trigo_sin((int16_t)(i % 360)) / LV_TRIGO_SIN_MAX);
+    }
+    lv_obj_set_size(scope, BENCH_W, BENCH_H);
+    lv_scope_set_range(scope, 0, 3500);
+    lv_scope_set_values(scope, trace, values, 20000);
+    lv_scope_set_view(scope, 0, 400);
+    lv_refr_now(NULL);
+
+    /*Dragging moves the view a few samples per input read, each one is redrawn*/
+    clock_t start = clock();
+    for(i = 0; i < BENCH_FRAMES; i++) {
+        lv_scope_set_view(scope, i * 7, 400);
+        lv_refr_now(NULL);
+    }
+    uint32_t pan_us = (uint32_t)((clock() - start) * 1000000 / CLOCKS_PER_SEC / BENCH_FRAMES);
+
+    char msg[128];
+    lv_snprintf(msg, sizeof(msg), "%dx%d, 400 of 20000 samples in view, us per panned frame: %d", BENCH_W, BENCH_H,
+                (int)pan_us);
+    TEST_MESSAGE(msg);
+}
+
+/*Counts what the display would be sent, and keeps the top left of the screen in place to compare redraws*/
+static uint32_t flushed_bytes;
+static lv_color_t shadow_fb[BENCH_W * BENCH_H];
+
+static void counting_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    flushed_bytes += lv_area_get_size(area) * sizeof(lv_color_t);
+
+    lv_coord_t y;
+    for(y = area->y1; y <= LV_MIN(area->y2, BENCH_H - 1); y++) {
+        lv_coord_t x;
+        for(x = area->x1; x <= LV_MIN(area->x2, BENCH_W - 1); x++) {
+            shadow_fb[y * BENCH_W + x] = color_p[(y - area->y1) * lv_area_get_width(area) + x - area->x1];
+        }
+    }
+    lv_disp_flush_ready(disp_drv);
+}
+
+static void set_sine(lv_scope_trace_t * t, int32_t amplitude, int32_t phase, int32_t offset)
+{
+    static lv_coord_t values[BENCH_POINTS];
+    int32_t i;
+    for(i = 0; i < BENCH_POINTS; i++) {
+        values[i] = (lv_coord_t)(offset + amplitude * lv_trigo_sin((int16_t)((i * 360 / BENCH_POINTS + phase) % 360)) /
+                                 LV_TRIGO_SIN_MAX);
+    }
+    lv_scope_set_values(scope, t, values, BENCH_POINTS);
+}
+
+void test_scope_should_flush_only_bands_a_slow_signal_moved_in(void)
+{
+    lv_obj_set_size(scope, BENCH_W, BENCH_H);
+    lv_obj_set_style_line_width(scope, 2, LV_PART_ITEMS);
+    lv_scope_set_range(scope, 0, 3500);
+    lv_scope_trace_t * second = lv_scope_add_trace(scope, lv_color_hex(0x00ff00));
+    set_sine(trace, 400, 0, 1200);
+    set_sine(second, 0, 0, 2500);
+    lv_disp_get_default()->driver->flush_cb = counting_flush_cb;
+    redraw();
+
+    /*Sine creeps to the left and a DC level drifts up, each by about a pixel a frame*/
+    uint32_t banded = 0;
+    int32_t f;
+    for(f = 1; f <= 10; f++) {
+        flushed_bytes = 0;
+        set_sine(trace, 400, 2 * f, 1200);
+        set_sine(second, 0, 0, 2500 + 20 * f);
+        lv_refr_now(NULL);
+        banded += flushed_bytes;
+    }
+    static lv_color_t banded_fb[BENCH_W * BENCH_H];
+    lv_memcpy(banded_fb, shadow_fb, sizeof(shadow_fb));
+
+    flushed_bytes = 0;
+    lv_obj_invalidate(scope);
+    lv_refr_now(NULL);
+    uint32_t whole = flushed_bytes;
+
+    char msg[128];
+    lv_snprintf(msg, sizeof(msg), "%dx%d, slowly moving traces, bytes flushed per frame: %d of %d", BENCH_W, BENCH_H,
+                (int)(banded / 10), (int)whole);
+    TEST_MESSAGE(msg);
+
+    /*Updating only the bands leaves the screen the same as redrawing all of it*/
+    TEST_ASSERT_EQUAL_MEMORY(shadow_fb, banded_fb, sizeof(shadow_fb));
+    TEST_ASSERT_LESS_THAN(whole / 3, banded / 10);
+}
+
+void test_scope_should_not_invalidate_what_did_not_move(void)
+{
+    lv_coord_t values[10] = {10, 20, 30, 40, 50, 60, 70, 80, 90, 100};
+    lv_scope_set_values(scope, trace, values, 10);
+    redraw();
+
+    lv_scope_set_values(scope, trace, values, 10);
+    TEST_ASSERT_EQUAL(0, lv_disp_get_default()->inv_p);
+
+    lv_scope_hide_trace(scope, trace, true);
+    lv_refr_now(NULL);
+    values[5] = 0;
+    lv_scope_set_values(scope, trace, values, 10);
+    TEST_ASSERT_EQUAL(0, lv_disp_get_default()->inv_p);
+
+    /*Hidden trace is still kept up to date*/
+    lv_scope_hide_trace(scope, trace, false);
+    redraw();
+    lv_coord_t top;
+    lv_coord_t bottom;
+    TEST_ASSERT_TRUE(column_has_trace(SCOPE_W * 5 / 9, &top, &bottom));
+    TEST_ASSERT_INT_WITHIN(1, SCOPE_H - 1, bottom);
+}
+
+void test_scope_view_change_should_invalidate_bands_shared_by_all_traces(void)
+{
+    lv_coord_t values[10] = {10, 90, 20, 80, 30, 70, 40, 60, 50, 50};
+    lv_scope_set_values(scope, trace, values, 10);
+    uint32_t i;
+    for(i = 1; i < LV_SCOPE_TRACE_MAX; i++) {
+        lv_scope_set_values(scope, lv_scope_add_trace(scope, trace_color), values, 10);
+    }
+    redraw();
+
+    /*Every trace moves, still each band is one area and none of them is the whole screen*/
+    lv_scope_set_view(scope, 1, 5);
+    lv_disp_t * disp = lv_disp_get_default();
+    TEST_ASSERT_GREATER_THAN(0, disp->inv_p);
+    TEST_ASSERT_LESS_OR_EQUAL(8, disp->inv_p);
+    for(i = 0; i < disp->inv_p; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(SCOPE_W, lv_area_get_width(&disp->inv_areas[i]));
+    }
+}
+
+void test_scope_should_draw_cursors_over_traces(void)
+{
+    lv_color_t cursor_color = lv_color_hex(0x0000ff);
+    lv_obj_set_style_line_color(scope, cursor_color, LV_PART_CURSOR);
+    lv_coord_t values[2] = {50, 50};
+    lv_scope_set_values(scope, trace, values, 2);
+    lv_scope_set_cursor(scope, LV_SCOPE_CURSOR_X1, 30);
+    lv_scope_set_cursor(scope, LV_SCOPE_CURSOR_Y2, 20);
+    redraw();
+
+    lv_coord_t top;
+    lv_coord_t bottom;
+    TEST_ASSERT_TRUE(column_has_trace(31, &top, &bottom));
+    TEST_ASSERT_TRUE(is_color(30, 0, cursor_color));
+    TEST_ASSERT_TRUE(is_color(30, SCOPE_H - 1, cursor_color));
+    TEST_ASSERT_TRUE(is_color(30, top, cursor_color));
+    TEST_ASSERT_TRUE(is_color(0, 20, cursor_color));
+    TEST_ASSERT_TRUE(is_color(SCOPE_W - 1, 20, cursor_color));
+    TEST_ASSERT_TRUE(is_color(29, 5, bg_color));
+    TEST_ASSERT_TRUE(is_color(5, 21, bg_color));
+
+    /*Off cursors aren't drawn, positions past the content stop at its edge*/
+    lv_scope_set_cursor(scope, LV_SCOPE_CURSOR_X1, LV_SCOPE_CURSOR_OFF);
+    lv_scope_set_cursor(scope, LV_SCOPE_CURSOR_Y2, 1000);
+    redraw();
+    TEST_ASSERT_EQUAL(LV_SCOPE_CURSOR_OFF, lv_scope_get_cursor(scope, LV_SCOPE_CURSOR_X1));
+    TEST_ASSERT_EQUAL(SCOPE_H - 1, lv_scope_get_cursor(scope, LV_SCOPE_CURSOR_Y2));
+    TEST_ASSERT_TRUE(is_color(30, 0, bg_color));
+    TEST_ASSERT_TRUE(is_color(5, SCOPE_H - 1, cursor_color));
+}
+
+void test_scope_cursor_move_should_flush_only_its_strips(void)
+{
+    lv_coord_t values[10] = {10, 90, 10, 90, 10, 90, 10, 90, 10, 90};
+    lv_scope_set_values(scope, trace, values, 10);
+    lv_scope_set_cursor(scope, LV_SCOPE_CURSOR_X2, 40);
+    lv_disp_get_default()->driver->flush_cb = counting_flush_cb;
+    redraw();
+
+    /*Line the cursor leaves and the one it goes to*/
+    flushed_bytes = 0;
+    lv_scope_set_cursor(scope, LV_SCOPE_CURSOR_X2, 45);
+    TEST_ASSERT_EQUAL(2, lv_disp_get_default()->inv_p);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL(2 * SCOPE_H * sizeof(lv_color_t), flushed_bytes);
+
+    flushed_bytes = 0;
+    lv_scope_set_cursor(scope, LV_SCOPE_CURSOR_Y1, 10);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL(SCOPE_W * sizeof(lv_color_t), flushed_bytes);
+
+    /*Strips are redrawn from what is built, same as redrawing everything*/
+    static lv_color_t moved_fb[BENCH_W * BENCH_H];
+    lv_memcpy(moved_fb, shadow_fb, sizeof(shadow_fb));
+    redraw();
+    TEST_ASSERT_EQUAL_MEMORY(shadow_fb, moved_fb, sizeof(shadow_fb));
+}
+
+void test_scope_should_interpolate_between_samples(void)
+{
+    lv_coord_t values[3] = {0, 100, 40};
+    lv_scope_set_values(scope, trace, values, 3);
+
+    TEST_ASSERT_EQUAL(25 * LV_SCOPE_FRAC, lv_scope_get_value_at(trace, LV_SCOPE_FRAC / 4));
+    TEST_ASSERT_EQUAL(70 * LV_SCOPE_FRAC, lv_scope_get_value_at(trace, LV_SCOPE_FRAC * 3 / 2));
+    TEST_ASSERT_EQUAL(0, lv_scope_get_value_at(trace, -5));
+    TEST_ASSERT_EQUAL(40 * LV_SCOPE_FRAC, lv_scope_get_value_at(trace, 10 * LV_SCOPE_FRAC));
+
+    /*Columns spread the samples the same way traces are drawn*/
+    TEST_ASSERT_EQUAL(0, lv_scope_get_sample_at(scope, 0));
+    TEST_ASSERT_EQUAL(2 * LV_SCOPE_FRAC, lv_scope_get_sample_at(scope, SCOPE_W - 1));
+    TEST_ASSERT_EQUAL((33 * 2 * LV_SCOPE_FRAC + 49) / 99, lv_scope_get_sample_at(scope, 33));
+    lv_scope_set_view(scope, 1, 11);
+    TEST_ASSERT_EQUAL(LV_SCOPE_FRAC, lv_scope_get_sample_at(scope, 0));
+    TEST_ASSERT_EQUAL(11 * LV_SCOPE_FRAC, lv_scope_get_sample_at(scope, SCOPE_W - 1));
+
+    /*Rows go from the top to the bottom of the range*/
+    TEST_ASSERT_EQUAL(100 * LV_SCOPE_FRAC, lv_scope_get_level_at(scope, 0));
+    TEST_ASSERT_EQUAL(0, lv_scope_get_level_at(scope, SCOPE_H - 1));
+    TEST_ASSERT_INT_WITHIN(1, 100 * LV_SCOPE_FRAC - 40 * 100 * LV_SCOPE_FRAC / (SCOPE_H - 1),
+                           lv_scope_get_level_at(scope, 40));
+}
+
+static bool is_color_near(lv_coord_t x, lv_coord_t y, lv_color_t color)
+{
+    /*Packed RGB565 blending rounds its 5 bit opacity differently than lv_color_mix*/
+    int32_t tol = LV_COLOR_DEPTH == 16 ? 1 : 0;
+    lv_color_t px = test_fb[y * TEST_HOR_RES + x];
+    return LV_ABS((int32_t)LV_COLOR_GET_R(px) - LV_COLOR_GET_R(color)) <= tol &&
+           LV_ABS((int32_t)LV_COLOR_GET_G(px) - LV_COLOR_GET_G(color)) <= tol &&
+           LV_ABS((int32_t)LV_COLOR_GET_B(px) - LV_COLOR_GET_B(color)) <= tol;
+}
+
+void test_scope_antialias_should_split_a_level_between_two_rows(void)
+{
+    lv_scope_set_antialias(scope, true);
+
+    /*50 of 0..100 is halfway between rows 39 and 40*/
+    lv_coord_t values[2] = {50, 50};
+    lv_scope_set_values(scope, trace, values, 2);
+    redraw();
+
+    /*Row 40 is a division line, what is under a pixel is blended too*/
+    TEST_ASSERT_TRUE(is_color_near(5, 39, lv_color_mix(trace_color, bg_color, 174)));
+    TEST_ASSERT_TRUE(is_color_near(5, 40, lv_color_mix(trace_color, line_color, 174)));
+    TEST_ASSERT_TRUE(is_color(5, 38, bg_color));
+    TEST_ASSERT_TRUE(is_color(5, 41, bg_color));
+
+    /*Level on a whole row is drawn the same as without antialiasing*/
+    values[0] = values[1] = 0;
+    lv_scope_set_values(scope, trace, values, 2);
+    redraw();
+    TEST_ASSERT_TRUE(is_color(5, SCOPE_H - 1, trace_color));
+    TEST_ASSERT_TRUE(is_color(5, SCOPE_H - 2, bg_color));
+}
+
+void test_scope_antialias_should_blend_edges_over_the_graticule(void)
+{
+    lv_scope_set_antialias(scope, true);
+
+    /*Slow slope crosses the division line at a quarter of the width*/
+    lv_coord_t values[2] = {30, 70};
+    lv_scope_set_values(scope, trace, values, 2);
+    redraw();
+
+    lv_coord_t x = SCOPE_W / 4;
+    lv_coord_t y;
+    uint32_t blended = 0;
+    for(y = 0; y < SCOPE_H; y++) {
+        lv_color_t px = test_fb[y * TEST_HOR_RES + x];
+        if(px.full != line_color.full && px.full != trace_color.full) blended++;
+    }
+
+    /*Partly covered rows are neither the line nor the trace*/
+    TEST_ASSERT_GREATER_OR_EQUAL(1, blended);
+    TEST_ASSERT_LESS_OR_EQUAL(2, blended);
+}
+
+void test_scope_antialias_should_redraw_bands_like_the_whole(void)
+{
+    lv_obj_set_size(scope, BENCH_W, BENCH_H);
+    lv_obj_set_style_line_width(scope, 2, LV_PART_ITEMS);
+    lv_scope_set_range(scope, 0, 3500);
+    lv_scope_set_antialias(scope, true);
+    set_sine(trace, 400, 0, 1200);
+    lv_disp_get_default()->driver->flush_cb = counting_flush_cb;
+    redraw();
+
+    int32_t f;
+    for(f = 1; f <= 10; f++) {
+        set_sine(trace, 400 + 10 * f, 2 * f, 1200);
+        lv_refr_now(NULL);
+    }
+    static lv_color_t banded_fb[BENCH_W * BENCH_H];
+    lv_memcpy(banded_fb, shadow_fb, sizeof(shadow_fb));
+
+    /*Blended edges that moved are invalidated along with the rest of the columns*/
+    redraw();
+    TEST_ASSERT_EQUAL_MEMORY(shadow_fb, banded_fb, sizeof(shadow_fb));
+}
+
+static void draw_reference(bool is_antialias)
+{
+    static lv_coord_t triangle[BENCH_POINTS];
+    int32_t i;
+    for(i = 0; i < BENCH_POINTS; i++) {
+        triangle[i] = (lv_coord_t)(2000 + ((i % 100) < 50 ? (i % 100) * 30 : (100 - i % 100) * 30));
+    }
+
+    lv_obj_set_size(scope, BENCH_W, BENCH_H);
+    lv_obj_set_style_line_width(scope, 2, LV_PART_ITEMS);
+    lv_obj_set_style_line_color(scope, axis_color, LV_PART_TICKS);
+    lv_obj_set_style_line_width(scope, 1, LV_PART_TICKS);
+    lv_scope_set_range(scope, 0, 3500);
+    lv_scope_set_div_count(scope, 5, 7);
+    lv_scope_set_antialias(scope, is_antialias);
+    set_sine(trace, 900, 0, 1200);
+    lv_scope_set_values(scope, lv_scope_add_trace(scope, lv_color_hex(0x5bc6ca)), triangle, BENCH_POINTS);
+}
+
+void test_scope_should_match_reference_image(void)
+{
+    draw_reference(false);
+    TEST_ASSERT_EQUAL_SCREENSHOT("scope_aliased.png");
+}
+
+void test_scope_antialias_should_match_reference_image(void)
+{
+    draw_reference(true);
+    TEST_ASSERT_EQUAL_SCREENSHOT("scope_antialiased.png");
+}
+
+typedef struct {
+    uint32_t refresh_us;    /*Whole refresh of the object, flushing included*/
+    uint32_t render_us;     /*Only drawing the object into a buffer*/
+} bench_t;
+
+static void bench_set_frame(lv_obj_t * obj, void * traces[2], bool is_scope, uint32_t f)
+{
+    static lv_coord_t frames[4][BENCH_POINTS];
+    uint32_t i;
+    if(f == 0) {
+        for(i = 0; i < BENCH_POINTS; i++) {
+            /*Triangle and square in two phases, so consecutive frames differ*/
+            frames[0][i] = (lv_coord_t)((i % 100) < 50 ? (i % 100) * 60 : (100 - i % 100) * 60);
+            frames[1][i] = (lv_coord_t)((i % 80) < 40 ? 500 : 2500);
+            frames[2][i] = (lv_coord_t)(3000 - frames[0][i]);
+            frames[3][i] = (lv_coord_t)(3000 - frames[1][i]);
+        }
+    }
+
+    for(i = 0; i < 2; i++) {
+        if(is_scope) lv_scope_set_values(obj, traces[i], frames[(f & 1) * 2 + i], BENCH_POINTS);
+        else lv_chart_set_values(obj, traces[i], frames[(f & 1) * 2 + i], BENCH_POINTS);
+    }
+}
+
+static bench_t bench(lv_obj_t * obj, bool is_scope)
+{
+    void * traces[2];
+    if(is_scope) {
+        lv_scope_set_range(obj, 0, 3500);
+        traces[0] = lv_scope_add_trace(obj, lv_color_hex(0xff99ff));
+        traces[1] = lv_scope_add_trace(obj, lv_color_hex(0x5bc6ca));
+    }
+    else {
+        lv_chart_set_range(obj, LV_CHART_AXIS_PRIMARY_Y, 0, 3500);
+        lv_chart_set_point_count(obj, BENCH_POINTS);
+        traces[0] = lv_chart_add_series(obj, lv_color_hex(0xff99ff), LV_CHART_AXIS_PRIMARY_Y);
+        traces[1] = lv_chart_add_series(obj, lv_color_hex(0x5bc6ca), LV_CHART_AXIS_PRIMARY_Y);
+    }
+
+    bench_t res;
+    uint32_t f;
+    clock_t start = clock();
+    for(f = 0; f < BENCH_FRAMES; f++) {
+        bench_set_frame(obj, traces, is_scope, f);
+        lv_refr_now(NULL);
+    }
+    res.refresh_us = (uint32_t)((clock() - start) * 1000000 / CLOCKS_PER_SEC / BENCH_FRAMES);
+
+    /*Draw straight into a buffer of the object's size the way the refresh does*/
+    static lv_color_t buf[BENCH_W * BENCH_H];
+    lv_draw_ctx_t * draw_ctx = lv_disp_get_default()->driver->draw_ctx;
+    lv_area_t area;
+    lv_obj_get_coords(obj, &area);
+    draw_ctx->buf = buf;
+    draw_ctx->buf_area = &area;
+    draw_ctx->clip_area = &area;
+
+    start = clock();
+    for(f = 0; f < BENCH_FRAMES; f++) {
+        bench_set_frame(obj, traces, is_scope, f);
+        lv_obj_redraw(draw_ctx, obj);
+    }
+    res.render_us = (uint32_t)((clock() - start) * 1000000 / CLOCKS_PER_SEC / BENCH_FRAMES);
+
+    lv_disp_get_default()->inv_p = 0;
+    return res;
+}
+
+void test_scope_benchmark(void)
+{
+    lv_obj_del(scope);
+
+    /*Same size and styles, both draw two traces of a new frame each time*/
+    lv_obj_t * chart = lv_chart_create(active_screen);
+    style_plain(chart);
+    lv_obj_set_size(chart, BENCH_W, BENCH_H);
+    lv_obj_set_style_size(chart, 0, LV_PART_INDICATOR);
+    lv_chart_set_div_line_count(chart, 8, 6);
+    lv_refr_now(NULL);
+    bench_t chart_res = bench(chart, false);
+    lv_obj_del(chart);
+
+    scope = lv_scope_create(active_screen);
+    style_plain(scope);
+    lv_obj_set_size(scope, BENCH_W, BENCH_H);
+    lv_scope_set_div_count(scope, 5, 7);
+    lv_refr_now(NULL);
+    bench_t scope_res = bench(scope, true);
+
+    char msg[160];
+    lv_snprintf(msg, sizeof(msg), "%dx%d, two traces of %d points, us per frame: lv_chart %d render, %d refresh; "
+                "lv_scope %d render, %d refresh", BENCH_W, BENCH_H, BENCH_POINTS, (int)chart_res.render_us,
+                (int)chart_res.refresh_us, (int)scope_res.render_us, (int)scope_res.refresh_us);
+    TEST_MESSAGE(msg);
+
+    /*Several times faster than lv_chart, so the margin outlasts timing noise*/
+    TEST_ASSERT_LESS_THAN(chart_res.render_us, scope_res.render_us);
+#if BENCH_OPTIMIZED
+    TEST_ASSERT_LESS_THAN(1000, scope_res.render_us);
+#endif
+}
+
+void test_scope_antialias_benchmark(void)
+{
+    /*Same two traces two pixels wide as on the device, with and without antialiasing*/
+    bench_t res[2];
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        lv_obj_del(scope);
+        scope = lv_scope_create(active_screen);
+        style_plain(scope);
+        lv_obj_set_size(scope, BENCH_W, BENCH_H);
+        lv_obj_set_style_line_width(scope, 2, LV_PART_ITEMS);
+        lv_scope_set_div_count(scope, 5, 7);
+        lv_scope_set_antialias(scope, i == 1);
+        lv_refr_now(NULL);
+        res[i] = bench(scope, true);
+    }
+
+    char msg[160];
+    lv_snprintf(msg, sizeof(msg), "%dx%d, two traces of %d points, us per frame: aliased %d render, %d refresh; "
+                "antialiased %d render, %d refresh", BENCH_W, BENCH_H, BENCH_POINTS, (int)res[0].render_us,
+                (int)res[0].refresh_us, (int)res[1].render_us, (int)res[1].refresh_us);
+    TEST_MESSAGE(msg);
+
+    /*About 2x the aliased mode at most, headroom to 3x keeps timing noise out*/
+    TEST_ASSERT_LESS_THAN(3 * res[0].render_us, res[1].render_us);
+}
+
+#endif
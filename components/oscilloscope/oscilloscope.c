@@ -9,6 +9,7 @@
 
 //--------------------------------- INCLUDES ----------------------------------
 #include "oscilloscope.h"
+#include "profiler.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -33,6 +34,9 @@ struct _oscilloscope_t
     QueueHandle_t    queue;
     potentiometer_t *p_pot;
     osc_timer_t     *p_tim;
+
+    oscilloscope_frame_cb_t frame_cb;
+    void                   *p_frame_arg;
 };
 
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
@@ -50,6 +54,8 @@ oscilloscope_t *oscilloscope_create(int pin, int channel_number)
     p_osc->chan       = channel_number;
     p_osc->pin        = pin;
     p_osc->timer_tick = 0;
+    p_osc->is_running = false;
+    p_osc->frame_cb   = NULL;
     p_osc->p_pot      = potentiometer_create(pin, channel_number, 3300, false);
     p_osc->p_tim      = osc_timer_create(_adc_read_cb, p_osc, OSCILLOSCOPE_TIMER_PERIOD_US);
 
@@ -88,6 +94,41 @@ void oscilloscope_send_new_data(oscilloscope_t *p_osc, int *data)
     }
 }
 
+bool oscilloscope_take_frame(oscilloscope_t *p_osc, int *data)
+{
+    return (NULL != p_osc->queue) && (pdTRUE == xQueueReceive(p_osc->queue, data, 0));
+}
+
+void oscilloscope_set_frame_cb(oscilloscope_t *p_osc, oscilloscope_frame_cb_t cb, void *p_arg)
+{
+    // Sampling timer may run any time, it never sees the new callback with the old argument
+    p_osc->frame_cb    = NULL;
+    p_osc->p_frame_arg = p_arg;
+    p_osc->frame_cb    = cb;
+}
+
+bool oscilloscope_is_running(oscilloscope_t *p_osc)
+{
+    return p_osc->is_running;
+}
+
+int oscilloscope_read_mV(oscilloscope_t *p_osc, int sample_count)
+{
+    int sum   = 0;
+    int count = 0;
+
+    for(int i = 0; i < sample_count; i++)
+    {
+        int voltage_mv = potentiometer_get_mV(p_osc->p_pot);
+        if(voltage_mv >= 0)
+        {
+            sum += voltage_mv;
+            count++;
+        }
+    }
+    return (count > 0) ? (sum + count / 2) / count : -1;
+}
+
 void oscilloscope_print(oscilloscope_t *p_osc)
 {
     for(int i = 0; i < OSCILLOSCOPE_SAMPLE_NUMBER; i++)
@@ -103,6 +144,8 @@ void IRAM_ATTR _adc_read_cb(void *arg)
     oscilloscope_t *p_osc                    = (oscilloscope_t *)arg;
     BaseType_t      xHigherPriorityTaskWoken = pdFALSE;
 
+    PROFILER_BEGIN(PROFILER_PROBE_ADC_READ);
+
     // Read value
     p_osc->adc_raw[p_osc->timer_tick] = potentiometer_get_raw(p_osc->p_pot) * VDD / POTENTIOMETER_ADC_INT_RANGE;
 
@@ -130,7 +173,12 @@ void IRAM_ATTR _adc_read_cb(void *arg)
         {
             xQueueOverwriteFromISR(p_osc->queue, p_osc->adc_raw, &xHigherPriorityTaskWoken);
         }
+        if(NULL != p_osc->frame_cb)
+        {
+            p_osc->frame_cb(p_osc, p_osc->p_frame_arg);
+        }
         p_osc->timer_tick = 0;
     }
+    PROFILER_END(PROFILER_PROBE_ADC_READ);
 }
 //---------------------------- INTERRUPT HANDLERS -----------------------------
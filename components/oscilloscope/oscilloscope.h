@@ -31,6 +31,12 @@ extern "C" {
 struct _oscilloscope_t;
 typedef struct _oscilloscope_t oscilloscope_t;
 
+/**
+ * @brief Called from the sampling timer each time a frame is complete, in real-time context, so it must not block
+ *
+ */
+typedef void (*oscilloscope_frame_cb_t)(oscilloscope_t *p_osc, void *p_arg);
+
 //---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
 
 /**
@@ -64,6 +70,43 @@ void oscilloscope_stop(oscilloscope_t *p_osc);
  */
 void oscilloscope_send_new_data(oscilloscope_t *p_osc, int *data);
 
+/**
+ * @brief Copies the latest complete frame to data without waiting. Frames nobody took in time are replaced by newer
+ * ones, so a slow reader always gets the latest.
+ *
+ * @param p_osc Oscilloscope handler which to read from
+ * @param data [out] Frame of OSCILLOSCOPE_SAMPLE_NUMBER samples
+ * @return bool true if there was a frame not taken yet
+ */
+bool oscilloscope_take_frame(oscilloscope_t *p_osc, int *data);
+
+/**
+ * @brief Sets function called each time a frame is complete
+ *
+ * @param p_osc Oscilloscope handler
+ * @param cb Callback, NULL for none
+ * @param p_arg Argument passed to cb
+ */
+void oscilloscope_set_frame_cb(oscilloscope_t *p_osc, oscilloscope_frame_cb_t cb, void *p_arg);
+
+/**
+ * @brief Returns true while timer fills up the buffer
+ *
+ * @param p_osc Oscilloscope handler
+ * @return bool
+ */
+bool oscilloscope_is_running(oscilloscope_t *p_osc);
+
+/**
+ * @brief Measures DC voltage on the input by averaging calibrated adc readings. Meant for stopped oscilloscope,
+ * running one competes for the adc.
+ *
+ * @param p_osc Oscilloscope handler
+ * @param sample_count Number of readings averaged
+ * @return int Voltage in mV, -1 if adc couldn't be read
+ */
+int oscilloscope_read_mV(oscilloscope_t *p_osc, int sample_count);
+
 void oscilloscope_print(oscilloscope_t *p_osc);
 
 #ifdef __cplusplus
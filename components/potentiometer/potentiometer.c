@@ -10,6 +10,8 @@
 //--------------------------------- INCLUDES ----------------------------------
 #include "potentiometer.h"
 #include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
@@ -71,6 +73,7 @@ static int _potentiometer_map_values(int raw_result);
 
 // Handle for ADC1
 static adc_oneshot_unit_handle_t _adc1_handle = NULL;
+static adc_cali_handle_t         _adc1_cali   = NULL; // eFuse calibration, NULL if chip has none
 static SemaphoreHandle_t adc_semaphore = NULL;  // Semaphore to protect ADC access
 
 static const char *TAG = "Potentiometer";
@@ -197,6 +200,22 @@ int potentiometer_get_raw(potentiometer_t *p_potentiometer)
     return raw_result;
 }
 
+int potentiometer_get_mV(potentiometer_t *p_potentiometer)
+{
+    int raw_result = potentiometer_get_raw(p_potentiometer);
+    int voltage_mv;
+
+    if(raw_result < 0)
+    {
+        return -1;
+    }
+    if((NULL == _adc1_cali) || (ESP_OK != adc_cali_raw_to_voltage(_adc1_cali, raw_result, &voltage_mv)))
+    {
+        voltage_mv = raw_result * VDD / POTENTIOMETER_ADC_INT_RANGE;
+    }
+    return voltage_mv;
+}
+
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
 
 static int _potentiometer_map_values(int raw_result)
@@ -222,6 +241,20 @@ static esp_err_t _adc_create(potentiometer_t *p_pot)
     };
     ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_config1, &_adc1_handle));
 
+#if ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    // All channels share attenuation, so one calibration covers them
+    adc_cali_line_fitting_config_t cali_config = {
+        .unit_id  = ADC_UNIT_1,
+        .atten    = POTENTIOMETER_ADC_ATTEN,
+        .bitwidth = ADC_BITWIDTH_DEFAULT,
+    };
+    if(ESP_OK != adc_cali_create_scheme_line_fitting(&cali_config, &_adc1_cali))
+    {
+        ESP_LOGW(TAG, "No ADC calibration in eFuse, voltages are scaled from raw values");
+        _adc1_cali = NULL;
+    }
+#endif
+
     return ESP_OK;
 }
 
@@ -72,6 +72,15 @@ uint32_t potentiometer_position_get(potentiometer_t *p_potentiometer);
  */
 int potentiometer_get_raw(potentiometer_t *p_potentiometer);
 
+/**
+ * @brief Returns voltage on the pin, corrected with the ADC calibration burnt into eFuse. Falls back to scaling the
+ * raw value if the chip has no calibration. Not safe in ISR.
+ *
+ * @param p_potentiometer A pointer to the potentiometer_t structure.
+ * @return int Voltage in mV, -1 if ADC is busy
+ */
+int potentiometer_get_mV(potentiometer_t *p_potentiometer);
+
 
 
 #ifdef __cplusplus
@@ -0,0 +1,374 @@
+/**
+ * @file profiler.c
+ *
+ * @brief   CPU load, stack and hot section profiler
+ *
+ * A housekeeping task wakes every CONFIG_PROFILER_PERIOD_MS and turns what happened since its last wake-up into a
+ * sample: CPU load of each core from FreeRTOS run-time stats of its idle task, calls and cycles of every probe, and
+ * CPU share, priority and stack high-water mark of every task. Samples go into a ring the diagnostics screen draws
+ * load history from, the console prints the newest one.
+ *
+ * Probes are ISR safe and never wait: each core writes only its own probes, and the sampler only reads totals and
+ * clears maximums. A maximum that lands between the sampler reading and clearing it is lost, which only ever makes
+ * a window's maximum low by one run.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "profiler.h"
+#include "sched.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define _THREAD_STACK_SIZE (3072u)
+#define _CPU_MHZ           (CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+#if CONFIG_PROFILER_ENABLE
+// Run time of a task at the end of the previous window
+typedef struct _profiler_run_time_t
+{
+    TaskHandle_t handle;
+    uint32_t     run_time;
+} profiler_run_time_t;
+#endif
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+#if CONFIG_PROFILER_ENABLE
+/**
+ * @brief Takes a sample every CONFIG_PROFILER_PERIOD_MS
+ *
+ * @param p_param Unused
+ */
+static void _sample_task(void *p_param);
+
+/**
+ * @brief Computes probe statistics of the window and starts the next one
+ *
+ * @param p_sample Sample statistics are written to
+ * @param window_cycles Length of the window in CPU cycles
+ */
+static void _sample_probes(profiler_sample_t *p_sample, uint64_t window_cycles);
+
+/**
+ * @brief Computes CPU load of cores and tasks from run-time stats
+ *
+ * @param p_sample Sample core loads are written to
+ */
+static void _sample_tasks(profiler_sample_t *p_sample);
+
+/**
+ * @brief Returns run time of task at the end of the previous window
+ *
+ * @param handle Task
+ * @return uint32_t Run time, 0 if task didn't exist back then
+ */
+static uint32_t _prev_run_time(TaskHandle_t handle);
+
+/**
+ * @brief Orders tasks by CPU share, busiest first
+ *
+ * @param p_a Task
+ * @param p_b Task
+ * @return int qsort() order
+ */
+static int _task_cmp(const void *p_a, const void *p_b);
+#endif
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "profiler";
+
+static const char *const _probe_name[PROFILER_PROBE_COUNT] = {
+    [PROFILER_PROBE_ADC_READ]     = "adc read",
+    [PROFILER_PROBE_DDS_ISR]      = "dds isr",
+    [PROFILER_PROBE_GATE_ISR]     = "gate isr",
+    [PROFILER_PROBE_CHART_UPDATE] = "chart update",
+    [PROFILER_PROBE_LV_TIMER]     = "lv timer",
+    [PROFILER_PROBE_DISP_FLUSH]   = "disp flush",
+};
+
+#if CONFIG_PROFILER_ENABLE
+static profiler_sample_t  _samples[CONFIG_PROFILER_RING_LEN];
+static profiler_ring_t    _ring;
+static profiler_counter_t _start[PROFILER_PROBE_COUNT]; // Probe totals at the start of the window
+
+// Run-time stats, the snapshot is kept between windows so per task load can be computed
+static TaskStatus_t        _status[PROFILER_MAX_TASKS];
+static profiler_run_time_t _prev[PROFILER_MAX_TASKS];
+static int                 _prev_count   = 0;
+static uint32_t            _prev_total   = 0;
+static int64_t             _prev_time_us = 0;
+static profiler_task_t     _tasks[PROFILER_MAX_TASKS];
+static int                 _task_count   = 0;
+static bool                _is_truncated = false;
+static SemaphoreHandle_t   _lock         = NULL;
+#endif
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+profiler_counter_t profiler_counters[PROFILER_PROBE_COUNT];
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+profiler_err_t profiler_init(void)
+{
+#if CONFIG_PROFILER_ENABLE
+    profiler_ring_init(&_ring, _samples, CONFIG_PROFILER_RING_LEN);
+
+    _lock = xSemaphoreCreateMutex();
+    if((NULL == _lock) ||
+       (SCHED_ERR_NONE != sched_task_create(SCHED_TASK_PROFILER, _sample_task, _THREAD_STACK_SIZE, NULL, NULL)))
+    {
+        ESP_LOGE(TAG, "Failed to start profiler");
+        return PROFILER_ERR;
+    }
+    return PROFILER_ERR_NONE;
+#else
+    ESP_LOGW(TAG, "Profiler is disabled in menuconfig");
+    return PROFILER_ERR;
+#endif
+}
+
+bool profiler_get_latest(profiler_sample_t *p_sample)
+{
+    bool is_found = false;
+#if CONFIG_PROFILER_ENABLE
+    if(NULL == _lock)
+    {
+        return false;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    const profiler_sample_t *p_latest = profiler_ring_get(&_ring, 0);
+    if(NULL != p_latest)
+    {
+        *p_sample = *p_latest;
+        is_found  = true;
+    }
+    xSemaphoreGive(_lock);
+#endif
+    return is_found;
+}
+
+int profiler_get_load_history(int core, uint16_t *p_permille, int max_count)
+{
+    int count = 0;
+#if CONFIG_PROFILER_ENABLE
+    if((NULL == _lock) || (core < 0) || (core >= PROFILER_CORES))
+    {
+        return 0;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    count = ((int)_ring.count < max_count) ? (int)_ring.count : max_count;
+    for(int i = 0; i < count; i++)
+    {
+        p_permille[i] = profiler_ring_get(&_ring, count - 1 - i)->cpu_permille[core];
+    }
+    xSemaphoreGive(_lock);
+#endif
+    return count;
+}
+
+int profiler_get_tasks(profiler_task_t *p_tasks, int max_count)
+{
+    int count = 0;
+#if CONFIG_PROFILER_ENABLE
+    if(NULL == _lock)
+    {
+        return 0;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    count = (_task_count < max_count) ? _task_count : max_count;
+    memcpy(p_tasks, _tasks, count * sizeof(*p_tasks));
+    xSemaphoreGive(_lock);
+#endif
+    return count;
+}
+
+const char *profiler_probe_name(profiler_probe_t probe)
+{
+    return (probe < PROFILER_PROBE_COUNT) ? _probe_name[probe] : "unknown";
+}
+
+float profiler_cycles_to_us(uint32_t cycles)
+{
+    return (float)cycles / _CPU_MHZ;
+}
+
+void profiler_print(void)
+{
+    profiler_sample_t sample;
+    if(!profiler_get_latest(&sample))
+    {
+        printf("No samples, profiler is disabled or hasn't run yet\n");
+        return;
+    }
+
+    printf("CPU load over %lu ms:", (unsigned long)(sample.window_us / 1000));
+    for(int core = 0; core < PROFILER_CORES; core++)
+    {
+        printf(" core %d %u.%u%%", core, sample.cpu_permille[core] / 10, sample.cpu_permille[core] % 10);
+    }
+    printf("\n\n%-13s %8s %9s %9s %6s\n", "probe", "calls/s", "mean us", "max us", "load");
+    for(int i = 0; i < PROFILER_PROBE_COUNT; i++)
+    {
+        const profiler_probe_stats_t *p_probe = &sample.probe[i];
+
+        printf("%-13s %8lu %9.2f %9.2f %3u.%u%%\n", _probe_name[i],
+               (unsigned long)((uint64_t)p_probe->calls * 1000000 / sample.window_us),
+               profiler_cycles_to_us(p_probe->mean_cycles), profiler_cycles_to_us(p_probe->max_cycles),
+               p_probe->permille / 10, p_probe->permille % 10);
+    }
+
+    profiler_task_t *p_tasks = malloc(PROFILER_MAX_TASKS * sizeof(*p_tasks));
+    if(NULL == p_tasks)
+    {
+        return;
+    }
+    int count = profiler_get_tasks(p_tasks, PROFILER_MAX_TASKS);
+    printf("\n%-16s %4s %6s %10s\n", "task", "prio", "cpu", "stack free");
+    for(int i = 0; i < count; i++)
+    {
+        printf("%-16s %4u %3u.%u%% %10lu\n", p_tasks[i].name, p_tasks[i].priority, p_tasks[i].cpu_permille / 10,
+               p_tasks[i].cpu_permille % 10, (unsigned long)p_tasks[i].stack_free);
+    }
+#if CONFIG_PROFILER_ENABLE
+    if(_is_truncated)
+    {
+        printf("More than %d tasks, the rest aren't profiled\n", PROFILER_MAX_TASKS);
+    }
+#endif
+    free(p_tasks);
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+#if CONFIG_PROFILER_ENABLE
+
+static void _sample_task(void *p_param)
+{
+    (void)p_param;
+
+    TickType_t wake = xTaskGetTickCount();
+
+    // First window starts now, everything before it is history nobody asked for
+    profiler_sample_t discard = { 0 };
+
+    _prev_time_us = esp_timer_get_time();
+    _sample_probes(&discard, 0);
+    xSemaphoreTake(_lock, portMAX_DELAY);
+    _sample_tasks(&discard);
+    xSemaphoreGive(_lock);
+
+    for(;;)
+    {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(CONFIG_PROFILER_PERIOD_MS));
+
+        profiler_sample_t sample = { 0 };
+        int64_t           now_us = esp_timer_get_time();
+
+        sample.time_us   = now_us;
+        sample.window_us = (uint32_t)(now_us - _prev_time_us);
+        _prev_time_us    = now_us;
+
+        _sample_probes(&sample, (uint64_t)sample.window_us * _CPU_MHZ);
+
+        xSemaphoreTake(_lock, portMAX_DELAY);
+        _sample_tasks(&sample);
+        profiler_ring_add(&_ring, &sample);
+        xSemaphoreGive(_lock);
+    }
+}
+
+static void _sample_probes(profiler_sample_t *p_sample, uint64_t window_cycles)
+{
+    for(int i = 0; i < PROFILER_PROBE_COUNT; i++)
+    {
+        profiler_counter_t *p_counter = &profiler_counters[i];
+        profiler_counter_t  end       = { .calls = p_counter->calls, .cycles = p_counter->cycles };
+        uint32_t            max       = p_counter->max;
+
+        p_counter->max = 0;
+        profiler_probe_stats(&_start[i], &end, max, window_cycles, &p_sample->probe[i]);
+        _start[i] = end;
+    }
+}
+
+static void _sample_tasks(profiler_sample_t *p_sample)
+{
+    uint32_t total = 0;
+    int      count = (int)uxTaskGetSystemState(_status, PROFILER_MAX_TASKS, &total);
+
+    // Array too small gives nothing at all, tasks keep the previous snapshot and core loads are left at 0
+    _is_truncated = (0 == count);
+    if(0 == count)
+    {
+        return;
+    }
+
+    uint32_t window = total - _prev_total;
+    for(int core = 0; core < PROFILER_CORES; core++)
+    {
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(core);
+        for(int i = 0; i < count; i++)
+        {
+            if(_status[i].xHandle == idle)
+            {
+                uint32_t idle_time = _status[i].ulRunTimeCounter - _prev_run_time(idle);
+                p_sample->cpu_permille[core] = 1000 - profiler_permille(idle_time, window);
+            }
+        }
+    }
+
+    for(int i = 0; i < count; i++)
+    {
+        profiler_task_t *p_task = &_tasks[i];
+
+        strlcpy(p_task->name, _status[i].pcTaskName, sizeof(p_task->name));
+        p_task->priority     = (uint8_t)_status[i].uxCurrentPriority;
+        p_task->cpu_permille = profiler_permille(_status[i].ulRunTimeCounter - _prev_run_time(_status[i].xHandle),
+                                                 window);
+        p_task->stack_free   = _status[i].usStackHighWaterMark;
+    }
+    qsort(_tasks, count, sizeof(_tasks[0]), _task_cmp);
+    _task_count = count;
+
+    for(int i = 0; i < count; i++)
+    {
+        _prev[i].handle   = _status[i].xHandle;
+        _prev[i].run_time = _status[i].ulRunTimeCounter;
+    }
+    _prev_count = count;
+    _prev_total = total;
+}
+
+static uint32_t _prev_run_time(TaskHandle_t handle)
+{
+    for(int i = 0; i < _prev_count; i++)
+    {
+        if(_prev[i].handle == handle)
+        {
+            return _prev[i].run_time;
+        }
+    }
+    return 0;
+}
+
+static int _task_cmp(const void *p_a, const void *p_b)
+{
+    const profiler_task_t *p_task_a = p_a;
+    const profiler_task_t *p_task_b = p_b;
+
+    return (int)p_task_b->cpu_permille - (int)p_task_a->cpu_permille;
+}
+
+#endif
+//---------------------------- INTERRUPT HANDLERS -----------------------------
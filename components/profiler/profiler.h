@@ -0,0 +1,145 @@
+/**
+ * @file profiler.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "profiler_stats.h"
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#if CONFIG_PROFILER_ENABLE
+#include "esp_cpu.h"
+#endif
+
+//---------------------------------- MACROS -----------------------------------
+#define PROFILER_MAX_TASKS     (32) // Most tasks run-time stats are taken of
+#define PROFILER_TASK_NAME_LEN (16) // Same as configMAX_TASK_NAME_LEN
+
+/*
+ * Probes time the code between PROFILER_BEGIN() and PROFILER_END() in the same scope with the cycle counter of the
+ * core they run on, PROFILER_COUNT() only counts calls. Each probe has to stay on one core and one context at a time.
+ * They cost a couple of register reads and three adds, and expand to nothing unless CONFIG_PROFILER_ENABLE is set.
+ */
+#if CONFIG_PROFILER_ENABLE
+#define PROFILER_BEGIN(probe) uint32_t _profiler_begin_##probe = esp_cpu_get_cycle_count()
+#define PROFILER_END(probe)   profiler_probe_add(probe, esp_cpu_get_cycle_count() - _profiler_begin_##probe)
+#define PROFILER_COUNT(probe) profiler_probe_add(probe, 0)
+#else
+#define PROFILER_BEGIN(probe)
+#define PROFILER_END(probe)
+#define PROFILER_COUNT(probe)
+#endif
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef enum
+{
+    PROFILER_ERR_NONE = 0,
+
+    PROFILER_ERR = -1,
+} profiler_err_t;
+
+typedef struct _profiler_task_t
+{
+    char     name[PROFILER_TASK_NAME_LEN];
+    uint8_t  priority;     // Current priority
+    uint16_t cpu_permille; // Share of one core the task took in the last window
+    uint32_t stack_free;   // Least free stack the task ever had, in bytes
+} profiler_task_t;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+extern profiler_counter_t profiler_counters[PROFILER_PROBE_COUNT];
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Adds run of a probe to its totals, use PROFILER_BEGIN() and PROFILER_END() instead. Safe in ISR.
+ *
+ * @param probe Probe
+ * @param cycles Length of the run in CPU cycles
+ */
+FORCE_INLINE_ATTR void profiler_probe_add(profiler_probe_t probe, uint32_t cycles)
+{
+    profiler_counter_t *p_counter = &profiler_counters[probe];
+
+    p_counter->calls++;
+    p_counter->cycles += cycles;
+    if(cycles > p_counter->max)
+    {
+        p_counter->max = cycles;
+    }
+}
+
+/**
+ * @brief Starts sampling run-time stats, stack high-water marks and probes every CONFIG_PROFILER_PERIOD_MS
+ *
+ * @return profiler_err_t PROFILER_ERR if the profiler is disabled or can't be started
+ */
+profiler_err_t profiler_init(void);
+
+/**
+ * @brief Copies the newest sample
+ *
+ * @param p_sample Sample
+ * @return true if there is a sample
+ */
+bool profiler_get_latest(profiler_sample_t *p_sample);
+
+/**
+ * @brief Copies CPU load history of a core
+ *
+ * @param core Core
+ * @param p_permille Load of each window in thousandths, oldest first
+ * @param max_count Number of loads p_permille holds
+ * @return int Number of loads copied, the newest ones if there are more than max_count
+ */
+int profiler_get_load_history(int core, uint16_t *p_permille, int max_count);
+
+/**
+ * @brief Copies tasks of the newest sample, busiest first
+ *
+ * @param p_tasks Tasks
+ * @param max_count Number of tasks p_tasks holds
+ * @return int Number of tasks copied
+ */
+int profiler_get_tasks(profiler_task_t *p_tasks, int max_count);
+
+/**
+ * @brief Returns short name of probe
+ *
+ * @param probe Probe
+ * @return const char* Name
+ */
+const char *profiler_probe_name(profiler_probe_t probe);
+
+/**
+ * @brief Converts CPU cycles to microseconds
+ *
+ * @param cycles Cycles
+ * @return float Microseconds
+ */
+float profiler_cycles_to_us(uint32_t cycles);
+
+/**
+ * @brief Prints CPU load, probes and tasks of the newest sample to stdout
+ *
+ */
+void profiler_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PROFILER_H__
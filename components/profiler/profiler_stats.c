@@ -0,0 +1,82 @@
+/**
+ * @file profiler_stats.c
+ *
+ * @brief   Window statistics of profiler probes and the ring they are kept in
+ *
+ * Probes only add to free running totals, so they cost a handful of cycles and need no lock. Everything else is done
+ * here by whoever samples them: totals taken at the start and end of a window are subtracted, which is correct across
+ * wraps as long as a window spends fewer than 2^32 cycles in one probe. Nothing here touches hardware, so it runs on
+ * host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "profiler_stats.h"
+#include <stddef.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+void profiler_probe_stats(const profiler_counter_t *p_start, const profiler_counter_t *p_end, uint32_t max_cycles,
+                          uint64_t window_cycles, profiler_probe_stats_t *p_stats)
+{
+    uint32_t calls  = p_end->calls - p_start->calls;
+    uint32_t cycles = p_end->cycles - p_start->cycles;
+
+    p_stats->calls       = calls;
+    p_stats->mean_cycles = (calls > 0) ? (uint32_t)(((uint64_t)cycles + calls / 2) / calls) : 0;
+    p_stats->max_cycles  = (calls > 0) ? max_cycles : 0;
+    p_stats->permille    = profiler_permille(cycles, window_cycles);
+}
+
+uint16_t profiler_permille(uint64_t part, uint64_t whole)
+{
+    if((0 == whole) || (part >= whole))
+    {
+        return (0 == whole) ? 0 : 1000;
+    }
+    return (uint16_t)((part * 1000 + whole / 2) / whole);
+}
+
+void profiler_ring_init(profiler_ring_t *p_ring, profiler_sample_t *p_samples, uint32_t len)
+{
+    p_ring->p_samples = p_samples;
+    p_ring->len       = len;
+    p_ring->head      = 0;
+    p_ring->count     = 0;
+}
+
+void profiler_ring_add(profiler_ring_t *p_ring, const profiler_sample_t *p_sample)
+{
+    p_ring->p_samples[p_ring->head] = *p_sample;
+    p_ring->head                    = (p_ring->head + 1 == p_ring->len) ? 0 : p_ring->head + 1;
+    if(p_ring->count < p_ring->len)
+    {
+        p_ring->count++;
+    }
+}
+
+const profiler_sample_t *profiler_ring_get(const profiler_ring_t *p_ring, uint32_t age)
+{
+    if(age >= p_ring->count)
+    {
+        return NULL;
+    }
+    uint32_t index = (p_ring->head + p_ring->len - 1 - age) % p_ring->len;
+    return &p_ring->p_samples[index];
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
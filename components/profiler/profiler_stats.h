@@ -0,0 +1,123 @@
+/**
+ * @file profiler_stats.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __PROFILER_STATS_H__
+#define __PROFILER_STATS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define PROFILER_CORES (2) // Cores CPU load is reported for
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef enum
+{
+    PROFILER_PROBE_ADC_READ,     // Oscilloscope sample, esp_timer callback
+    PROFILER_PROBE_DDS_ISR,      // Function generator sample timer interrupt
+    PROFILER_PROBE_GATE_ISR,     // Function generator gate edge interrupt
+    PROFILER_PROBE_CHART_UPDATE, // Copy of oscilloscope frames into the chart
+    PROFILER_PROBE_LV_TIMER,     // LVGL timer handler, includes rendering
+    PROFILER_PROBE_DISP_FLUSH,   // Display flush of a rendered area
+
+    PROFILER_PROBE_COUNT
+} profiler_probe_t;
+
+// Running totals written by probes, they only ever grow and wrap, readers take differences
+typedef struct _profiler_counter_t
+{
+    volatile uint32_t calls;  // Times the probe ran
+    volatile uint32_t cycles; // CPU cycles spent between begin and end of the probe
+    volatile uint32_t max;    // Longest single run since reader last cleared it
+} profiler_counter_t;
+
+typedef struct _profiler_probe_stats_t
+{
+    uint32_t calls;       // Times the probe ran in the window
+    uint32_t mean_cycles; // Average run, rounded
+    uint32_t max_cycles;  // Longest run
+    uint16_t permille;    // Share of one core the probe took
+} profiler_probe_stats_t;
+
+typedef struct _profiler_sample_t
+{
+    int64_t                time_us;                      // End of the window
+    uint32_t               window_us;                    // Length of the window
+    uint16_t               cpu_permille[PROFILER_CORES]; // Share of each core not spent in its idle task
+    profiler_probe_stats_t probe[PROFILER_PROBE_COUNT];
+} profiler_sample_t;
+
+typedef struct _profiler_ring_t
+{
+    profiler_sample_t *p_samples; // Sample storage
+    uint32_t           len;       // Number of samples storage holds
+    uint32_t           head;      // Index next sample is written to
+    uint32_t           count;     // Number of valid samples, saturates at len
+} profiler_ring_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Computes statistics of a probe over a window from its totals at the start and end of the window
+ *
+ * @param p_start Totals at the start of the window
+ * @param p_end Totals at the end of the window
+ * @param max_cycles Longest run in the window
+ * @param window_cycles Length of the window in CPU cycles
+ * @param p_stats Statistics
+ */
+void profiler_probe_stats(const profiler_counter_t *p_start, const profiler_counter_t *p_end, uint32_t max_cycles,
+                          uint64_t window_cycles, profiler_probe_stats_t *p_stats);
+
+/**
+ * @brief Returns part of whole in thousandths, rounded and clamped to 1000
+ *
+ * @param part Part
+ * @param whole Whole, 0 gives 0
+ * @return uint16_t Thousandths
+ */
+uint16_t profiler_permille(uint64_t part, uint64_t whole);
+
+/**
+ * @brief Initializes empty ring on storage
+ *
+ * @param p_ring Sample ring
+ * @param p_samples Storage for samples
+ * @param len Number of samples storage holds, at least 1
+ */
+void profiler_ring_init(profiler_ring_t *p_ring, profiler_sample_t *p_samples, uint32_t len);
+
+/**
+ * @brief Adds sample to ring, overwriting the oldest one when it is full
+ *
+ * @param p_ring Sample ring
+ * @param p_sample Sample
+ */
+void profiler_ring_add(profiler_ring_t *p_ring, const profiler_sample_t *p_sample);
+
+/**
+ * @brief Returns sample of ring
+ *
+ * @param p_ring Sample ring
+ * @param age 0 for the newest sample, 1 for the one before it and so on
+ * @return const profiler_sample_t* Sample, NULL if ring holds no more than age samples
+ */
+const profiler_sample_t *profiler_ring_get(const profiler_ring_t *p_ring, uint32_t age);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PROFILER_STATS_H__
@@ -0,0 +1,124 @@
+/**
+ * @file test_profiler_stats.c
+ *
+ * @brief   Host unit tests of profiler window statistics and sample ring
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "profiler_stats.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <stddef.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void _test_probe_stats(void);
+static void _test_wrap(void);
+static void _test_permille(void);
+static void _test_ring(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    _test_probe_stats();
+    _test_wrap();
+    _test_permille();
+    _test_ring();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _test_probe_stats(void)
+{
+    profiler_counter_t     start = { .calls = 100, .cycles = 5000 };
+    profiler_counter_t     end   = { .calls = 133, .cycles = 5000 + 33 * 160 + 20 };
+    profiler_probe_stats_t stats;
+
+    // 33 runs of 160 cycles plus a bit, 1 ms window at 160 MHz
+    profiler_probe_stats(&start, &end, 180, 160000, &stats);
+    CHECK(33 == stats.calls);
+    CHECK(161 == stats.mean_cycles);
+    CHECK(180 == stats.max_cycles);
+    CHECK(33 == stats.permille);
+
+    // Nothing ran, stale maximum isn't reported
+    profiler_probe_stats(&end, &end, 180, 160000, &stats);
+    CHECK(0 == stats.calls);
+    CHECK(0 == stats.mean_cycles);
+    CHECK(0 == stats.max_cycles);
+    CHECK(0 == stats.permille);
+
+    // Count only probes have calls but no time
+    profiler_counter_t counted = { .calls = 110, .cycles = 5000 };
+    profiler_probe_stats(&start, &counted, 0, 160000, &stats);
+    CHECK(10 == stats.calls);
+    CHECK(0 == stats.mean_cycles);
+    CHECK(0 == stats.permille);
+}
+
+static void _test_wrap(void)
+{
+    profiler_counter_t     start = { .calls = 0xFFFFFFF0u, .cycles = 0xFFFFFF00u };
+    profiler_counter_t     end   = { .calls = 0x10u, .cycles = 0x100u };
+    profiler_probe_stats_t stats;
+
+    profiler_probe_stats(&start, &end, 40, 1000000, &stats);
+    CHECK(0x20 == stats.calls);
+    CHECK(0x200 / 0x20 == stats.mean_cycles);
+    CHECK(1 == stats.permille);
+}
+
+static void _test_permille(void)
+{
+    CHECK(0 == profiler_permille(0, 1000));
+    CHECK(500 == profiler_permille(1, 2));
+    CHECK(1 == profiler_permille(14, 10000));
+    CHECK(2 == profiler_permille(15, 10000));
+    CHECK(1000 == profiler_permille(7, 7));
+    CHECK(1000 == profiler_permille(8, 7));
+    CHECK(0 == profiler_permille(5, 0));
+
+    // Large totals don't overflow
+    CHECK(250 == profiler_permille(1ull << 40, 1ull << 42));
+}
+
+static void _test_ring(void)
+{
+    profiler_sample_t storage[3];
+    profiler_ring_t   ring;
+
+    profiler_ring_init(&ring, storage, 3);
+    CHECK(NULL == profiler_ring_get(&ring, 0));
+
+    for(int i = 1; i <= 5; i++)
+    {
+        profiler_sample_t sample = { .time_us = i };
+        profiler_ring_add(&ring, &sample);
+
+        int kept = (i < 3) ? i : 3;
+        CHECK(kept == (int)ring.count);
+        for(int age = 0; age < kept; age++)
+        {
+            const profiler_sample_t *p_sample = profiler_ring_get(&ring, age);
+            CHECK((NULL != p_sample) && (i - age == p_sample->time_us));
+        }
+        CHECK(NULL == profiler_ring_get(&ring, kept));
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
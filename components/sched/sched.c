@@ -0,0 +1,213 @@
+/**
+ * @file sched.c
+ *
+ * @brief   Scheduling model: the core and priority class of every task and interrupt
+ *
+ * Core 0 (SCHED_CORE_IO) runs everything with a deadline. The DDS sample timer and gate GPIO interrupts are allocated
+ * from app_start(), which runs on core 0, and interrupts stay on the core that allocated them. The esp_timer task is
+ * pinned to core 0 by IDF at SCHED_PRIO_RT and runs oscilloscope sampling, the config sequencer timer and the LVGL
+ * tick. The sequencer timer only wakes the sequencer task, which takes the config lock and builds the next step.
+ * Housekeeping tasks share core 0 just above idle, so they only get time real-time paths leave.
+ *
+ * Core 1 (SCHED_CORE_UI) runs LVGL in the GUI task. LVGL isn't thread safe, so every LVGL call made outside of the
+ * GUI task's handler is made under gui_lock(). Oscilloscope frames are shown by an LVGL timer in that handler, the
+ * sampling timer only wakes the GUI task with gui_wake() when one is complete.
+ *
+ *     Task / interrupt          Class          Core  Priority
+ *     DDS sample timer ISR      real-time      0     interrupt
+ *     Gate GPIO ISR             real-time      0     interrupt
+ *     esp_timer callbacks       real-time      0     SCHED_PRIO_RT
+ *     GUI task                  ui             1     SCHED_PRIO_UI
+ *     Joystick update task      housekeeping   0     SCHED_PRIO_HOUSEKEEPING
+ *     Temperature read task     housekeeping   0     SCHED_PRIO_HOUSEKEEPING
+ *     Settings save task        housekeeping   0     SCHED_PRIO_HOUSEKEEPING
+ *     Profiler task             housekeeping   0     SCHED_PRIO_HOUSEKEEPING
+ *     Sequencer task            housekeeping   0     SCHED_PRIO_HOUSEKEEPING
+ *     Console, main task        housekeeping   any   IDF default
+ *
+ * Real-time paths never wait on UI. They pass data to it through queues they overwrite and never block on (oscilloscope
+ * frames), and the ISR renders from a bank built outside of it (DDS). The DDS ISR and all it touches are in IRAM/DRAM,
+ * so settings and preset flash writes don't hold output either. UI locks ask sched_ui_wait_allowed() before they block,
+ * which refuses real-time callers and counts the attempt, so a path that would stall sampling behind a redraw shows up
+ * in sched_print() and the stress test instead of as jitter.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "sched.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define SCHED_TIMER_TASK_NAME "esp_timer" // Name IDF gives the task running esp_timer callbacks
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _sched_task_cfg_t
+{
+    const char   *p_name;
+    sched_class_t class;
+    int           core;
+} sched_task_cfg_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "sched";
+
+static const sched_task_cfg_t _task_cfg[SCHED_TASK_COUNT] = {
+    [SCHED_TASK_GUI]      = { "gui", SCHED_CLASS_UI, SCHED_CORE_UI },
+    [SCHED_TASK_JOYSTICK] = { "Joystick update task", SCHED_CLASS_HOUSEKEEPING, SCHED_CORE_IO },
+    [SCHED_TASK_TEMP]     = { "Temperature read task", SCHED_CLASS_HOUSEKEEPING, SCHED_CORE_IO },
+    [SCHED_TASK_SETTINGS] = { "Settings save task", SCHED_CLASS_HOUSEKEEPING, SCHED_CORE_IO },
+    [SCHED_TASK_PROFILER] = { "Profiler task", SCHED_CLASS_HOUSEKEEPING, SCHED_CORE_IO },
+    [SCHED_TASK_SEQ]      = { "Sequencer task", SCHED_CLASS_HOUSEKEEPING, SCHED_CORE_IO },
+};
+
+static const UBaseType_t _class_prio[SCHED_CLASS_COUNT] = {
+    [SCHED_CLASS_RT]           = SCHED_PRIO_RT,
+    [SCHED_CLASS_UI]           = SCHED_PRIO_UI,
+    [SCHED_CLASS_HOUSEKEEPING] = SCHED_PRIO_HOUSEKEEPING,
+};
+
+static const char *const _class_name[SCHED_CLASS_COUNT] = {
+    [SCHED_CLASS_RT]           = "real-time",
+    [SCHED_CLASS_UI]           = "ui",
+    [SCHED_CLASS_HOUSEKEEPING] = "housekeeping",
+};
+
+static TaskHandle_t _handle[SCHED_TASK_COUNT];
+static TaskHandle_t _timer_task = NULL; // Looked up on first use, IDF creates it before app_main()
+static uint32_t     _violations = 0;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+sched_err_t sched_task_create(sched_task_t task, TaskFunction_t fn, uint32_t stack_size, void *p_arg,
+                              TaskHandle_t *p_handle)
+{
+    if(task >= SCHED_TASK_COUNT)
+    {
+        return SCHED_ERR;
+    }
+
+    const sched_task_cfg_t *p_cfg  = &_task_cfg[task];
+    TaskHandle_t            handle = NULL;
+
+    if(pdPASS != xTaskCreatePinnedToCore(fn, p_cfg->p_name, stack_size, p_arg, _class_prio[p_cfg->class], &handle,
+                                         p_cfg->core))
+    {
+        ESP_LOGE(TAG, "Failed to create %s", p_cfg->p_name);
+        return SCHED_ERR;
+    }
+
+    _handle[task] = handle;
+    if(NULL != p_handle)
+    {
+        *p_handle = handle;
+    }
+    return SCHED_ERR_NONE;
+}
+
+void sched_task_delete(sched_task_t task)
+{
+    // Forget the handle first, it's invalid once the task is gone
+    if(task < SCHED_TASK_COUNT)
+    {
+        _handle[task] = NULL;
+    }
+    vTaskDelete(NULL);
+}
+
+sched_class_t sched_class_current(void)
+{
+    if(xPortInIsrContext())
+    {
+        return SCHED_CLASS_RT;
+    }
+
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    if(NULL == _timer_task)
+    {
+        _timer_task = xTaskGetHandle(SCHED_TIMER_TASK_NAME);
+    }
+    if(self == _timer_task)
+    {
+        return SCHED_CLASS_RT;
+    }
+
+    for(int i = 0; i < SCHED_TASK_COUNT; i++)
+    {
+        if(self == _handle[i])
+        {
+            return _task_cfg[i].class;
+        }
+    }
+    return SCHED_CLASS_HOUSEKEEPING;
+}
+
+const char *sched_class_name(sched_class_t class)
+{
+    return (class < SCHED_CLASS_COUNT) ? _class_name[class] : "unknown";
+}
+
+bool sched_ui_wait_allowed(const char *p_lock)
+{
+    if(SCHED_CLASS_RT != sched_class_current())
+    {
+        return true;
+    }
+
+    __atomic_fetch_add(&_violations, 1, __ATOMIC_RELAXED);
+    if(!xPortInIsrContext())
+    {
+        ESP_LOGE(TAG, "Real-time path tried to wait on %s lock", p_lock);
+    }
+#if CONFIG_SCHED_STRICT
+    abort();
+#endif
+    return false;
+}
+
+uint32_t sched_violation_count(void)
+{
+    return __atomic_load_n(&_violations, __ATOMIC_RELAXED);
+}
+
+bool sched_check_core(int core, const char *p_what)
+{
+    int current = xPortGetCoreID();
+    if(current != core)
+    {
+        ESP_LOGE(TAG, "%s set up on core %d instead of core %d", p_what, current, core);
+        return false;
+    }
+    return true;
+}
+
+void sched_print(void)
+{
+    printf("%-22s %-13s %4s %4s %10s\n", "task", "class", "core", "prio", "stack free");
+    for(int i = 0; i < SCHED_TASK_COUNT; i++)
+    {
+        const sched_task_cfg_t *p_cfg = &_task_cfg[i];
+        if(NULL == _handle[i])
+        {
+            printf("%-22s %-13s %4d %4u %10s\n", p_cfg->p_name, _class_name[p_cfg->class], p_cfg->core,
+                   (unsigned)_class_prio[p_cfg->class], "not running");
+            continue;
+        }
+        printf("%-22s %-13s %4d %4u %10u\n", p_cfg->p_name, _class_name[p_cfg->class], p_cfg->core,
+               (unsigned)uxTaskPriorityGet(_handle[i]), (unsigned)uxTaskGetStackHighWaterMark(_handle[i]));
+    }
+    printf("Real-time waits on UI locks refused: %lu\n", (unsigned long)sched_violation_count());
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
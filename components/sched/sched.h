@@ -0,0 +1,152 @@
+/**
+ * @file sched.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_task.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define SCHED_CORE_IO (0) // Acquisition and generation: interrupts, esp_timer callbacks, housekeeping
+#define SCHED_CORE_UI (1) // Everything that touches LVGL
+
+#define SCHED_PRIO_RT           (ESP_TASK_TIMER_PRIO)   // esp_timer task, no application task runs this high
+#define SCHED_PRIO_UI           (tskIDLE_PRIORITY + 2u) // Above housekeeping, so slow I/O never delays a redraw
+#define SCHED_PRIO_HOUSEKEEPING (tskIDLE_PRIORITY + 1u) // Just above idle
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef enum
+{
+    SCHED_ERR_NONE = 0,
+
+    SCHED_ERR = -1,
+} sched_err_t;
+
+typedef enum
+{
+    SCHED_CLASS_RT,           // Interrupts and esp_timer callbacks, never block on anything but short driver locks
+    SCHED_CLASS_UI,           // LVGL work, serialized by the GUI lock
+    SCHED_CLASS_HOUSEKEEPING, // Sensors, input polling, storage, console and anything not listed
+
+    SCHED_CLASS_COUNT
+} sched_class_t;
+
+typedef enum
+{
+    SCHED_TASK_GUI,      // LVGL timer handler
+    SCHED_TASK_JOYSTICK, // Polls joystick for GUI navigation
+    SCHED_TASK_TEMP,     // Reads temperature sensor
+    SCHED_TASK_SETTINGS, // Writes batched settings to NVS
+    SCHED_TASK_PROFILER, // Samples run-time stats and probes
+    SCHED_TASK_SEQ,      // Applies function generator sequence steps
+
+    SCHED_TASK_COUNT
+} sched_task_t;
+
+/**
+ * @brief Work the stress test repeats to load UI class, e.g. a full redraw under the GUI lock
+ *
+ */
+typedef void (*sched_load_t)(void);
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Creates task pinned to the core and at the priority its class is given in the scheduling table
+ *
+ * @param task Task from the scheduling table
+ * @param fn Task function
+ * @param stack_size Stack size in bytes
+ * @param p_arg Argument passed to fn
+ * @param p_handle Handle of created task, NULL if not needed
+ * @return sched_err_t
+ */
+sched_err_t sched_task_create(sched_task_t task, TaskFunction_t fn, uint32_t stack_size, void *p_arg,
+                              TaskHandle_t *p_handle);
+
+/**
+ * @brief Deletes task created with sched_task_create(), called by the task itself when it gives up
+ *
+ * @param task Task from the scheduling table
+ */
+void sched_task_delete(sched_task_t task);
+
+/**
+ * @brief Returns class of the caller: interrupts and esp_timer callbacks are real-time, tasks created with
+ * sched_task_create() have their table class and any other task is housekeeping
+ *
+ * @return sched_class_t
+ */
+sched_class_t sched_class_current(void);
+
+/**
+ * @brief Returns name of class
+ *
+ * @param class Class
+ * @return const char*
+ */
+const char *sched_class_name(sched_class_t class);
+
+/**
+ * @brief Checks caller may wait on a UI lock. Real-time callers may not: the violation is counted and, with
+ * CONFIG_SCHED_STRICT, aborts.
+ *
+ * @param p_lock Name of the lock, for the log
+ * @return true if caller may wait
+ */
+bool sched_ui_wait_allowed(const char *p_lock);
+
+/**
+ * @brief Returns number of times a real-time path tried to wait on a UI lock since boot
+ *
+ * @return uint32_t
+ */
+uint32_t sched_violation_count(void);
+
+/**
+ * @brief Checks caller runs on core, used where interrupts are allocated since they stay on the allocating core
+ *
+ * @param core Expected core
+ * @param p_what What is being set up, for the log
+ * @return true if caller runs on core
+ */
+bool sched_check_core(int core, const char *p_what);
+
+/**
+ * @brief Prints scheduling table with the state of every created task
+ *
+ */
+void sched_print(void);
+
+/**
+ * @brief Runs a probe per class for duration_ms while UI and housekeeping cores are loaded, then prints wake-up
+ * latency of each class: how late an esp_timer callback, a UI task and a housekeeping task run after their deadline.
+ * Blocks the caller.
+ *
+ * @param duration_ms Length of the run
+ * @param ui_load Work repeated by the UI load task, NULL to only load housekeeping
+ * @return sched_err_t
+ */
+sched_err_t sched_stress_run(int duration_ms, sched_load_t ui_load);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SCHED_H__
@@ -0,0 +1,279 @@
+/**
+ * @file sched_stress.c
+ *
+ * @brief   Stress test reporting worst-case wake-up latency of each scheduling class
+ *
+ * A periodic esp_timer callback stands in for real-time paths, its latency is how late it runs after its alarm. Every
+ * STRESS_KICK_PERIOD_MS it also stamps the time and notifies one probe task per UI and housekeeping class, their
+ * latency is how late they run after the notification. Meanwhile a task at UI priority on the UI core repeats the
+ * given load and a task at housekeeping priority on the I/O core burns CPU, so each class is measured while the
+ * classes it should be isolated from are busy.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "sched.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define STRESS_RT_PERIOD_US   (1000) // Period of the real-time probe
+#define STRESS_KICK_PERIOD_MS (10)   // Period probe tasks are woken at
+#define STRESS_HOG_BUSY_US    (5000) // Time housekeeping load burns per tick, leaves the rest to idle and watchdog
+#define STRESS_STACK_SIZE     (3072u)
+#define STRESS_TASK_COUNT     (4)    // Probe and load tasks, all signal when they exit
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _stress_lat_t
+{
+    uint32_t count;
+    int64_t  sum_us;
+    int64_t  worst_us;
+} stress_lat_t;
+
+typedef struct _stress_t
+{
+    stress_lat_t      lat[SCHED_CLASS_COUNT];
+    stress_lat_t      ui_work;         // Duration of UI load calls
+    int64_t           rt_start_us;     // Time the real-time probe was started at
+    uint32_t          rt_ticks;        // Real-time probe callbacks run
+    volatile int64_t  kick_us;         // Time probe tasks were last notified at
+    TaskHandle_t      probe[SCHED_CLASS_COUNT];
+    sched_load_t      ui_load;
+    volatile bool     is_running;
+    SemaphoreHandle_t exited;          // Given by every task as it exits
+} stress_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Adds latency sample
+ *
+ * @param p_lat Accumulated latency
+ * @param late_us Sample, negative values count as 0
+ */
+static void _lat_add(stress_lat_t *p_lat, int64_t late_us);
+
+/**
+ * @brief Prints a row of the report
+ *
+ * @param p_name Row name
+ * @param p_lat Accumulated latency
+ */
+static void _lat_print(const char *p_name, const stress_lat_t *p_lat);
+
+/**
+ * @brief Real-time probe, measures how late it runs after its alarm
+ *
+ * @param p_arg Unused
+ */
+static void _on_rt_probe(void *p_arg);
+
+/**
+ * @brief Wakes probe tasks and stamps the time they were woken at
+ *
+ * @param p_arg Unused
+ */
+static void _on_kick(void *p_arg);
+
+/**
+ * @brief Probe task, measures how late it runs after being woken
+ *
+ * @param p_arg Class the task stands for
+ */
+static void _probe_task(void *p_arg);
+
+/**
+ * @brief Repeats UI load at UI priority on the UI core
+ *
+ * @param p_arg Unused
+ */
+static void _ui_load_task(void *p_arg);
+
+/**
+ * @brief Burns CPU at housekeeping priority on the I/O core
+ *
+ * @param p_arg Unused
+ */
+static void _hog_task(void *p_arg);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "sched_stress";
+
+static stress_t _stress;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+sched_err_t sched_stress_run(int duration_ms, sched_load_t ui_load)
+{
+    if(_stress.is_running || (duration_ms <= 0))
+    {
+        return SCHED_ERR;
+    }
+
+    memset(&_stress, 0, sizeof(_stress));
+    _stress.ui_load = ui_load;
+    _stress.exited  = xSemaphoreCreateCounting(STRESS_TASK_COUNT, 0);
+    if(NULL == _stress.exited)
+    {
+        return SCHED_ERR;
+    }
+
+    esp_timer_handle_t            rt_timer   = NULL;
+    esp_timer_handle_t            kick_timer = NULL;
+    const esp_timer_create_args_t rt_args    = { .callback = _on_rt_probe, .name = "stress_rt" };
+    const esp_timer_create_args_t kick_args  = { .callback = _on_kick, .name = "stress_kick" };
+    int                           created    = 0;
+    sched_err_t                   err        = SCHED_ERR_NONE;
+    uint32_t                      violations = sched_violation_count();
+
+    _stress.is_running = true;
+
+    created += (pdPASS == xTaskCreatePinnedToCore(_probe_task, "stress_ui", STRESS_STACK_SIZE,
+                                                  (void *)SCHED_CLASS_UI, SCHED_PRIO_UI,
+                                                  &_stress.probe[SCHED_CLASS_UI], SCHED_CORE_UI));
+    created += (pdPASS == xTaskCreatePinnedToCore(_probe_task, "stress_hk", STRESS_STACK_SIZE,
+                                                  (void *)SCHED_CLASS_HOUSEKEEPING, SCHED_PRIO_HOUSEKEEPING,
+                                                  &_stress.probe[SCHED_CLASS_HOUSEKEEPING], SCHED_CORE_IO));
+    created += (pdPASS == xTaskCreatePinnedToCore(_ui_load_task, "stress_load", STRESS_STACK_SIZE, NULL,
+                                                  SCHED_PRIO_UI, NULL, SCHED_CORE_UI));
+    created += (pdPASS == xTaskCreatePinnedToCore(_hog_task, "stress_hog", STRESS_STACK_SIZE, NULL,
+                                                  SCHED_PRIO_HOUSEKEEPING, NULL, SCHED_CORE_IO));
+
+    if((STRESS_TASK_COUNT != created) || (ESP_OK != esp_timer_create(&rt_args, &rt_timer)) ||
+       (ESP_OK != esp_timer_create(&kick_args, &kick_timer)))
+    {
+        ESP_LOGE(TAG, "Failed to start stress test");
+        err = SCHED_ERR;
+    }
+    else
+    {
+        // Periodic alarms are re-armed from the previous alarm, so lateness is measured against a fixed grid
+        _stress.rt_start_us = esp_timer_get_time();
+        esp_timer_start_periodic(rt_timer, STRESS_RT_PERIOD_US);
+        esp_timer_start_periodic(kick_timer, STRESS_KICK_PERIOD_MS * 1000);
+
+        vTaskDelay(pdMS_TO_TICKS(duration_ms));
+
+        esp_timer_stop(kick_timer);
+        esp_timer_stop(rt_timer);
+    }
+
+    // Probes may be waiting for a kick that won't come, they time out and see the flag
+    _stress.is_running = false;
+    for(int i = 0; i < created; i++)
+    {
+        xSemaphoreTake(_stress.exited, portMAX_DELAY);
+    }
+    esp_timer_delete(kick_timer);
+    esp_timer_delete(rt_timer);
+    vSemaphoreDelete(_stress.exited);
+
+    if(SCHED_ERR_NONE == err)
+    {
+        printf("%-13s %8s %9s %9s\n", "class", "wakeups", "mean us", "worst us");
+        for(int i = 0; i < SCHED_CLASS_COUNT; i++)
+        {
+            _lat_print(sched_class_name(i), &_stress.lat[i]);
+        }
+        _lat_print("ui load run", &_stress.ui_work);
+        printf("Real-time waits on UI locks refused: %lu\n",
+               (unsigned long)(sched_violation_count() - violations));
+    }
+    return err;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _lat_add(stress_lat_t *p_lat, int64_t late_us)
+{
+    late_us = (late_us < 0) ? 0 : late_us;
+
+    p_lat->count++;
+    p_lat->sum_us += late_us;
+    p_lat->worst_us = (late_us > p_lat->worst_us) ? late_us : p_lat->worst_us;
+}
+
+static void _lat_print(const char *p_name, const stress_lat_t *p_lat)
+{
+    int64_t mean_us = (p_lat->count > 0) ? p_lat->sum_us / p_lat->count : 0;
+
+    printf("%-13s %8lu %9lld %9lld\n", p_name, (unsigned long)p_lat->count, (long long)mean_us,
+           (long long)p_lat->worst_us);
+}
+
+static void _on_rt_probe(void *p_arg)
+{
+    (void)p_arg;
+
+    int64_t now_us = esp_timer_get_time();
+    _stress.rt_ticks++;
+
+    int64_t due_us = _stress.rt_start_us + (int64_t)_stress.rt_ticks * STRESS_RT_PERIOD_US;
+    _lat_add(&_stress.lat[SCHED_CLASS_RT], now_us - due_us);
+}
+
+static void _on_kick(void *p_arg)
+{
+    (void)p_arg;
+
+    _stress.kick_us = esp_timer_get_time();
+    xTaskNotifyGive(_stress.probe[SCHED_CLASS_UI]);
+    xTaskNotifyGive(_stress.probe[SCHED_CLASS_HOUSEKEEPING]);
+}
+
+static void _probe_task(void *p_arg)
+{
+    sched_class_t class = (sched_class_t)(intptr_t)p_arg;
+
+    while(_stress.is_running)
+    {
+        if(ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10 * STRESS_KICK_PERIOD_MS)) > 0)
+        {
+            _lat_add(&_stress.lat[class], esp_timer_get_time() - _stress.kick_us);
+        }
+    }
+    xSemaphoreGive(_stress.exited);
+    vTaskDelete(NULL);
+}
+
+static void _ui_load_task(void *p_arg)
+{
+    (void)p_arg;
+
+    while(_stress.is_running)
+    {
+        if(NULL != _stress.ui_load)
+        {
+            int64_t start_us = esp_timer_get_time();
+            _stress.ui_load();
+            _lat_add(&_stress.ui_work, esp_timer_get_time() - start_us);
+        }
+        vTaskDelay(1);
+    }
+    xSemaphoreGive(_stress.exited);
+    vTaskDelete(NULL);
+}
+
+static void _hog_task(void *p_arg)
+{
+    (void)p_arg;
+
+    while(_stress.is_running)
+    {
+        esp_rom_delay_us(STRESS_HOG_BUSY_US);
+        vTaskDelay(1);
+    }
+    xSemaphoreGive(_stress.exited);
+    vTaskDelete(NULL);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
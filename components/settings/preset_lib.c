@@ -0,0 +1,622 @@
+/**
+ * @file preset_lib.c
+ *
+ * @brief   Named preset library in raw flash
+ *
+ * Flash is split into fixed PRESET_LIB_REC_SIZE slots. A preset is written once into an erased slot and retired by
+ * programming its state word to zero, so saving never erases. RAM only holds the slot numbers of live records sorted
+ * by name, which makes lookup a binary search and lets presets be indexed in name order; names are read back from
+ * flash while searching.
+ *
+ * One erased sector is always kept in reserve. When no other slot is free, live records of the sector with most
+ * retired ones are copied into the reserve before that sector is erased, so a power loss at any point leaves every
+ * record in at least one place. Copies keep their sequence number, which is how open() tells them from newer records
+ * saved under the same name.
+ *
+ * Nothing here touches hardware, flash comes in through preset_lib_flash_t, so the library is tested on host. Calls
+ * aren't serialized, library is meant to be used from one task.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "preset_lib.h"
+#include <stdlib.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define SLOT_OFFSET(slot) ((uint32_t)(slot) * PRESET_LIB_REC_SIZE)
+#define NAME_OFFSET(slot) (SLOT_OFFSET(slot) + offsetof(preset_lib_rec_t, name))
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Returns CRC of everything in record after the state and CRC words
+ *
+ * @param p_rec Record
+ * @return uint32_t CRC
+ */
+static uint32_t _rec_crc(const preset_lib_rec_t *p_rec);
+
+/**
+ * @brief Checks name fits a record
+ *
+ * @param p_name Name
+ * @return true if name is valid
+ */
+static bool _is_name_valid(const char *p_name);
+
+/**
+ * @brief Binary searches the index for name
+ *
+ * @param p_name Name
+ * @param p_pos Index position of the name if found, otherwise position it would be inserted at
+ * @return int 1 if found, 0 if not, PRESET_LIB_ERR_FLASH if a name couldn't be read
+ */
+static int _search(const char *p_name, int *p_pos);
+
+/**
+ * @brief Adds a valid record found while scanning to the index, retiring the older of two records with one name
+ *
+ * @param slot Slot of the record
+ * @param p_rec Record
+ */
+static void _index_scanned(int slot, const preset_lib_rec_t *p_rec);
+
+/**
+ * @brief Programs record state word to PRESET_LIB_REC_DELETED
+ *
+ * @param slot Slot of the record
+ * @return int 0 on success
+ */
+static int _retire(int slot);
+
+/**
+ * @brief Takes a free slot, keeping one erased sector in reserve. Reclaims retired slots if needed.
+ *
+ * @param p_slot Free slot
+ * @return preset_lib_err_t
+ */
+static preset_lib_err_t _alloc_slot(int *p_slot);
+
+/**
+ * @brief Erases the sector with most retired slots, moving its live records into free slots of other sectors first
+ *
+ * @return preset_lib_err_t PRESET_LIB_ERR_FULL if nothing can be reclaimed
+ */
+static preset_lib_err_t _collect(void);
+
+/**
+ * @brief Erases sector and marks all its slots free
+ *
+ * @param sector Sector
+ * @return int 0 on success
+ */
+static int _erase_sector(int sector);
+
+/**
+ * @brief Returns number of live records in sector
+ *
+ * @param sector Sector
+ * @return int
+ */
+static int _sector_live(int sector);
+
+/**
+ * @brief Returns first erased sector
+ *
+ * @return int Sector, -1 if none is erased
+ */
+static int _erased_sector(void);
+
+/**
+ * @brief Returns true if slot is erased
+ *
+ * @param slot Slot
+ * @return true if slot is free
+ */
+static bool _is_free(int slot);
+
+/**
+ * @brief Marks slot free or taken
+ *
+ * @param slot Slot
+ * @param is_free True if slot is erased
+ */
+static void _set_free(int slot, bool is_free);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+_Static_assert(sizeof(preset_lib_rec_t) == PRESET_LIB_REC_SIZE, "Preset record doesn't fill its slot");
+
+static const preset_lib_flash_t *_p_flash          = NULL;
+static uint16_t                 *_p_index          = NULL; // Slots of live records in name order
+static uint32_t                 *_p_free_bits      = NULL; // Bit per slot, set if slot is erased
+static uint16_t                 *_p_sector_free    = NULL; // Number of erased slots per sector
+static int                       _count            = 0;    // Number of live records
+static int                       _slot_count       = 0;
+static int                       _sector_count     = 0;
+static int                       _slots_per_sector = 0;
+static uint32_t                  _seq              = 0; // Highest sequence number on flash
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+preset_lib_err_t preset_lib_open(const preset_lib_flash_t *p_flash)
+{
+    free(_p_index);
+    free(_p_free_bits);
+    free(_p_sector_free);
+    _p_index       = NULL;
+    _p_free_bits   = NULL;
+    _p_sector_free = NULL;
+    _p_flash       = NULL;
+    _count         = 0;
+    _seq           = 0;
+
+    // Library needs a sector to write into besides the reserve one
+    if((0 == p_flash->sector_size) || (0 != p_flash->sector_size % PRESET_LIB_REC_SIZE) ||
+       (p_flash->size / p_flash->sector_size < 2) || (p_flash->size / PRESET_LIB_REC_SIZE > UINT16_MAX))
+    {
+        return PRESET_LIB_ERR;
+    }
+
+    _slots_per_sector = p_flash->sector_size / PRESET_LIB_REC_SIZE;
+    _sector_count     = p_flash->size / p_flash->sector_size;
+    _slot_count       = _sector_count * _slots_per_sector;
+
+    _p_index       = malloc(_slot_count * sizeof(*_p_index));
+    _p_free_bits   = calloc((_slot_count + 31) / 32, sizeof(*_p_free_bits));
+    _p_sector_free = calloc(_sector_count, sizeof(*_p_sector_free));
+    if((NULL == _p_index) || (NULL == _p_free_bits) || (NULL == _p_sector_free))
+    {
+        return PRESET_LIB_ERR;
+    }
+    _p_flash = p_flash;
+
+    // Free slots are counted first, copies left by a cut short collection are told apart by them
+    preset_lib_rec_t rec;
+    for(int slot = 0; slot < _slot_count; slot++)
+    {
+        if(0 != _p_flash->read(_p_flash->p_ctx, SLOT_OFFSET(slot), &rec, sizeof(rec)))
+        {
+            return PRESET_LIB_ERR_FLASH;
+        }
+
+        // Slot is only free if a write never started in it
+        const uint8_t *p_byte = (const uint8_t *)&rec;
+        bool           is_erased = true;
+        for(size_t i = 0; (i < sizeof(rec)) && is_erased; i++)
+        {
+            is_erased = (0xFF == p_byte[i]);
+        }
+        _set_free(slot, is_erased);
+    }
+
+    for(int slot = 0; slot < _slot_count; slot++)
+    {
+        if(_is_free(slot) || (0 != _p_flash->read(_p_flash->p_ctx, SLOT_OFFSET(slot), &rec, sizeof(rec))))
+        {
+            continue;
+        }
+
+        // Deleted, torn and other layout records just wait to be reclaimed
+        if((PRESET_LIB_REC_VALID == rec.state) && (_rec_crc(&rec) == rec.crc) &&
+           ('\0' == rec.name[PRESET_LIB_NAME_LEN - 1]) && _is_name_valid(rec.name))
+        {
+            _index_scanned(slot, &rec);
+        }
+    }
+
+    // Collection was cut short, finish it so there is a reserve sector again
+    if(_erased_sector() < 0)
+    {
+        _collect();
+    }
+    return PRESET_LIB_ERR_NONE;
+}
+
+int preset_lib_count(void)
+{
+    return _count;
+}
+
+int preset_lib_free(void)
+{
+    // Everything but the reserve sector can be reclaimed
+    return (NULL == _p_flash) ? 0 : _slot_count - _slots_per_sector - _count;
+}
+
+preset_lib_err_t preset_lib_save(const char *p_name, const fn_signal_config_t *p_config)
+{
+    if(NULL == _p_flash)
+    {
+        return PRESET_LIB_ERR;
+    }
+    if(!_is_name_valid(p_name))
+    {
+        return PRESET_LIB_ERR_NAME;
+    }
+
+    preset_lib_rec_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.state = PRESET_LIB_REC_VALID;
+    strncpy(rec.name, p_name, sizeof(rec.name) - 1);
+    settings_signal_encode(p_config, &rec.config);
+
+    int pos;
+    int found = _search(p_name, &pos);
+    if(found < 0)
+    {
+        return PRESET_LIB_ERR_FLASH;
+    }
+
+    // Saving the same config again doesn't cost a write
+    if(found)
+    {
+        settings_signal_rec_t stored;
+        if((0 == _p_flash->read(_p_flash->p_ctx, SLOT_OFFSET(_p_index[pos]) + offsetof(preset_lib_rec_t, config),
+                                &stored, sizeof(stored))) &&
+           (0 == memcmp(&stored, &rec.config, sizeof(stored))))
+        {
+            return PRESET_LIB_ERR_NONE;
+        }
+    }
+
+    // Collection moves records, so the position is searched again after it
+    int              slot;
+    preset_lib_err_t err = _alloc_slot(&slot);
+    if(PRESET_LIB_ERR_NONE != err)
+    {
+        return err;
+    }
+    found = _search(p_name, &pos);
+    if(found < 0)
+    {
+        return PRESET_LIB_ERR_FLASH;
+    }
+
+    rec.seq = _seq + 1;
+    rec.crc = _rec_crc(&rec);
+
+    _set_free(slot, false);
+    if(0 != _p_flash->write(_p_flash->p_ctx, SLOT_OFFSET(slot), &rec, sizeof(rec)))
+    {
+        // Slot may be half written, it is reclaimed as a retired one
+        return PRESET_LIB_ERR_FLASH;
+    }
+    _seq = rec.seq;
+
+    if(found)
+    {
+        // If this fails the older record is retired on next open by its lower sequence number
+        _retire(_p_index[pos]);
+        _p_index[pos] = (uint16_t)slot;
+    }
+    else
+    {
+        memmove(&_p_index[pos + 1], &_p_index[pos], (_count - pos) * sizeof(*_p_index));
+        _p_index[pos] = (uint16_t)slot;
+        _count++;
+    }
+    return PRESET_LIB_ERR_NONE;
+}
+
+preset_lib_err_t preset_lib_load(const char *p_name, fn_signal_config_t *p_config)
+{
+    int index = preset_lib_find(p_name);
+    if(index < 0)
+    {
+        return PRESET_LIB_ERR_NOT_FOUND;
+    }
+    return preset_lib_get(index, NULL, p_config);
+}
+
+preset_lib_err_t preset_lib_get(int index, char *p_name, fn_signal_config_t *p_config)
+{
+    if((index < 0) || (index >= _count))
+    {
+        return PRESET_LIB_ERR_NOT_FOUND;
+    }
+
+    preset_lib_rec_t rec;
+    if(0 != _p_flash->read(_p_flash->p_ctx, SLOT_OFFSET(_p_index[index]), &rec, sizeof(rec)))
+    {
+        return PRESET_LIB_ERR_FLASH;
+    }
+
+    if(NULL != p_name)
+    {
+        memcpy(p_name, rec.name, PRESET_LIB_NAME_LEN);
+    }
+    if(NULL != p_config)
+    {
+        settings_signal_decode(&rec.config, p_config);
+    }
+    return PRESET_LIB_ERR_NONE;
+}
+
+int preset_lib_find(const char *p_name)
+{
+    int pos;
+    if((NULL == _p_flash) || !_is_name_valid(p_name) || (1 != _search(p_name, &pos)))
+    {
+        return -1;
+    }
+    return pos;
+}
+
+preset_lib_err_t preset_lib_delete(const char *p_name)
+{
+    int pos = preset_lib_find(p_name);
+    if(pos < 0)
+    {
+        return PRESET_LIB_ERR_NOT_FOUND;
+    }
+    if(0 != _retire(_p_index[pos]))
+    {
+        return PRESET_LIB_ERR_FLASH;
+    }
+
+    _count--;
+    memmove(&_p_index[pos], &_p_index[pos + 1], (_count - pos) * sizeof(*_p_index));
+    return PRESET_LIB_ERR_NONE;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static uint32_t _rec_crc(const preset_lib_rec_t *p_rec)
+{
+    return settings_crc32(&p_rec->seq, sizeof(*p_rec) - offsetof(preset_lib_rec_t, seq));
+}
+
+static bool _is_name_valid(const char *p_name)
+{
+    size_t len = strnlen(p_name, PRESET_LIB_NAME_LEN);
+    return (len > 0) && (len < PRESET_LIB_NAME_LEN);
+}
+
+static int _search(const char *p_name, int *p_pos)
+{
+    int  low  = 0;
+    int  high = _count;
+    char name[PRESET_LIB_NAME_LEN];
+
+    while(low < high)
+    {
+        int mid = (low + high) / 2;
+        if(0 != _p_flash->read(_p_flash->p_ctx, NAME_OFFSET(_p_index[mid]), name, sizeof(name)))
+        {
+            return PRESET_LIB_ERR_FLASH;
+        }
+
+        int cmp = strncmp(p_name, name, sizeof(name));
+        if(0 == cmp)
+        {
+            *p_pos = mid;
+            return 1;
+        }
+        if(cmp < 0)
+        {
+            high = mid;
+        }
+        else
+        {
+            low = mid + 1;
+        }
+    }
+    *p_pos = low;
+    return 0;
+}
+
+static void _index_scanned(int slot, const preset_lib_rec_t *p_rec)
+{
+    if(p_rec->seq > _seq)
+    {
+        _seq = p_rec->seq;
+    }
+
+    int pos;
+    int found = _search(p_rec->name, &pos);
+    if(found < 0)
+    {
+        return;
+    }
+    if(0 == found)
+    {
+        memmove(&_p_index[pos + 1], &_p_index[pos], (_count - pos) * sizeof(*_p_index));
+        _p_index[pos] = (uint16_t)slot;
+        _count++;
+        return;
+    }
+
+    uint32_t other_seq;
+    int      other = _p_index[pos];
+    if(0 != _p_flash->read(_p_flash->p_ctx, SLOT_OFFSET(other) + offsetof(preset_lib_rec_t, seq), &other_seq,
+                           sizeof(other_seq)))
+    {
+        return;
+    }
+
+    // Equal numbers mean an identical copy left by a cut short collection, keeping the one in the fuller sector lets
+    // the other sector be reclaimed
+    bool is_newer = (p_rec->seq > other_seq) ||
+                    ((p_rec->seq == other_seq) &&
+                     (_p_sector_free[slot / _slots_per_sector] < _p_sector_free[other / _slots_per_sector]));
+    if(is_newer)
+    {
+        _retire(other);
+        _p_index[pos] = (uint16_t)slot;
+    }
+    else
+    {
+        _retire(slot);
+    }
+}
+
+static int _retire(int slot)
+{
+    uint32_t state = PRESET_LIB_REC_DELETED;
+    return _p_flash->write(_p_flash->p_ctx, SLOT_OFFSET(slot), &state, sizeof(state));
+}
+
+static preset_lib_err_t _alloc_slot(int *p_slot)
+{
+    for(int attempt = 0; attempt < 2; attempt++)
+    {
+        // Partly used sectors are filled first, erased ones are opened while another stays in reserve
+        int erased      = 0;
+        int open_sector = -1;
+        for(int sector = 0; sector < _sector_count; sector++)
+        {
+            if(_p_sector_free[sector] == _slots_per_sector)
+            {
+                erased++;
+            }
+            else if((_p_sector_free[sector] > 0) && (open_sector < 0))
+            {
+                open_sector = sector;
+            }
+        }
+        if((open_sector < 0) && (erased >= 2))
+        {
+            open_sector = _erased_sector();
+        }
+
+        if(open_sector >= 0)
+        {
+            for(int slot = open_sector * _slots_per_sector; slot < (open_sector + 1) * _slots_per_sector; slot++)
+            {
+                if(_is_free(slot))
+                {
+                    *p_slot = slot;
+                    return PRESET_LIB_ERR_NONE;
+                }
+            }
+        }
+
+        if((0 == attempt) && (PRESET_LIB_ERR_NONE != _collect()))
+        {
+            break;
+        }
+    }
+    return PRESET_LIB_ERR_FULL;
+}
+
+static preset_lib_err_t _collect(void)
+{
+    int total_free = 0;
+    for(int sector = 0; sector < _sector_count; sector++)
+    {
+        total_free += _p_sector_free[sector];
+    }
+
+    // Live records have to fit into free slots of other sectors, normally that is the reserve
+    int victim    = -1;
+    int most_dead = 0;
+    for(int sector = 0; sector < _sector_count; sector++)
+    {
+        int live = _sector_live(sector);
+        int dead = _slots_per_sector - _p_sector_free[sector] - live;
+        if((dead > most_dead) && (live <= total_free - _p_sector_free[sector]))
+        {
+            victim    = sector;
+            most_dead = dead;
+        }
+    }
+    if(victim < 0)
+    {
+        return PRESET_LIB_ERR_FULL;
+    }
+
+    preset_lib_rec_t rec;
+    int              copy = 0;
+    for(int i = 0; i < _count; i++)
+    {
+        int slot = _p_index[i];
+        if(slot / _slots_per_sector != victim)
+        {
+            continue;
+        }
+
+        while(!_is_free(copy) || (copy / _slots_per_sector == victim))
+        {
+            copy++;
+        }
+        if(0 != _p_flash->read(_p_flash->p_ctx, SLOT_OFFSET(slot), &rec, sizeof(rec)))
+        {
+            return PRESET_LIB_ERR_FLASH;
+        }
+        _set_free(copy, false);
+        if(0 != _p_flash->write(_p_flash->p_ctx, SLOT_OFFSET(copy), &rec, sizeof(rec)))
+        {
+            return PRESET_LIB_ERR_FLASH;
+        }
+        _p_index[i] = (uint16_t)copy;
+    }
+
+    return (0 == _erase_sector(victim)) ? PRESET_LIB_ERR_NONE : PRESET_LIB_ERR_FLASH;
+}
+
+static int _erase_sector(int sector)
+{
+    if(0 != _p_flash->erase(_p_flash->p_ctx, sector * _p_flash->sector_size, _p_flash->sector_size))
+    {
+        return -1;
+    }
+    for(int slot = sector * _slots_per_sector; slot < (sector + 1) * _slots_per_sector; slot++)
+    {
+        _set_free(slot, true);
+    }
+    return 0;
+}
+
+static int _sector_live(int sector)
+{
+    int live = 0;
+    for(int i = 0; i < _count; i++)
+    {
+        live += (_p_index[i] / _slots_per_sector == sector) ? 1 : 0;
+    }
+    return live;
+}
+
+static int _erased_sector(void)
+{
+    for(int sector = 0; sector < _sector_count; sector++)
+    {
+        if(_p_sector_free[sector] == _slots_per_sector)
+        {
+            return sector;
+        }
+    }
+    return -1;
+}
+
+static bool _is_free(int slot)
+{
+    return 0 != (_p_free_bits[slot / 32] & (1u << (slot % 32)));
+}
+
+static void _set_free(int slot, bool is_free)
+{
+    if(is_free == _is_free(slot))
+    {
+        return;
+    }
+
+    if(is_free)
+    {
+        _p_free_bits[slot / 32] |= 1u << (slot % 32);
+        _p_sector_free[slot / _slots_per_sector]++;
+    }
+    else
+    {
+        _p_free_bits[slot / 32] &= ~(1u << (slot % 32));
+        _p_sector_free[slot / _slots_per_sector]--;
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,150 @@
+/**
+ * @file preset_lib.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __PRESET_LIB_H__
+#define __PRESET_LIB_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "settings_codec.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define PRESET_LIB_PARTITION_LABEL "presets" // Data partition library is kept in
+#define PRESET_LIB_NAME_LEN        (28)      // Name buffer size, longest name is one character shorter
+#define PRESET_LIB_REC_SIZE        (64)      // Flash slot size of a preset record
+
+#define PRESET_LIB_REC_VALID   (0x31425350u) // "PSB1" little endian, state of a record written by this layout
+#define PRESET_LIB_REC_ERASED  (0xFFFFFFFFu) // State of a free slot
+#define PRESET_LIB_REC_DELETED (0x00000000u) // State of a deleted or replaced record, programmed over VALID
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef enum
+{
+    PRESET_LIB_ERR_NONE = 0,
+
+    PRESET_LIB_ERR           = -1,
+    PRESET_LIB_ERR_NOT_FOUND = -2, // No preset with the name or index
+    PRESET_LIB_ERR_FULL      = -3, // No free slot left, even after reclaiming deleted ones
+    PRESET_LIB_ERR_FLASH     = -4, // Flash access failed
+    PRESET_LIB_ERR_NAME      = -5, // Name is empty or too long
+} preset_lib_err_t;
+
+/**
+ * @brief Flash the library lives in. Erased bytes read 0xFF and writes can only clear bits, same as NOR flash.
+ * Accessors return 0 on success.
+ *
+ */
+typedef struct _preset_lib_flash_t
+{
+    int (*read)(void *p_ctx, uint32_t offset, void *p_dst, size_t len);
+    int (*write)(void *p_ctx, uint32_t offset, const void *p_src, size_t len);
+    int (*erase)(void *p_ctx, uint32_t offset, size_t len); // Offset and length are multiples of sector_size
+    void    *p_ctx;
+    uint32_t size;        // Bytes available, multiple of sector_size
+    uint32_t sector_size; // Erase unit, multiple of PRESET_LIB_REC_SIZE
+} preset_lib_flash_t;
+
+// Record is written in one go, its CRC covers everything after the state word so torn writes are detected
+typedef struct _preset_lib_rec_t
+{
+    uint32_t              state;                    // PRESET_LIB_REC_* value
+    uint32_t              crc;                      // CRC-32 of seq, name and config
+    uint32_t              seq;                      // Write order, newer record wins if power was lost mid replace
+    char                  name[PRESET_LIB_NAME_LEN]; // Zero padded
+    settings_signal_rec_t config;
+} preset_lib_rec_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Opens library on the preset data partition
+ *
+ * @return preset_lib_err_t
+ */
+preset_lib_err_t preset_lib_init(void);
+
+/**
+ * @brief Opens library on any flash. Flash is scanned once to build the name index in RAM, records left
+ * half replaced by a power loss are settled.
+ *
+ * @param p_flash Flash accessors, has to stay valid while the library is used
+ * @return preset_lib_err_t
+ */
+preset_lib_err_t preset_lib_open(const preset_lib_flash_t *p_flash);
+
+/**
+ * @brief Returns number of stored presets
+ *
+ * @return int
+ */
+int preset_lib_count(void);
+
+/**
+ * @brief Returns number of presets that can still be stored, counting slots reclaimed from deleted records
+ *
+ * @return int
+ */
+int preset_lib_free(void);
+
+/**
+ * @brief Stores preset under name, replacing the one with the same name
+ *
+ * @param p_name Name, 1 to PRESET_LIB_NAME_LEN - 1 characters
+ * @param p_config Signal config
+ * @return preset_lib_err_t
+ */
+preset_lib_err_t preset_lib_save(const char *p_name, const fn_signal_config_t *p_config);
+
+/**
+ * @brief Reads preset by name
+ *
+ * @param p_name Name
+ * @param p_config Signal config, only valid if PRESET_LIB_ERR_NONE is returned
+ * @return preset_lib_err_t
+ */
+preset_lib_err_t preset_lib_load(const char *p_name, fn_signal_config_t *p_config);
+
+/**
+ * @brief Reads preset by index. Presets are indexed in name order, from 0 to preset_lib_count() - 1.
+ *
+ * @param index Index
+ * @param p_name Buffer of PRESET_LIB_NAME_LEN bytes for the name, NULL if not needed
+ * @param p_config Signal config, NULL if not needed
+ * @return preset_lib_err_t
+ */
+preset_lib_err_t preset_lib_get(int index, char *p_name, fn_signal_config_t *p_config);
+
+/**
+ * @brief Returns index of preset
+ *
+ * @param p_name Name
+ * @return int Index in name order, or -1 if there is no such preset
+ */
+int preset_lib_find(const char *p_name);
+
+/**
+ * @brief Deletes preset
+ *
+ * @param p_name Name
+ * @return preset_lib_err_t
+ */
+preset_lib_err_t preset_lib_delete(const char *p_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PRESET_LIB_H__
@@ -0,0 +1,81 @@
+/**
+ * @file preset_lib_partition.c
+ *
+ * @brief   Preset library on the preset data partition
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "preset_lib.h"
+#include "esp_partition.h"
+#include "spi_flash_mmap.h"
+#include "esp_log.h"
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static int _read(void *p_ctx, uint32_t offset, void *p_dst, size_t len);
+static int _write(void *p_ctx, uint32_t offset, const void *p_src, size_t len);
+static int _erase(void *p_ctx, uint32_t offset, size_t len);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "preset_lib";
+
+static preset_lib_flash_t _flash = {
+    .read  = _read,
+    .write = _write,
+    .erase = _erase,
+};
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+preset_lib_err_t preset_lib_init(void)
+{
+    const esp_partition_t *p_part =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, PRESET_LIB_PARTITION_LABEL);
+    if(NULL == p_part)
+    {
+        ESP_LOGE(TAG, "No \"%s\" partition", PRESET_LIB_PARTITION_LABEL);
+        return PRESET_LIB_ERR;
+    }
+
+    _flash.p_ctx       = (void *)p_part;
+    _flash.size        = p_part->size - p_part->size % SPI_FLASH_SEC_SIZE;
+    _flash.sector_size = SPI_FLASH_SEC_SIZE;
+
+    preset_lib_err_t err = preset_lib_open(&_flash);
+    if(PRESET_LIB_ERR_NONE == err)
+    {
+        ESP_LOGI(TAG, "%d presets, room for %d more", preset_lib_count(), preset_lib_free());
+    }
+    else
+    {
+        ESP_LOGE(TAG, "Failed to open preset library (%d)", err);
+    }
+    return err;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static int _read(void *p_ctx, uint32_t offset, void *p_dst, size_t len)
+{
+    return (ESP_OK == esp_partition_read(p_ctx, offset, p_dst, len)) ? 0 : -1;
+}
+
+static int _write(void *p_ctx, uint32_t offset, const void *p_src, size_t len)
+{
+    return (ESP_OK == esp_partition_write(p_ctx, offset, p_src, len)) ? 0 : -1;
+}
+
+static int _erase(void *p_ctx, uint32_t offset, size_t len)
+{
+    return (ESP_OK == esp_partition_erase_range(p_ctx, offset, len)) ? 0 : -1;
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,282 @@
+/**
+ * @file settings.c
+ *
+ * @brief   Persistent settings in NVS
+ *
+ * Presets, last channel configs and oscilloscope view are kept in one NVS blob. Saving only copies settings and
+ * wakes the save task, which waits until they stop changing, so dragging an arc ends in a single flash write.
+ * Calibration and oscilloscope references have blobs of their own and are written when asked.
+ * Writes stall everything that runs from flash for their duration, the DDS sample ISR runs from IRAM through them.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "settings.h"
+#include "sched.h"
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+#include "esp_log.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define SETTINGS_NAMESPACE "settings"
+#define SETTINGS_KEY       "blob"
+#define SETTINGS_CAL_KEY   "cal"
+#define SETTINGS_REF_KEY   "ref%d" // Key of every reference slot
+
+#define _THREAD_STACK_SIZE (3072u)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Writes pending settings once they stop changing
+ *
+ * @param p_param
+ */
+static void _save_task(void *p_param);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const char *TAG = "settings";
+
+static nvs_handle_t      _nvs            = 0;
+static SemaphoreHandle_t _pending_lock   = NULL;
+static TaskHandle_t      _save_task_hndl = NULL;
+static settings_t        _pending; // Latest settings given to settings_save()
+static settings_blob_t   _stored;  // Blob as it is in NVS, read into directly on boot
+static settings_blob_t   _blob;    // Blob being written
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+settings_err_t settings_init(settings_t *p_settings)
+{
+    esp_err_t esp_err = nvs_flash_init();
+    if((ESP_ERR_NVS_NO_FREE_PAGES == esp_err) || (ESP_ERR_NVS_NEW_VERSION_FOUND == esp_err))
+    {
+        // Partition was truncated or written by newer NVS, it can only be erased
+        ESP_LOGW(TAG, "Erasing NVS partition");
+        nvs_flash_erase();
+        esp_err = nvs_flash_init();
+    }
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_open(SETTINGS_NAMESPACE, NVS_READWRITE, &_nvs);
+    }
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(esp_err));
+        return SETTINGS_ERR;
+    }
+
+    _pending_lock = xSemaphoreCreateMutex();
+    if((NULL == _pending_lock) ||
+       (SCHED_ERR_NONE
+        != sched_task_create(SCHED_TASK_SETTINGS, _save_task, _THREAD_STACK_SIZE, NULL, &_save_task_hndl)))
+    {
+        ESP_LOGE(TAG, "Failed to create settings save task");
+        return SETTINGS_ERR;
+    }
+
+    size_t size = sizeof(_stored);
+    esp_err     = nvs_get_blob(_nvs, SETTINGS_KEY, &_stored, &size);
+
+    settings_err_t err;
+    switch(esp_err)
+    {
+        case ESP_OK:
+            err = settings_decode(&_stored, size, p_settings);
+            break;
+        case ESP_ERR_NVS_NOT_FOUND:
+            err = SETTINGS_ERR_NOT_FOUND;
+            break;
+        case ESP_ERR_NVS_INVALID_LENGTH:
+            // Blob of another size can only come from another layout
+            err = SETTINGS_ERR_VERSION;
+            break;
+        default:
+            err = SETTINGS_ERR;
+            break;
+    }
+
+    if(SETTINGS_ERR_NONE == err)
+    {
+        ESP_LOGI(TAG, "Restored settings");
+    }
+    else
+    {
+        // Stored blob can't be trusted for change detection either
+        memset(&_stored, 0, sizeof(_stored));
+        ESP_LOGW(TAG, "No stored settings restored (%d)", err);
+    }
+    return err;
+}
+
+void settings_save(const settings_t *p_settings)
+{
+    if(NULL == _save_task_hndl)
+    {
+        return;
+    }
+
+    xSemaphoreTake(_pending_lock, portMAX_DELAY);
+    _pending = *p_settings;
+    xSemaphoreGive(_pending_lock);
+
+    xTaskNotifyGive(_save_task_hndl);
+}
+
+settings_err_t settings_cal_load(settings_cal_t *p_cal)
+{
+    settings_cal_blob_t blob;
+    size_t              size = sizeof(blob);
+
+    if(0 == _nvs)
+    {
+        return SETTINGS_ERR;
+    }
+
+    esp_err_t esp_err = nvs_get_blob(_nvs, SETTINGS_CAL_KEY, &blob, &size);
+    switch(esp_err)
+    {
+        case ESP_OK:
+            return settings_cal_decode(&blob, size, p_cal);
+        case ESP_ERR_NVS_NOT_FOUND:
+            return SETTINGS_ERR_NOT_FOUND;
+        case ESP_ERR_NVS_INVALID_LENGTH:
+            return SETTINGS_ERR_VERSION;
+        default:
+            return SETTINGS_ERR;
+    }
+}
+
+settings_err_t settings_cal_save(const settings_cal_t *p_cal)
+{
+    settings_cal_blob_t blob;
+
+    if(0 == _nvs)
+    {
+        return SETTINGS_ERR;
+    }
+
+    settings_cal_encode(p_cal, &blob);
+    esp_err_t esp_err = nvs_set_blob(_nvs, SETTINGS_CAL_KEY, &blob, sizeof(blob));
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_commit(_nvs);
+    }
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGE(TAG, "Failed to save calibration: %s", esp_err_to_name(esp_err));
+        return SETTINGS_ERR;
+    }
+
+    ESP_LOGI(TAG, "Saved calibration");
+    return SETTINGS_ERR_NONE;
+}
+
+settings_err_t settings_ref_load(int slot, settings_ref_blob_t *p_blob)
+{
+    char   key[NVS_KEY_NAME_MAX_SIZE];
+    size_t size = sizeof(*p_blob);
+
+    if((0 == _nvs) || (slot < 0) || (slot >= SETTINGS_REF_COUNT))
+    {
+        return SETTINGS_ERR;
+    }
+
+    snprintf(key, sizeof(key), SETTINGS_REF_KEY, slot);
+    esp_err_t esp_err = nvs_get_blob(_nvs, key, p_blob, &size);
+    switch(esp_err)
+    {
+        case ESP_OK:
+            return settings_ref_check(p_blob, size);
+        case ESP_ERR_NVS_NOT_FOUND:
+            return SETTINGS_ERR_NOT_FOUND;
+        case ESP_ERR_NVS_INVALID_LENGTH:
+            return SETTINGS_ERR_VERSION;
+        default:
+            return SETTINGS_ERR;
+    }
+}
+
+settings_err_t settings_ref_save(int slot, const settings_ref_blob_t *p_blob)
+{
+    char key[NVS_KEY_NAME_MAX_SIZE];
+
+    if((0 == _nvs) || (slot < 0) || (slot >= SETTINGS_REF_COUNT))
+    {
+        return SETTINGS_ERR;
+    }
+
+    snprintf(key, sizeof(key), SETTINGS_REF_KEY, slot);
+    esp_err_t esp_err = (NULL != p_blob) ? nvs_set_blob(_nvs, key, p_blob, sizeof(*p_blob)) : nvs_erase_key(_nvs, key);
+    if(ESP_ERR_NVS_NOT_FOUND == esp_err)
+    {
+        // Nothing stored to erase
+        return SETTINGS_ERR_NONE;
+    }
+    if(ESP_OK == esp_err)
+    {
+        esp_err = nvs_commit(_nvs);
+    }
+    if(ESP_OK != esp_err)
+    {
+        ESP_LOGE(TAG, "Failed to save reference %d: %s", slot + 1, esp_err_to_name(esp_err));
+        return SETTINGS_ERR;
+    }
+
+    ESP_LOGI(TAG, "%s reference %d", (NULL != p_blob) ? "Saved" : "Erased", slot + 1);
+    return SETTINGS_ERR_NONE;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _save_task(void *p_param)
+{
+    (void)p_param;
+
+    for(;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Every change restarts the wait
+        while(0 != ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SETTINGS_SAVE_DELAY_MS)))
+        {
+        }
+
+        xSemaphoreTake(_pending_lock, portMAX_DELAY);
+        settings_encode(&_pending, &_blob);
+        xSemaphoreGive(_pending_lock);
+
+        // Changes that were undone before the wait ended don't cost a write
+        if(0 == memcmp(&_blob, &_stored, sizeof(_blob)))
+        {
+            continue;
+        }
+
+        esp_err_t esp_err = nvs_set_blob(_nvs, SETTINGS_KEY, &_blob, sizeof(_blob));
+        if(ESP_OK == esp_err)
+        {
+            esp_err = nvs_commit(_nvs);
+        }
+        if(ESP_OK == esp_err)
+        {
+            _stored = _blob;
+            ESP_LOGI(TAG, "Saved settings");
+        }
+        else
+        {
+            ESP_LOGE(TAG, "Failed to save settings: %s", esp_err_to_name(esp_err));
+        }
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
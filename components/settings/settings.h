@@ -0,0 +1,82 @@
+/**
+ * @file settings.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __SETTINGS_H__
+#define __SETTINGS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "settings_codec.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define SETTINGS_SAVE_DELAY_MS (2000) // Settings are written once they stop changing for this long
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Initializes NVS and reads stored settings with a single blob read. Settings are left untouched if nothing
+ * valid is stored.
+ *
+ * @param p_settings Restored settings
+ * @return settings_err_t
+ */
+settings_err_t settings_init(settings_t *p_settings);
+
+/**
+ * @brief Queues settings to be stored. Writes are batched: settings are written SETTINGS_SAVE_DELAY_MS after the
+ * last call, and only if they differ from the stored ones.
+ *
+ * @param p_settings Settings to store
+ */
+void settings_save(const settings_t *p_settings);
+
+/**
+ * @brief Reads stored DAC correction tables. Needs settings_init() first.
+ *
+ * @param p_cal Restored tables, left untouched if nothing valid is stored
+ * @return settings_err_t
+ */
+settings_err_t settings_cal_load(settings_cal_t *p_cal);
+
+/**
+ * @brief Stores DAC correction tables right away, calibration is rare so it isn't batched
+ *
+ * @param p_cal Tables to store
+ * @return settings_err_t
+ */
+settings_err_t settings_cal_save(const settings_cal_t *p_cal);
+
+/**
+ * @brief Reads stored oscilloscope reference. Needs settings_init() first.
+ *
+ * @param slot Reference slot, 0 to SETTINGS_REF_COUNT - 1
+ * @param p_blob [out] Checked reference, contents are undefined unless SETTINGS_ERR_NONE is returned
+ * @return settings_err_t
+ */
+settings_err_t settings_ref_load(int slot, settings_ref_blob_t *p_blob);
+
+/**
+ * @brief Stores oscilloscope reference right away, references are stored by hand so they aren't batched
+ *
+ * @param slot Reference slot, 0 to SETTINGS_REF_COUNT - 1
+ * @param p_blob Reference to store, NULL erases stored one
+ * @return settings_err_t
+ */
+settings_err_t settings_ref_save(int slot, const settings_ref_blob_t *p_blob);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SETTINGS_H__
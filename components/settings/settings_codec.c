@@ -0,0 +1,258 @@
+/**
+ * @file settings_codec.c
+ *
+ * @brief   Binary format of stored settings
+ *
+ * Settings are stored as one blob: a header with magic, layout version, size and CRC-32, followed by fixed width
+ * records. Blob is read from storage straight into settings_blob_t, so loading needs no parsing beyond the header
+ * checks and widening the record fields. Nothing here touches hardware, so the codec is tested on host.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "settings_codec.h"
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define CRC32_POLY (0xEDB88320u) // Reflected IEEE 802.3 polynomial
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+_Static_assert(sizeof(settings_signal_rec_t) == 24, "Signal record layout changed, bump SETTINGS_VERSION");
+_Static_assert(sizeof(settings_osc_rec_t) == 8, "Oscilloscope record layout changed, bump SETTINGS_VERSION");
+_Static_assert(sizeof(settings_blob_t) < UINT16_MAX, "Blob size doesn't fit its header");
+_Static_assert(sizeof(settings_cal_blob_t) < UINT16_MAX, "Calibration blob size doesn't fit its header");
+_Static_assert(FN_CHANNEL_COUNT <= 8, "Calibration valid bits don't fit");
+_Static_assert(sizeof(settings_ref_rec_t) == 16, "Reference record layout changed, bump SETTINGS_REF_VERSION");
+_Static_assert(0 == (SETTINGS_REF_SAMPLE_MAX % 2), "References pack samples in pairs");
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+void settings_encode(const settings_t *p_settings, settings_blob_t *p_blob)
+{
+    // Reserved bytes are zeroed too, so equal settings always give equal blobs
+    memset(p_blob, 0, sizeof(*p_blob));
+
+    for(int i = 0; i < FN_GEN_PRESET_NUMBER; i++)
+    {
+        settings_signal_encode(&p_settings->presets[i], &p_blob->presets[i]);
+    }
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        settings_signal_encode(&p_settings->active[i], &p_blob->active[i]);
+    }
+
+    p_blob->osc.div_ms = (uint16_t)p_settings->osc.div_ms;
+    p_blob->osc.div_mV = (uint16_t)p_settings->osc.div_mV;
+    p_blob->osc.flags  = (p_settings->osc.is_ch1_shown ? SETTINGS_OSC_FLAG_CH1_SHOWN : 0) |
+                        (p_settings->osc.is_ch2_shown ? SETTINGS_OSC_FLAG_CH2_SHOWN : 0);
+
+    p_blob->header.magic   = SETTINGS_MAGIC;
+    p_blob->header.version = SETTINGS_VERSION;
+    p_blob->header.size    = sizeof(*p_blob);
+    p_blob->header.crc     = settings_crc32(&p_blob->header + 1, sizeof(*p_blob) - sizeof(p_blob->header));
+}
+
+settings_err_t settings_decode(const settings_blob_t *p_blob, size_t size, settings_t *p_settings)
+{
+    if((size < sizeof(p_blob->header)) || (SETTINGS_MAGIC != p_blob->header.magic))
+    {
+        return SETTINGS_ERR_CORRUPT;
+    }
+    if(SETTINGS_VERSION != p_blob->header.version)
+    {
+        return SETTINGS_ERR_VERSION;
+    }
+    if((size != sizeof(*p_blob)) || (sizeof(*p_blob) != p_blob->header.size) ||
+       (p_blob->header.crc != settings_crc32(&p_blob->header + 1, sizeof(*p_blob) - sizeof(p_blob->header))))
+    {
+        return SETTINGS_ERR_CORRUPT;
+    }
+
+    for(int i = 0; i < FN_GEN_PRESET_NUMBER; i++)
+    {
+        settings_signal_decode(&p_blob->presets[i], &p_settings->presets[i]);
+    }
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        settings_signal_decode(&p_blob->active[i], &p_settings->active[i]);
+    }
+
+    p_settings->osc.div_ms       = p_blob->osc.div_ms;
+    p_settings->osc.div_mV       = p_blob->osc.div_mV;
+    p_settings->osc.is_ch1_shown = (0 != (p_blob->osc.flags & SETTINGS_OSC_FLAG_CH1_SHOWN));
+    p_settings->osc.is_ch2_shown = (0 != (p_blob->osc.flags & SETTINGS_OSC_FLAG_CH2_SHOWN));
+
+    return SETTINGS_ERR_NONE;
+}
+
+void settings_cal_encode(const settings_cal_t *p_cal, settings_cal_blob_t *p_blob)
+{
+    memset(p_blob, 0, sizeof(*p_blob));
+
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        if(p_cal->is_valid[i])
+        {
+            p_blob->valid |= 1 << i;
+            memcpy(p_blob->lut[i], p_cal->lut[i], sizeof(p_blob->lut[i]));
+        }
+    }
+
+    p_blob->header.magic   = SETTINGS_CAL_MAGIC;
+    p_blob->header.version = SETTINGS_CAL_VERSION;
+    p_blob->header.size    = sizeof(*p_blob);
+    p_blob->header.crc     = settings_crc32(&p_blob->header + 1, sizeof(*p_blob) - sizeof(p_blob->header));
+}
+
+settings_err_t settings_cal_decode(const settings_cal_blob_t *p_blob, size_t size, settings_cal_t *p_cal)
+{
+    if((size < sizeof(p_blob->header)) || (SETTINGS_CAL_MAGIC != p_blob->header.magic))
+    {
+        return SETTINGS_ERR_CORRUPT;
+    }
+    if(SETTINGS_CAL_VERSION != p_blob->header.version)
+    {
+        return SETTINGS_ERR_VERSION;
+    }
+    if((size != sizeof(*p_blob)) || (sizeof(*p_blob) != p_blob->header.size) ||
+       (p_blob->header.crc != settings_crc32(&p_blob->header + 1, sizeof(*p_blob) - sizeof(p_blob->header))))
+    {
+        return SETTINGS_ERR_CORRUPT;
+    }
+
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        p_cal->is_valid[i] = (0 != (p_blob->valid & (1 << i)));
+        memcpy(p_cal->lut[i], p_blob->lut[i], sizeof(p_cal->lut[i]));
+    }
+    return SETTINGS_ERR_NONE;
+}
+
+void settings_ref_encode(const int *p_mV, uint16_t cnt, const settings_ref_rec_t *p_meta, settings_ref_blob_t *p_blob)
+{
+    memset(p_blob, 0, sizeof(*p_blob));
+    p_blob->meta             = *p_meta;
+    p_blob->meta.sample_cnt  = (cnt < SETTINGS_REF_SAMPLE_MAX) ? cnt : SETTINGS_REF_SAMPLE_MAX;
+    p_blob->meta.min_mV      = SETTINGS_REF_MV_MAX;
+    p_blob->meta.max_mV      = 0;
+    memset(p_blob->meta.reserved, 0, sizeof(p_blob->meta.reserved));
+
+    for(int i = 0; i < p_blob->meta.sample_cnt; i++)
+    {
+        int      mV     = p_mV[i];
+        uint16_t sample = (uint16_t)((mV < 0) ? 0 : (mV > SETTINGS_REF_MV_MAX) ? SETTINGS_REF_MV_MAX : mV);
+        uint8_t *p_pair = &p_blob->samples[i / 2 * 3];
+
+        // First sample of a pair takes the first byte and low half of the second, the other one the rest
+        if(0 == (i & 1))
+        {
+            p_pair[0] = (uint8_t)sample;
+            p_pair[1] = (uint8_t)(sample >> 8);
+        }
+        else
+        {
+            p_pair[1] |= (uint8_t)(sample << 4);
+            p_pair[2] = (uint8_t)(sample >> 4);
+        }
+        p_blob->meta.min_mV = (sample < p_blob->meta.min_mV) ? sample : p_blob->meta.min_mV;
+        p_blob->meta.max_mV = (sample > p_blob->meta.max_mV) ? sample : p_blob->meta.max_mV;
+    }
+
+    p_blob->header.magic   = SETTINGS_REF_MAGIC;
+    p_blob->header.version = SETTINGS_REF_VERSION;
+    p_blob->header.size    = sizeof(*p_blob);
+    p_blob->header.crc     = settings_crc32(&p_blob->header + 1, sizeof(*p_blob) - sizeof(p_blob->header));
+}
+
+settings_err_t settings_ref_check(const settings_ref_blob_t *p_blob, size_t size)
+{
+    if((size < sizeof(p_blob->header)) || (SETTINGS_REF_MAGIC != p_blob->header.magic))
+    {
+        return SETTINGS_ERR_CORRUPT;
+    }
+    if(SETTINGS_REF_VERSION != p_blob->header.version)
+    {
+        return SETTINGS_ERR_VERSION;
+    }
+    if((size != sizeof(*p_blob)) || (sizeof(*p_blob) != p_blob->header.size) ||
+       (p_blob->header.crc != settings_crc32(&p_blob->header + 1, sizeof(*p_blob) - sizeof(p_blob->header))) ||
+       (p_blob->meta.sample_cnt > SETTINGS_REF_SAMPLE_MAX))
+    {
+        return SETTINGS_ERR_CORRUPT;
+    }
+    return SETTINGS_ERR_NONE;
+}
+
+uint16_t settings_ref_decode(const settings_ref_blob_t *p_blob, int *p_mV, uint16_t cnt)
+{
+    cnt = (cnt < p_blob->meta.sample_cnt) ? cnt : p_blob->meta.sample_cnt;
+    for(int i = 0; i < cnt; i++)
+    {
+        const uint8_t *p_pair = &p_blob->samples[i / 2 * 3];
+        p_mV[i] = (0 == (i & 1)) ? (p_pair[0] | ((p_pair[1] & 0x0F) << 8)) : ((p_pair[1] >> 4) | (p_pair[2] << 4));
+    }
+    return cnt;
+}
+
+uint32_t settings_crc32(const void *p_data, size_t len)
+{
+    const uint8_t *p_byte = p_data;
+    uint32_t       crc    = 0xFFFFFFFFu;
+
+    // Bitwise, blob is small and only checked on boot and save
+    while(len--)
+    {
+        crc ^= *p_byte++;
+        for(int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (CRC32_POLY & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+void settings_signal_encode(const fn_signal_config_t *p_config, settings_signal_rec_t *p_rec)
+{
+    p_rec->frequency_Hz          = (uint32_t)p_config->frequency_Hz;
+    p_rec->burst_cycles          = (uint32_t)p_config->trigger.burst_cycles;
+    p_rec->amplitude_mV          = (uint16_t)p_config->amplitude_mV;
+    p_rec->mod_rate_Hz           = (uint16_t)p_config->modulation.rate_Hz;
+    p_rec->mod_depth             = (uint16_t)p_config->modulation.depth;
+    p_rec->burst_idle_ms         = (uint16_t)p_config->trigger.burst_idle_ms;
+    p_rec->signal                = (uint8_t)p_config->signal;
+    p_rec->duty_cycle_percentage = (uint8_t)p_config->duty_cycle_percentage;
+    p_rec->mod_type              = (uint8_t)p_config->modulation.type;
+    p_rec->mod_shape             = (uint8_t)p_config->modulation.shape;
+    p_rec->trig_mode             = (uint8_t)p_config->trigger.mode;
+    p_rec->gate_pin              = (int8_t)p_config->trigger.gate_pin;
+    p_rec->offset_mV             = (int16_t)p_config->offset_mV;
+}
+
+void settings_signal_decode(const settings_signal_rec_t *p_rec, fn_signal_config_t *p_config)
+{
+    p_config->signal                = (fn_signal_type_t)p_rec->signal;
+    p_config->frequency_Hz          = (int)p_rec->frequency_Hz;
+    p_config->amplitude_mV          = p_rec->amplitude_mV;
+    p_config->offset_mV             = p_rec->offset_mV;
+    p_config->duty_cycle_percentage = p_rec->duty_cycle_percentage;
+    p_config->modulation.type       = (fn_mod_type_t)p_rec->mod_type;
+    p_config->modulation.shape      = (fn_signal_type_t)p_rec->mod_shape;
+    p_config->modulation.rate_Hz    = p_rec->mod_rate_Hz;
+    p_config->modulation.depth      = p_rec->mod_depth;
+    p_config->trigger.mode          = (fn_trig_mode_t)p_rec->trig_mode;
+    p_config->trigger.burst_cycles  = (int)p_rec->burst_cycles;
+    p_config->trigger.burst_idle_ms = p_rec->burst_idle_ms;
+    p_config->trigger.gate_pin      = p_rec->gate_pin;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,241 @@
+/**
+ * @file settings_codec.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __SETTINGS_CODEC_H__
+#define __SETTINGS_CODEC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "fn_gen.h"
+
+//---------------------------------- MACROS -----------------------------------
+#define SETTINGS_MAGIC   (0x53474E46u) // "FNGS" little endian
+#define SETTINGS_VERSION (1)           // Bumped whenever blob layout changes
+
+#define SETTINGS_CAL_MAGIC   (0x4C434E46u) // "FNCL" little endian
+#define SETTINGS_CAL_VERSION (1)           // Bumped whenever calibration blob layout changes
+
+#define SETTINGS_REF_MAGIC      (0x46524E46u) // "FNRF" little endian
+#define SETTINGS_REF_VERSION    (1)           // Bumped whenever reference blob layout changes
+#define SETTINGS_REF_COUNT      (4)           // Reference memories, REF1 to REF4
+#define SETTINGS_REF_SAMPLE_MAX (256)         // Samples one reference holds at most
+#define SETTINGS_REF_MV_MAX     (4095)        // Samples are packed as 12 bit mV, higher ones are clamped to this
+
+#define SETTINGS_OSC_FLAG_CH1_SHOWN (1 << 0)
+#define SETTINGS_OSC_FLAG_CH2_SHOWN (1 << 1)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef enum
+{
+    SETTINGS_ERR_NONE = 0,
+
+    SETTINGS_ERR           = -1,
+    SETTINGS_ERR_NOT_FOUND = -2, // Nothing stored yet
+    SETTINGS_ERR_CORRUPT   = -3, // Wrong magic, size or checksum
+    SETTINGS_ERR_VERSION   = -4, // Stored by firmware with another blob layout
+} settings_err_t;
+
+typedef struct _settings_osc_t
+{
+    int  div_ms;       // Time per division
+    int  div_mV;       // Voltage per division
+    bool is_ch1_shown; // True if channel A trace is shown
+    bool is_ch2_shown; // True if channel B trace is shown
+} settings_osc_t;
+
+typedef struct _settings_t
+{
+    fn_signal_config_t presets[FN_GEN_PRESET_NUMBER];
+    fn_signal_config_t active[FN_CHANNEL_COUNT]; // Last config of each channel
+    settings_osc_t     osc;
+} settings_t;
+
+// DAC correction tables, kept apart from settings since they belong to the board and change rarely
+typedef struct _settings_cal_t
+{
+    bool    is_valid[FN_CHANNEL_COUNT]; // True if channel was calibrated
+    uint8_t lut[FN_CHANNEL_COUNT][FN_CAL_CODES];
+} settings_cal_t;
+
+// Blob records have fixed width fields ordered by size, so the layout has no padding and doesn't depend on enum size
+typedef struct _settings_signal_rec_t
+{
+    uint32_t frequency_Hz;
+    uint32_t burst_cycles;
+    uint16_t amplitude_mV;
+    uint16_t mod_rate_Hz;
+    uint16_t mod_depth;
+    uint16_t burst_idle_ms;
+    uint8_t  signal;
+    uint8_t  duty_cycle_percentage;
+    uint8_t  mod_type;
+    uint8_t  mod_shape;
+    uint8_t  trig_mode;
+    int8_t   gate_pin;
+    int16_t  offset_mV; // Was reserved and always written as 0, so older blobs decode without offset
+} settings_signal_rec_t;
+
+typedef struct _settings_osc_rec_t
+{
+    uint16_t div_ms;
+    uint16_t div_mV;
+    uint8_t  flags; // SETTINGS_OSC_FLAG_* bits
+    uint8_t  reserved[3];
+} settings_osc_rec_t;
+
+typedef struct _settings_header_t
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size; // Size of the whole blob
+    uint32_t crc;  // CRC-32 of everything after the header
+} settings_header_t;
+
+typedef struct _settings_blob_t
+{
+    settings_header_t     header;
+    settings_signal_rec_t presets[FN_GEN_PRESET_NUMBER];
+    settings_signal_rec_t active[FN_CHANNEL_COUNT];
+    settings_osc_rec_t    osc;
+} settings_blob_t;
+
+typedef struct _settings_cal_blob_t
+{
+    settings_header_t header;
+    uint8_t           valid; // Bit per calibrated channel
+    uint8_t           reserved[3];
+    uint8_t           lut[FN_CHANNEL_COUNT][FN_CAL_CODES];
+} settings_cal_blob_t;
+
+// What a reference frame was captured with
+typedef struct _settings_ref_rec_t
+{
+    uint16_t sample_cnt;
+    uint16_t sample_period_us;
+    uint16_t div_ms; // Divisions shown when it was captured
+    uint16_t div_mV;
+    uint16_t min_mV; // Lowest and highest sample
+    uint16_t max_mV;
+    uint8_t  channel; // Oscilloscope channel, 0 for CH1
+    uint8_t  reserved[3];
+} settings_ref_rec_t;
+
+// Oscilloscope frame saved as a reference. It is kept in this form in RAM as well, packed two samples to three bytes
+// with the first one in the low 12 bits, so a reference costs little more than its samples wherever it is.
+typedef struct _settings_ref_blob_t
+{
+    settings_header_t  header;
+    settings_ref_rec_t meta;
+    uint8_t            samples[SETTINGS_REF_SAMPLE_MAX / 2 * 3];
+} settings_ref_blob_t;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Packs settings into blob and seals it with header
+ *
+ * @param p_settings Settings
+ * @param p_blob Blob to store
+ */
+void settings_encode(const settings_t *p_settings, settings_blob_t *p_blob);
+
+/**
+ * @brief Checks blob read from storage and unpacks it into settings. Settings are left untouched on error.
+ *
+ * @param p_blob Stored blob
+ * @param size Number of bytes read into blob
+ * @param p_settings Settings
+ * @return settings_err_t
+ */
+settings_err_t settings_decode(const settings_blob_t *p_blob, size_t size, settings_t *p_settings);
+
+/**
+ * @brief Packs DAC correction tables into blob and seals it with header
+ *
+ * @param p_cal Correction tables
+ * @param p_blob Blob to store
+ */
+void settings_cal_encode(const settings_cal_t *p_cal, settings_cal_blob_t *p_blob);
+
+/**
+ * @brief Checks calibration blob read from storage and unpacks it. Tables are left untouched on error.
+ *
+ * @param p_blob Stored blob
+ * @param size Number of bytes read into blob
+ * @param p_cal Correction tables
+ * @return settings_err_t
+ */
+settings_err_t settings_cal_decode(const settings_cal_blob_t *p_blob, size_t size, settings_cal_t *p_cal);
+
+/**
+ * @brief Packs frame into 12 bit samples and seals it with header. Samples past SETTINGS_REF_SAMPLE_MAX are dropped.
+ *
+ * @param p_mV Frame in mV
+ * @param cnt Number of samples
+ * @param p_meta What the frame was captured with, sample count and lowest and highest sample are taken from the frame
+ * @param p_blob Blob to keep or store
+ */
+void settings_ref_encode(const int *p_mV, uint16_t cnt, const settings_ref_rec_t *p_meta, settings_ref_blob_t *p_blob);
+
+/**
+ * @brief Checks reference blob read from storage
+ *
+ * @param p_blob Stored blob
+ * @param size Number of bytes read into blob
+ * @return settings_err_t
+ */
+settings_err_t settings_ref_check(const settings_ref_blob_t *p_blob, size_t size);
+
+/**
+ * @brief Unpacks samples of a reference
+ *
+ * @param p_blob Checked blob
+ * @param p_mV [out] Frame in mV
+ * @param cnt Room in p_mV
+ * @return uint16_t Number of samples unpacked
+ */
+uint16_t settings_ref_decode(const settings_ref_blob_t *p_blob, int *p_mV, uint16_t cnt);
+
+/**
+ * @brief Packs signal config into fixed width record
+ *
+ * @param p_config Signal config
+ * @param p_rec Record
+ */
+void settings_signal_encode(const fn_signal_config_t *p_config, settings_signal_rec_t *p_rec);
+
+/**
+ * @brief Unpacks fixed width record into signal config
+ *
+ * @param p_rec Record
+ * @param p_config Signal config
+ */
+void settings_signal_decode(const settings_signal_rec_t *p_rec, fn_signal_config_t *p_config);
+
+/**
+ * @brief Computes CRC-32 (IEEE 802.3) of data
+ *
+ * @param p_data Data
+ * @param len Number of bytes
+ * @return uint32_t CRC
+ */
+uint32_t settings_crc32(const void *p_data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SETTINGS_CODEC_H__
@@ -0,0 +1,360 @@
+/**
+ * @file test_preset_lib.c
+ *
+ * @brief   Host unit tests of the preset library on emulated NOR flash
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "preset_lib.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define FLASH_SECTOR_SIZE (4096)
+#define FLASH_SECTORS     (4)
+#define FLASH_SIZE        (FLASH_SECTOR_SIZE * FLASH_SECTORS)
+#define CAPACITY          ((FLASH_SECTORS - 1) * FLASH_SECTOR_SIZE / PRESET_LIB_REC_SIZE)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct
+{
+    uint8_t mem[FLASH_SIZE];
+    int     ops_left; // Writes and erases done before power is cut, negative for no cut
+    int     writes;
+    int     erases;
+} ram_flash_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static int  _flash_read(void *p_ctx, uint32_t offset, void *p_dst, size_t len);
+static int  _flash_write(void *p_ctx, uint32_t offset, const void *p_src, size_t len);
+static int  _flash_erase(void *p_ctx, uint32_t offset, size_t len);
+static void _flash_reset(void);
+
+/**
+ * @brief Returns config with fields derived from n
+ *
+ * @param n Seed
+ * @return fn_signal_config_t
+ */
+static fn_signal_config_t _config(int n);
+
+/**
+ * @brief Checks preset is stored with config derived from n
+ *
+ * @param p_name Name
+ * @param n Seed
+ * @return true if it is
+ */
+static bool _has(const char *p_name, int n);
+
+static void _test_basic(void);
+static void _test_order(void);
+static void _test_reopen(void);
+static void _test_churn(void);
+static void _test_full(void);
+static void _test_power_cut(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static ram_flash_t _ram;
+
+static const preset_lib_flash_t _flash = {
+    .read        = _flash_read,
+    .write       = _flash_write,
+    .erase       = _flash_erase,
+    .p_ctx       = &_ram,
+    .size        = FLASH_SIZE,
+    .sector_size = FLASH_SECTOR_SIZE,
+};
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    _test_basic();
+    _test_order();
+    _test_reopen();
+    _test_churn();
+    _test_full();
+    _test_power_cut();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static int _flash_read(void *p_ctx, uint32_t offset, void *p_dst, size_t len)
+{
+    ram_flash_t *p_ram = p_ctx;
+    memcpy(p_dst, &p_ram->mem[offset], len);
+    return 0;
+}
+
+static int _flash_write(void *p_ctx, uint32_t offset, const void *p_src, size_t len)
+{
+    ram_flash_t   *p_ram = p_ctx;
+    const uint8_t *p_byte = p_src;
+
+    // Cut power halfway through the write
+    size_t done = len;
+    if(0 == p_ram->ops_left)
+    {
+        done = len / 2;
+    }
+    for(size_t i = 0; i < done; i++)
+    {
+        p_ram->mem[offset + i] &= p_byte[i];
+    }
+    p_ram->writes++;
+
+    if(p_ram->ops_left >= 0)
+    {
+        return (0 == p_ram->ops_left--) ? -1 : 0;
+    }
+    return 0;
+}
+
+static int _flash_erase(void *p_ctx, uint32_t offset, size_t len)
+{
+    ram_flash_t *p_ram = p_ctx;
+
+    if(0 == p_ram->ops_left)
+    {
+        p_ram->ops_left--;
+        return -1;
+    }
+    if(p_ram->ops_left > 0)
+    {
+        p_ram->ops_left--;
+    }
+    memset(&p_ram->mem[offset], 0xFF, len);
+    p_ram->erases++;
+    return 0;
+}
+
+static void _flash_reset(void)
+{
+    memset(_ram.mem, 0xFF, sizeof(_ram.mem));
+    _ram.ops_left = -1;
+    _ram.writes   = 0;
+    _ram.erases   = 0;
+}
+
+static fn_signal_config_t _config(int n)
+{
+    fn_signal_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.signal                = (fn_signal_type_t)(n % FN_SIGNAL_COUNT);
+    config.frequency_Hz          = 1 + n * 7;
+    config.amplitude_mV          = n % 3300;
+    config.duty_cycle_percentage = n % 101;
+    config.trigger.gate_pin      = -1;
+    return config;
+}
+
+static bool _has(const char *p_name, int n)
+{
+    fn_signal_config_t config;
+    fn_signal_config_t expected = _config(n);
+
+    return (PRESET_LIB_ERR_NONE == preset_lib_load(p_name, &config)) &&
+           (config.frequency_Hz == expected.frequency_Hz) && (config.amplitude_mV == expected.amplitude_mV) &&
+           (config.signal == expected.signal) && (config.duty_cycle_percentage == expected.duty_cycle_percentage);
+}
+
+static void _test_basic(void)
+{
+    _flash_reset();
+    CHECK(PRESET_LIB_ERR_NONE == preset_lib_open(&_flash));
+    CHECK(0 == preset_lib_count());
+    CHECK(CAPACITY == preset_lib_free());
+
+    fn_signal_config_t config = _config(1);
+    CHECK(PRESET_LIB_ERR_NONE == preset_lib_save("sweep start", &config));
+    CHECK(_has("sweep start", 1));
+    CHECK(PRESET_LIB_ERR_NOT_FOUND == preset_lib_load("sweep", &config));
+
+    // Replacing keeps one preset, saving the same config doesn't write
+    config = _config(2);
+    CHECK(PRESET_LIB_ERR_NONE == preset_lib_save("sweep start", &config));
+    CHECK(1 == preset_lib_count());
+    CHECK(_has("sweep start", 2));
+
+    int writes = _ram.writes;
+    CHECK(PRESET_LIB_ERR_NONE == preset_lib_save("sweep start", &config));
+    CHECK(writes == _ram.writes);
+
+    CHECK(PRESET_LIB_ERR_NAME == preset_lib_save("", &config));
+    CHECK(PRESET_LIB_ERR_NAME == preset_lib_save("name that is longer than the record holds", &config));
+
+    CHECK(PRESET_LIB_ERR_NONE == preset_lib_delete("sweep start"));
+    CHECK(PRESET_LIB_ERR_NOT_FOUND == preset_lib_delete("sweep start"));
+    CHECK(0 == preset_lib_count());
+}
+
+static void _test_order(void)
+{
+    static const char *const names[] = { "delta", "alpha", "echo", "charlie", "bravo" };
+    static const char *const sorted[] = { "alpha", "bravo", "charlie", "delta", "echo" };
+
+    _flash_reset();
+    preset_lib_open(&_flash);
+    for(int i = 0; i < 5; i++)
+    {
+        fn_signal_config_t config = _config(i);
+        preset_lib_save(names[i], &config);
+    }
+
+    char name[PRESET_LIB_NAME_LEN];
+    for(int i = 0; i < 5; i++)
+    {
+        CHECK(PRESET_LIB_ERR_NONE == preset_lib_get(i, name, NULL));
+        CHECK(0 == strcmp(name, sorted[i]));
+        CHECK(i == preset_lib_find(sorted[i]));
+    }
+    CHECK(PRESET_LIB_ERR_NOT_FOUND == preset_lib_get(5, name, NULL));
+    CHECK(-1 == preset_lib_find("foxtrot"));
+}
+
+static void _test_reopen(void)
+{
+    char name[16];
+
+    _flash_reset();
+    preset_lib_open(&_flash);
+    for(int i = 0; i < 100; i++)
+    {
+        fn_signal_config_t config = _config(i);
+        snprintf(name, sizeof(name), "p%03d", i);
+        preset_lib_save(name, &config);
+    }
+    preset_lib_delete("p050");
+
+    CHECK(PRESET_LIB_ERR_NONE == preset_lib_open(&_flash));
+    CHECK(99 == preset_lib_count());
+    for(int i = 0; i < 100; i++)
+    {
+        snprintf(name, sizeof(name), "p%03d", i);
+        CHECK((50 == i) ? (-1 == preset_lib_find(name)) : _has(name, i));
+    }
+}
+
+static void _test_churn(void)
+{
+    char name[16];
+    int  latest[20];
+
+    // Far more saves than slots, so retired records are reclaimed over and over
+    _flash_reset();
+    preset_lib_open(&_flash);
+    for(int i = 0; i < 5000; i++)
+    {
+        int                id     = (i * 7) % 20;
+        fn_signal_config_t config = _config(i);
+        snprintf(name, sizeof(name), "churn %d", id);
+        CHECK(PRESET_LIB_ERR_NONE == preset_lib_save(name, &config));
+        latest[id] = i;
+    }
+    CHECK(_ram.erases > 0);
+
+    preset_lib_open(&_flash);
+    CHECK(20 == preset_lib_count());
+    for(int id = 0; id < 20; id++)
+    {
+        snprintf(name, sizeof(name), "churn %d", id);
+        CHECK(_has(name, latest[id]));
+    }
+}
+
+static void _test_full(void)
+{
+    char name[16];
+
+    _flash_reset();
+    preset_lib_open(&_flash);
+
+    int saved = 0;
+    for(;;)
+    {
+        fn_signal_config_t config = _config(saved);
+        snprintf(name, sizeof(name), "full %d", saved);
+        if(PRESET_LIB_ERR_NONE != preset_lib_save(name, &config))
+        {
+            break;
+        }
+        saved++;
+    }
+    CHECK(CAPACITY == saved);
+    CHECK(0 == preset_lib_free());
+
+    // Deleting anything makes room again
+    fn_signal_config_t config = _config(9999);
+    CHECK(PRESET_LIB_ERR_NONE == preset_lib_delete("full 7"));
+    CHECK(PRESET_LIB_ERR_NONE == preset_lib_save("after delete", &config));
+    CHECK(_has("after delete", 9999));
+    CHECK(_has("full 8", 8));
+}
+
+static void _test_power_cut(void)
+{
+    char name[16];
+
+    // Cut power at every write and erase of a run that reclaims, then check nothing older was lost
+    for(int cut = 0; cut < 400; cut++)
+    {
+        int latest[10];
+        int pending_id = -1;
+        int pending    = -1;
+
+        _flash_reset();
+        preset_lib_open(&_flash);
+        for(int id = 0; id < 10; id++)
+        {
+            fn_signal_config_t config = _config(id);
+            snprintf(name, sizeof(name), "cut %d", id);
+            preset_lib_save(name, &config);
+            latest[id] = id;
+        }
+
+        _ram.ops_left = cut;
+        for(int i = 10; i < 300; i++)
+        {
+            int                id     = i % 10;
+            fn_signal_config_t config = _config(i);
+            snprintf(name, sizeof(name), "cut %d", id);
+            if(PRESET_LIB_ERR_NONE != preset_lib_save(name, &config))
+            {
+                pending_id = id;
+                pending    = i;
+                break;
+            }
+            latest[id] = i;
+        }
+
+        _ram.ops_left = -1;
+        CHECK(PRESET_LIB_ERR_NONE == preset_lib_open(&_flash));
+        CHECK(10 == preset_lib_count());
+        for(int id = 0; id < 10; id++)
+        {
+            snprintf(name, sizeof(name), "cut %d", id);
+            CHECK(_has(name, latest[id]) || ((id == pending_id) && _has(name, pending)));
+        }
+
+        // Library keeps working after recovery
+        fn_signal_config_t config = _config(7777);
+        CHECK(PRESET_LIB_ERR_NONE == preset_lib_save("after cut", &config));
+        CHECK(_has("after cut", 7777));
+        CHECK(PRESET_LIB_ERR_NONE == preset_lib_open(&_flash));
+        CHECK(_has("after cut", 7777));
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
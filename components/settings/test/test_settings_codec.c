@@ -0,0 +1,303 @@
+/**
+ * @file test_settings_codec.c
+ *
+ * @brief   Host unit tests of the settings blob codec
+ *
+ * Built and run by ctest with the other host tests, see test/CMakeLists.txt in the project root.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "settings_codec.h"
+#include "test_check.h"
+#include <stdio.h>
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Fills settings with distinct values in every field
+ *
+ * @param p_settings Settings
+ */
+static void _fill(settings_t *p_settings);
+
+/**
+ * @brief Compares two signal configs field by field
+ *
+ * @param p_a First config
+ * @param p_b Second config
+ * @return true if all fields are equal
+ */
+static bool _config_equal(const fn_signal_config_t *p_a, const fn_signal_config_t *p_b);
+
+static void _test_crc(void);
+static void _test_round_trip(void);
+static void _test_deterministic(void);
+static void _test_rejects(void);
+static void _test_cal(void);
+static void _test_ref(void);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+int main(void)
+{
+    _test_crc();
+    _test_round_trip();
+    _test_deterministic();
+    _test_rejects();
+    _test_cal();
+    _test_ref();
+
+    return test_check_result();
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _test_crc(void)
+{
+    // Standard check value of CRC-32
+    CHECK(0xCBF43926u == settings_crc32("123456789", 9));
+    CHECK(0 == settings_crc32("", 0));
+}
+
+static void _test_round_trip(void)
+{
+    settings_t      in;
+    settings_t      out;
+    settings_blob_t blob;
+
+    _fill(&in);
+    memset(&out, 0, sizeof(out));
+    settings_encode(&in, &blob);
+
+    CHECK(SETTINGS_MAGIC == blob.header.magic);
+    CHECK(SETTINGS_VERSION == blob.header.version);
+    CHECK(sizeof(blob) == blob.header.size);
+    CHECK(SETTINGS_ERR_NONE == settings_decode(&blob, sizeof(blob), &out));
+
+    for(int i = 0; i < FN_GEN_PRESET_NUMBER; i++)
+    {
+        CHECK(_config_equal(&in.presets[i], &out.presets[i]));
+    }
+    for(int i = 0; i < FN_CHANNEL_COUNT; i++)
+    {
+        CHECK(_config_equal(&in.active[i], &out.active[i]));
+    }
+    CHECK(in.osc.div_ms == out.osc.div_ms);
+    CHECK(in.osc.div_mV == out.osc.div_mV);
+    CHECK(in.osc.is_ch1_shown == out.osc.is_ch1_shown);
+    CHECK(in.osc.is_ch2_shown == out.osc.is_ch2_shown);
+}
+
+static void _test_deterministic(void)
+{
+    settings_t      a;
+    settings_blob_t blob_a;
+    settings_blob_t blob_b;
+
+    // Garbage in unused memory must not reach the blob, save task skips writes of equal blobs
+    _fill(&a);
+    memset(&blob_a, 0xA5, sizeof(blob_a));
+    memset(&blob_b, 0x5A, sizeof(blob_b));
+    settings_encode(&a, &blob_a);
+    settings_encode(&a, &blob_b);
+    CHECK(0 == memcmp(&blob_a, &blob_b, sizeof(blob_a)));
+
+    a.presets[3].amplitude_mV++;
+    settings_encode(&a, &blob_b);
+    CHECK(0 != memcmp(&blob_a, &blob_b, sizeof(blob_a)));
+}
+
+static void _test_rejects(void)
+{
+    settings_t      in;
+    settings_t      out;
+    settings_t      untouched;
+    settings_blob_t blob;
+    settings_blob_t bad;
+
+    _fill(&in);
+    memset(&out, 0x33, sizeof(out));
+    untouched = out;
+    settings_encode(&in, &blob);
+
+    // Flipped payload bit
+    bad = blob;
+    ((uint8_t *)&bad)[sizeof(bad) - 5] ^= 0x10;
+    CHECK(SETTINGS_ERR_CORRUPT == settings_decode(&bad, sizeof(bad), &out));
+
+    bad = blob;
+    bad.header.magic ^= 1;
+    CHECK(SETTINGS_ERR_CORRUPT == settings_decode(&bad, sizeof(bad), &out));
+
+    bad                = blob;
+    bad.header.version = SETTINGS_VERSION + 1;
+    CHECK(SETTINGS_ERR_VERSION == settings_decode(&bad, sizeof(bad), &out));
+
+    CHECK(SETTINGS_ERR_CORRUPT == settings_decode(&blob, sizeof(blob) - 1, &out));
+    CHECK(SETTINGS_ERR_CORRUPT == settings_decode(&blob, 2, &out));
+
+    CHECK(0 == memcmp(&out, &untouched, sizeof(out)));
+}
+
+static void _test_cal(void)
+{
+    settings_cal_t      in;
+    settings_cal_t      out;
+    settings_cal_t      untouched;
+    settings_cal_blob_t blob;
+    settings_cal_blob_t bad;
+
+    // Only channel 1 calibrated, table of the other one isn't stored
+    memset(&in, 0, sizeof(in));
+    in.is_valid[FN_CHANNEL_1] = true;
+    for(int k = 0; k < FN_CAL_CODES; k++)
+    {
+        in.lut[FN_CHANNEL_1][k] = (uint8_t)(k * 7 / 8 + 9);
+        in.lut[FN_CHANNEL_2][k] = 0x77;
+    }
+    memset(&blob, 0xA5, sizeof(blob));
+    settings_cal_encode(&in, &blob);
+    CHECK(SETTINGS_CAL_MAGIC == blob.header.magic);
+    CHECK(sizeof(blob) == blob.header.size);
+    CHECK(0 == blob.lut[FN_CHANNEL_2][0]);
+
+    memset(&out, 0x33, sizeof(out));
+    CHECK(SETTINGS_ERR_NONE == settings_cal_decode(&blob, sizeof(blob), &out));
+    CHECK(out.is_valid[FN_CHANNEL_1] && !out.is_valid[FN_CHANNEL_2]);
+    CHECK(0 == memcmp(in.lut[FN_CHANNEL_1], out.lut[FN_CHANNEL_1], FN_CAL_CODES));
+
+    untouched = out;
+    bad       = blob;
+    bad.lut[FN_CHANNEL_1][100] ^= 1;
+    CHECK(SETTINGS_ERR_CORRUPT == settings_cal_decode(&bad, sizeof(bad), &out));
+
+    // Settings blob isn't mistaken for calibration
+    bad              = blob;
+    bad.header.magic = SETTINGS_MAGIC;
+    CHECK(SETTINGS_ERR_CORRUPT == settings_cal_decode(&bad, sizeof(bad), &out));
+
+    bad                = blob;
+    bad.header.version = SETTINGS_CAL_VERSION + 1;
+    CHECK(SETTINGS_ERR_VERSION == settings_cal_decode(&bad, sizeof(bad), &out));
+    CHECK(SETTINGS_ERR_CORRUPT == settings_cal_decode(&blob, sizeof(blob) - 1, &out));
+
+    CHECK(0 == memcmp(&out, &untouched, sizeof(out)));
+}
+
+static void _test_ref(void)
+{
+    int                 in[SETTINGS_REF_SAMPLE_MAX + 1];
+    int                 out[SETTINGS_REF_SAMPLE_MAX];
+    settings_ref_rec_t  meta = { .sample_period_us = 250, .div_ms = 10, .div_mV = 500, .channel = 1 };
+    settings_ref_blob_t blob;
+    settings_ref_blob_t other;
+    settings_ref_blob_t bad;
+
+    // Every 12 bit value passes at both positions of a pair
+    for(int k = 0; k <= SETTINGS_REF_MV_MAX; k += SETTINGS_REF_SAMPLE_MAX - 1)
+    {
+        for(int i = 0; i < SETTINGS_REF_SAMPLE_MAX; i++)
+        {
+            in[i] = (k + i * 17) & SETTINGS_REF_MV_MAX;
+        }
+        settings_ref_encode(in, SETTINGS_REF_SAMPLE_MAX, &meta, &blob);
+        CHECK(SETTINGS_ERR_NONE == settings_ref_check(&blob, sizeof(blob)));
+        CHECK(SETTINGS_REF_SAMPLE_MAX == settings_ref_decode(&blob, out, SETTINGS_REF_SAMPLE_MAX));
+        CHECK(0 == memcmp(in, out, sizeof(out)));
+    }
+
+    // Odd count, clamping, sample range and metadata
+    for(int i = 0; i <= SETTINGS_REF_SAMPLE_MAX; i++)
+    {
+        in[i] = 1000 + i;
+    }
+    in[0] = -20;
+    in[6] = 5000;
+    memset(&blob, 0xA5, sizeof(blob));
+    settings_ref_encode(in, 7, &meta, &blob);
+    CHECK(SETTINGS_REF_MAGIC == blob.header.magic);
+    CHECK(sizeof(blob) == blob.header.size);
+    CHECK(7 == blob.meta.sample_cnt);
+    CHECK(0 == blob.meta.min_mV);
+    CHECK(SETTINGS_REF_MV_MAX == blob.meta.max_mV);
+    CHECK((250 == blob.meta.sample_period_us) && (500 == blob.meta.div_mV) && (1 == blob.meta.channel));
+    CHECK(0 == blob.samples[sizeof(blob.samples) - 1]);
+    CHECK(7 == settings_ref_decode(&blob, out, SETTINGS_REF_SAMPLE_MAX));
+    CHECK((0 == out[0]) && (1001 == out[1]) && (1005 == out[5]) && (SETTINGS_REF_MV_MAX == out[6]));
+    CHECK(3 == settings_ref_decode(&blob, out, 3));
+
+    // Garbage in unused memory must not reach the blob, and samples past the limit are dropped
+    memset(&other, 0x5A, sizeof(other));
+    settings_ref_encode(in, 7, &meta, &other);
+    CHECK(0 == memcmp(&blob, &other, sizeof(blob)));
+    settings_ref_encode(in, SETTINGS_REF_SAMPLE_MAX + 1, &meta, &other);
+    CHECK(SETTINGS_REF_SAMPLE_MAX == other.meta.sample_cnt);
+
+    bad = blob;
+    bad.samples[1] ^= 0x40;
+    CHECK(SETTINGS_ERR_CORRUPT == settings_ref_check(&bad, sizeof(bad)));
+
+    // Calibration blob isn't mistaken for a reference
+    bad              = blob;
+    bad.header.magic = SETTINGS_CAL_MAGIC;
+    CHECK(SETTINGS_ERR_CORRUPT == settings_ref_check(&bad, sizeof(bad)));
+
+    bad                = blob;
+    bad.header.version = SETTINGS_REF_VERSION + 1;
+    CHECK(SETTINGS_ERR_VERSION == settings_ref_check(&bad, sizeof(bad)));
+    CHECK(SETTINGS_ERR_CORRUPT == settings_ref_check(&blob, sizeof(blob) - 1));
+    CHECK(SETTINGS_ERR_CORRUPT == settings_ref_check(&blob, 2));
+}
+
+static void _fill(settings_t *p_settings)
+{
+    memset(p_settings, 0, sizeof(*p_settings));
+
+    for(int i = 0; i < FN_GEN_PRESET_NUMBER + FN_CHANNEL_COUNT; i++)
+    {
+        fn_signal_config_t *p_config = (i < FN_GEN_PRESET_NUMBER) ? &p_settings->presets[i]
+                                                                   : &p_settings->active[i - FN_GEN_PRESET_NUMBER];
+
+        p_config->signal                = (fn_signal_type_t)(i % FN_SIGNAL_COUNT);
+        p_config->frequency_Hz          = 9000000 + i;
+        p_config->amplitude_mV          = 3300 - i;
+        p_config->offset_mV             = (i & 1) ? -3300 + i : 3300 - i;
+        p_config->duty_cycle_percentage = 10 + i;
+        p_config->modulation.type       = (fn_mod_type_t)(i % FN_MOD_COUNT);
+        p_config->modulation.shape      = (fn_signal_type_t)((i + 1) % FN_SIGNAL_COUNT);
+        p_config->modulation.rate_Hz    = 16000 + i;
+        p_config->modulation.depth      = 16600 + i;
+        p_config->trigger.mode          = (fn_trig_mode_t)(i % FN_TRIG_COUNT);
+        p_config->trigger.burst_cycles  = 100000 + i;
+        p_config->trigger.burst_idle_ms = 60000 - i;
+        p_config->trigger.gate_pin      = (i & 1) ? -1 : 39 - i;
+    }
+    p_settings->osc.div_ms       = 10;
+    p_settings->osc.div_mV       = 500;
+    p_settings->osc.is_ch1_shown = true;
+    p_settings->osc.is_ch2_shown = false;
+}
+
+static bool _config_equal(const fn_signal_config_t *p_a, const fn_signal_config_t *p_b)
+{
+    return (p_a->signal == p_b->signal) && (p_a->frequency_Hz == p_b->frequency_Hz) &&
+           (p_a->amplitude_mV == p_b->amplitude_mV) && (p_a->offset_mV == p_b->offset_mV) &&
+           (p_a->duty_cycle_percentage == p_b->duty_cycle_percentage) &&
+           (p_a->modulation.type == p_b->modulation.type) && (p_a->modulation.shape == p_b->modulation.shape) &&
+           (p_a->modulation.rate_Hz == p_b->modulation.rate_Hz) && (p_a->modulation.depth == p_b->modulation.depth) &&
+           (p_a->trigger.mode == p_b->trigger.mode) && (p_a->trigger.burst_cycles == p_b->trigger.burst_cycles) &&
+           (p_a->trigger.burst_idle_ms == p_b->trigger.burst_idle_ms) && (p_a->trigger.gate_pin == p_b->trigger.gate_pin);
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,228 @@
+/**
+ * @file diag_view.c
+ *
+ * @brief   Diagnostics screen, shows profiler samples
+ *
+ * Everything here runs in the GUI task, from screen events and an LVGL timer that only exists while the screen is
+ * shown, so no GUI lock is taken and nothing is sampled while nobody looks.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "diag_view.h"
+#include "profiler.h"
+#include "ui.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define DIAG_HISTORY_LEN  (30)  // Points of CPU load history, newest on the right
+#define DIAG_TABLE_ROWS   (8)   // Rows the table has room for, header included
+#define DIAG_CELL_LEN     (16)
+
+#define DIAG_CORE_0_COLOR (0x31C294)
+#define DIAG_CORE_1_COLOR (0x5bc6ca)
+
+#if CONFIG_PROFILER_ENABLE
+#define DIAG_REFRESH_MS      (CONFIG_PROFILER_PERIOD_MS)
+#define DIAG_NO_SAMPLES_TEXT "Waiting for the first sample"
+#else
+#define DIAG_REFRESH_MS      (1000)
+#define DIAG_NO_SAMPLES_TEXT "Profiler is disabled in menuconfig"
+#endif
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef struct _diag_view_t
+{
+    lv_timer_t        *p_timer;
+    lv_chart_series_t *p_ser[PROFILER_CORES];
+    lv_coord_t         history[PROFILER_CORES][DIAG_HISTORY_LEN];
+    bool               is_tasks;
+} diag_view_t;
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+/**
+ * @brief Redraws everything from the newest profiler sample
+ *
+ * @param p_timer Refresh timer
+ */
+static void _refresh(lv_timer_t *p_timer);
+
+/**
+ * @brief Fills the table with probe statistics
+ *
+ * @param p_sample Sample
+ */
+static void _show_probes(const profiler_sample_t *p_sample);
+
+/**
+ * @brief Fills the table with the busiest tasks
+ *
+ */
+static void _show_tasks(void);
+
+/**
+ * @brief Sets column count and widths of the table
+ *
+ * @param p_widths Width of each column, 0 terminated
+ */
+static void _set_columns(const lv_coord_t *p_widths);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static const lv_coord_t _probe_widths[] = { 84, 56, 54, 54, 42, 0 };
+static const lv_coord_t _task_widths[]  = { 110, 40, 60, 80, 0 };
+
+static diag_view_t _diag;
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+void diag_view_start(void)
+{
+    // Series are created on first show, chart draws straight from the history arrays
+    if(NULL == _diag.p_ser[0])
+    {
+        static const uint32_t color[PROFILER_CORES] = { DIAG_CORE_0_COLOR, DIAG_CORE_1_COLOR };
+
+        lv_chart_set_point_count(ui_cpuChart, DIAG_HISTORY_LEN);
+        for(int core = 0; core < PROFILER_CORES; core++)
+        {
+            _diag.p_ser[core] = lv_chart_add_series(ui_cpuChart, lv_color_hex(color[core]), LV_CHART_AXIS_PRIMARY_Y);
+            lv_chart_set_ext_y_array(ui_cpuChart, _diag.p_ser[core], _diag.history[core]);
+        }
+    }
+
+    if(NULL == _diag.p_timer)
+    {
+        _diag.p_timer = lv_timer_create(_refresh, DIAG_REFRESH_MS, NULL);
+    }
+    _refresh(_diag.p_timer);
+}
+
+void diag_view_stop(void)
+{
+    if(NULL != _diag.p_timer)
+    {
+        lv_timer_del(_diag.p_timer);
+        _diag.p_timer = NULL;
+    }
+}
+
+void diag_view_show_tasks(bool is_tasks)
+{
+    _diag.is_tasks = is_tasks;
+    if(NULL != _diag.p_timer)
+    {
+        _refresh(_diag.p_timer);
+    }
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _refresh(lv_timer_t *p_timer)
+{
+    (void)p_timer;
+
+    profiler_sample_t sample;
+    if(!profiler_get_latest(&sample))
+    {
+        lv_label_set_text(ui_cpuLabel, DIAG_NO_SAMPLES_TEXT);
+        return;
+    }
+
+    lv_label_set_text_fmt(ui_cpuLabel, "CPU0 %d.%d%%   CPU1 %d.%d%%", sample.cpu_permille[0] / 10,
+                          sample.cpu_permille[0] % 10, sample.cpu_permille[1] / 10, sample.cpu_permille[1] % 10);
+
+    // Points without history stay empty on the left
+    uint16_t load[DIAG_HISTORY_LEN];
+    for(int core = 0; core < PROFILER_CORES; core++)
+    {
+        int count = profiler_get_load_history(core, load, DIAG_HISTORY_LEN);
+        int empty = DIAG_HISTORY_LEN - count;
+        for(int i = 0; i < DIAG_HISTORY_LEN; i++)
+        {
+            _diag.history[core][i] = (i < empty) ? LV_CHART_POINT_NONE : (lv_coord_t)load[i - empty];
+        }
+    }
+    lv_chart_refresh(ui_cpuChart);
+
+    _diag.is_tasks ? _show_tasks() : _show_probes(&sample);
+}
+
+static void _show_probes(const profiler_sample_t *p_sample)
+{
+    char cell[DIAG_CELL_LEN];
+
+    _set_columns(_probe_widths);
+    lv_table_set_row_cnt(ui_diagTable, PROFILER_PROBE_COUNT + 1);
+    lv_table_set_cell_value(ui_diagTable, 0, 0, "probe");
+    lv_table_set_cell_value(ui_diagTable, 0, 1, "calls/s");
+    lv_table_set_cell_value(ui_diagTable, 0, 2, "mean us");
+    lv_table_set_cell_value(ui_diagTable, 0, 3, "max us");
+    lv_table_set_cell_value(ui_diagTable, 0, 4, "load");
+
+    for(int i = 0; i < PROFILER_PROBE_COUNT; i++)
+    {
+        const profiler_probe_stats_t *p_probe = &p_sample->probe[i];
+        uint16_t                      row     = i + 1;
+        uint32_t                      rate    = (uint64_t)p_probe->calls * 1000000 / p_sample->window_us;
+
+        lv_table_set_cell_value(ui_diagTable, row, 0, profiler_probe_name(i));
+        snprintf(cell, sizeof(cell), "%lu", (unsigned long)rate);
+        lv_table_set_cell_value(ui_diagTable, row, 1, cell);
+        snprintf(cell, sizeof(cell), "%.1f", profiler_cycles_to_us(p_probe->mean_cycles));
+        lv_table_set_cell_value(ui_diagTable, row, 2, cell);
+        snprintf(cell, sizeof(cell), "%.1f", profiler_cycles_to_us(p_probe->max_cycles));
+        lv_table_set_cell_value(ui_diagTable, row, 3, cell);
+        snprintf(cell, sizeof(cell), "%u.%u%%", p_probe->permille / 10, p_probe->permille % 10);
+        lv_table_set_cell_value(ui_diagTable, row, 4, cell);
+    }
+}
+
+static void _show_tasks(void)
+{
+    profiler_task_t tasks[DIAG_TABLE_ROWS - 1];
+    char            cell[DIAG_CELL_LEN];
+    int             count = profiler_get_tasks(tasks, DIAG_TABLE_ROWS - 1);
+
+    _set_columns(_task_widths);
+    lv_table_set_row_cnt(ui_diagTable, count + 1);
+    lv_table_set_cell_value(ui_diagTable, 0, 0, "task");
+    lv_table_set_cell_value(ui_diagTable, 0, 1, "prio");
+    lv_table_set_cell_value(ui_diagTable, 0, 2, "cpu");
+    lv_table_set_cell_value(ui_diagTable, 0, 3, "stack free");
+
+    for(int i = 0; i < count; i++)
+    {
+        uint16_t row = i + 1;
+
+        lv_table_set_cell_value(ui_diagTable, row, 0, tasks[i].name);
+        snprintf(cell, sizeof(cell), "%u", tasks[i].priority);
+        lv_table_set_cell_value(ui_diagTable, row, 1, cell);
+        snprintf(cell, sizeof(cell), "%u.%u%%", tasks[i].cpu_permille / 10, tasks[i].cpu_permille % 10);
+        lv_table_set_cell_value(ui_diagTable, row, 2, cell);
+        snprintf(cell, sizeof(cell), "%lu", (unsigned long)tasks[i].stack_free);
+        lv_table_set_cell_value(ui_diagTable, row, 3, cell);
+    }
+}
+
+static void _set_columns(const lv_coord_t *p_widths)
+{
+    uint16_t count = 0;
+    while(0 != p_widths[count])
+    {
+        count++;
+    }
+
+    lv_table_set_col_cnt(ui_diagTable, count);
+    for(uint16_t col = 0; col < count; col++)
+    {
+        lv_table_set_col_width(ui_diagTable, col, p_widths[col]);
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,49 @@
+/**
+ * @file diag_view.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __DIAG_VIEW_H__
+#define __DIAG_VIEW_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdbool.h>
+
+//---------------------------------- MACROS -----------------------------------
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Starts refreshing the diagnostics screen from the profiler. Called from the GUI task when it is shown.
+ *
+ */
+void diag_view_start(void);
+
+/**
+ * @brief Stops refreshing the diagnostics screen. Called from the GUI task when it is left.
+ *
+ */
+void diag_view_stop(void);
+
+/**
+ * @brief Chooses what the table shows
+ *
+ * @param is_tasks True for tasks, false for probes
+ */
+void diag_view_show_tasks(bool is_tasks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DIAG_VIEW_H__
@@ -30,6 +30,8 @@
 #include "button.h"
 #include "joystick.h"
 #include "led.h"
+#include "sched.h"
+#include "profiler.h"
 
 //---------------------------------- MACROS -----------------------------------
 #define LV_TICK_PERIOD_MS (1U)
@@ -58,6 +60,7 @@ struct
     lv_group_t *focus_scr_0; // Home screen
     lv_group_t *focus_scr_1; // Function generator screen
     lv_group_t *focus_scr_2; // Oscilloscope screen
+    lv_group_t *focus_scr_3; // Diagnostics screen
 
     // mutexes
     // semaphore to handle physical button
@@ -113,9 +116,19 @@ static void _ui_btn_1_callback_isr(void *p_arg);
  */
 static void _gui_switch_indev_group_to_active_screen(void);
 
+/**
+ * @brief Flushes rendered area to the display, timed by the profiler
+ *
+ * @param drv Display driver
+ * @param area Area to flush
+ * @param color_map Rendered pixels of the area
+ */
+static void _gui_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map);
+
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 static SemaphoreHandle_t p_gui_semaphore;
 static QueueHandle_t     _gui_joystick_queue;
+static TaskHandle_t      _gui_task_handle = NULL;
 
 static const char *TAG = "GUI";
 
@@ -142,12 +155,17 @@ void gui_init()
     if(BUTTON_ERR_NONE != button_create(BUTTON_1, _ui_btn_1_callback_isr))
         return;
 
-    /* The ESP32 MCU has got two cores - Core 0 and Core 1, each capable of running tasks independently.
-    We want the GUI to run smoothly, without Wi-Fi, Bluetooth and any other task taking its time and therefor
-    slowing it down. That's why we need to "pin" the GUI task to it's own core, Core 1.
-    Doing so, we reduce the risk of resource conflicts, race conditions and other potential issues.
-    * NOTE: When not using Wi-Fi nor Bluetooth, you can pin the GUI task to Core 0.*/
-    xTaskCreatePinnedToCore(_gui_task, "gui", 4096 * 2, NULL, 0, NULL, 1);
+    // Created before the task, so tasks started later can wait on it while LVGL is being set up
+    p_gui_semaphore = xSemaphoreCreateRecursiveMutex();
+    if(NULL == p_gui_semaphore)
+    {
+        ESP_LOGE(TAG, "Failed to create GUI lock!");
+        return;
+    }
+
+    /* All LVGL work runs on the UI core, so redraws never compete with sampling and generation on the I/O core.
+    See sched.c for the full scheduling model. */
+    sched_task_create(SCHED_TASK_GUI, _gui_task, 4096 * 2, NULL, &_gui_task_handle);
 }
 
 void gui_receive_joystick_pos(int pos)
@@ -156,6 +174,41 @@ void gui_receive_joystick_pos(int pos)
     gui_io.j_pos_changed = true;
 }
 
+bool gui_lock(uint32_t timeout_ms)
+{
+    if((NULL == p_gui_semaphore) || !sched_ui_wait_allowed("GUI"))
+    {
+        return false;
+    }
+
+    TickType_t ticks = (GUI_LOCK_WAIT_FOREVER == timeout_ms) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return (pdTRUE == xSemaphoreTakeRecursive(p_gui_semaphore, ticks));
+}
+
+void gui_unlock(void)
+{
+    xSemaphoreGiveRecursive(p_gui_semaphore);
+}
+
+void gui_wake(void)
+{
+    if(NULL == _gui_task_handle)
+    {
+        return;
+    }
+
+    if(xPortInIsrContext())
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(_gui_task_handle, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+    else
+    {
+        xTaskNotifyGive(_gui_task_handle);
+    }
+}
+
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
 
 static void _create_application(void)
@@ -174,7 +227,9 @@ static void _gui_task(void *p_parameter)
 {
 
     (void)p_parameter;
-    p_gui_semaphore = xSemaphoreCreateMutex();
+
+    // Held until the application is created, nobody may touch LVGL before that
+    gui_lock(GUI_LOCK_WAIT_FOREVER);
 
     lv_init();
 
@@ -197,7 +252,7 @@ static void _gui_task(void *p_parameter)
     disp_drv.hor_res = LV_HOR_RES_MAX;
     disp_drv.ver_res = LV_VER_RES_MAX;
     lv_disp_drv_init(&disp_drv);
-    disp_drv.flush_cb = disp_driver_flush;
+    disp_drv.flush_cb = _gui_flush_cb;
 
     disp_drv.draw_buf = &disp_draw_buf;
     lv_disp_drv_register(&disp_drv);
@@ -231,11 +286,13 @@ static void _gui_task(void *p_parameter)
     gui_io.focus_scr_0 = lv_group_create();
     gui_io.focus_scr_1 = lv_group_create();
     gui_io.focus_scr_2 = lv_group_create();
+    gui_io.focus_scr_3 = lv_group_create();
 
     /* Screen 0 focusable objects */
     lv_group_add_obj(gui_io.focus_scr_0, ui_oscbutton1);
     lv_group_add_obj(gui_io.focus_scr_0, ui_fngen1);
     lv_group_add_obj(gui_io.focus_scr_0, ui_wifiBtn);
+    lv_group_add_obj(gui_io.focus_scr_0, ui_diagBtn);
 
     /* Screen 1 focusable objects */
     lv_group_add_obj(gui_io.focus_scr_1, ui_signalTypeDropdown);
@@ -252,21 +309,31 @@ static void _gui_task(void *p_parameter)
     lv_group_add_obj(gui_io.focus_scr_2, ui_ch1Btn1);
     lv_group_add_obj(gui_io.focus_scr_2, ui_togglemsBtn);
     lv_group_add_obj(gui_io.focus_scr_2, ui_togglemVBtn);
+    lv_group_add_obj(gui_io.focus_scr_2, ui_Chart2);
+    lv_group_add_obj(gui_io.focus_scr_2, ui_cursorBtn);
+    lv_group_add_obj(gui_io.focus_scr_2, ui_refBtn);
     lv_group_add_obj(gui_io.focus_scr_2, ui_backbtn);
 
+    /* Screen 3 focusable objects */
+    lv_group_add_obj(gui_io.focus_scr_3, ui_diagPageBtn);
+    lv_group_add_obj(gui_io.focus_scr_3, ui_backBtn3);
+
     // Initialize joystick as gui input device
     _gui_indev_init();
+    gui_unlock();
 
     for(;;)
     {
-        /* Delay 1 tick (assumes FreeRTOS tick is 10ms */
-        vTaskDelay(pdMS_TO_TICKS(10));
+        // Sleep 10 ms, or until someone has new data to show, see gui_wake()
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
 
         /* Try to take the semaphore, call lvgl related function on success */
-        if(pdTRUE == xSemaphoreTake(p_gui_semaphore, portMAX_DELAY))
+        if(gui_lock(GUI_LOCK_WAIT_FOREVER))
         {
+            PROFILER_BEGIN(PROFILER_PROBE_LV_TIMER);
             lv_task_handler();
-            xSemaphoreGive(p_gui_semaphore);
+            PROFILER_END(PROFILER_PROBE_LV_TIMER);
+            gui_unlock();
         }
     }
 
@@ -365,6 +432,17 @@ static void _gui_switch_indev_group_to_active_screen(void)
     {
         lv_indev_set_group(indev_io, gui_io.focus_scr_2); // Switch indev focus group to function generator screen
     }
+    else if(ui_diagnosticsscr == active_screen)
+    {
+        lv_indev_set_group(indev_io, gui_io.focus_scr_3); // Switch indev focus group to diagnostics screen
+    }
+}
+
+static void _gui_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map)
+{
+    PROFILER_BEGIN(PROFILER_PROBE_DISP_FLUSH);
+    disp_driver_flush(drv, area, color_map);
+    PROFILER_END(PROFILER_PROBE_DISP_FLUSH);
 }
 
 //---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -16,7 +16,10 @@ extern "C" {
 
 //--------------------------------- INCLUDES ----------------------------------
 #include "joystick.h"
+#include <stdbool.h>
+#include <stdint.h>
 //---------------------------------- MACROS -----------------------------------
+#define GUI_LOCK_WAIT_FOREVER (UINT32_MAX)
 
 //-------------------------------- DATA TYPES ---------------------------------
 
@@ -30,6 +33,28 @@ void gui_init(void);
 
 void gui_receive_joystick_pos(int pos);
 
+/**
+ * @brief Takes the lock every LVGL call made outside of the GUI task has to hold. The lock is recursive, so code
+ * running from LVGL event callbacks may take it again. Real-time paths are refused, see sched_ui_wait_allowed().
+ *
+ * @param timeout_ms Time to wait for the lock, GUI_LOCK_WAIT_FOREVER to wait as long as it takes
+ * @return true if the lock is held and has to be released with gui_unlock()
+ */
+bool gui_lock(uint32_t timeout_ms);
+
+/**
+ * @brief Releases the lock taken by gui_lock()
+ *
+ */
+void gui_unlock(void);
+
+/**
+ * @brief Wakes the GUI task, so new data gets shown by the next LVGL timer due instead of after the task's poll
+ * period. Never blocks, real-time paths may call it.
+ *
+ */
+void gui_wake(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1119 @@
+/**
+ * @file lv_scope.c
+ *
+ * @brief   Oscilloscope widget, draws traces and graticule straight into the draw buffer
+ *
+ * lv_chart draws a line series as one masked and blended line per pair of points, which costs far more than the
+ * pixels it touches. Here samples are reduced once per update to the rows each column of the content area covers, so
+ * drawing a trace is one vertical run of pixels per column. The graticule (division lines, and centre axes with
+ * ticks if the ticks part has a line width) is rendered once per size, division or style change. Rows of it look the
+ * same unless a line or a tick crosses them, so it is kept as one pre-rendered row per kind of row plus the kind of
+ * each row, a few KB instead of a whole layer, and the background of the content area is one copy per row. Both
+ * write opaque pixels into the draw buffer, clipped to the area being redrawn, without going through the blend
+ * pipeline. Only software rendering is supported, which is all this project uses.
+ *
+ * New samples of a trace that was already drawn are reduced right away and compared with the columns on screen. Only
+ * the rows the changed columns covered or cover now are invalidated, per band of columns, so a slowly moving signal
+ * costs a few thin strips of rendering and display transfer instead of the whole widget. Traces updated together share
+ * the bands, so a view change of every trace still fits the areas LVGL keeps track of.
+ *
+ * Antialiased traces keep the rows of each column in 1/64 of a row. A column is drawn as a band one row thick around
+ * them, so the first and last rows it reaches are only partly covered, the way Wu's line algorithm splits a point
+ * between two pixels. Coverage goes through a gamma corrected table to the opacity the pixel is blended with, and in
+ * RGB565 blending is a single packed multiply per colour instead of one per channel.
+ *
+ * Cursors are one pixel lines blended over everything else when the area under them is drawn. Moving one invalidates
+ * the line it leaves and the one it goes to, which redraws the graticule and traces of those strips from what is
+ * already built.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "lv_scope.h"
+#include <string.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define MY_CLASS &lv_scope_class
+
+#define SCOPE_DEF_X_DIV (10)
+#define SCOPE_DEF_Y_DIV (8)
+#define SCOPE_DEF_MAX   (100)
+
+#define SCOPE_MINOR_DIV (5) // Ticks per division on the centre axes
+#define SCOPE_TICK_HALF (2) // Pixels a tick reaches to either side of its axis
+
+// Changes of a trace are invalidated in bands of columns, few enough for LVGL to keep track of all of them
+#define SCOPE_BAND_MAX (8)
+#define SCOPE_BAND_MIN (8) // Narrowest band in pixels
+
+// Antialiased columns are kept in fractions of a row, small enough to still fit lv_coord_t
+#define SCOPE_AA_BITS  (6)
+#define SCOPE_AA_ONE   (1 << SCOPE_AA_BITS)
+#define SCOPE_AA_MAX_H (INT16_MAX >> SCOPE_AA_BITS) // Highest content area that can be antialiased
+
+// Kinds of graticule rows, what a row looks like only depends on which of these it is
+#define SCOPE_ROW_LINE   (0x01) // Horizontal division line
+#define SCOPE_ROW_AXIS   (0x02) // Horizontal centre axis
+#define SCOPE_ROW_TICK_X (0x04) // Close enough to the horizontal axis to cross its ticks
+#define SCOPE_ROW_TICK_Y (0x08) // Tick of the vertical axis
+#define SCOPE_ROW_KINDS  (0x10)
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+//---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
+static void _constructor(const lv_obj_class_t *p_class, lv_obj_t *p_obj);
+static void _destructor(const lv_obj_class_t *p_class, lv_obj_t *p_obj);
+static void _event_cb(const lv_obj_class_t *p_class, lv_event_t *p_e);
+
+/**
+ * @brief Draws content area into the draw buffer, and the rest of the object the usual way if it is being redrawn
+ *
+ * @param p_e Draw main event
+ */
+static void _draw(lv_event_t *p_e);
+
+/**
+ * @brief Draws columns of trace within clip area
+ *
+ * @param p_scope Scope
+ * @param p_trace Trace
+ * @param p_ctx Draw context
+ * @param p_content Content area
+ * @param p_clip Part of content area being drawn
+ */
+static void _draw_trace(const lv_scope_t *p_scope, const lv_scope_trace_t *p_trace, lv_draw_ctx_t *p_ctx,
+                        const lv_area_t *p_content, const lv_area_t *p_clip);
+
+/**
+ * @brief Draws columns of antialiased trace within clip area
+ *
+ * @param p_scope Scope
+ * @param p_trace Trace
+ * @param p_ctx Draw context
+ * @param p_content Content area
+ * @param p_clip Part of content area being drawn
+ */
+static void _draw_trace_aa(const lv_scope_t *p_scope, const lv_scope_trace_t *p_trace, lv_draw_ctx_t *p_ctx,
+                           const lv_area_t *p_content, const lv_area_t *p_clip);
+
+/**
+ * @brief Blends color over pixel
+ *
+ * @param color Color on top
+ * @param bg Pixel
+ * @param opa Opacity of color
+ * @return lv_color_t Blended pixel
+ */
+static inline lv_color_t _mix(lv_color_t color, lv_color_t bg, lv_opa_t opa);
+
+/**
+ * @brief Returns fraction bits rows of columns are kept in
+ *
+ * @param p_scope Scope
+ * @return uint8_t SCOPE_AA_BITS if the scope is antialiased and low enough, 0 otherwise
+ */
+static inline uint8_t _sub_bits(const lv_scope_t *p_scope);
+
+/**
+ * @brief Draws visible cursors within clip area
+ *
+ * @param p_scope Scope
+ * @param p_ctx Draw context
+ * @param p_content Content area
+ * @param p_clip Part of content area being drawn
+ */
+static void _draw_cursors(const lv_scope_t *p_scope, lv_draw_ctx_t *p_ctx, const lv_area_t *p_content,
+                          const lv_area_t *p_clip);
+
+/**
+ * @brief Invalidates the line cursor covers, if it is visible
+ *
+ * @param p_scope Scope
+ * @param cursor Cursor
+ */
+static void _invalidate_cursor(lv_scope_t *p_scope, lv_scope_cursor_t cursor);
+
+/**
+ * @brief Returns whether object or one of its parents is rotated or zoomed
+ *
+ * @param p_obj Object
+ * @return true If transformed
+ */
+static bool _is_transformed(const lv_obj_t *p_obj);
+
+/**
+ * @brief Rebuilds graticule and columns if content area has a different size than they were built for, and the
+ * graticule alone if its colors changed. Colors are compared on every draw, as LVGL only reports style changes
+ * that affect the layout.
+ *
+ * @param p_scope Scope
+ * @param p_content Content area
+ * @return true if everything needed for drawing is there
+ */
+static bool _update_geometry(lv_scope_t *p_scope, const lv_area_t *p_content);
+
+/**
+ * @brief Renders one row of each kind the graticule has and points every row of the content area at its kind
+ *
+ * @param p_scope Scope
+ * @return true if there was memory for the rows
+ */
+static bool _build_graticule(lv_scope_t *p_scope);
+
+/**
+ * @brief Renders graticule row
+ *
+ * @param p_scope Scope
+ * @param kind SCOPE_ROW_x flags of the row
+ * @param p_row Row of the content width
+ */
+static void _render_row(const lv_scope_t *p_scope, uint8_t kind, lv_color_t *p_row);
+
+/**
+ * @brief Reduces samples of trace to the rows each column covers
+ *
+ * @param p_scope Scope
+ * @param p_trace Trace
+ */
+static void _build_columns(const lv_scope_t *p_scope, lv_scope_trace_t *p_trace);
+
+/**
+ * @brief Rebuilds columns of traces and invalidates what changed, or leaves both to the next draw for a trace that
+ * hasn't been drawn since its columns were dropped
+ *
+ * @param p_scope Scope
+ * @param traces Bit per index of a trace to update
+ */
+static void _update_columns(lv_scope_t *p_scope, uint32_t traces);
+
+/**
+ * @brief Invalidates the rows columns of traces covered before or cover after the last update, in each band of
+ * columns where the update changed something. Traces share the bands, so however many of them moved, LVGL is given
+ * no more areas than there are bands.
+ *
+ * @param p_scope Scope
+ * @param traces Bit per index of a trace with previous columns in p_old_top and p_old_bottom
+ */
+static void _invalidate_changes(lv_scope_t *p_scope, uint32_t traces);
+
+/**
+ * @brief Drops graticule and columns, so they are rebuilt on the next draw
+ *
+ * @param p_scope Scope
+ */
+static void _reset_geometry(lv_scope_t *p_scope);
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+
+// Opacity of a pixel by 1/64 of it covered, with gamma 1.8 so partly covered edges don't look thinner than the rest
+static const uint8_t _coverage_opa[SCOPE_AA_ONE + 1] = {
+    0,   25,  37,  47,  55,  62,  68,  75,  80,  86,  91,  96,  101, 105, 110, 114, 118, 122, 126, 130, 134, 137,
+    141, 144, 148, 151, 155, 158, 161, 164, 167, 170, 174, 176, 179, 182, 185, 188, 191, 194, 196, 199, 202, 204,
+    207, 210, 212, 215, 217, 220, 222, 225, 227, 230, 232, 234, 237, 239, 241, 244, 246, 248, 251, 253, 255,
+};
+
+//------------------------------- GLOBAL DATA ---------------------------------
+
+const lv_obj_class_t lv_scope_class = {
+    .constructor_cb = _constructor,
+    .destructor_cb  = _destructor,
+    .event_cb       = _event_cb,
+    .width_def      = LV_PCT(100),
+    .height_def     = LV_DPI_DEF * 2,
+    .instance_size  = sizeof(lv_scope_t),
+    .base_class     = &lv_obj_class,
+};
+
+//------------------------------ PUBLIC FUNCTIONS -----------------------------
+
+lv_obj_t *lv_scope_create(lv_obj_t *p_parent)
+{
+    lv_obj_t *p_obj = lv_obj_class_create_obj(MY_CLASS, p_parent);
+    lv_obj_class_init_obj(p_obj);
+    return p_obj;
+}
+
+lv_scope_trace_t *lv_scope_add_trace(lv_obj_t *p_obj, lv_color_t color)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    if(p_scope->trace_cnt >= LV_SCOPE_TRACE_MAX)
+    {
+        LV_LOG_WARN("Scope has no room for another trace");
+        return NULL;
+    }
+
+    lv_scope_trace_t *p_trace = &p_scope->traces[p_scope->trace_cnt++];
+    lv_memset_00(p_trace, sizeof(*p_trace));
+    p_trace->color = color;
+
+    // Columns of the new trace are allocated with everyone else's
+    _reset_geometry(p_scope);
+    return p_trace;
+}
+
+void lv_scope_set_values(lv_obj_t *p_obj, lv_scope_trace_t *p_trace, const lv_coord_t *p_values, uint16_t cnt)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    LV_ASSERT_NULL(p_trace);
+
+    if(cnt > p_trace->value_cap)
+    {
+        lv_coord_t *p_new = lv_mem_realloc(p_trace->p_values, cnt * sizeof(lv_coord_t));
+        LV_ASSERT_MALLOC(p_new);
+        if(NULL == p_new)
+        {
+            return;
+        }
+        p_trace->p_values  = p_new;
+        p_trace->value_cap = cnt;
+    }
+
+    lv_memcpy(p_trace->p_values, p_values, cnt * sizeof(lv_coord_t));
+    p_trace->value_cnt = cnt;
+    _update_columns((lv_scope_t *)p_obj, 1u << (p_trace - ((lv_scope_t *)p_obj)->traces));
+}
+
+void lv_scope_set_view(lv_obj_t *p_obj, int32_t first, uint16_t cnt)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    cnt = (0 == cnt) ? 0 : LV_MAX(cnt, 2);
+    if((first == p_scope->view_first) && (cnt == p_scope->view_cnt))
+    {
+        return;
+    }
+
+    // Panning moves most of a trace, zooming all of it, still only the rows they cover get redrawn
+    p_scope->view_first = first;
+    p_scope->view_cnt   = cnt;
+    _update_columns(p_scope, (1u << p_scope->trace_cnt) - 1);
+}
+
+void lv_scope_hide_trace(lv_obj_t *p_obj, lv_scope_trace_t *p_trace, bool is_hidden)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    LV_ASSERT_NULL(p_trace);
+
+    if(p_trace->is_hidden != is_hidden)
+    {
+        p_trace->is_hidden = is_hidden;
+        lv_obj_invalidate(p_obj);
+    }
+}
+
+void lv_scope_set_antialias(lv_obj_t *p_obj, bool is_antialias)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    if(p_scope->is_antialias == is_antialias)
+    {
+        return;
+    }
+
+    // Columns are kept in other units, old and new ones can't be compared
+    p_scope->is_antialias = is_antialias;
+    for(uint8_t i = 0; i < p_scope->trace_cnt; i++)
+    {
+        p_scope->traces[i].is_dirty = true;
+    }
+    lv_obj_invalidate(p_obj);
+}
+
+void lv_scope_set_range(lv_obj_t *p_obj, lv_coord_t min, lv_coord_t max)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    p_scope->min = min;
+    p_scope->max = max;
+    for(uint8_t i = 0; i < p_scope->trace_cnt; i++)
+    {
+        p_scope->traces[i].is_dirty = true;
+    }
+    lv_obj_invalidate(p_obj);
+}
+
+void lv_scope_set_div_count(lv_obj_t *p_obj, uint8_t x_div, uint8_t y_div)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    p_scope->x_div = x_div;
+    p_scope->y_div = y_div;
+    _reset_geometry(p_scope);
+    lv_obj_invalidate(p_obj);
+}
+
+void lv_scope_set_cursor(lv_obj_t *p_obj, lv_scope_cursor_t cursor, lv_coord_t pos)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    if(cursor >= LV_SCOPE_CURSOR_CNT)
+    {
+        return;
+    }
+
+    // Cursors may be placed before the first layout, sizes of the content area have to be there already
+    lv_obj_update_layout(p_obj);
+    if(LV_SCOPE_CURSOR_OFF != pos)
+    {
+        lv_coord_t size = (cursor <= LV_SCOPE_CURSOR_X2) ? lv_obj_get_content_width(p_obj)
+                                                          : lv_obj_get_content_height(p_obj);
+        pos             = LV_CLAMP(0, pos, LV_MAX(size - 1, 0));
+    }
+    if(pos == p_scope->cursors[cursor])
+    {
+        return;
+    }
+
+    _invalidate_cursor(p_scope, cursor);
+    p_scope->cursors[cursor] = pos;
+    _invalidate_cursor(p_scope, cursor);
+}
+
+lv_coord_t lv_scope_get_cursor(const lv_obj_t *p_obj, lv_scope_cursor_t cursor)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+
+    return (cursor < LV_SCOPE_CURSOR_CNT) ? ((const lv_scope_t *)p_obj)->cursors[cursor] : LV_SCOPE_CURSOR_OFF;
+}
+
+int32_t lv_scope_get_sample_at(lv_obj_t *p_obj, lv_coord_t col)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    // Same spread as the columns are built with, all samples of the longest trace if there is no view
+    int32_t first = (0 != p_scope->view_cnt) ? p_scope->view_first : 0;
+    int32_t cnt   = p_scope->view_cnt;
+    for(uint8_t i = 0; (0 == p_scope->view_cnt) && (i < p_scope->trace_cnt); i++)
+    {
+        cnt = LV_MAX(cnt, p_scope->traces[i].value_cnt);
+    }
+
+    lv_obj_update_layout(p_obj);
+    int32_t last_x = LV_MAX(lv_obj_get_content_width(p_obj) - 1, 1);
+    int32_t offset = ((int64_t)col * LV_MAX(cnt - 1, 0) * LV_SCOPE_FRAC + last_x / 2) / last_x;
+    return first * LV_SCOPE_FRAC + offset;
+}
+
+int32_t lv_scope_get_value_at(const lv_scope_trace_t *p_trace, int32_t pos)
+{
+    LV_ASSERT_NULL(p_trace);
+
+    if(0 == p_trace->value_cnt)
+    {
+        return 0;
+    }
+
+    int32_t last = p_trace->value_cnt - 1;
+    if(pos <= 0)
+    {
+        return p_trace->p_values[0] * LV_SCOPE_FRAC;
+    }
+    if(pos >= last * LV_SCOPE_FRAC)
+    {
+        return p_trace->p_values[last] * LV_SCOPE_FRAC;
+    }
+
+    int32_t i    = pos / LV_SCOPE_FRAC;
+    int32_t frac = pos % LV_SCOPE_FRAC;
+    return p_trace->p_values[i] * LV_SCOPE_FRAC + (p_trace->p_values[i + 1] - p_trace->p_values[i]) * frac;
+}
+
+int32_t lv_scope_get_level_at(lv_obj_t *p_obj, lv_coord_t row)
+{
+    LV_ASSERT_OBJ(p_obj, MY_CLASS);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    // Inverse of the row samples are drawn at
+    lv_obj_update_layout(p_obj);
+    int32_t last_y = LV_MAX(lv_obj_get_content_height(p_obj) - 1, 1);
+    int32_t range  = LV_MAX(p_scope->max - p_scope->min, 1);
+    int32_t offset = ((int64_t)row * range * LV_SCOPE_FRAC + last_y / 2) / last_y;
+    return p_scope->max * LV_SCOPE_FRAC - offset;
+}
+
+//---------------------------- PRIVATE FUNCTIONS ------------------------------
+
+static void _constructor(const lv_obj_class_t *p_class, lv_obj_t *p_obj)
+{
+    LV_UNUSED(p_class);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    p_scope->min   = 0;
+    p_scope->max   = SCOPE_DEF_MAX;
+    p_scope->x_div = SCOPE_DEF_X_DIV;
+    p_scope->y_div = SCOPE_DEF_Y_DIV;
+    for(uint8_t i = 0; i < LV_SCOPE_CURSOR_CNT; i++)
+    {
+        p_scope->cursors[i] = LV_SCOPE_CURSOR_OFF;
+    }
+
+    lv_obj_clear_flag(p_obj, LV_OBJ_FLAG_SCROLLABLE);
+}
+
+static void _destructor(const lv_obj_class_t *p_class, lv_obj_t *p_obj)
+{
+    LV_UNUSED(p_class);
+    lv_scope_t *p_scope = (lv_scope_t *)p_obj;
+
+    _reset_geometry(p_scope);
+    for(uint8_t i = 0; i < p_scope->trace_cnt; i++)
+    {
+        lv_mem_free(p_scope->traces[i].p_values);
+    }
+}
+
+static void _event_cb(const lv_obj_class_t *p_class, lv_event_t *p_e)
+{
+    LV_UNUSED(p_class);
+
+    lv_event_code_t code = lv_event_get_code(p_e);
+    if(LV_EVENT_DRAW_MAIN == code)
+    {
+        _draw(p_e);
+        return;
+    }
+
+    if(LV_RES_OK != lv_obj_event_base(MY_CLASS, p_e))
+    {
+        return;
+    }
+
+    if((LV_EVENT_SIZE_CHANGED == code) || (LV_EVENT_STYLE_CHANGED == code))
+    {
+        // Colors may have changed too, not just the size
+        _reset_geometry((lv_scope_t *)lv_event_get_target(p_e));
+    }
+}
+
+static void _draw(lv_event_t *p_e)
+{
+    lv_obj_t      *p_obj   = lv_event_get_target(p_e);
+    lv_scope_t    *p_scope = (lv_scope_t *)p_obj;
+    lv_draw_ctx_t *p_ctx   = lv_event_get_draw_ctx(p_e);
+
+    lv_area_t content;
+    lv_obj_get_content_coords(p_obj, &content);
+
+    // Background and border only need drawing when some of them is being redrawn, or content can't be drawn
+    bool is_ready = _update_geometry(p_scope, &content);
+    if(!is_ready || !_lv_area_is_in(p_ctx->clip_area, &content, 0))
+    {
+        if(LV_RES_OK != lv_obj_event_base(MY_CLASS, p_e))
+        {
+            return;
+        }
+    }
+
+    lv_area_t clip;
+    if(!is_ready || !_lv_area_intersect(&clip, p_ctx->clip_area, &content))
+    {
+        return;
+    }
+
+    lv_coord_t  stride = lv_area_get_width(p_ctx->buf_area);
+    lv_coord_t  width  = lv_area_get_width(&clip);
+    lv_coord_t  x      = clip.x1 - content.x1;
+    lv_color_t *p_dst  = (lv_color_t *)p_ctx->buf + (clip.y1 - p_ctx->buf_area->y1) * stride;
+    p_dst += clip.x1 - p_ctx->buf_area->x1;
+
+    for(lv_coord_t y = clip.y1 - content.y1; y <= clip.y2 - content.y1; y++)
+    {
+        const lv_color_t *p_src = p_scope->p_rows + p_scope->p_row_of[y] * p_scope->w;
+        // C library copy is word wide and unrolled, the one of LVGL isn't unless LV_MEMCPY_MEMSET_STD is set
+        memcpy(p_dst, p_src + x, width * sizeof(lv_color_t));
+        p_dst += stride;
+    }
+
+    for(uint8_t i = 0; i < p_scope->trace_cnt; i++)
+    {
+        lv_scope_trace_t *p_trace = &p_scope->traces[i];
+        if(p_trace->is_dirty)
+        {
+            _build_columns(p_scope, p_trace);
+        }
+        if(p_trace->is_hidden)
+        {
+            continue;
+        }
+        if(0 != _sub_bits(p_scope))
+        {
+            _draw_trace_aa(p_scope, p_trace, p_ctx, &content, &clip);
+        }
+        else
+        {
+            _draw_trace(p_scope, p_trace, p_ctx, &content, &clip);
+        }
+    }
+    _draw_cursors(p_scope, p_ctx, &content, &clip);
+}
+
+static void _draw_trace(const lv_scope_t *p_scope, const lv_scope_trace_t *p_trace, lv_draw_ctx_t *p_ctx,
+                        const lv_area_t *p_content, const lv_area_t *p_clip)
+{
+    // Wider traces repeat each column to its neighbours and grow it up and down
+    lv_coord_t width = lv_obj_get_style_line_width((const lv_obj_t *)p_scope, LV_PART_ITEMS);
+    width            = LV_MAX(width, 1);
+    lv_coord_t before = (width - 1) / 2;
+    lv_coord_t after  = width / 2;
+
+    lv_coord_t stride = lv_area_get_width(p_ctx->buf_area);
+    lv_coord_t first  = LV_MAX(p_clip->x1 - p_content->x1 - after, 0);
+    lv_coord_t last   = LV_MIN(p_clip->x2 - p_content->x1 + before, p_scope->w - 1);
+
+    for(lv_coord_t col = first; col <= last; col++)
+    {
+        if(p_trace->p_top[col] > p_trace->p_bottom[col])
+        {
+            continue;
+        }
+
+        lv_coord_t y1 = LV_MAX(p_content->y1 + p_trace->p_top[col] - before, p_clip->y1);
+        lv_coord_t y2 = LV_MIN(p_content->y1 + p_trace->p_bottom[col] + after, p_clip->y2);
+        lv_coord_t x1 = LV_MAX(p_content->x1 + col - before, p_clip->x1);
+        lv_coord_t x2 = LV_MIN(p_content->x1 + col + after, p_clip->x2);
+
+        for(lv_coord_t x = x1; x <= x2; x++)
+        {
+            lv_color_t *p_px = (lv_color_t *)p_ctx->buf + (y1 - p_ctx->buf_area->y1) * stride;
+            p_px += x - p_ctx->buf_area->x1;
+            for(lv_coord_t y = y1; y <= y2; y++)
+            {
+                *p_px = p_trace->color;
+                p_px += stride;
+            }
+        }
+    }
+}
+
+static void _draw_trace_aa(const lv_scope_t *p_scope, const lv_scope_trace_t *p_trace, lv_draw_ctx_t *p_ctx,
+                           const lv_area_t *p_content, const lv_area_t *p_clip)
+{
+    lv_coord_t width  = lv_obj_get_style_line_width((const lv_obj_t *)p_scope, LV_PART_ITEMS);
+    width             = LV_MAX(width, 1);
+    lv_coord_t before = (width - 1) / 2;
+    lv_coord_t after  = width / 2;
+    lv_coord_t stride = lv_area_get_width(p_ctx->buf_area);
+
+    for(lv_coord_t x = p_clip->x1; x <= p_clip->x2; x++)
+    {
+        // Wider traces join the spans of the columns reaching this one, blending each of them would overlap
+        lv_coord_t col   = x - p_content->x1;
+        int32_t    start = INT32_MAX;
+        int32_t    end   = INT32_MIN;
+        for(lv_coord_t c = LV_MAX(col - after, 0); c <= LV_MIN(col + before, p_scope->w - 1); c++)
+        {
+            if(p_trace->p_top[c] <= p_trace->p_bottom[c])
+            {
+                start = LV_MIN(start, p_trace->p_top[c]);
+                end   = LV_MAX(end, p_trace->p_bottom[c]);
+            }
+        }
+        if(start > end)
+        {
+            continue;
+        }
+
+        // Band one row thick, or as thick as the trace, from the top of the span to past its bottom
+        start = LV_MAX(start - before * SCOPE_AA_ONE, 0);
+        end   = LV_MIN(end + (after + 1) * SCOPE_AA_ONE, p_scope->h * SCOPE_AA_ONE);
+        lv_coord_t first = (lv_coord_t)(start >> SCOPE_AA_BITS);
+        lv_coord_t last  = (lv_coord_t)((end - 1) >> SCOPE_AA_BITS);
+        lv_coord_t y1    = LV_MAX(p_content->y1 + first, p_clip->y1);
+        lv_coord_t y2    = LV_MIN(p_content->y1 + last, p_clip->y2);
+
+        lv_color_t *p_px = (lv_color_t *)p_ctx->buf + (y1 - p_ctx->buf_area->y1) * stride;
+        p_px += x - p_ctx->buf_area->x1;
+        for(lv_coord_t y = y1; y <= y2; y++)
+        {
+            // Only the first and the last row can be partly covered
+            lv_coord_t row = y - p_content->y1;
+            if((row == first) || (row == last))
+            {
+                int32_t cover = LV_MIN(end, (row + 1) * SCOPE_AA_ONE) - LV_MAX(start, row * SCOPE_AA_ONE);
+                *p_px         = _mix(p_trace->color, *p_px, _coverage_opa[cover]);
+            }
+            else
+            {
+                *p_px = p_trace->color;
+            }
+            p_px += stride;
+        }
+    }
+}
+
+static inline lv_color_t _mix(lv_color_t color, lv_color_t bg, lv_opa_t opa)
+{
+#if LV_COLOR_DEPTH == 16
+    // Green goes to the upper half so each channel has room for its product, then 5 bit opacity mixes all three at once
+    uint32_t fg = color.full;
+    uint32_t px = bg.full;
+#if LV_COLOR_16_SWAP
+    fg = ((fg >> 8) | (fg << 8)) & 0xFFFF;
+    px = ((px >> 8) | (px << 8)) & 0xFFFF;
+#endif
+    uint32_t a = ((uint32_t)opa + 4) >> 3;
+    fg         = (fg | (fg << 16)) & 0x07E0F81F;
+    px         = (px | (px << 16)) & 0x07E0F81F;
+    px         = ((fg * a + px * (32 - a)) >> 5) & 0x07E0F81F;
+    px         = (px | (px >> 16)) & 0xFFFF;
+#if LV_COLOR_16_SWAP
+    px = ((px >> 8) | (px << 8)) & 0xFFFF;
+#endif
+    lv_color_t res;
+    res.full = (uint16_t)px;
+    return res;
+#else
+    return lv_color_mix(color, bg, opa);
+#endif
+}
+
+static inline uint8_t _sub_bits(const lv_scope_t *p_scope)
+{
+    return (p_scope->is_antialias && (p_scope->h <= SCOPE_AA_MAX_H)) ? SCOPE_AA_BITS : 0;
+}
+
+static void _draw_cursors(const lv_scope_t *p_scope, lv_draw_ctx_t *p_ctx, const lv_area_t *p_content,
+                          const lv_area_t *p_clip)
+{
+    lv_obj_t  *p_obj  = (lv_obj_t *)p_scope;
+    lv_color_t color  = lv_obj_get_style_line_color(p_obj, LV_PART_CURSOR);
+    lv_opa_t   opa    = lv_obj_get_style_line_opa(p_obj, LV_PART_CURSOR);
+    lv_coord_t stride = lv_area_get_width(p_ctx->buf_area);
+
+    for(uint8_t i = 0; i < LV_SCOPE_CURSOR_CNT; i++)
+    {
+        if(LV_SCOPE_CURSOR_OFF == p_scope->cursors[i])
+        {
+            continue;
+        }
+
+        // Vertical cursor steps down the rows of one column, horizontal one along the columns of one row
+        bool       is_x   = (i <= LV_SCOPE_CURSOR_X2);
+        lv_area_t  line   = *p_clip;
+        lv_coord_t step   = is_x ? stride : 1;
+        lv_coord_t length = is_x ? lv_area_get_height(p_clip) : lv_area_get_width(p_clip);
+        if(is_x)
+        {
+            line.x1 = line.x2 = p_content->x1 + p_scope->cursors[i];
+        }
+        else
+        {
+            line.y1 = line.y2 = p_content->y1 + p_scope->cursors[i];
+        }
+        if(!_lv_area_is_in(&line, p_clip, 0))
+        {
+            continue;
+        }
+
+        lv_color_t *p_px = (lv_color_t *)p_ctx->buf + (line.y1 - p_ctx->buf_area->y1) * stride;
+        p_px += line.x1 - p_ctx->buf_area->x1;
+        for(lv_coord_t k = 0; k < length; k++)
+        {
+            *p_px = lv_color_mix(color, *p_px, opa);
+            p_px += step;
+        }
+    }
+}
+
+static void _invalidate_cursor(lv_scope_t *p_scope, lv_scope_cursor_t cursor)
+{
+    lv_obj_t  *p_obj = (lv_obj_t *)p_scope;
+    lv_coord_t pos   = p_scope->cursors[cursor];
+    if(LV_SCOPE_CURSOR_OFF == pos)
+    {
+        return;
+    }
+
+    lv_area_t area;
+    lv_obj_get_content_coords(p_obj, &area);
+    if(cursor <= LV_SCOPE_CURSOR_X2)
+    {
+        area.x1 = area.x2 = area.x1 + pos;
+    }
+    else
+    {
+        area.y1 = area.y2 = area.y1 + pos;
+    }
+
+    // LVGL grows invalidated areas by the 5 px rounding margin of transformed corners, which turns a 1 px strip into
+    // an 11 px one. An untransformed scope hands the strip to the display as it is, clipped to what is visible.
+    lv_area_t visible = area;
+    if(_is_transformed(p_obj) || !lv_disp_is_invalidation_enabled(lv_obj_get_disp(p_obj)))
+    {
+        lv_obj_invalidate_area(p_obj, &area);
+    }
+    else if(lv_obj_area_is_visible(p_obj, &visible) && _lv_area_intersect(&area, &area, &visible))
+    {
+        _lv_inv_area(lv_obj_get_disp(p_obj), &area);
+    }
+}
+
+static bool _is_transformed(const lv_obj_t *p_obj)
+{
+    for(; NULL != p_obj; p_obj = lv_obj_get_parent(p_obj))
+    {
+        if(LV_LAYER_TYPE_TRANSFORM == _lv_obj_get_layer_type(p_obj))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool _update_geometry(lv_scope_t *p_scope, const lv_area_t *p_content)
+{
+    lv_obj_t  *p_obj   = (lv_obj_t *)p_scope;
+    lv_color_t bg      = lv_obj_get_style_bg_color(p_obj, LV_PART_MAIN);
+    lv_color_t line    = lv_color_mix(lv_obj_get_style_line_color(p_obj, LV_PART_MAIN), bg,
+                                      lv_obj_get_style_line_opa(p_obj, LV_PART_MAIN));
+    lv_color_t axis    = lv_color_mix(lv_obj_get_style_line_color(p_obj, LV_PART_TICKS), bg,
+                                      lv_obj_get_style_line_opa(p_obj, LV_PART_TICKS));
+    bool       is_axes = lv_obj_get_style_line_width(p_obj, LV_PART_TICKS) > 0;
+    bool       is_same = (bg.full == p_scope->bg_color.full) && (line.full == p_scope->line_color.full) &&
+                   (axis.full == p_scope->axis_color.full) && (is_axes == p_scope->is_axes);
+    p_scope->bg_color   = bg;
+    p_scope->line_color = line;
+    p_scope->axis_color = axis;
+    p_scope->is_axes    = is_axes;
+
+    lv_coord_t w = lv_area_get_width(p_content);
+    lv_coord_t h = lv_area_get_height(p_content);
+    if((w == p_scope->w) && (h == p_scope->h))
+    {
+        if(is_same)
+        {
+            return true;
+        }
+        // Same size, rows of the graticule are the only thing colors go into
+        lv_mem_free(p_scope->p_rows);
+        p_scope->p_rows = NULL;
+        if(_build_graticule(p_scope))
+        {
+            return true;
+        }
+        LV_LOG_WARN("Not enough memory for a %dx%d scope", w, h);
+        _reset_geometry(p_scope);
+        return false;
+    }
+
+    _reset_geometry(p_scope);
+    if((w <= 0) || (h <= 0))
+    {
+        return false;
+    }
+
+    p_scope->w        = w;
+    p_scope->h        = h;
+    p_scope->p_row_of = lv_mem_alloc(h);
+    bool is_ok        = (NULL != p_scope->p_row_of) && _build_graticule(p_scope);
+    for(uint8_t i = 0; i < p_scope->trace_cnt; i++)
+    {
+        lv_scope_trace_t *p_trace = &p_scope->traces[i];
+
+        p_trace->p_top        = lv_mem_alloc(4 * w * sizeof(lv_coord_t));
+        p_trace->p_bottom     = p_trace->p_top + w;
+        p_trace->p_old_top    = p_trace->p_top + 2 * w;
+        p_trace->p_old_bottom = p_trace->p_top + 3 * w;
+        p_trace->is_dirty     = true;
+        is_ok             = is_ok && (NULL != p_trace->p_top);
+    }
+    if(!is_ok)
+    {
+        LV_LOG_WARN("Not enough memory for a %dx%d scope", w, h);
+        _reset_geometry(p_scope);
+        return false;
+    }
+
+    return true;
+}
+
+static bool _build_graticule(lv_scope_t *p_scope)
+{
+    int32_t h     = p_scope->h;
+    int32_t ticks = p_scope->y_div * SCOPE_MINOR_DIV;
+
+    lv_memset_00(p_scope->p_row_of, h);
+    for(int32_t i = 1; i < p_scope->y_div; i++)
+    {
+        p_scope->p_row_of[i * h / p_scope->y_div] |= SCOPE_ROW_LINE;
+    }
+    if(p_scope->is_axes)
+    {
+        p_scope->p_row_of[h / 2] |= SCOPE_ROW_AXIS;
+        for(int32_t y = LV_MAX(h / 2 - SCOPE_TICK_HALF, 0); y <= LV_MIN(h / 2 + SCOPE_TICK_HALF, h - 1); y++)
+        {
+            p_scope->p_row_of[y] |= SCOPE_ROW_TICK_X;
+        }
+        for(int32_t i = 1; i < ticks; i++)
+        {
+            p_scope->p_row_of[i * h / ticks] |= SCOPE_ROW_TICK_Y;
+        }
+    }
+
+    // Only a handful of kinds show up, each is rendered once however many rows it covers
+    int8_t  slot[SCOPE_ROW_KINDS];
+    uint8_t kinds = 0;
+    lv_memset(slot, -1, sizeof(slot));
+    for(int32_t y = 0; y < h; y++)
+    {
+        if(slot[p_scope->p_row_of[y]] < 0)
+        {
+            slot[p_scope->p_row_of[y]] = (int8_t)kinds++;
+        }
+    }
+
+    p_scope->p_rows = lv_mem_alloc(kinds * p_scope->w * sizeof(lv_color_t));
+    if(NULL == p_scope->p_rows)
+    {
+        return false;
+    }
+    for(uint8_t kind = 0; kind < SCOPE_ROW_KINDS; kind++)
+    {
+        if(slot[kind] >= 0)
+        {
+            _render_row(p_scope, kind, p_scope->p_rows + slot[kind] * p_scope->w);
+        }
+    }
+    for(int32_t y = 0; y < h; y++)
+    {
+        p_scope->p_row_of[y] = (uint8_t)slot[p_scope->p_row_of[y]];
+    }
+    return true;
+}
+
+static void _render_row(const lv_scope_t *p_scope, uint8_t kind, lv_color_t *p_row)
+{
+    lv_color_t bg    = p_scope->bg_color;
+    lv_color_t line  = p_scope->line_color;
+    lv_color_t axis  = p_scope->axis_color;
+    int32_t    w     = p_scope->w;
+    int32_t    ticks = p_scope->x_div * SCOPE_MINOR_DIV;
+
+    lv_color_t fill = (kind & SCOPE_ROW_AXIS) ? axis : ((kind & SCOPE_ROW_LINE) ? line : bg);
+    for(int32_t x = 0; x < w; x++)
+    {
+        p_row[x] = fill;
+    }
+    if(!(kind & (SCOPE_ROW_LINE | SCOPE_ROW_AXIS)))
+    {
+        for(int32_t i = 1; i < p_scope->x_div; i++)
+        {
+            p_row[i * w / p_scope->x_div] = line;
+        }
+    }
+
+    // Tick flags are never set without axes
+    if(p_scope->is_axes)
+    {
+        p_row[w / 2] = axis;
+    }
+    if(kind & SCOPE_ROW_TICK_X)
+    {
+        for(int32_t i = 1; i < ticks; i++)
+        {
+            p_row[i * w / ticks] = axis;
+        }
+    }
+    if(kind & SCOPE_ROW_TICK_Y)
+    {
+        for(int32_t x = LV_MAX(w / 2 - SCOPE_TICK_HALF, 0); x <= LV_MIN(w / 2 + SCOPE_TICK_HALF, w - 1); x++)
+        {
+            p_row[x] = axis;
+        }
+    }
+}
+
+static void _build_columns(const lv_scope_t *p_scope, lv_scope_trace_t *p_trace)
+{
+    lv_coord_t *p_top    = p_trace->p_top;
+    lv_coord_t *p_bottom = p_trace->p_bottom;
+    uint8_t     sub      = _sub_bits(p_scope);
+
+    p_trace->is_dirty = false;
+    for(lv_coord_t col = 0; col < p_scope->w; col++)
+    {
+        p_top[col]    = p_scope->h << sub;
+        p_bottom[col] = -1;
+    }
+    if(0 == p_trace->value_cnt)
+    {
+        return;
+    }
+
+    // Rows and columns are found with 16.16 fixed point steps, no division per sample, rows end up in sub rows
+    int32_t cnt   = (0 != p_scope->view_cnt) ? p_scope->view_cnt : p_trace->value_cnt;
+    int32_t range = LV_MAX(p_scope->max - p_scope->min, 1);
+    int32_t y_mul = ((int32_t)(p_scope->h - 1) << 16) / range;
+    int32_t x_mul = (cnt > 1) ? ((int32_t)(p_scope->w - 1) << 16) / (cnt - 1) : 0;
+
+    // Only samples in view are visited, plus one on each side so lines leave through the edges
+    int32_t first = (0 != p_scope->view_cnt) ? p_scope->view_first : 0;
+    int32_t start = LV_MAX(first - 1, 0);
+    int32_t end   = LV_MIN(first + cnt, p_trace->value_cnt - 1);
+
+    int32_t prev_x = 0;
+    int32_t prev_y = 0;
+    for(int32_t i = start; i <= end; i++)
+    {
+        int32_t value = LV_CLAMP(p_scope->min, p_trace->p_values[i], p_scope->max);
+        int32_t y     = ((p_scope->max - value) * y_mul + (0x8000 >> sub)) >> (16 - sub);
+        int32_t x     = ((i - first) * x_mul + 0x8000) >> 16;
+
+        // Columns between two samples get the rows the line between them crosses, meeting halfway between columns
+        int32_t dx = x - prev_x;
+        int32_t dy = y - prev_y;
+        for(int32_t k = LV_MAX(-1 - prev_x, 0); (i > start) && (k < dx) && (prev_x + k < p_scope->w); k++)
+        {
+            lv_coord_t mid = (lv_coord_t)(prev_y + dy * (2 * k + 1) / (2 * dx));
+
+            if(prev_x + k >= 0)
+            {
+                p_top[prev_x + k]    = LV_MIN(p_top[prev_x + k], mid);
+                p_bottom[prev_x + k] = LV_MAX(p_bottom[prev_x + k], mid);
+            }
+            if(prev_x + k + 1 < p_scope->w)
+            {
+                p_top[prev_x + k + 1]    = LV_MIN(p_top[prev_x + k + 1], mid);
+                p_bottom[prev_x + k + 1] = LV_MAX(p_bottom[prev_x + k + 1], mid);
+            }
+        }
+        if((x >= 0) && (x < p_scope->w))
+        {
+            p_top[x]    = LV_MIN(p_top[x], (lv_coord_t)y);
+            p_bottom[x] = LV_MAX(p_bottom[x], (lv_coord_t)y);
+        }
+
+        prev_x = x;
+        prev_y = y;
+    }
+
+    // Single sample is a level
+    if(1 == p_trace->value_cnt)
+    {
+        for(lv_coord_t col = 1; col < p_scope->w; col++)
+        {
+            p_top[col]    = p_top[0];
+            p_bottom[col] = p_bottom[0];
+        }
+    }
+}
+
+static void _update_columns(lv_scope_t *p_scope, uint32_t traces)
+{
+    uint32_t changed = 0;
+    for(uint8_t i = 0; i < p_scope->trace_cnt; i++)
+    {
+        lv_scope_trace_t *p_trace = &p_scope->traces[i];
+        if(0 == (traces & (1u << i)))
+        {
+            continue;
+        }
+
+        // Without columns to compare against, or with a whole redraw already pending, they are built on the next draw
+        if((NULL == p_trace->p_top) || p_trace->is_dirty)
+        {
+            p_trace->is_dirty = true;
+            lv_obj_invalidate((lv_obj_t *)p_scope);
+            continue;
+        }
+
+        lv_memcpy(p_trace->p_old_top, p_trace->p_top, 2 * p_scope->w * sizeof(lv_coord_t));
+        _build_columns(p_scope, p_trace);
+        if(!p_trace->is_hidden)
+        {
+            changed |= 1u << i;
+        }
+    }
+    if(0 != changed)
+    {
+        _invalidate_changes(p_scope, changed);
+    }
+}
+
+static void _invalidate_changes(lv_scope_t *p_scope, uint32_t traces)
+{
+    lv_obj_t  *p_obj  = (lv_obj_t *)p_scope;
+    lv_coord_t width  = LV_MAX(lv_obj_get_style_line_width(p_obj, LV_PART_ITEMS), 1);
+    lv_coord_t before = (width - 1) / 2;
+    lv_coord_t after  = width / 2;
+    lv_coord_t band_w = LV_MAX((p_scope->w + SCOPE_BAND_MAX - 1) / SCOPE_BAND_MAX, SCOPE_BAND_MIN);
+    uint8_t    sub    = _sub_bits(p_scope);
+
+    lv_area_t content;
+    lv_obj_get_content_coords(p_obj, &content);
+
+    for(lv_coord_t band = 0; band < p_scope->w; band += band_w)
+    {
+        lv_coord_t first  = -1;
+        lv_coord_t last   = -1;
+        lv_coord_t top    = p_scope->h << sub;
+        lv_coord_t bottom = -1;
+        for(uint8_t i = 0; i < p_scope->trace_cnt; i++)
+        {
+            const lv_scope_trace_t *p_trace = &p_scope->traces[i];
+            if(0 == (traces & (1u << i)))
+            {
+                continue;
+            }
+            for(lv_coord_t col = band; col < LV_MIN(band + band_w, p_scope->w); col++)
+            {
+                if((p_trace->p_top[col] == p_trace->p_old_top[col]) &&
+                   (p_trace->p_bottom[col] == p_trace->p_old_bottom[col]))
+                {
+                    continue;
+                }
+
+                // Empty column has top below bottom and adds nothing
+                first  = ((first < 0) || (col < first)) ? col : first;
+                last   = LV_MAX(last, col);
+                top    = LV_MIN(top, LV_MIN(p_trace->p_top[col], p_trace->p_old_top[col]));
+                bottom = LV_MAX(bottom, LV_MAX(p_trace->p_bottom[col], p_trace->p_old_bottom[col]));
+            }
+        }
+        if(top > bottom)
+        {
+            continue;
+        }
+
+        // Same reach around each column as drawing it has, antialiased ones reach into the row past their bottom
+        lv_area_t area = {
+            .x1 = content.x1 + first - before,
+            .y1 = content.y1 + (top >> sub) - before,
+            .x2 = content.x1 + last + after,
+            .y2 = content.y1 + ((bottom + (1 << sub) - 1) >> sub) + after,
+        };
+        lv_obj_invalidate_area(p_obj, &area);
+    }
+}
+
+static void _reset_geometry(lv_scope_t *p_scope)
+{
+    lv_mem_free(p_scope->p_rows);
+    lv_mem_free(p_scope->p_row_of);
+    p_scope->p_rows   = NULL;
+    p_scope->p_row_of = NULL;
+    p_scope->w        = 0;
+    p_scope->h        = 0;
+
+    for(uint8_t i = 0; i < p_scope->trace_cnt; i++)
+    {
+        lv_mem_free(p_scope->traces[i].p_top);
+        p_scope->traces[i].p_top        = NULL;
+        p_scope->traces[i].p_bottom     = NULL;
+        p_scope->traces[i].p_old_top    = NULL;
+        p_scope->traces[i].p_old_bottom = NULL;
+        p_scope->traces[i].is_dirty     = true;
+    }
+}
+
+//---------------------------- INTERRUPT HANDLERS -----------------------------
@@ -0,0 +1,213 @@
+/**
+ * @file lv_scope.h
+ *
+ * @brief See the source file.
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __LV_SCOPE_H__
+#define __LV_SCOPE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include "lvgl.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define LV_SCOPE_TRACE_MAX  (6)   // Traces one scope can show, drawn in the order they were added
+#define LV_SCOPE_CURSOR_OFF (-1)  // Position of a cursor that isn't shown
+#define LV_SCOPE_FRAC       (256) // Fixed point scale of positions between samples and of interpolated values
+
+//-------------------------------- DATA TYPES ---------------------------------
+
+typedef enum
+{
+    LV_SCOPE_CURSOR_X1, // Vertical cursors, positions are columns of the content area
+    LV_SCOPE_CURSOR_X2,
+    LV_SCOPE_CURSOR_Y1, // Horizontal cursors, positions are rows of the content area
+    LV_SCOPE_CURSOR_Y2,
+    LV_SCOPE_CURSOR_CNT
+} lv_scope_cursor_t;
+
+typedef struct _lv_scope_trace_t
+{
+    lv_color_t  color;
+    bool        is_hidden;
+    bool        is_dirty;     // Samples changed since columns were built
+    lv_coord_t *p_values;     // Copy of the samples, spread evenly across the width
+    uint16_t    value_cnt;
+    uint16_t    value_cap;    // Samples p_values has room for
+    lv_coord_t *p_top;        // Topmost row the trace covers in each column, relative to the content area, in
+                              // fractions of a row if the scope is antialiased
+    lv_coord_t *p_bottom;     // Bottommost row, below p_top if the trace doesn't reach the column
+    lv_coord_t *p_old_top;    // Columns before the last update, to invalidate only what it changed
+    lv_coord_t *p_old_bottom;
+} lv_scope_trace_t;
+
+typedef struct _lv_scope_t
+{
+    lv_obj_t         obj;
+    lv_scope_trace_t traces[LV_SCOPE_TRACE_MAX];
+    uint8_t          trace_cnt;
+    lv_coord_t       min;        // Value shown at the bottom row
+    lv_coord_t       max;        // Value shown at the top row
+    uint8_t          x_div;      // Divisions across the width
+    uint8_t          y_div;      // Divisions across the height
+    int32_t          view_first; // Sample shown at the left edge
+    uint16_t         view_cnt;   // Samples from the left to the right edge, 0 for all of them
+    lv_coord_t       cursors[LV_SCOPE_CURSOR_CNT]; // Drawn over the traces, LV_SCOPE_CURSOR_OFF if hidden
+
+    // Graticule and columns are built for this content size, 0 until first drawn
+    lv_coord_t  w;
+    lv_coord_t  h;
+    lv_color_t *p_rows;   // Pre-rendered graticule rows, one of each kind the graticule has
+    uint8_t    *p_row_of; // Index in p_rows of each row of the content area
+
+    // Colors the graticule was rendered with, line and axis already blended over the background
+    lv_color_t bg_color;
+    lv_color_t line_color;
+    lv_color_t axis_color;
+    bool       is_axes; // Centre axes and ticks are drawn
+
+    bool is_antialias; // Edges of traces are blended with what is under them
+} lv_scope_t;
+
+extern const lv_obj_class_t lv_scope_class;
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Creates oscilloscope widget. Background and division lines use bg_color and line_color of the main part,
+ * trace width is line_width of the items part. Centre axes with ticks are drawn in line_color of the ticks part if
+ * its line_width isn't 0, and cursors in line_color of the cursor part.
+ *
+ * @param p_parent Parent object
+ * @return lv_obj_t* Scope
+ */
+lv_obj_t *lv_scope_create(lv_obj_t *p_parent);
+
+/**
+ * @brief Adds trace
+ *
+ * @param p_obj Scope
+ * @param color Trace color
+ * @return lv_scope_trace_t* Trace, NULL if the scope already has LV_SCOPE_TRACE_MAX
+ */
+lv_scope_trace_t *lv_scope_add_trace(lv_obj_t *p_obj, lv_color_t color);
+
+/**
+ * @brief Sets samples of trace. They are copied and spread evenly from the left to the right edge, or over the view
+ * if one is set. Once the trace has been drawn, only the parts of it that moved are invalidated.
+ *
+ * @param p_obj Scope
+ * @param p_trace Trace
+ * @param p_values Samples
+ * @param cnt Number of samples
+ */
+void lv_scope_set_values(lv_obj_t *p_obj, lv_scope_trace_t *p_trace, const lv_coord_t *p_values, uint16_t cnt);
+
+/**
+ * @brief Sets part of the samples spread across the width, the same for every trace. Samples outside of it are kept
+ * and come back into view when it changes, so a stored record can be zoomed and panned.
+ *
+ * @param p_obj Scope
+ * @param first Sample at the left edge, may be negative or past the last sample
+ * @param cnt Samples from the left to the right edge, at least 2, 0 for all samples of each trace
+ */
+void lv_scope_set_view(lv_obj_t *p_obj, int32_t first, uint16_t cnt);
+
+/**
+ * @brief Hides or shows trace
+ *
+ * @param p_obj Scope
+ * @param p_trace Trace
+ * @param is_hidden True to hide
+ */
+void lv_scope_hide_trace(lv_obj_t *p_obj, lv_scope_trace_t *p_trace, bool is_hidden);
+
+/**
+ * @brief Turns antialiasing of traces on or off. Antialiased traces have edges blended by how much of each pixel the
+ * trace covers, so slow slopes don't show steps. They cost up to twice as much to draw, and fall back to plain ones
+ * on content areas over 511 rows high.
+ *
+ * @param p_obj Scope
+ * @param is_antialias True to antialias
+ */
+void lv_scope_set_antialias(lv_obj_t *p_obj, bool is_antialias);
+
+/**
+ * @brief Sets values shown at the bottom and the top row, samples outside of them stick to the edge
+ *
+ * @param p_obj Scope
+ * @param min Value at the bottom row
+ * @param max Value at the top row
+ */
+void lv_scope_set_range(lv_obj_t *p_obj, lv_coord_t min, lv_coord_t max);
+
+/**
+ * @brief Sets number of divisions of the graticule
+ *
+ * @param p_obj Scope
+ * @param x_div Divisions across the width
+ * @param y_div Divisions across the height
+ */
+void lv_scope_set_div_count(lv_obj_t *p_obj, uint8_t x_div, uint8_t y_div);
+
+/**
+ * @brief Moves cursor. Only the lines it leaves and goes to are invalidated, traces under them aren't rebuilt.
+ *
+ * @param p_obj Scope
+ * @param cursor Cursor
+ * @param pos Column of a vertical or row of a horizontal cursor, clamped to the content area, LV_SCOPE_CURSOR_OFF
+ * to hide it
+ */
+void lv_scope_set_cursor(lv_obj_t *p_obj, lv_scope_cursor_t cursor, lv_coord_t pos);
+
+/**
+ * @brief Returns position of cursor
+ *
+ * @param p_obj Scope
+ * @param cursor Cursor
+ * @return lv_coord_t Column or row, LV_SCOPE_CURSOR_OFF if hidden
+ */
+lv_coord_t lv_scope_get_cursor(const lv_obj_t *p_obj, lv_scope_cursor_t cursor);
+
+/**
+ * @brief Returns sample a column shows in the current view, between samples if the view has fewer samples than columns
+ *
+ * @param p_obj Scope
+ * @param col Column of the content area
+ * @return int32_t Sample times LV_SCOPE_FRAC, 0 with no view and no samples
+ */
+int32_t lv_scope_get_sample_at(lv_obj_t *p_obj, lv_coord_t col);
+
+/**
+ * @brief Returns value of trace at a position on its sample record, linearly interpolated between the two samples
+ * around it. Positions outside of the record get the first or the last sample.
+ *
+ * @param p_trace Trace
+ * @param pos Sample times LV_SCOPE_FRAC
+ * @return int32_t Value times LV_SCOPE_FRAC, 0 if the trace has no samples
+ */
+int32_t lv_scope_get_value_at(const lv_scope_trace_t *p_trace, int32_t pos);
+
+/**
+ * @brief Returns value a row shows, in the same units as the range
+ *
+ * @param p_obj Scope
+ * @param row Row of the content area
+ * @return int32_t Value times LV_SCOPE_FRAC
+ */
+int32_t lv_scope_get_level_at(lv_obj_t *p_obj, lv_coord_t row);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LV_SCOPE_H__
@@ -1,7 +1,7 @@
 /**
  * @file osc_chart.c
  *
- * @brief   Class to handle lvgl chart used as oscilloscope
+ * @brief   Class to handle scope widget used as oscilloscope
  *
  * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
  * All rights reserved.
@@ -14,6 +14,7 @@
 #include "../gui.h"
 #include "ui.h"
 #include "oscilloscope.h"
+#include "profiler.h"
 
 #include <stdbool.h>
 #include <stdio.h>
@@ -30,8 +31,8 @@
 #include "esp_err.h"
 
 //---------------------------------- MACROS -----------------------------------
-#define CHART_TASK_PERIOD_MS  (250)
-#define CHART_TASK_STACK_SIZE (1024 * 4)
+// Frames are shown at most once per display refresh, ones arriving faster replace each other
+#define CHART_UPDATE_PERIOD_MS (LV_DISP_DEF_REFR_PERIOD)
 
 #define CHART_SER_A_COLOR (0xff99ff)
 #define CHART_SER_B_COLOR (0x5bc6ca)
@@ -42,16 +43,158 @@
 #define CHART_DIV_1_MV (500)
 #define CHART_DIV_2_MV (100)
 
+#define CHART_ZOOM_MIN_SAMPLES (10) // Fewest samples a stopped capture can be zoomed in to
+#define CHART_ZOOM_DRAG_PX     (40) // Vertical drag that zooms in or out twice
+#define CHART_DRAG_LIMIT_PX    (8)  // Movement that makes a press a drag instead of a tap
+
+#define CHART_CURSOR_GRAB_PX (8) // Distance from a cursor a press picks it up from
+#define CHART_CURSOR_STEP_PX (4) // Cursor movement per joystick press
+
+#define CHART_REF_COLORS { 0xffffff, 0x60ff60, 0xff8040, 0x6090ff } // REF1 to REF4, before they are dimmed
+#define CHART_REF_OPA    (LV_OPA_50)                                 // Share of reference color mixed with background
+
 //-------------------------------- DATA TYPES ---------------------------------
 
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
 
 /**
- * @brief Gets latest value from oscilloscope and sets chart values
+ * @brief Sets traces to the latest frames of the oscilloscopes, if they have new ones. Runs in LVGL context.
+ *
+ * @param p_timer LVGL timer
+ */
+static void _chart_update_cb(lv_timer_t *p_timer);
+
+/**
+ * @brief Scales frames to the current divisions and sets them to traces
+ *
+ * @param is_new_1 True to set channel 1 frame
+ * @param is_new_2 True to set channel 2 frame
+ */
+static void _show_frames(bool is_new_1, bool is_new_2);
+
+/**
+ * @brief Shows the part of frames the time division asks for
+ *
+ */
+static void _reset_view(void);
+
+/**
+ * @brief Clamps view to the frame and sets it to the scope
+ *
+ * @param first Sample at the left edge
+ * @param cnt Samples across the width
+ */
+static void _set_view(int first, int cnt);
+
+/**
+ * @brief Zooms view keeping the sample at the given column in place
+ *
+ * @param cnt Samples across the width after zooming
+ * @param anchor_x Column relative to the content area
+ * @param first Sample at the left edge before zooming
+ * @param old_cnt Samples across the width before zooming
+ */
+static void _zoom_view(int cnt, lv_coord_t anchor_x, int first, int old_cnt);
+
+/**
+ * @brief Handles taps, drags and keys on the chart: run and stop, and zoom and pan of a stopped capture
+ *
+ * @param p_e Event
+ */
+static void _chart_event_cb(lv_event_t *p_e);
+
+/**
+ * @brief Cycles cursor button through cursors off and the four cursors, moves the selected one with joystick keys
+ *
+ * @param p_e Event
+ */
+static void _cursor_btn_event_cb(lv_event_t *p_e);
+
+/**
+ * @brief Selects cursor, shows cursors at their default places when they are turned on and hides them when off
+ *
+ * @param sel 0 for off, cursor + 1 otherwise
+ */
+static void _select_cursor(int sel);
+
+/**
+ * @brief Moves cursor to a column or row of the content area and refreshes the readout
+ *
+ * @param cursor Cursor
+ * @param pos Column or row
+ */
+static void _move_cursor(lv_scope_cursor_t cursor, lv_coord_t pos);
+
+/**
+ * @brief Returns cursor within CHART_CURSOR_GRAB_PX of a point, the closest one if there are several
+ *
+ * @param p_point Point on the screen
+ * @return int Cursor, -1 if none
+ */
+static int _find_cursor(const lv_point_t *p_point);
+
+/**
+ * @brief Writes time and voltage between the cursors to the readout, interpolated between samples of the shown frames
+ *
+ */
+static void _update_readout(void);
+
+/**
+ * @brief Cycles reference button through the slots, stores and clears the selected one
+ *
+ * @param p_e Event
+ */
+static void _ref_btn_event_cb(lv_event_t *p_e);
+
+/**
+ * @brief Shows reference button on the selected slot, checked if the slot holds a reference
+ *
+ */
+static void _update_ref_btn(void);
+
+/**
+ * @brief Scales reference to the current divisions and sets it to its trace, or hides the trace of an empty slot
+ *
+ * @param slot Reference slot
+ */
+static void _show_ref(int slot);
+
+/**
+ * @brief Scales references again if the voltage division changed since they were set
+ *
+ */
+static void _rescale_refs(void);
+
+/**
+ * @brief Converts chart value of the current divisions back to mV
+ *
+ * @param value Chart value times LV_SCOPE_FRAC
+ * @return int mV
+ */
+static int _to_mV(int32_t value);
+
+/**
+ * @brief Wakes the GUI to pick up the frame that was just completed
+ *
+ * @param p_osc Oscilloscope
+ * @param p_arg Unused
+ */
+static void _frame_ready_cb(oscilloscope_t *p_osc, void *p_arg);
+
+/**
+ * @brief Frees what osc_chart_init() allocated and clears the pointers, so their NULL checks hold again
+ *
+ */
+static void _free_buffers(void);
+
+/**
+ * @brief Scales frame to chart values of the current divisions
  *
- * @param p_param
+ * @param p_data Frame in mV
+ * @param p_points Chart values
+ * @param count Number of values
  */
-static void _chart_update_task(void *p_param);
+static void _to_points(const int *p_data, lv_coord_t *p_points, int count);
 
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 
@@ -65,74 +208,131 @@ static osc_chart_t _chart;
 esp_err_t osc_chart_init(lv_obj_t *chart, oscilloscope_t *p_osc1, oscilloscope_t *p_osc2)
 {
 
+    static const uint32_t ref_colors[SETTINGS_REF_COUNT] = CHART_REF_COLORS;
+
     _chart.chart       = chart;
     _chart.p_chan_1    = p_osc1;
     _chart.p_chan_2    = p_osc2;
-    _chart.p_ser1      = lv_chart_add_series(_chart.chart, lv_color_hex(CHART_SER_A_COLOR), LV_CHART_AXIS_PRIMARY_Y);
-    _chart.p_ser2      = lv_chart_add_series(_chart.chart, lv_color_hex(CHART_SER_B_COLOR), LV_CHART_AXIS_PRIMARY_Y);
     _chart.div_ms      = CHART_DIV_1_MS;
     _chart.div_mV      = CHART_DIV_1_MV;
     _chart.data_length = OSCILLOSCOPE_SAMPLE_NUMBER;
 
-    _chart.data_1 = (int *)malloc(_chart.data_length * sizeof(int));
+    _chart.is_ch1_shown = true;
+    _chart.is_ch2_shown = true;
+
+    // Buffers and timer come first, scope has no way to remove traces if one of them fails
+    _chart.data_1 = (int *)calloc(_chart.data_length, sizeof(int));
     if(_chart.data_1 == NULL)
     {
         ESP_LOGE(TAG, "Failed to allocate memory for data_1");
+        _free_buffers();
         return ESP_FAIL;
     }
-    _chart.data_2 = (int *)malloc(_chart.data_length * sizeof(int));
+    _chart.data_2 = (int *)calloc(_chart.data_length, sizeof(int));
     if(_chart.data_2 == NULL)
     {
         ESP_LOGE(TAG, "Failed to allocate memory for data_2");
-        free(_chart.data_1); // Clean up previously allocated memory
+        _free_buffers();
         return ESP_FAIL;
     }
-
-    // Set lvgl chart to our point number
-    lv_chart_set_point_count(_chart.chart, _chart.data_length);
-
-    // Initialize series to 0
-    for(int i = 0; i < _chart.data_length; i++)
+    _chart.points_1 = (lv_coord_t *)malloc(3 * _chart.data_length * sizeof(lv_coord_t));
+    if(_chart.points_1 == NULL)
     {
-        lv_chart_set_next_value(_chart.chart, _chart.p_ser1, 0);
-        lv_chart_set_next_value(_chart.chart, _chart.p_ser2, 0);
+        ESP_LOGE(TAG, "Failed to allocate memory for chart points");
+        _free_buffers();
+        return ESP_FAIL;
     }
+    _chart.points_2   = _chart.points_1 + _chart.data_length;
+    _chart.ref_points = _chart.points_2 + _chart.data_length;
 
-    /* Create task that refreshes chart data absed on oscilloscope readings */
-    static TaskHandle_t task__hndl = NULL;
-    BaseType_t          task_ret_val;
-
-    task_ret_val = xTaskCreatePinnedToCore(_chart_update_task, "Chart update task", CHART_TASK_STACK_SIZE, NULL, 0, &task__hndl, 1);
+    // Packed reference takes about half of what the frame it was stored from does
+    _chart.p_refs   = (settings_ref_blob_t *)calloc(SETTINGS_REF_COUNT, sizeof(settings_ref_blob_t));
+    _chart.ref_data = (int *)calloc(_chart.data_length, sizeof(int));
+    if((NULL == _chart.p_refs) || (NULL == _chart.ref_data))
+    {
+        ESP_LOGE(TAG, "Failed to allocate memory for references");
+        _free_buffers();
+        return ESP_FAIL;
+    }
+    _chart.ref_div_mV = _chart.div_mV;
 
-    if((NULL == task__hndl) || (task_ret_val != pdPASS))
+    // Traces are updated from the LVGL handler when frames arrive, so LVGL is never called from another task
+    _chart.p_timer = lv_timer_create(_chart_update_cb, CHART_UPDATE_PERIOD_MS, NULL);
+    if(NULL == _chart.p_timer)
     {
-        ESP_LOGE(TAG, "Chart update task not created");
+        ESP_LOGE(TAG, "Chart update timer not created");
+        _free_buffers();
         return ESP_FAIL;
     }
+
+    // References are added first, traces are drawn in the order they were added
+    lv_color_t bg = lv_obj_get_style_bg_color(chart, LV_PART_MAIN);
+    for(int slot = 0; slot < SETTINGS_REF_COUNT; slot++)
+    {
+        _chart.p_ref_traces[slot] = lv_scope_add_trace(chart, lv_color_mix(lv_color_hex(ref_colors[slot]), bg,
+                                                                           CHART_REF_OPA));
+        lv_scope_hide_trace(chart, _chart.p_ref_traces[slot], true);
+    }
+    _chart.p_trace1 = lv_scope_add_trace(_chart.chart, lv_color_hex(CHART_SER_A_COLOR));
+    _chart.p_trace2 = lv_scope_add_trace(_chart.chart, lv_color_hex(CHART_SER_B_COLOR));
+    lv_scope_set_antialias(_chart.chart, true);
+
+    oscilloscope_set_frame_cb(_chart.p_chan_1, _frame_ready_cb, NULL);
+    oscilloscope_set_frame_cb(_chart.p_chan_2, _frame_ready_cb, NULL);
+
+    // Drags on the chart zoom and pan instead of scrolling the screen
+    _chart.p_stop_label = lv_label_create(_chart.chart);
+    lv_label_set_text(_chart.p_stop_label, "STOP");
+    lv_obj_set_style_text_color(_chart.p_stop_label, lv_color_hex(0xFF5050), LV_PART_MAIN);
+    lv_obj_align(_chart.p_stop_label, LV_ALIGN_TOP_RIGHT, -4, 2);
+    lv_obj_add_flag(_chart.p_stop_label, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(_chart.chart, LV_OBJ_FLAG_SCROLL_CHAIN);
+    lv_obj_add_event_cb(_chart.chart, _chart_event_cb, LV_EVENT_ALL, NULL);
+    _chart.cursor_drag = -1;
+    lv_obj_add_event_cb(ui_cursorBtn, _cursor_btn_event_cb, LV_EVENT_ALL, NULL);
+    lv_obj_add_event_cb(ui_refBtn, _ref_btn_event_cb, LV_EVENT_ALL, NULL);
+    _update_ref_btn();
+    _reset_view();
     return ESP_OK;
 }
 
 void osc_chart_ch1_show()
 {
-    lv_chart_hide_series(_chart.chart, _chart.p_ser1, false);
+    _chart.is_ch1_shown = true;
+    if(NULL != _chart.p_trace1)
+    {
+        lv_scope_hide_trace(_chart.chart, _chart.p_trace1, false);
+    }
     oscilloscope_start(_chart.p_chan_1);
 }
 
 void osc_chart_ch1_hide()
 {
-    lv_chart_hide_series(_chart.chart, _chart.p_ser1, true);
+    _chart.is_ch1_shown = false;
+    if(NULL != _chart.p_trace1)
+    {
+        lv_scope_hide_trace(_chart.chart, _chart.p_trace1, true);
+    }
     oscilloscope_stop(_chart.p_chan_1);
 }
 
 void osc_chart_ch2_show()
 {
-    lv_chart_hide_series(_chart.chart, _chart.p_ser2, false);
+    _chart.is_ch2_shown = true;
+    if(NULL != _chart.p_trace2)
+    {
+        lv_scope_hide_trace(_chart.chart, _chart.p_trace2, false);
+    }
     oscilloscope_start(_chart.p_chan_2);
 }
 
 void osc_chart_ch2_hide()
 {
-    lv_chart_hide_series(_chart.chart, _chart.p_ser2, true);
+    _chart.is_ch2_shown = false;
+    if(NULL != _chart.p_trace2)
+    {
+        lv_scope_hide_trace(_chart.chart, _chart.p_trace2, true);
+    }
     oscilloscope_stop(_chart.p_chan_2);
 }
 
@@ -140,6 +340,7 @@ void ui_set_div_10ms(void)
 {
 
     _chart.div_ms = 10;
+    _reset_view();
             ESP_LOGI(TAG, "Set divY to 10ms");
 
 }
@@ -147,6 +348,7 @@ void ui_set_div_10ms(void)
 void ui_set_div_1ms(void)
 {
     _chart.div_ms = 1;
+    _reset_view();
         ESP_LOGI(TAG, "Set divY to 1ms");
 
 }
@@ -154,72 +356,559 @@ void ui_set_div_1ms(void)
 void ui_set_div_500mV(void)
 {
     _chart.div_mV = 500;
+
+    // Stopped frames are shown again at the new scale, live ones get it with the next frame
+    if(_chart.is_stopped)
+    {
+        _show_frames(true, true);
+    }
+    _rescale_refs();
 }
 
 void ui_set_div_100mV(void)
 {
     _chart.div_mV = 100;
+    if(_chart.is_stopped)
+    {
+        _show_frames(true, true);
+    }
+    _rescale_refs();
     ESP_LOGI(TAG, "Set divY to 100mV");
 }
 
+void osc_chart_set_stopped(bool is_stopped)
+{
+    _chart.is_stopped = is_stopped;
+    if(NULL != _chart.p_stop_label)
+    {
+        is_stopped ? lv_obj_clear_flag(_chart.p_stop_label, LV_OBJ_FLAG_HIDDEN)
+                   : lv_obj_add_flag(_chart.p_stop_label, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    // Live frames always follow the divisions
+    if(!is_stopped)
+    {
+        _reset_view();
+    }
+    ESP_LOGI(TAG, "Capture %s", is_stopped ? "stopped" : "running");
+}
+
+void osc_chart_get_view(osc_chart_view_t *p_view)
+{
+    p_view->div_ms       = _chart.div_ms;
+    p_view->div_mV       = _chart.div_mV;
+    p_view->is_ch1_shown = _chart.is_ch1_shown;
+    p_view->is_ch2_shown = _chart.is_ch2_shown;
+}
+
+void osc_chart_set_view(const osc_chart_view_t *p_view)
+{
+    // Anything but the two divisions buttons offer falls back to the default one
+    _chart.div_ms = (CHART_DIV_2_MS == p_view->div_ms) ? CHART_DIV_2_MS : CHART_DIV_1_MS;
+    _chart.div_mV = (CHART_DIV_2_MV == p_view->div_mV) ? CHART_DIV_2_MV : CHART_DIV_1_MV;
+
+    _reset_view();
+    _rescale_refs();
+    p_view->is_ch1_shown ? osc_chart_ch1_show() : osc_chart_ch1_hide();
+    p_view->is_ch2_shown ? osc_chart_ch2_show() : osc_chart_ch2_hide();
+
+    // Toggle buttons are checked for the first division, same as their event handlers expect
+    _ui_state_modify(ui_ch1Btn, LV_STATE_CHECKED, _chart.is_ch1_shown ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+    _ui_state_modify(ui_ch1Btn1, LV_STATE_CHECKED, _chart.is_ch2_shown ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+    _ui_state_modify(ui_togglemsBtn, LV_STATE_CHECKED, (CHART_DIV_1_MS == _chart.div_ms) ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+    _ui_state_modify(ui_divms10, LV_STATE_CHECKED, (CHART_DIV_1_MS == _chart.div_ms) ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+    _ui_state_modify(ui_divms1, LV_STATE_CHECKED, (CHART_DIV_2_MS == _chart.div_ms) ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+    _ui_state_modify(ui_togglemVBtn, LV_STATE_CHECKED, (CHART_DIV_1_MV == _chart.div_mV) ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+    _ui_state_modify(ui_div500mV, LV_STATE_CHECKED, (CHART_DIV_1_MV == _chart.div_mV) ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+    _ui_state_modify(ui_divmV100, LV_STATE_CHECKED, (CHART_DIV_2_MV == _chart.div_mV) ? _UI_MODIFY_STATE_ADD : _UI_MODIFY_STATE_REMOVE);
+}
+
+esp_err_t osc_chart_ref_store(int slot)
+{
+    if((slot < 0) || (slot >= SETTINGS_REF_COUNT) || (NULL == _chart.p_refs))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(!_chart.is_ch1_shown && !_chart.is_ch2_shown)
+    {
+        ESP_LOGW(TAG, "No channel shown to store as REF%d", slot + 1);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Same channel the cursor readout follows
+    settings_ref_rec_t meta = {
+        .sample_period_us = OSCILLOSCOPE_TIMER_PERIOD_US,
+        .div_ms           = (uint16_t)_chart.div_ms,
+        .div_mV           = (uint16_t)_chart.div_mV,
+        .channel          = _chart.is_ch1_shown ? 0 : 1,
+    };
+    settings_ref_encode(_chart.is_ch1_shown ? _chart.data_1 : _chart.data_2, (uint16_t)_chart.data_length, &meta,
+                        &_chart.p_refs[slot]);
+    _show_ref(slot);
+    _update_ref_btn();
+    ESP_LOGI(TAG, "Stored CH%d as REF%d", meta.channel + 1, slot + 1);
+
+    if(NULL != _chart.ref_cb)
+    {
+        _chart.ref_cb(slot, &_chart.p_refs[slot]);
+    }
+    return ESP_OK;
+}
+
+void osc_chart_ref_clear(int slot)
+{
+    if((slot < 0) || (slot >= SETTINGS_REF_COUNT) || (NULL == _chart.p_refs))
+    {
+        return;
+    }
+
+    memset(&_chart.p_refs[slot], 0, sizeof(_chart.p_refs[slot]));
+    _show_ref(slot);
+    _update_ref_btn();
+    ESP_LOGI(TAG, "Cleared REF%d", slot + 1);
+
+    if(NULL != _chart.ref_cb)
+    {
+        _chart.ref_cb(slot, NULL);
+    }
+}
+
+void osc_chart_ref_set(int slot, const settings_ref_blob_t *p_ref)
+{
+    if((slot < 0) || (slot >= SETTINGS_REF_COUNT) || (NULL == _chart.p_refs))
+    {
+        return;
+    }
+
+    _chart.p_refs[slot] = *p_ref;
+    _show_ref(slot);
+    _update_ref_btn();
+}
+
+void osc_chart_set_ref_cb(osc_chart_ref_cb_t cb)
+{
+    _chart.ref_cb = cb;
+}
+
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
 
-static void _chart_update_task(void *p_param)
+static void _chart_update_cb(lv_timer_t *p_timer)
 {
-    (void)p_param;
-    ESP_LOGI(TAG, "Update chart task created!");
+    (void)p_timer;
 
-    // Wait for other initializations
-    vTaskDelay(pdMS_TO_TICKS(5000));
+    // Frames keep coming while stopped, they just aren't taken
+    if(_chart.is_stopped)
+    {
+        return;
+    }
 
-    for(;;)
+    // Each channel has at most one frame waiting, the latest, however long the GUI was busy
+    bool is_new_1 = oscilloscope_take_frame(_chart.p_chan_1, _chart.data_1);
+    bool is_new_2 = oscilloscope_take_frame(_chart.p_chan_2, _chart.data_2);
+    if(is_new_1 || is_new_2)
     {
-        // Receive new data from oscilloscope
-        oscilloscope_send_new_data(_chart.p_chan_1, _chart.data_1);
-        oscilloscope_send_new_data(_chart.p_chan_2, _chart.data_2);
+        PROFILER_BEGIN(PROFILER_PROBE_CHART_UPDATE);
+        _show_frames(is_new_1, is_new_2);
+        PROFILER_END(PROFILER_PROBE_CHART_UPDATE);
+    }
+}
 
-        // Shorted data buff is divX is smaller
-        if(CHART_DIV_2_MS == _chart.div_ms)
+static void _show_frames(bool is_new_1, bool is_new_2)
+{
+    // Whole frames are kept by the scope, the view picks what is shown of them
+    if(is_new_1)
+    {
+        _to_points(_chart.data_1, _chart.points_1, _chart.data_length);
+        lv_scope_set_values(_chart.chart, _chart.p_trace1, _chart.points_1, _chart.data_length);
+    }
+    if(is_new_2)
+    {
+        _to_points(_chart.data_2, _chart.points_2, _chart.data_length);
+        lv_scope_set_values(_chart.chart, _chart.p_trace2, _chart.points_2, _chart.data_length);
+    }
+    _update_readout();
+}
+
+static void _reset_view(void)
+{
+    // Shorter part of the frame is shown if divX is smaller
+    int cnt = _chart.data_length;
+    if(CHART_DIV_2_MS == _chart.div_ms)
+    {
+        cnt = _chart.data_length / (CHART_DIV_1_MS / CHART_DIV_2_MS);
+    }
+    _set_view(0, cnt);
+}
+
+static void _set_view(int first, int cnt)
+{
+    // Division buttons work before the chart is set up
+    if(NULL == _chart.chart)
+    {
+        return;
+    }
+
+    _chart.view_cnt   = LV_CLAMP(CHART_ZOOM_MIN_SAMPLES, cnt, _chart.data_length);
+    _chart.view_first = LV_CLAMP(0, first, _chart.data_length - _chart.view_cnt);
+    lv_scope_set_view(_chart.chart, _chart.view_first, (uint16_t)_chart.view_cnt);
+
+    // Same columns cover other samples now
+    _update_readout();
+}
+
+static void _zoom_view(int cnt, lv_coord_t anchor_x, int first, int old_cnt)
+{
+    // Samples sit at columns i * (width - 1) / (cnt - 1), the one under the anchor stays under it
+    int last_x = LV_MAX(lv_obj_get_content_width(_chart.chart) - 1, 1);
+    int anchor = first + anchor_x * (old_cnt - 1) / last_x;
+
+    cnt = LV_CLAMP(CHART_ZOOM_MIN_SAMPLES, cnt, _chart.data_length);
+    _set_view(anchor - anchor_x * (cnt - 1) / last_x, cnt);
+}
+
+static void _chart_event_cb(lv_event_t *p_e)
+{
+    lv_event_code_t code = lv_event_get_code(p_e);
+
+    if(LV_EVENT_PRESSED == code)
+    {
+        lv_indev_get_point(lv_indev_get_act(), &_chart.press_point);
+        _chart.is_dragged  = false;
+        _chart.press_first = _chart.view_first;
+        _chart.press_cnt   = _chart.view_cnt;
+
+        // Press next to a cursor drags it instead of the view, and doesn't count as a tap
+        _chart.cursor_drag = _find_cursor(&_chart.press_point);
+        if(_chart.cursor_drag >= 0)
         {
-            lv_chart_set_point_count(_chart.chart, _chart.data_length / (CHART_DIV_1_MS / CHART_DIV_2_MS));
+            _chart.is_dragged = true;
+            _select_cursor(_chart.cursor_drag + 1);
         }
-        else if(CHART_DIV_1_MS == _chart.div_ms)
+    }
+    else if((LV_EVENT_PRESSING == code) && (_chart.cursor_drag >= 0))
+    {
+        lv_point_t point;
+        lv_area_t  content;
+        lv_indev_get_point(lv_indev_get_act(), &point);
+        lv_obj_get_content_coords(_chart.chart, &content);
+        _move_cursor((lv_scope_cursor_t)_chart.cursor_drag, (_chart.cursor_drag <= LV_SCOPE_CURSOR_X2)
+                                                                ? point.x - content.x1
+                                                                : point.y - content.y1);
+    }
+    else if(LV_EVENT_PRESSING == code)
+    {
+        lv_point_t point;
+        lv_indev_get_point(lv_indev_get_act(), &point);
+        lv_coord_t dx = point.x - _chart.press_point.x;
+        lv_coord_t dy = point.y - _chart.press_point.y;
+
+        // Direction is picked once, when the press becomes a drag
+        if(!_chart.is_dragged)
         {
-            lv_chart_set_point_count(_chart.chart, _chart.data_length);
+            if((LV_ABS(dx) < CHART_DRAG_LIMIT_PX) && (LV_ABS(dy) < CHART_DRAG_LIMIT_PX))
+            {
+                return;
+            }
+            _chart.is_dragged   = true;
+            _chart.is_drag_zoom = LV_ABS(dy) > LV_ABS(dx);
+        }
+        if(!_chart.is_stopped)
+        {
+            return;
         }
 
-        for(int i = 0; i < _chart.data_length ; i++)
+        lv_area_t content;
+        lv_obj_get_content_coords(_chart.chart, &content);
+        if(_chart.is_drag_zoom)
+        {
+            // Up zooms in, down out, by a factor of two every CHART_ZOOM_DRAG_PX
+            int cnt = (dy < 0) ? _chart.press_cnt * CHART_ZOOM_DRAG_PX / (CHART_ZOOM_DRAG_PX - dy)
+                               : _chart.press_cnt * (CHART_ZOOM_DRAG_PX + dy) / CHART_ZOOM_DRAG_PX;
+            _zoom_view(cnt, _chart.press_point.x - content.x1, _chart.press_first, _chart.press_cnt);
+        }
+        else
+        {
+            // Samples follow the finger
+            int width = LV_MAX(lv_area_get_width(&content) - 1, 1);
+            _set_view(_chart.press_first - dx * (_chart.press_cnt - 1) / width, _chart.press_cnt);
+        }
+    }
+    else if(LV_EVENT_CLICKED == code)
+    {
+        // Drags end with a click too, only a tap or enter toggles
+        if(!_chart.is_dragged)
         {
-            // Add the new value to the chart series
-            int data_to_add_1 = _chart.data_1[i];
-            int data_to_add_2 = _chart.data_2[i];
+            osc_chart_set_stopped(!_chart.is_stopped);
+        }
+        _chart.is_dragged = false;
+    }
+    else if((LV_EVENT_KEY == code) && _chart.is_stopped)
+    {
+        // Joystick up and down zoom around the middle
+        uint32_t   key = lv_event_get_key(p_e);
+        lv_coord_t mid = lv_obj_get_content_width(_chart.chart) / 2;
+        if(LV_KEY_UP == key)
+        {
+            _zoom_view(_chart.view_cnt / 2, mid, _chart.view_first, _chart.view_cnt);
+        }
+        else if(LV_KEY_DOWN == key)
+        {
+            _zoom_view(_chart.view_cnt * 2, mid, _chart.view_first, _chart.view_cnt);
+        }
+    }
+}
 
-            // Scale accordingly if divY is smaller
-            if(CHART_DIV_2_MV == _chart.div_mV)
-            {
-                data_to_add_1 -= (VDD / 2);
-                data_to_add_1 *= (CHART_DIV_1_MV / CHART_DIV_2_MV);
-                data_to_add_1 += (VDD / 2);
+static void _cursor_btn_event_cb(lv_event_t *p_e)
+{
+    lv_event_code_t code = lv_event_get_code(p_e);
 
-                data_to_add_2 -= (VDD / 2);
-                data_to_add_2 *= (CHART_DIV_1_MV / CHART_DIV_2_MV);
-                data_to_add_2 += (VDD / 2);
-            }
+    if(LV_EVENT_CLICKED == code)
+    {
+        _select_cursor((_chart.cursor_sel + 1) % (LV_SCOPE_CURSOR_CNT + 1));
+    }
+    else if((LV_EVENT_KEY == code) && (0 != _chart.cursor_sel))
+    {
+        // Left and right move focus, so up moves vertical cursors right and horizontal ones up
+        lv_scope_cursor_t cursor = (lv_scope_cursor_t)(_chart.cursor_sel - 1);
+        uint32_t          key    = lv_event_get_key(p_e);
+        lv_coord_t        step   = 0;
+        if(LV_KEY_UP == key)
+        {
+            step = (cursor <= LV_SCOPE_CURSOR_X2) ? CHART_CURSOR_STEP_PX : -CHART_CURSOR_STEP_PX;
+        }
+        else if(LV_KEY_DOWN == key)
+        {
+            step = (cursor <= LV_SCOPE_CURSOR_X2) ? -CHART_CURSOR_STEP_PX : CHART_CURSOR_STEP_PX;
+        }
+        if(0 != step)
+        {
+            _move_cursor(cursor, lv_scope_get_cursor(_chart.chart, cursor) + step);
+        }
+    }
+}
 
-            // Skip if divX is
-            if(CHART_DIV_2_MS == _chart.div_ms)
-            {
-                if(i > _chart.data_length / (CHART_DIV_1_MS / CHART_DIV_2_MS)) continue;
-            }
-            lv_chart_set_next_value(_chart.chart, _chart.p_ser1, data_to_add_1);
-            lv_chart_set_next_value(_chart.chart, _chart.p_ser2, data_to_add_2);
+static void _select_cursor(int sel)
+{
+    static const char *p_names[LV_SCOPE_CURSOR_CNT + 1] = { "CUR", "X1", "X2", "Y1", "Y2" };
+
+    if(sel == _chart.cursor_sel)
+    {
+        return;
+    }
+
+    lv_coord_t w = lv_obj_get_content_width(_chart.chart);
+    lv_coord_t h = lv_obj_get_content_height(_chart.chart);
+    if(0 == _chart.cursor_sel)
+    {
+        // Turned on, vertical ones a quarter in from the sides and horizontal ones a third from the top and bottom
+        lv_scope_set_cursor(_chart.chart, LV_SCOPE_CURSOR_X1, w / 4);
+        lv_scope_set_cursor(_chart.chart, LV_SCOPE_CURSOR_X2, w * 3 / 4);
+        lv_scope_set_cursor(_chart.chart, LV_SCOPE_CURSOR_Y1, h / 3);
+        lv_scope_set_cursor(_chart.chart, LV_SCOPE_CURSOR_Y2, h * 2 / 3);
+        lv_obj_clear_flag(ui_cursorReadout, LV_OBJ_FLAG_HIDDEN);
+    }
+    else if(0 == sel)
+    {
+        for(int i = 0; i < LV_SCOPE_CURSOR_CNT; i++)
+        {
+            lv_scope_set_cursor(_chart.chart, (lv_scope_cursor_t)i, LV_SCOPE_CURSOR_OFF);
         }
+        lv_obj_add_flag(ui_cursorReadout, LV_OBJ_FLAG_HIDDEN);
+    }
 
-        // Refresh the chart to show the updated data
-        lv_chart_refresh(_chart.chart);
+    _chart.cursor_sel = sel;
+    lv_label_set_text_static(ui_cursorLabel, p_names[sel]);
+    _update_readout();
+}
 
-        // Delay to control the update rate (convert milliseconds to ticks)
-        vTaskDelay(pdMS_TO_TICKS(CHART_TASK_PERIOD_MS));
+static void _move_cursor(lv_scope_cursor_t cursor, lv_coord_t pos)
+{
+    lv_scope_set_cursor(_chart.chart, cursor, pos);
+    _update_readout();
+}
+
+static int _find_cursor(const lv_point_t *p_point)
+{
+    if(0 == _chart.cursor_sel)
+    {
+        return -1;
+    }
+
+    lv_area_t content;
+    lv_obj_get_content_coords(_chart.chart, &content);
+
+    int        found   = -1;
+    lv_coord_t closest = CHART_CURSOR_GRAB_PX + 1;
+    for(int i = 0; i < LV_SCOPE_CURSOR_CNT; i++)
+    {
+        lv_coord_t pos  = lv_scope_get_cursor(_chart.chart, (lv_scope_cursor_t)i);
+        lv_coord_t dist = (i <= LV_SCOPE_CURSOR_X2) ? p_point->x - content.x1 - pos : p_point->y - content.y1 - pos;
+        if(LV_ABS(dist) < closest)
+        {
+            closest = LV_ABS(dist);
+            found   = i;
+        }
+    }
+    return found;
+}
+
+static void _update_readout(void)
+{
+    if(0 == _chart.cursor_sel)
+    {
+        return;
+    }
+
+    // Sample positions come with a fraction of a sample, so the time between cursors is finer than one sample period
+    lv_obj_t *p_obj = _chart.chart;
+    int32_t   s1    = lv_scope_get_sample_at(p_obj, lv_scope_get_cursor(p_obj, LV_SCOPE_CURSOR_X1));
+    int32_t   s2    = lv_scope_get_sample_at(p_obj, lv_scope_get_cursor(p_obj, LV_SCOPE_CURSOR_X2));
+    int64_t   dt_ns = (int64_t)LV_ABS(s2 - s1) * OSCILLOSCOPE_TIMER_PERIOD_US * 1000 / LV_SCOPE_FRAC;
+    int32_t   freq  = (dt_ns > 0) ? (int32_t)(10000000000LL / dt_ns) : 0; // 0.1 Hz steps
+    int       y1_mV = _to_mV(lv_scope_get_level_at(p_obj, lv_scope_get_cursor(p_obj, LV_SCOPE_CURSOR_Y1)));
+    int       y2_mV = _to_mV(lv_scope_get_level_at(p_obj, lv_scope_get_cursor(p_obj, LV_SCOPE_CURSOR_Y2)));
+
+    char text[96];
+    int  len = snprintf(text, sizeof(text), "dt %d.%02d ms  1/dt %d.%d Hz\nY2-Y1 %d mV", (int)(dt_ns / 1000000),
+                        (int)(dt_ns / 10000 % 100), (int)(freq / 10), (int)(freq % 10), y2_mV - y1_mV);
+
+    // Trace voltage at the vertical cursors, of the first shown channel
+    const lv_scope_trace_t *p_trace = _chart.is_ch1_shown ? _chart.p_trace1 : _chart.p_trace2;
+    if((_chart.is_ch1_shown || _chart.is_ch2_shown) && (len > 0) && (len < (int)sizeof(text)))
+    {
+        int v1 = _to_mV(lv_scope_get_value_at(p_trace, s1));
+        int v2 = _to_mV(lv_scope_get_value_at(p_trace, s2));
+        snprintf(text + len, sizeof(text) - len, "\nCH%d %d / %d mV  dV %d mV", _chart.is_ch1_shown ? 1 : 2, v1, v2,
+                 v2 - v1);
+    }
+    lv_label_set_text(ui_cursorReadout, text);
+}
+
+static void _ref_btn_event_cb(lv_event_t *p_e)
+{
+    lv_event_code_t code      = lv_event_get_code(p_e);
+    bool            is_filled = (SETTINGS_REF_MAGIC == _chart.p_refs[_chart.ref_sel].header.magic);
+
+    // Clicks come after long presses as well, short ones only cycle the slots
+    if(LV_EVENT_SHORT_CLICKED == code)
+    {
+        _chart.ref_sel = (_chart.ref_sel + 1) % SETTINGS_REF_COUNT;
+        _update_ref_btn();
+    }
+    else if(LV_EVENT_LONG_PRESSED == code)
+    {
+        is_filled ? osc_chart_ref_clear(_chart.ref_sel) : (void)osc_chart_ref_store(_chart.ref_sel);
+    }
+    else if(LV_EVENT_KEY == code)
+    {
+        // Joystick up stores over whatever the slot holds, down clears it
+        uint32_t key = lv_event_get_key(p_e);
+        if(LV_KEY_UP == key)
+        {
+            (void)osc_chart_ref_store(_chart.ref_sel);
+        }
+        else if((LV_KEY_DOWN == key) && is_filled)
+        {
+            osc_chart_ref_clear(_chart.ref_sel);
+        }
+    }
+}
+
+static void _update_ref_btn(void)
+{
+    static const char *p_names[SETTINGS_REF_COUNT] = { "REF1", "REF2", "REF3", "REF4" };
+
+    lv_label_set_text_static(ui_refLabel, p_names[_chart.ref_sel]);
+    _ui_state_modify(ui_refBtn, LV_STATE_CHECKED,
+                     (SETTINGS_REF_MAGIC == _chart.p_refs[_chart.ref_sel].header.magic) ? _UI_MODIFY_STATE_ADD
+                                                                                        : _UI_MODIFY_STATE_REMOVE);
+}
+
+static void _show_ref(int slot)
+{
+    const settings_ref_blob_t *p_ref = &_chart.p_refs[slot];
+
+    if(SETTINGS_REF_MAGIC != p_ref->header.magic)
+    {
+        lv_scope_hide_trace(_chart.chart, _chart.p_ref_traces[slot], true);
+        return;
     }
+
+    // Samples past the frame length would fall outside every view
+    uint16_t cnt = settings_ref_decode(p_ref, _chart.ref_data, (uint16_t)_chart.data_length);
+    _to_points(_chart.ref_data, _chart.ref_points, cnt);
+    lv_scope_set_values(_chart.chart, _chart.p_ref_traces[slot], _chart.ref_points, cnt);
+    lv_scope_hide_trace(_chart.chart, _chart.p_ref_traces[slot], false);
 }
+
+static void _rescale_refs(void)
+{
+    // References don't change with frames, their cached columns are kept until the scale changes
+    if((NULL == _chart.p_refs) || (_chart.ref_div_mV == _chart.div_mV))
+    {
+        return;
+    }
+
+    _chart.ref_div_mV = _chart.div_mV;
+    for(int slot = 0; slot < SETTINGS_REF_COUNT; slot++)
+    {
+        if(SETTINGS_REF_MAGIC == _chart.p_refs[slot].header.magic)
+        {
+            _show_ref(slot);
+        }
+    }
+}
+
+static int _to_mV(int32_t value)
+{
+    // Inverse of _to_points, rounded to the nearest mV
+    int64_t scaled = (int64_t)value - (int64_t)(VDD / 2) * LV_SCOPE_FRAC;
+    if(CHART_DIV_2_MV == _chart.div_mV)
+    {
+        scaled /= CHART_DIV_1_MV / CHART_DIV_2_MV;
+    }
+    scaled += (int64_t)(VDD / 2) * LV_SCOPE_FRAC;
+    return (int)((scaled + ((scaled < 0) ? -LV_SCOPE_FRAC / 2 : LV_SCOPE_FRAC / 2)) / LV_SCOPE_FRAC);
+}
+
+static void _frame_ready_cb(oscilloscope_t *p_osc, void *p_arg)
+{
+    (void)p_osc;
+    (void)p_arg;
+
+    gui_wake();
+}
+
+static void _free_buffers(void)
+{
+    free(_chart.data_1);
+    free(_chart.data_2);
+    free(_chart.points_1);
+    free(_chart.p_refs);
+    free(_chart.ref_data);
+
+    _chart.data_1     = NULL;
+    _chart.data_2     = NULL;
+    _chart.points_1   = NULL;
+    _chart.points_2   = NULL;
+    _chart.ref_points = NULL;
+    _chart.p_refs     = NULL;
+    _chart.ref_data   = NULL;
+}
+
+static void _to_points(const int *p_data, lv_coord_t *p_points, int count)
+{
+    for(int i = 0; i < count; i++)
+    {
+        int value = p_data[i];
+
+        // Scale accordingly if divY is smaller
+        if(CHART_DIV_2_MV == _chart.div_mV)
+        {
+            value = (value - (VDD / 2)) * (CHART_DIV_1_MV / CHART_DIV_2_MV) + (VDD / 2);
+        }
+        p_points[i] = (lv_coord_t)value;
+    }
+}
+
 //---------------------------- INTERRUPT HANDLERS -----------------------------
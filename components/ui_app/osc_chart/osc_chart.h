@@ -18,23 +18,45 @@ extern "C" {
 
 #include "oscilloscope.h"
 #include "ui.h"
+#include "lv_scope.h"
+#include "settings_codec.h"
 //---------------------------------- MACROS -----------------------------------
 
 //-------------------------------- DATA TYPES ---------------------------------
+typedef struct
+{
+    int  div_ms;       // Time per division
+    int  div_mV;       // Voltage per division
+    bool is_ch1_shown; // True if channel A trace is shown
+    bool is_ch2_shown; // True if channel B trace is shown
+} osc_chart_view_t;
+
+/**
+ * @brief Called from LVGL context when a reference is stored or cleared
+ *
+ * @param slot Reference slot
+ * @param p_ref Stored reference, NULL if cleared
+ */
+typedef void (*osc_chart_ref_cb_t)(int slot, const settings_ref_blob_t *p_ref);
+
 typedef struct {
 
     // Two oscilloscopes serving as two channels
     oscilloscope_t *p_chan_1;
     oscilloscope_t *p_chan_2;
 
-    // Series for the two channels
-    lv_chart_series_t *p_ser1;
-    lv_chart_series_t *p_ser2;
+    // Traces for the two channels
+    lv_scope_trace_t *p_trace1;
+    lv_scope_trace_t *p_trace2;
 
     // Voltage and time divisions
     int div_mV;
     int div_ms;
 
+    // Trace visibility
+    bool is_ch1_shown;
+    bool is_ch2_shown;
+
     // Number of points shown on chart
     int  data_length;
 
@@ -42,11 +64,41 @@ typedef struct {
     int *data_1;
     int *data_2;
 
-    // lvgl chart object
-    lv_obj_t *chart;
-
+    // Frames scaled to chart values, each one published to its trace in one call
+    lv_coord_t *points_1;
+    lv_coord_t *points_2;
 
+    // Scope object
+    lv_obj_t *chart;
 
+    // LVGL timer that shows new frames
+    lv_timer_t *p_timer;
+
+    // Stopped capture keeps the frames it was stopped on, they can be zoomed and panned
+    bool      is_stopped;
+    int       view_first; // Sample at the left edge
+    int       view_cnt;   // Samples across the width
+    lv_obj_t *p_stop_label;
+
+    // Pointer drag on the chart, view is moved relative to where it was when pressed
+    bool       is_dragged;
+    bool       is_drag_zoom; // Vertical drag zooms, horizontal one pans
+    lv_point_t press_point;
+    int        press_first;
+    int        press_cnt;
+
+    // Cursor the button and joystick move, 0 with cursors off, LV_SCOPE_CURSOR_X1 + 1 and on for the others
+    int cursor_sel;
+    int cursor_drag; // Cursor following the pointer, -1 if none
+
+    // Reference memories, kept packed and drawn dimmed under the channels. Empty slots have no magic.
+    settings_ref_blob_t *p_refs;
+    lv_scope_trace_t   *p_ref_traces[SETTINGS_REF_COUNT];
+    int                 ref_sel;    // Slot the button stores to and clears
+    int                 ref_div_mV; // Voltage division references were last scaled to
+    int                *ref_data;   // Unpacked reference, scaled to ref_points before it is set to its trace
+    lv_coord_t         *ref_points;
+    osc_chart_ref_cb_t  ref_cb;
 } osc_chart_t;
 //---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
 
@@ -108,6 +160,59 @@ void ui_set_div_500mV(void);
  */
 void ui_set_div_100mV(void);
 
+/**
+ * @brief Stops showing new frames and lets the ones on screen be zoomed and panned, or goes back to live frames
+ * shown by the divisions. Tapping the chart or pressing enter on it does the same.
+ *
+ * @param is_stopped True to stop
+ */
+void osc_chart_set_stopped(bool is_stopped);
+
+/**
+ * @brief Returns divisions and trace visibility
+ *
+ * @param p_view Chart view
+ */
+void osc_chart_get_view(osc_chart_view_t *p_view);
+
+/**
+ * @brief Sets divisions and trace visibility, and updates oscilloscope screen buttons to match
+ *
+ * @param p_view Chart view
+ */
+void osc_chart_set_view(const osc_chart_view_t *p_view);
+
+/**
+ * @brief Stores frame of the first shown channel as a reference and shows it under the channels. A stopped capture
+ * stores the frame it was stopped on.
+ *
+ * @param slot Reference slot, 0 to SETTINGS_REF_COUNT - 1
+ * @return esp_err_t ESP_ERR_INVALID_STATE if no channel is shown
+ */
+esp_err_t osc_chart_ref_store(int slot);
+
+/**
+ * @brief Clears reference and hides it
+ *
+ * @param slot Reference slot, 0 to SETTINGS_REF_COUNT - 1
+ */
+void osc_chart_ref_clear(int slot);
+
+/**
+ * @brief Shows a reference restored from storage, without calling the reference callback
+ *
+ * @param slot Reference slot, 0 to SETTINGS_REF_COUNT - 1
+ * @param p_ref Checked reference
+ */
+void osc_chart_ref_set(int slot, const settings_ref_blob_t *p_ref);
+
+/**
+ * @brief Sets callback called whenever a reference is stored or cleared from the chart
+ *
+ * @param cb Callback, NULL for none
+ */
+void osc_chart_set_ref_cb(osc_chart_ref_cb_t cb);
+
 
 
 
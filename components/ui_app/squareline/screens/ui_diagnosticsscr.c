@@ -0,0 +1,135 @@
+// This file was generated by SquareLine Studio
+// SquareLine Studio version: SquareLine Studio 1.4.2
+// LVGL version: 8.3.6
+// Project name: mashina_sq_fn_gen_screen_almost_work
+
+#include "../ui.h"
+
+void ui_diagnosticsscr_screen_init(void)
+{
+    ui_diagnosticsscr = lv_obj_create(NULL);
+    lv_obj_clear_flag(ui_diagnosticsscr, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+    lv_obj_set_style_bg_color(ui_diagnosticsscr, lv_color_hex(0x202829), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_diagnosticsscr, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(ui_diagnosticsscr, lv_color_hex(0x31C294), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_opa(ui_diagnosticsscr, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(ui_diagnosticsscr, 5, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_backBtn3 = lv_btn_create(ui_diagnosticsscr);
+    lv_obj_set_width(ui_backBtn3, 31);
+    lv_obj_set_height(ui_backBtn3, 26);
+    lv_obj_set_x(ui_backBtn3, -132);
+    lv_obj_set_y(ui_backBtn3, -94);
+    lv_obj_set_align(ui_backBtn3, LV_ALIGN_CENTER);
+    lv_obj_set_style_bg_color(ui_backBtn3, lv_color_hex(0x31C294), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_backBtn3, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_outline_color(ui_backBtn3, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_opa(ui_backBtn3, 255, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_width(ui_backBtn3, 2, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_pad(ui_backBtn3, 3, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+
+    ui_Image15 = lv_img_create(ui_backBtn3);
+    lv_img_set_src(ui_Image15, &ui_img_653708034);
+    lv_obj_set_width(ui_Image15, LV_SIZE_CONTENT);   /// 50
+    lv_obj_set_height(ui_Image15, LV_SIZE_CONTENT);    /// 50
+    lv_obj_set_align(ui_Image15, LV_ALIGN_CENTER);
+    lv_obj_add_flag(ui_Image15, LV_OBJ_FLAG_ADV_HITTEST);     /// Flags
+    lv_obj_clear_flag(ui_Image15, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+    lv_img_set_zoom(ui_Image15, 100);
+
+    ui_Label12 = lv_label_create(ui_diagnosticsscr);
+    lv_obj_set_width(ui_Label12, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_Label12, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_Label12, -40);
+    lv_obj_set_y(ui_Label12, -94);
+    lv_obj_set_align(ui_Label12, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_Label12, "DIAGNOSTICS");
+    lv_obj_set_style_text_color(ui_Label12, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_Label12, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_diagPageBtn = lv_btn_create(ui_diagnosticsscr);
+    lv_obj_set_width(ui_diagPageBtn, 70);
+    lv_obj_set_height(ui_diagPageBtn, 22);
+    lv_obj_set_x(ui_diagPageBtn, 110);
+    lv_obj_set_y(ui_diagPageBtn, -94);
+    lv_obj_set_align(ui_diagPageBtn, LV_ALIGN_CENTER);
+    lv_obj_add_flag(ui_diagPageBtn, LV_OBJ_FLAG_CHECKABLE);     /// Flags
+    lv_obj_set_style_radius(ui_diagPageBtn, 40, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_diagPageBtn, lv_color_hex(0x4A6962), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_diagPageBtn, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_diagPageBtn, lv_color_hex(0x31C294), LV_PART_MAIN | LV_STATE_CHECKED);
+    lv_obj_set_style_bg_opa(ui_diagPageBtn, 255, LV_PART_MAIN | LV_STATE_CHECKED);
+    lv_obj_set_style_outline_color(ui_diagPageBtn, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_opa(ui_diagPageBtn, 255, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_width(ui_diagPageBtn, 2, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_pad(ui_diagPageBtn, 3, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+
+    ui_Label13 = lv_label_create(ui_diagPageBtn);
+    lv_obj_set_width(ui_Label13, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_Label13, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_align(ui_Label13, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_Label13, "TASKS");
+    lv_obj_set_style_text_font(ui_Label13, &lv_font_montserrat_10, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_cpuLabel = lv_label_create(ui_diagnosticsscr);
+    lv_obj_set_width(ui_cpuLabel, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_cpuLabel, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_cpuLabel, 0);
+    lv_obj_set_y(ui_cpuLabel, -70);
+    lv_obj_set_align(ui_cpuLabel, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_cpuLabel, "CPU0 --   CPU1 --");
+    lv_obj_set_style_text_color(ui_cpuLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_cpuLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_cpuLabel, &lv_font_montserrat_10, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_cpuChart = lv_chart_create(ui_diagnosticsscr);
+    lv_obj_set_width(ui_cpuChart, 296);
+    lv_obj_set_height(ui_cpuChart, 40);
+    lv_obj_set_x(ui_cpuChart, 0);
+    lv_obj_set_y(ui_cpuChart, -42);
+    lv_obj_set_align(ui_cpuChart, LV_ALIGN_CENTER);
+    lv_chart_set_type(ui_cpuChart, LV_CHART_TYPE_LINE);
+    lv_chart_set_point_count(ui_cpuChart, 30);
+    lv_chart_set_range(ui_cpuChart, LV_CHART_AXIS_PRIMARY_Y, 0, 1000);
+    lv_chart_set_div_line_count(ui_cpuChart, 3, 0);
+    lv_obj_set_style_pad_all(ui_cpuChart, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_cpuChart, lv_color_hex(0x202829), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_cpuChart, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(ui_cpuChart, lv_color_hex(0xB6B6B6), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_opa(ui_cpuChart, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_line_color(ui_cpuChart, lv_color_hex(0x606060), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_line_opa(ui_cpuChart, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    lv_obj_set_style_line_width(ui_cpuChart, 2, LV_PART_ITEMS | LV_STATE_DEFAULT);
+
+    lv_obj_set_style_size(ui_cpuChart, 0, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+
+    ui_diagTable = lv_table_create(ui_diagnosticsscr);
+    lv_obj_set_width(ui_diagTable, 296);
+    lv_obj_set_height(ui_diagTable, 132);
+    lv_obj_set_x(ui_diagTable, 0);
+    lv_obj_set_y(ui_diagTable, 50);
+    lv_obj_set_align(ui_diagTable, LV_ALIGN_CENTER);
+    lv_obj_clear_flag(ui_diagTable, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+    lv_obj_set_style_bg_color(ui_diagTable, lv_color_hex(0x202829), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_diagTable, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(ui_diagTable, lv_color_hex(0xB6B6B6), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_opa(ui_diagTable, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    lv_obj_set_style_text_color(ui_diagTable, lv_color_hex(0xFFFFFF), LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_diagTable, 255, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_diagTable, &lv_font_montserrat_10, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_diagTable, 0, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_color(ui_diagTable, lv_color_hex(0x606060), LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(ui_diagTable, 1, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_side(ui_diagTable, LV_BORDER_SIDE_BOTTOM, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_top(ui_diagTable, 2, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_bottom(ui_diagTable, 2, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_left(ui_diagTable, 4, LV_PART_ITEMS | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_right(ui_diagTable, 4, LV_PART_ITEMS | LV_STATE_DEFAULT);
+
+    lv_obj_add_event_cb(ui_backBtn3, ui_event_backBtn3, LV_EVENT_ALL, NULL);
+    lv_obj_add_event_cb(ui_diagPageBtn, ui_event_diagPageBtn, LV_EVENT_ALL, NULL);
+    lv_obj_add_event_cb(ui_diagnosticsscr, ui_event_diagnosticsscr, LV_EVENT_ALL, NULL);
+
+}
@@ -60,7 +60,7 @@ void ui_functiongenscr_screen_init(void)
     lv_img_set_zoom(ui_Image5, 100);
 
     ui_signalTypeDropdown = lv_dropdown_create(ui_functiongenscr);
-    lv_dropdown_set_options(ui_signalTypeDropdown, "Sine\nSquare\nTriangle\nSawtooth");
+    lv_dropdown_set_options(ui_signalTypeDropdown, "Sine\nSquare\nTriangle\nSawtooth\nWhite noise\nPink noise\nGaussian noise");
     lv_obj_set_width(ui_signalTypeDropdown, 108);
     lv_obj_set_height(ui_signalTypeDropdown, LV_SIZE_CONTENT);    /// 1
     lv_obj_set_x(ui_signalTypeDropdown, -90);
@@ -188,6 +188,55 @@ void ui_functiongenscr_screen_init(void)
     lv_obj_set_style_text_color(ui_mVLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_text_opa(ui_mVLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
 
+    ui_clipLabel = lv_label_create(ui_amplArc);
+    lv_obj_set_width(ui_clipLabel, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_clipLabel, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_clipLabel, -30);
+    lv_obj_set_y(ui_clipLabel, -19);
+    lv_obj_set_align(ui_clipLabel, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_clipLabel, "CLIP");
+    lv_obj_add_flag(ui_clipLabel, LV_OBJ_FLAG_HIDDEN);     /// Flags
+    lv_obj_set_style_text_color(ui_clipLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_clipLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_clipLabel, &lv_font_montserrat_10, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_radius(ui_clipLabel, 3, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_clipLabel, lv_color_hex(0xFF0000), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_clipLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_left(ui_clipLabel, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_right(ui_clipLabel, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_offsetSlider = lv_slider_create(ui_functiongenscr);
+    lv_slider_set_range(ui_offsetSlider, -3300, 3300);
+    lv_slider_set_mode(ui_offsetSlider, LV_SLIDER_MODE_SYMMETRICAL);
+    lv_obj_set_width(ui_offsetSlider, 120);
+    lv_obj_set_height(ui_offsetSlider, 8);
+    lv_obj_set_x(ui_offsetSlider, -55);
+    lv_obj_set_y(ui_offsetSlider, -5);
+    lv_obj_set_align(ui_offsetSlider, LV_ALIGN_CENTER);
+    lv_obj_set_style_bg_color(ui_offsetSlider, lv_color_hex(0x4A6962), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_offsetSlider, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_outline_color(ui_offsetSlider, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_opa(ui_offsetSlider, 255, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_width(ui_offsetSlider, 2, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_pad(ui_offsetSlider, 3, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+
+    lv_obj_set_style_bg_color(ui_offsetSlider, lv_color_hex(0x31C294), LV_PART_INDICATOR | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_offsetSlider, 255, LV_PART_INDICATOR | LV_STATE_DEFAULT);
+
+    lv_obj_set_style_bg_color(ui_offsetSlider, lv_color_hex(0x31C294), LV_PART_KNOB | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_offsetSlider, 255, LV_PART_KNOB | LV_STATE_DEFAULT);
+
+    ui_offsetLabel = lv_label_create(ui_functiongenscr);
+    lv_obj_set_width(ui_offsetLabel, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_offsetLabel, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_offsetLabel, 178);
+    lv_obj_set_y(ui_offsetLabel, -5);
+    lv_obj_set_align(ui_offsetLabel, LV_ALIGN_LEFT_MID);
+    lv_label_set_text(ui_offsetLabel, "0 mV");
+    lv_obj_set_style_text_color(ui_offsetLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_offsetLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_offsetLabel, &lv_font_montserrat_10, LV_PART_MAIN | LV_STATE_DEFAULT);
+
     ui_startButton = lv_btn_create(ui_functiongenscr);
     lv_obj_set_width(ui_startButton, 55);
     lv_obj_set_height(ui_startButton, 55);
@@ -405,6 +454,7 @@ void ui_functiongenscr_screen_init(void)
     lv_obj_add_event_cb(ui_signalTypeDropdown, ui_event_signalTypeDropdown, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_freqarc1, ui_event_freqarc1, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_amplArc, ui_event_amplArc, LV_EVENT_ALL, NULL);
+    lv_obj_add_event_cb(ui_offsetSlider, ui_event_offsetSlider, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_startButton, ui_event_startButton, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_dutyCycleDropdown, ui_event_dutyCycleDropdown, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_savePresetBtn, ui_event_savePresetBtn, LV_EVENT_ALL, NULL);
@@ -189,7 +189,32 @@ void ui_homescr_screen_init(void)
     lv_obj_clear_flag(ui_Image17, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
     lv_img_set_zoom(ui_Image17, 135);
 
+    ui_diagBtn = lv_btn_create(ui_homescr);
+    lv_obj_set_width(ui_diagBtn, 35);
+    lv_obj_set_height(ui_diagBtn, 35);
+    lv_obj_set_x(ui_diagBtn, 12);
+    lv_obj_set_y(ui_diagBtn, -87);
+    lv_obj_set_align(ui_diagBtn, LV_ALIGN_CENTER);
+    lv_obj_set_style_radius(ui_diagBtn, 30, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_diagBtn, lv_color_hex(0x4A6962), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_diagBtn, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_diagBtn, lv_color_hex(0x31C294), LV_PART_MAIN | LV_STATE_PRESSED);
+    lv_obj_set_style_bg_opa(ui_diagBtn, 255, LV_PART_MAIN | LV_STATE_PRESSED);
+    lv_obj_set_style_outline_color(ui_diagBtn, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_opa(ui_diagBtn, 255, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_width(ui_diagBtn, 2, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_pad(ui_diagBtn, 3, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+
+    ui_Label11 = lv_label_create(ui_diagBtn);
+    lv_obj_set_width(ui_Label11, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_Label11, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_align(ui_Label11, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_Label11, LV_SYMBOL_SETTINGS);
+    lv_obj_set_style_text_color(ui_Label11, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_Label11, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+
     lv_obj_add_event_cb(ui_fngen1, ui_event_fngen1, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_oscbutton1, ui_event_oscbutton1, LV_EVENT_ALL, NULL);
+    lv_obj_add_event_cb(ui_diagBtn, ui_event_diagBtn, LV_EVENT_ALL, NULL);
 
 }
@@ -4,6 +4,7 @@
 // Project name: mashina_sq_fn_gen_screen_almost_work
 
 #include "../ui.h"
+#include "lv_scope.h"
 
 void ui_oscilloscopescr_screen_init(void)
 {
@@ -318,36 +319,98 @@ void ui_oscilloscopescr_screen_init(void)
     lv_obj_set_style_outline_width(ui_togglemVBtn, 2, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
     lv_obj_set_style_outline_pad(ui_togglemVBtn, 3, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
 
-    ui_Chart2 = lv_chart_create(ui_oscilloscopescr);
+    ui_Chart2 = lv_scope_create(ui_oscilloscopescr);
     lv_obj_set_width(ui_Chart2, 296);
     lv_obj_set_height(ui_Chart2, 176);
     lv_obj_set_x(ui_Chart2, 0);
     lv_obj_set_y(ui_Chart2, 21);
     lv_obj_set_align(ui_Chart2, LV_ALIGN_CENTER);
-    lv_chart_set_type(ui_Chart2, LV_CHART_TYPE_LINE);
-    lv_chart_set_point_count(ui_Chart2, 200);
-    lv_chart_set_range(ui_Chart2, LV_CHART_AXIS_PRIMARY_Y, 0, 3500);
-    lv_chart_set_div_line_count(ui_Chart2, 8, 6);
-    lv_chart_set_axis_tick(ui_Chart2, LV_CHART_AXIS_PRIMARY_X, 0, 0, 12, 3, false, 50);
-    lv_chart_set_axis_tick(ui_Chart2, LV_CHART_AXIS_PRIMARY_Y, 0, 0, 8, 2, false, 50);
-    lv_chart_set_axis_tick(ui_Chart2, LV_CHART_AXIS_SECONDARY_Y, 0, 0, 0, 0, false, 25);
+    lv_scope_set_range(ui_Chart2, 0, 3500);
+    lv_scope_set_div_count(ui_Chart2, 5, 7);
     lv_obj_set_style_bg_color(ui_Chart2, lv_color_hex(0x202829), LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_bg_opa(ui_Chart2, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_border_color(ui_Chart2, lv_color_hex(0xB6B6B6), LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_border_opa(ui_Chart2, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_border_width(ui_Chart2, 1, LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_line_color(ui_Chart2, lv_color_hex(0x606060), LV_PART_MAIN | LV_STATE_DEFAULT);
     lv_obj_set_style_line_opa(ui_Chart2, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
 
-    lv_obj_set_style_line_color(ui_Chart2, lv_color_hex(0x31C294), LV_PART_ITEMS | LV_STATE_DEFAULT);
-    lv_obj_set_style_line_opa(ui_Chart2, 255, LV_PART_ITEMS | LV_STATE_DEFAULT);
     lv_obj_set_style_line_width(ui_Chart2, 2, LV_PART_ITEMS | LV_STATE_DEFAULT);
 
-    lv_obj_set_style_size(ui_Chart2, 0, LV_PART_INDICATOR | LV_STATE_DEFAULT);
-
     lv_obj_set_style_line_color(ui_Chart2, lv_color_hex(0xFFFFFF), LV_PART_TICKS | LV_STATE_DEFAULT);
-    lv_obj_set_style_line_opa(ui_Chart2, 255, LV_PART_TICKS | LV_STATE_DEFAULT);
+    lv_obj_set_style_line_opa(ui_Chart2, 160, LV_PART_TICKS | LV_STATE_DEFAULT);
     lv_obj_set_style_line_width(ui_Chart2, 1, LV_PART_TICKS | LV_STATE_DEFAULT);
-    lv_obj_set_style_line_rounded(ui_Chart2, false, LV_PART_TICKS | LV_STATE_DEFAULT);
+    lv_obj_set_style_outline_color(ui_Chart2, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_opa(ui_Chart2, 255, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_width(ui_Chart2, 2, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_pad(ui_Chart2, 1, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_line_color(ui_Chart2, lv_color_hex(0xFFD040), LV_PART_CURSOR | LV_STATE_DEFAULT);
+    lv_obj_set_style_line_opa(ui_Chart2, 255, LV_PART_CURSOR | LV_STATE_DEFAULT);
+
+    ui_cursorBtn = lv_btn_create(ui_Chart2);
+    lv_obj_set_width(ui_cursorBtn, 30);
+    lv_obj_set_height(ui_cursorBtn, 16);
+    lv_obj_set_x(ui_cursorBtn, 2);
+    lv_obj_set_y(ui_cursorBtn, 2);
+    lv_obj_set_align(ui_cursorBtn, LV_ALIGN_TOP_LEFT);
+    lv_obj_set_style_radius(ui_cursorBtn, 3, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_cursorBtn, lv_color_hex(0x31C294), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_cursorBtn, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_shadow_opa(ui_cursorBtn, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_outline_color(ui_cursorBtn, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_opa(ui_cursorBtn, 255, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_width(ui_cursorBtn, 2, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_pad(ui_cursorBtn, 1, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+
+    ui_cursorLabel = lv_label_create(ui_cursorBtn);
+    lv_obj_set_width(ui_cursorLabel, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_cursorLabel, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_align(ui_cursorLabel, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_cursorLabel, "CUR");
+    lv_obj_set_style_text_color(ui_cursorLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_cursorLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_cursorLabel, &lv_font_montserrat_10, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_refBtn = lv_btn_create(ui_Chart2);
+    lv_obj_set_width(ui_refBtn, 34);
+    lv_obj_set_height(ui_refBtn, 16);
+    lv_obj_set_x(ui_refBtn, 34);
+    lv_obj_set_y(ui_refBtn, 2);
+    lv_obj_set_align(ui_refBtn, LV_ALIGN_TOP_LEFT);
+    lv_obj_set_style_radius(ui_refBtn, 3, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_refBtn, lv_color_hex(0x4A5253), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_refBtn, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_shadow_opa(ui_refBtn, 0, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_refBtn, lv_color_hex(0x31C294), LV_PART_MAIN | LV_STATE_CHECKED);
+    lv_obj_set_style_bg_opa(ui_refBtn, 255, LV_PART_MAIN | LV_STATE_CHECKED);
+    lv_obj_set_style_outline_color(ui_refBtn, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_opa(ui_refBtn, 255, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_width(ui_refBtn, 2, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+    lv_obj_set_style_outline_pad(ui_refBtn, 1, LV_PART_MAIN | LV_STATE_FOCUS_KEY);
+
+    ui_refLabel = lv_label_create(ui_refBtn);
+    lv_obj_set_width(ui_refLabel, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_refLabel, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_align(ui_refLabel, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_refLabel, "REF1");
+    lv_obj_set_style_text_color(ui_refLabel, lv_color_hex(0xFFFFFF), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_refLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_refLabel, &lv_font_montserrat_10, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_cursorReadout = lv_label_create(ui_Chart2);
+    lv_obj_set_width(ui_cursorReadout, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_cursorReadout, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_cursorReadout, 2);
+    lv_obj_set_y(ui_cursorReadout, -2);
+    lv_obj_set_align(ui_cursorReadout, LV_ALIGN_BOTTOM_LEFT);
+    lv_label_set_text(ui_cursorReadout, "");
+    lv_obj_add_flag(ui_cursorReadout, LV_OBJ_FLAG_HIDDEN);     /// Flags
+    lv_obj_set_style_text_color(ui_cursorReadout, lv_color_hex(0xFFD040), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_opa(ui_cursorReadout, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_cursorReadout, &lv_font_montserrat_10, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_color(ui_cursorReadout, lv_color_hex(0x202829), LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_bg_opa(ui_cursorReadout, 200, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_pad_all(ui_cursorReadout, 2, LV_PART_MAIN | LV_STATE_DEFAULT);
 
     ui_fngenonflagLabel = lv_label_create(ui_Chart2);
     lv_obj_set_width(ui_fngenonflagLabel, LV_SIZE_CONTENT);   /// 1
@@ -28,11 +28,22 @@ lv_obj_t * ui_Image12;
 lv_obj_t * ui_deviceTooHotLabel1;
 lv_obj_t * ui_wifiBtn;
 lv_obj_t * ui_Image17;
+void ui_event_diagBtn(lv_event_t * e);
+lv_obj_t * ui_diagBtn;
+lv_obj_t * ui_Label11;
 
 
 // SCREEN: ui_oscilloscopescr
 void ui_oscilloscopescr_screen_init(void);
 lv_obj_t * ui_oscilloscopescr;
+void ui_event_diagBtn(lv_event_t * e)
+{
+    lv_event_code_t event_code = lv_event_get_code(e);
+    lv_obj_t * target = lv_event_get_target(e);
+    if(event_code == LV_EVENT_CLICKED) {
+        _ui_screen_change(&ui_diagnosticsscr, LV_SCR_LOAD_ANIM_MOVE_LEFT, 500, 0, &ui_diagnosticsscr_screen_init);
+    }
+}
 void ui_event_backbtn(lv_event_t * e);
 lv_obj_t * ui_backbtn;
 lv_obj_t * ui_Image4;
@@ -63,6 +74,11 @@ lv_obj_t * ui_togglemsBtn;
 void ui_event_togglemVBtn(lv_event_t * e);
 lv_obj_t * ui_togglemVBtn;
 lv_obj_t * ui_Chart2;
+lv_obj_t * ui_cursorBtn;
+lv_obj_t * ui_cursorLabel;
+lv_obj_t * ui_refBtn;
+lv_obj_t * ui_refLabel;
+lv_obj_t * ui_cursorReadout;
 lv_obj_t * ui_fngenonflagLabel;
 lv_obj_t * ui_deviceTooHotLabel;
 
@@ -86,6 +102,10 @@ void ui_event_amplArc(lv_event_t * e);
 lv_obj_t * ui_amplArc;
 lv_obj_t * ui_amplLabel;
 lv_obj_t * ui_mVLabel;
+lv_obj_t * ui_clipLabel;
+void ui_event_offsetSlider(lv_event_t * e);
+lv_obj_t * ui_offsetSlider;
+lv_obj_t * ui_offsetLabel;
 void ui_event_startButton(lv_event_t * e);
 lv_obj_t * ui_startButton;
 lv_obj_t * ui_Image6;
@@ -104,6 +124,22 @@ void ui_event_presetDropdown(lv_event_t * e);
 lv_obj_t * ui_presetDropdown;
 lv_obj_t * ui_Image7;
 lv_obj_t * ui_Image3;
+
+
+// SCREEN: ui_diagnosticsscr
+void ui_diagnosticsscr_screen_init(void);
+void ui_event_diagnosticsscr(lv_event_t * e);
+lv_obj_t * ui_diagnosticsscr;
+void ui_event_backBtn3(lv_event_t * e);
+lv_obj_t * ui_backBtn3;
+lv_obj_t * ui_Image15;
+lv_obj_t * ui_Label12;
+void ui_event_diagPageBtn(lv_event_t * e);
+lv_obj_t * ui_diagPageBtn;
+lv_obj_t * ui_Label13;
+lv_obj_t * ui_cpuLabel;
+lv_obj_t * ui_cpuChart;
+lv_obj_t * ui_diagTable;
 void ui_event____initial_actions0(lv_event_t * e);
 lv_obj_t * ui____initial_actions0;
 
@@ -246,6 +282,23 @@ void ui_event_amplArc(lv_event_t * e)
         ui_ampl_arc_cb(e);
     }
 }
+void ui_event_offsetSlider(lv_event_t * e)
+{
+    lv_event_code_t event_code = lv_event_get_code(e);
+    lv_obj_t * target = lv_event_get_target(e);
+    if(event_code == LV_EVENT_VALUE_CHANGED) {
+        _ui_slider_set_text_value(ui_offsetLabel, target, "", " mV");
+    }
+    if(event_code == LV_EVENT_KEY &&  lv_event_get_key(e) == LV_KEY_UP) {
+        _ui_slider_increment(ui_offsetSlider, 50, LV_ANIM_OFF);
+    }
+    if(event_code == LV_EVENT_KEY &&  lv_event_get_key(e) == LV_KEY_DOWN) {
+        _ui_slider_increment(ui_offsetSlider, -50, LV_ANIM_OFF);
+    }
+    if(event_code == LV_EVENT_VALUE_CHANGED) {
+        ui_offset_slider_cb(e);
+    }
+}
 void ui_event_startButton(lv_event_t * e)
 {
     lv_event_code_t event_code = lv_event_get_code(e);
@@ -285,6 +338,39 @@ void ui_event_presetDropdown(lv_event_t * e)
         ui_load_preset(e);
     }
 }
+void ui_event_diagnosticsscr(lv_event_t * e)
+{
+    lv_event_code_t event_code = lv_event_get_code(e);
+    lv_obj_t * target = lv_event_get_target(e);
+    if(event_code == LV_EVENT_SCREEN_LOADED) {
+        ui_diag_show_cb(e);
+    }
+    if(event_code == LV_EVENT_SCREEN_UNLOAD_START) {
+        ui_diag_hide_cb(e);
+    }
+}
+void ui_event_backBtn3(lv_event_t * e)
+{
+    lv_event_code_t event_code = lv_event_get_code(e);
+    lv_obj_t * target = lv_event_get_target(e);
+    if(event_code == LV_EVENT_CLICKED) {
+        _ui_screen_change(&ui_homescr, LV_SCR_LOAD_ANIM_OVER_RIGHT, 500, 0, &ui_homescr_screen_init);
+    }
+}
+void ui_event_diagPageBtn(lv_event_t * e)
+{
+    lv_event_code_t event_code = lv_event_get_code(e);
+    lv_obj_t * target = lv_event_get_target(e);
+    if(event_code == LV_EVENT_VALUE_CHANGED &&  lv_obj_has_state(target, LV_STATE_CHECKED)) {
+        _ui_label_set_property(ui_Label13, _UI_LABEL_PROPERTY_TEXT, "PROBES");
+    }
+    if(event_code == LV_EVENT_VALUE_CHANGED &&  !lv_obj_has_state(target, LV_STATE_CHECKED)) {
+        _ui_label_set_property(ui_Label13, _UI_LABEL_PROPERTY_TEXT, "TASKS");
+    }
+    if(event_code == LV_EVENT_VALUE_CHANGED) {
+        ui_diag_page_cb(e);
+    }
+}
 void ui_event____initial_actions0(lv_event_t * e)
 {
     lv_event_code_t event_code = lv_event_get_code(e);
@@ -319,6 +405,7 @@ void ui_init(void)
     ui_homescr_screen_init();
     ui_oscilloscopescr_screen_init();
     ui_functiongenscr_screen_init();
+    ui_diagnosticsscr_screen_init();
     ui____initial_actions0 = lv_obj_create(NULL);
     lv_obj_add_event_cb(ui____initial_actions0, ui_event____initial_actions0, LV_EVENT_ALL, NULL);
 
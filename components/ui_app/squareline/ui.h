@@ -36,6 +36,9 @@ extern lv_obj_t * ui_Image12;
 extern lv_obj_t * ui_deviceTooHotLabel1;
 extern lv_obj_t * ui_wifiBtn;
 extern lv_obj_t * ui_Image17;
+void ui_event_diagBtn(lv_event_t * e);
+extern lv_obj_t * ui_diagBtn;
+extern lv_obj_t * ui_Label11;
 // SCREEN: ui_oscilloscopescr
 void ui_oscilloscopescr_screen_init(void);
 extern lv_obj_t * ui_oscilloscopescr;
@@ -69,6 +72,11 @@ extern lv_obj_t * ui_togglemsBtn;
 void ui_event_togglemVBtn(lv_event_t * e);
 extern lv_obj_t * ui_togglemVBtn;
 extern lv_obj_t * ui_Chart2;
+extern lv_obj_t * ui_cursorBtn;
+extern lv_obj_t * ui_cursorLabel;
+extern lv_obj_t * ui_refBtn;
+extern lv_obj_t * ui_refLabel;
+extern lv_obj_t * ui_cursorReadout;
 extern lv_obj_t * ui_fngenonflagLabel;
 extern lv_obj_t * ui_deviceTooHotLabel;
 // SCREEN: ui_functiongenscr
@@ -90,6 +98,10 @@ void ui_event_amplArc(lv_event_t * e);
 extern lv_obj_t * ui_amplArc;
 extern lv_obj_t * ui_amplLabel;
 extern lv_obj_t * ui_mVLabel;
+extern lv_obj_t * ui_clipLabel;
+void ui_event_offsetSlider(lv_event_t * e);
+extern lv_obj_t * ui_offsetSlider;
+extern lv_obj_t * ui_offsetLabel;
 void ui_event_startButton(lv_event_t * e);
 extern lv_obj_t * ui_startButton;
 extern lv_obj_t * ui_Image6;
@@ -108,6 +120,20 @@ void ui_event_presetDropdown(lv_event_t * e);
 extern lv_obj_t * ui_presetDropdown;
 extern lv_obj_t * ui_Image7;
 extern lv_obj_t * ui_Image3;
+// SCREEN: ui_diagnosticsscr
+void ui_diagnosticsscr_screen_init(void);
+void ui_event_diagnosticsscr(lv_event_t * e);
+extern lv_obj_t * ui_diagnosticsscr;
+void ui_event_backBtn3(lv_event_t * e);
+extern lv_obj_t * ui_backBtn3;
+extern lv_obj_t * ui_Image15;
+extern lv_obj_t * ui_Label12;
+void ui_event_diagPageBtn(lv_event_t * e);
+extern lv_obj_t * ui_diagPageBtn;
+extern lv_obj_t * ui_Label13;
+extern lv_obj_t * ui_cpuLabel;
+extern lv_obj_t * ui_cpuChart;
+extern lv_obj_t * ui_diagTable;
 void ui_event____initial_actions0(lv_event_t * e);
 extern lv_obj_t * ui____initial_actions0;
 
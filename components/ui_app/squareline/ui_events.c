@@ -6,12 +6,16 @@
 #include "ui.h"
 #include "../ui_app.h"
 #include "../osc_chart/osc_chart.h"
+#include "../diag_view/diag_view.h"
 #include "fn_gen.h"
 #include "led.h"
 #include "esp_log.h"
 
 #define DUTY_CYCLE_INCREMENT (5)
 
+static void _show_config(const fn_signal_config_t *p_conf);
+static void _show_clip(void);
+
 void ui_signal_type_dropdown_cb(lv_event_t *p_e)
 {
     lv_obj_t *dropdown = lv_event_get_current_target(p_e);
@@ -40,6 +44,15 @@ void ui_ampl_arc_cb(lv_event_t *p_e)
     int value = lv_arc_get_value(arc);
 
     fn_gen_set_amplitude(value);
+    _show_clip();
+}
+
+void ui_offset_slider_cb(lv_event_t *p_e)
+{
+    lv_obj_t *slider = lv_event_get_target(p_e);
+
+    fn_gen_set_offset(lv_slider_get_value(slider));
+    _show_clip();
 }
 
 void ui_start_btn_checked_cb(lv_event_t *p_e)
@@ -74,50 +87,59 @@ void ui_duty_cycle_dropdown_cb(lv_event_t *p_e)
 void ch1_show(lv_event_t *e)
 {
     osc_chart_ch1_show();
+    ui_save_settings();
 }
 
 void ch1_hide(lv_event_t *e)
 {
     osc_chart_ch1_hide();
+    ui_save_settings();
 }
 
 void ch2_show(lv_event_t *e)
 {
     osc_chart_ch2_show();
+    ui_save_settings();
 }
 
 void ch2_hide(lv_event_t *e)
 {
     osc_chart_ch2_hide();
+    ui_save_settings();
 }
 
 void set_div_10ms(lv_event_t *e)
 {
 
     ui_set_div_10ms();
+    ui_save_settings();
 }
 
 void set_div_1ms(lv_event_t *e)
 {
 
     ui_set_div_1ms();
+    ui_save_settings();
 }
 
 void set_div_500mV(lv_event_t *e)
 {
 
     ui_set_div_500mV();
+    ui_save_settings();
 }
 
 void set_div_100mV(lv_event_t *e)
 {
     ui_set_div_100mV();
+    ui_save_settings();
 }
 
 void ui_save_preset(lv_event_t *e)
 {
 
     fn_signal_config_t config = { .amplitude_mV          = lv_arc_get_value(ui_amplArc),
+                                  .offset_mV             = lv_slider_get_value(ui_offsetSlider),
                                   .frequency_Hz          = lv_arc_get_value(ui_freqarc1),
                                   .signal                = lv_dropdown_get_selected(ui_signalTypeDropdown),
                                   .duty_cycle_percentage = lv_dropdown_get_selected(ui_dutyCycleDropdown) * 5 };
@@ -131,7 +153,12 @@ void ui_save_preset(lv_event_t *e)
 
 void ui_init_preset(lv_event_t * e)
 {
-	ui_load_preset(NULL);
+    // Show config restored at boot instead of loading a preset over it
+    fn_signal_config_t conf;
+    fn_gen_get_channel_config(FN_CHANNEL_1, &conf);
+
+    _show_config(&conf);
+    _show_clip();
 }
 
 void ui_load_preset(lv_event_t *p_e)
@@ -141,30 +168,64 @@ void ui_load_preset(lv_event_t *p_e)
     fn_signal_config_t conf;
     fn_gen_get_preset(&conf, preset_num);
 
-    lv_dropdown_set_selected(ui_signalTypeDropdown, conf.signal);
-    lv_dropdown_set_selected(ui_dutyCycleDropdown, conf.duty_cycle_percentage / 5);
-    lv_arc_set_value(ui_freqarc1, conf.frequency_Hz);
-    lv_arc_set_value(ui_amplArc, conf.amplitude_mV);
-
-    char labelF[10];
-    char labelA[10];
-
-    sprintf(labelF, "%d", conf.frequency_Hz);
-    lv_label_set_text(ui_freqLabel1, labelF);
-
-    sprintf(labelA, "%d", conf.amplitude_mV);
-    lv_label_set_text(ui_amplLabel, labelA);
+    _show_config(&conf);
 
     fn_gen_load_preset(preset_num);
+    _show_clip();
 
     ESP_LOGI("EVENTS:",
-             "Loading preset:\n Frequency = %d\n Amplitude = %d\n Duty cycle = %d\n Signal type = %d\n amplabel = %s\n freqlabel = %s\n",
+             "Loading preset:\n Frequency = %d\n Amplitude = %d\n Offset = %d\n Duty cycle = %d\n Signal type = %d\n",
              conf.frequency_Hz,
              conf.amplitude_mV,
+             conf.offset_mV,
              conf.duty_cycle_percentage,
-             conf.signal,
-             labelA,
-             labelF);
+             conf.signal);
 }
 
+void ui_diag_show_cb(lv_event_t *p_e)
+{
+    diag_view_start();
+}
 
+void ui_diag_hide_cb(lv_event_t *p_e)
+{
+    diag_view_stop();
+}
+
+void ui_diag_page_cb(lv_event_t *p_e)
+{
+    diag_view_show_tasks(lv_obj_has_state(lv_event_get_target(p_e), LV_STATE_CHECKED));
+}
+
+static void _show_config(const fn_signal_config_t *p_conf)
+{
+    lv_dropdown_set_selected(ui_signalTypeDropdown, p_conf->signal);
+    lv_dropdown_set_selected(ui_dutyCycleDropdown, p_conf->duty_cycle_percentage / DUTY_CYCLE_INCREMENT);
+    lv_arc_set_value(ui_freqarc1, p_conf->frequency_Hz);
+    lv_arc_set_value(ui_amplArc, p_conf->amplitude_mV);
+    lv_slider_set_value(ui_offsetSlider, p_conf->offset_mV, LV_ANIM_OFF);
+
+    char labelF[10];
+    char labelA[10];
+
+    sprintf(labelF, "%d", p_conf->frequency_Hz);
+    lv_label_set_text(ui_freqLabel1, labelF);
+
+    sprintf(labelA, "%d", p_conf->amplitude_mV);
+    lv_label_set_text(ui_amplLabel, labelA);
+
+    lv_label_set_text_fmt(ui_offsetLabel, "%d mV", p_conf->offset_mV);
+}
+
+static void _show_clip(void)
+{
+    // Tells which rail the swing runs into, it's flattened there instead of output
+    uint8_t clip = fn_gen_get_clip(FN_CHANNEL_1);
+    if(0 == clip)
+    {
+        lv_obj_add_flag(ui_clipLabel, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    lv_label_set_text(ui_clipLabel, (FN_LEVEL_CLIP_LOW & clip) ? "CLIP 0V" : "CLIP VDD");
+    lv_obj_clear_flag(ui_clipLabel, LV_OBJ_FLAG_HIDDEN);
+}
@@ -22,11 +22,15 @@ void set_div_100mV(lv_event_t * e);
 void ui_signal_type_dropdown_cb(lv_event_t * e);
 void ui_freq_arc_cb(lv_event_t * e);
 void ui_ampl_arc_cb(lv_event_t * e);
+void ui_offset_slider_cb(lv_event_t * e);
 void ui_start_btn_checked_cb(lv_event_t * e);
 void ui_start_btn_unchecked_cb(lv_event_t * e);
 void ui_duty_cycle_dropdown_cb(lv_event_t * e);
 void ui_save_preset(lv_event_t * e);
 void ui_load_preset(lv_event_t * e);
+void ui_diag_show_cb(lv_event_t * e);
+void ui_diag_hide_cb(lv_event_t * e);
+void ui_diag_page_cb(lv_event_t * e);
 
 #ifdef __cplusplus
 } /*extern "C"*/
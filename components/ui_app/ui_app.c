@@ -10,9 +10,14 @@
 //--------------------------------- INCLUDES ----------------------------------
 #include "ui_app.h"
 #include "fn_gen.h"
+#include "fn_gen_console.h"
 #include "gui.h"
 #include "ui.h"
 #include "oscilloscope.h"
+#include "settings.h"
+#include "preset_lib.h"
+#include "sched.h"
+#include "profiler.h"
 
 #include <stdbool.h>
 #include <stdio.h>
@@ -26,6 +31,8 @@
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "esp_sleep.h"
+#include "esp_console.h"
+#include "sdkconfig.h"
 
 #include "button.h"
 #include "joystick.h"
@@ -47,6 +54,10 @@
 #define UI_ADC1_CHANNEL_B  (4)
 
 #define UI_TEMP_SHUTOWN_THRESH_C (32)
+
+#define UI_CAL_SAMPLES (16) // ADC readings averaged per DAC code during calibration
+
+#define UI_STRESS_DEFAULT_S (10) // Duration of sched_stress when none is given
 //-------------------------------- DATA TYPES ---------------------------------
 
 //---------------------- PRIVATE FUNCTION PROTOTYPES --------------------------
@@ -73,6 +84,114 @@ static void _temp_read_task(void *param);
  */
 void static _set_temp_hum_text(float temp, float hum);
 
+/**
+ * @brief Fills settings with presets and active channel configs from function generator
+ *
+ * @param p_settings Settings to fill
+ */
+static void _fn_gen_settings_get(settings_t *p_settings);
+
+/**
+ * @brief Queues settings to be stored whenever function generator config changes
+ *
+ */
+static void _fn_gen_change_cb(void);
+
+/**
+ * @brief Measures channel's output on the oscilloscope input it is looped back to
+ *
+ * @param channel Channel being calibrated, channel 1 is read on oscilloscope A and channel 2 on B
+ * @param p_arg Unused
+ * @return int Voltage in mV, negative on failure
+ */
+static int _cal_read_cb(fn_channel_t channel, void *p_arg);
+
+/**
+ * @brief Stores correction tables of both channels
+ *
+ */
+static void _cal_save(void);
+
+#if CONFIG_UI_APP_REF_PERSIST
+/**
+ * @brief Stores oscilloscope reference or erases it when it is cleared
+ *
+ * @param slot Reference slot
+ * @param p_ref Reference, NULL if cleared
+ */
+static void _ref_change_cb(int slot, const settings_ref_blob_t *p_ref);
+#endif
+
+/**
+ * @brief Handles fn_cal console command
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int 0 on success
+ */
+static int _cmd_cal(int argc, char **argv);
+
+/**
+ * @brief Handles sched console command
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int 0 on success
+ */
+static int _cmd_sched(int argc, char **argv);
+
+/**
+ * @brief Handles sched_stress console command
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int 0 on success
+ */
+static int _cmd_sched_stress(int argc, char **argv);
+
+/**
+ * @brief Handles preset console command, saves, loads, deletes and lists named presets of the library
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int 0 on success
+ */
+static int _cmd_preset(int argc, char **argv);
+
+/**
+ * @brief Handles seq console command, runs named presets of the library as a sequence on channel 1
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int 0 on success
+ */
+static int _cmd_seq(int argc, char **argv);
+
+/**
+ * @brief Prints why preset library call failed
+ *
+ * @param err Error returned by the library
+ * @param p_name Name of the preset
+ */
+static void _preset_err_print(preset_lib_err_t err, const char *p_name);
+
+/**
+ * @brief UI load of the stress test, redraws the whole active screen under the GUI lock
+ *
+ */
+static void _stress_ui_load(void);
+
+#if CONFIG_PROFILER_ENABLE
+/**
+ * @brief Handles prof console command
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int 0 on success
+ */
+static int _cmd_prof(int argc, char **argv);
+#endif
+
 //------------------------- STATIC DATA & CONSTANTS ---------------------------
 static const char *TAG = "ui_app";
 //------------------------------- GLOBAL DATA ---------------------------------
@@ -82,6 +201,9 @@ oscilloscope_t *p_osc_other; // Channel 2
 //------------------------------ PUBLIC FUNCTIONS -----------------------------
 void app_start(void)
 {
+    // Interrupts stay on the core that allocates them, DDS and gate ones are allocated from here
+    sched_check_core(SCHED_CORE_IO, "Interrupts");
+
     // Joystick initialization
     if(JOYSTICK_ERR_NONE != joystick_create(JOYSTICK_1))
         return;
@@ -101,10 +223,100 @@ void app_start(void)
     // Initialize function generatotor unit
     fn_gen_init();
 
+    // Restore presets, active configs and chart view with a single read, defaults stay if nothing is stored
+    settings_t       settings;
+    osc_chart_view_t view = { .div_ms = 0, .div_mV = 0, .is_ch1_shown = true, .is_ch2_shown = true };
+
+    if(SETTINGS_ERR_NONE == settings_init(&settings))
+    {
+        for(int preset = 0; preset < FN_GEN_PRESET_NUMBER; preset++)
+        {
+            fn_gen_set_preset(settings.presets[preset], preset);
+        }
+        for(int channel = 0; channel < FN_CHANNEL_COUNT; channel++)
+        {
+            fn_gen_set_channel_config(channel, settings.active[channel]);
+        }
+        view.div_ms       = settings.osc.div_ms;
+        view.div_mV       = settings.osc.div_mV;
+        view.is_ch1_shown = settings.osc.is_ch1_shown;
+        view.is_ch2_shown = settings.osc.is_ch2_shown;
+    }
+
+    // DAC correction tables are kept apart from settings, they belong to the board
+    settings_cal_t cal;
+    if(SETTINGS_ERR_NONE == settings_cal_load(&cal))
+    {
+        for(int channel = 0; channel < FN_CHANNEL_COUNT; channel++)
+        {
+            if(cal.is_valid[channel])
+            {
+                fn_gen_set_calibration(channel, cal.lut[channel]);
+            }
+        }
+    }
+
+    // Named presets for sequences live in their own partition
+    preset_lib_init();
+
     // Create instances of oscilloscopes
     p_osc       = oscilloscope_create(UI_ADC1_CHAN_A_PIN, UI_ADC1_CHANNEL_A);
     p_osc_other = oscilloscope_create(UI_ADC1_CHAN_B_PIN, UI_ADC1_CHANNEL_B);
 
+    // Calibration and timing statistics are run over the console
+    fn_gen_console_start();
+    const esp_console_cmd_t cal_cmd = {
+        .command = "fn_cal",
+        .help    = "Calibrates DAC of a channel looped back to the oscilloscope, GPIO25 to GPIO33 for channel 1 or "
+                   "GPIO26 to GPIO32 for channel 2. clear goes back to uncorrected output.",
+        .hint    = "<1|2> [clear]",
+        .func    = _cmd_cal,
+    };
+    esp_console_cmd_register(&cal_cmd);
+    const esp_console_cmd_t sched_cmd = {
+        .command = "sched",
+        .help    = "Prints core, priority and free stack of every task and real-time waits on UI locks refused",
+        .hint    = NULL,
+        .func    = _cmd_sched,
+    };
+    esp_console_cmd_register(&sched_cmd);
+    const esp_console_cmd_t stress_cmd = {
+        .command = "sched_stress",
+        .help    = "Loads every core and reports worst-case wake-up latency of each scheduling class",
+        .hint    = "[seconds]",
+        .func    = _cmd_sched_stress,
+    };
+    esp_console_cmd_register(&stress_cmd);
+    const esp_console_cmd_t preset_cmd = {
+        .command = "preset",
+        .help    = "Lists named presets, or saves, loads or deletes one. Save and load use channel 1 unless told "
+                   "otherwise.",
+        .hint    = "[list] | save|load <name> [1|2] | delete <name>",
+        .func    = _cmd_preset,
+    };
+    esp_console_cmd_register(&preset_cmd);
+    const esp_console_cmd_t seq_cmd = {
+        .command = "seq",
+        .help    = "Runs named presets on channel 1, each for its dwell time in ms, loops times or forever with 0. "
+                   "stop ends the sequence, no argument tells if one runs.",
+        .hint    = "[<loops> <name>:<dwell_ms>... | stop]",
+        .func    = _cmd_seq,
+    };
+    esp_console_cmd_register(&seq_cmd);
+#if CONFIG_PROFILER_ENABLE
+    const esp_console_cmd_t prof_cmd = {
+        .command = "prof",
+        .help    = "Prints load per core, calls and time of profiled sections, and CPU share and free stack per task",
+        .hint    = NULL,
+        .func    = _cmd_prof,
+    };
+    esp_console_cmd_register(&prof_cmd);
+    profiler_init();
+#endif
+#if CONFIG_FN_GEN_TIMING_TRACE
+    fn_gen_timing_capture(true);
+#endif
+
     // Start reading data from oscilloscopes
     oscilloscope_start(p_osc);
     oscilloscope_start(p_osc_other);
@@ -122,32 +334,43 @@ void app_start(void)
         vTaskDelay(pdMS_TO_TICKS(500));
     }
 
+    gui_lock(GUI_LOCK_WAIT_FOREVER);
     if(ESP_OK != osc_chart_init(ui_Chart2, p_osc, p_osc_other)){
+        // Chart has no buffers to restore view and references into
         ESP_LOGE(TAG, "Chart not successfully initialized!");
     }
+    else
+    {
+        osc_chart_set_view(&view);
+#if CONFIG_UI_APP_REF_PERSIST
+        // References are shown the way they were stored, ones that don't check out stay empty
+        for(int slot = 0; slot < SETTINGS_REF_COUNT; slot++)
+        {
+            settings_ref_blob_t ref;
+            if(SETTINGS_ERR_NONE == settings_ref_load(slot, &ref))
+            {
+                osc_chart_ref_set(slot, &ref);
+            }
+        }
+        osc_chart_set_ref_cb(_ref_change_cb);
+#endif
+    }
+    gui_unlock();
 
-    ESP_LOGI(TAG, "System initialized!");
+    // Everything is restored, from now on changes are stored
+    fn_gen_set_change_cb(_fn_gen_change_cb);
 
-    BaseType_t task_ret_val;
+    ESP_LOGI(TAG, "System initialized!");
 
     /* Create task thats sends joystick data to gui */
-    static TaskHandle_t _joystick_task_handle = NULL;
-
-    task_ret_val = xTaskCreatePinnedToCore(
-        _joystick_update_task, "Joystick update task", JOYSTICK_TASK_STACK_SIZE, NULL, 0, &_joystick_task_handle, 0);
-
-    if((NULL == _joystick_task_handle) || (task_ret_val != pdPASS))
+    if(SCHED_ERR_NONE
+       != sched_task_create(SCHED_TASK_JOYSTICK, _joystick_update_task, JOYSTICK_TASK_STACK_SIZE, NULL, NULL))
     {
         ESP_LOGE(TAG, "Joystick task not created");
     }
 
     /* Create task that periodically measures temperature and sends to gui */
-    static TaskHandle_t _temp_task_handle = NULL;
-
-    task_ret_val
-        = xTaskCreatePinnedToCore(_temp_read_task, "Temperature read task", UI_TEMP_TASK_STACK_SIZE, NULL, 0, &_temp_task_handle, 0);
-
-    if((NULL == _temp_task_handle) || (task_ret_val != pdPASS))
+    if(SCHED_ERR_NONE != sched_task_create(SCHED_TASK_TEMP, _temp_read_task, UI_TEMP_TASK_STACK_SIZE, NULL, NULL))
     {
         ESP_LOGE(TAG, "Temperature read task not created");
     }
@@ -167,6 +390,48 @@ void ui_turn_on_oscilloscope(void)
     ESP_LOGI(TAG, "Turning oscilloscope on");
 }
 
+void ui_save_settings(void)
+{
+    settings_t       settings;
+    osc_chart_view_t view;
+
+    _fn_gen_settings_get(&settings);
+    osc_chart_get_view(&view);
+
+    settings.osc.div_ms       = view.div_ms;
+    settings.osc.div_mV       = view.div_mV;
+    settings.osc.is_ch1_shown = view.is_ch1_shown;
+    settings.osc.is_ch2_shown = view.is_ch2_shown;
+
+    settings_save(&settings);
+}
+
+fn_gen_error_t ui_calibrate(fn_channel_t channel)
+{
+    bool is_running_a = oscilloscope_is_running(p_osc);
+    bool is_running_b = oscilloscope_is_running(p_osc_other);
+
+    // Sampling would compete with the sweep for the ADC
+    ui_turn_off_oscilloscope();
+
+    fn_gen_error_t err = fn_gen_calibrate(channel, _cal_read_cb, NULL, NULL);
+
+    if(is_running_a)
+    {
+        oscilloscope_start(p_osc);
+    }
+    if(is_running_b)
+    {
+        oscilloscope_start(p_osc_other);
+    }
+
+    if(FN_GEN_ERR_NONE == err)
+    {
+        _cal_save();
+    }
+    return err;
+}
+
 //---------------------------- PRIVATE FUNCTIONS ------------------------------
 
 static void _joystick_update_task(void *p_param)
@@ -193,7 +458,7 @@ static void _temp_read_task(void *param)
     if(err != ESP_OK)
     {
         ESP_LOGE(TAG, "Temperature sensor initialization failed");
-        vTaskDelete(NULL);
+        sched_task_delete(SCHED_TASK_TEMP);
     }
 
     for(;;)
@@ -203,7 +468,9 @@ static void _temp_read_task(void *param)
         if(err == ESP_OK)
         {
             ESP_LOGI(TAG, "Temperature: %.2f°C, Humidity: %.2f%%", temperature, humidity);
+            gui_lock(GUI_LOCK_WAIT_FOREVER);
             _set_temp_hum_text(temperature, humidity);
+            gui_unlock();
         }
         else
         {
@@ -213,6 +480,7 @@ static void _temp_read_task(void *param)
         if(temperature >= UI_TEMP_SHUTOWN_THRESH_C)
         {
             // Show too hot label
+            gui_lock(GUI_LOCK_WAIT_FOREVER);
             lv_obj_set_style_bg_color(ui_Panel1, lv_color_hex(0xff0000), LV_PART_MAIN | LV_STATE_DEFAULT);
             lv_obj_set_style_bg_color(ui_Panel4, lv_color_hex(0xff0000), LV_PART_MAIN | LV_STATE_DEFAULT);
             lv_obj_set_style_bg_color(ui_Panel3, lv_color_hex(0xff0000), LV_PART_MAIN | LV_STATE_DEFAULT);
@@ -220,6 +488,7 @@ static void _temp_read_task(void *param)
             lv_obj_set_style_opa(ui_deviceTooHotLabel1, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
             lv_obj_set_style_opa(ui_deviceTooHotLabel2, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
             lv_obj_set_style_opa(ui_deviceTooHotLabel, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+            gui_unlock();
 
 
             ESP_LOGE(TAG, ".");
@@ -259,4 +528,247 @@ void static _set_temp_hum_text(float temp, float hum)
     lv_label_set_text(ui_humText3, text2);
 }
 
+static void _fn_gen_settings_get(settings_t *p_settings)
+{
+    for(int preset = 0; preset < FN_GEN_PRESET_NUMBER; preset++)
+    {
+        fn_gen_get_preset(&p_settings->presets[preset], preset);
+    }
+    for(int channel = 0; channel < FN_CHANNEL_COUNT; channel++)
+    {
+        fn_gen_get_channel_config(channel, &p_settings->active[channel]);
+    }
+}
+
+static void _fn_gen_change_cb(void)
+{
+    ui_save_settings();
+}
+
+static int _cal_read_cb(fn_channel_t channel, void *p_arg)
+{
+    (void)p_arg;
+
+    return oscilloscope_read_mV((FN_CHANNEL_1 == channel) ? p_osc : p_osc_other, UI_CAL_SAMPLES);
+}
+
+static void _cal_save(void)
+{
+    settings_cal_t cal;
+
+    for(int channel = 0; channel < FN_CHANNEL_COUNT; channel++)
+    {
+        cal.is_valid[channel] = fn_gen_get_calibration(channel, cal.lut[channel]);
+    }
+    settings_cal_save(&cal);
+}
+
+#if CONFIG_UI_APP_REF_PERSIST
+static void _ref_change_cb(int slot, const settings_ref_blob_t *p_ref)
+{
+    // Stored by hand and rarely, so the GUI waits out the write instead of the save task batching it
+    settings_ref_save(slot, p_ref);
+}
+#endif
+
+static int _cmd_cal(int argc, char **argv)
+{
+    int channel = (argc > 1) ? atoi(argv[1]) - 1 : -1;
+
+    if((channel < 0) || (channel >= FN_CHANNEL_COUNT))
+    {
+        printf("Channel has to be 1 or 2\n");
+        return 1;
+    }
+
+    if((argc > 2) && (0 == strcmp(argv[2], "clear")))
+    {
+        fn_gen_set_calibration(channel, NULL);
+        _cal_save();
+        return 0;
+    }
+    return (FN_GEN_ERR_NONE == ui_calibrate(channel)) ? 0 : 1;
+}
+
+static int _cmd_sched(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    sched_print();
+    return 0;
+}
+
+static int _cmd_sched_stress(int argc, char **argv)
+{
+    int seconds = (argc > 1) ? atoi(argv[1]) : UI_STRESS_DEFAULT_S;
+
+    if(seconds <= 0)
+    {
+        printf("Duration has to be a positive number of seconds\n");
+        return 1;
+    }
+    return (SCHED_ERR_NONE == sched_stress_run(seconds * 1000, _stress_ui_load)) ? 0 : 1;
+}
+
+#if CONFIG_PROFILER_ENABLE
+static int _cmd_prof(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    profiler_print();
+    return 0;
+}
+#endif
+
+static int _cmd_preset(int argc, char **argv)
+{
+    const char *p_op    = (argc > 1) ? argv[1] : "list";
+    const char *p_name  = (argc > 2) ? argv[2] : NULL;
+    int         channel = (argc > 3) ? atoi(argv[3]) - 1 : FN_CHANNEL_1;
+
+    if(0 == strcmp(p_op, "list"))
+    {
+        int count = preset_lib_count();
+        for(int i = 0; i < count; i++)
+        {
+            char               name[PRESET_LIB_NAME_LEN];
+            fn_signal_config_t config;
+            if(PRESET_LIB_ERR_NONE == preset_lib_get(i, name, &config))
+            {
+                printf("%-*s signal %d, %d Hz, %d mV, offset %d mV, duty %d%%\n", PRESET_LIB_NAME_LEN - 1, name,
+                       config.signal, config.frequency_Hz, config.amplitude_mV, config.offset_mV,
+                       config.duty_cycle_percentage);
+            }
+        }
+        printf("%d presets, room for %d more\n", count, preset_lib_free());
+        return 0;
+    }
+
+    if((NULL == p_name) || (channel < 0) || (channel >= FN_CHANNEL_COUNT))
+    {
+        printf("Preset needs a name and channel 1 or 2\n");
+        return 1;
+    }
+
+    fn_signal_config_t config;
+    preset_lib_err_t   err;
+    if(0 == strcmp(p_op, "save"))
+    {
+        fn_gen_get_channel_config(channel, &config);
+        err = preset_lib_save(p_name, &config);
+    }
+    else if(0 == strcmp(p_op, "load"))
+    {
+        err = preset_lib_load(p_name, &config);
+        if((PRESET_LIB_ERR_NONE == err) && (FN_GEN_ERR_NONE != fn_gen_set_channel_config(channel, config)))
+        {
+            printf("Preset %s can't be output on channel %d now\n", p_name, channel + 1);
+            return 1;
+        }
+    }
+    else if(0 == strcmp(p_op, "delete"))
+    {
+        err = preset_lib_delete(p_name);
+    }
+    else
+    {
+        printf("Unknown argument %s\n", p_op);
+        return 1;
+    }
+
+    _preset_err_print(err, p_name);
+    return (PRESET_LIB_ERR_NONE == err) ? 0 : 1;
+}
+
+static int _cmd_seq(int argc, char **argv)
+{
+    if(argc < 2)
+    {
+        printf("Sequence is %s\n", fn_gen_seq_is_running() ? "running" : "stopped");
+        return 0;
+    }
+    if(0 == strcmp(argv[1], "stop"))
+    {
+        fn_gen_seq_stop();
+        return 0;
+    }
+    if(argc < 3)
+    {
+        printf("Sequence needs at least one step\n");
+        return 1;
+    }
+
+    int                loops   = atoi(argv[1]);
+    int                count   = argc - 2;
+    fn_gen_seq_step_t *p_steps = malloc(count * sizeof(*p_steps));
+    if(NULL == p_steps)
+    {
+        printf("Out of memory\n");
+        return 1;
+    }
+
+    int ret = 0;
+    for(int i = 0; (0 == ret) && (i < count); i++)
+    {
+        // Names may hold colons themselves, dwell time follows the last one
+        char *p_name  = argv[i + 2];
+        char *p_dwell = strrchr(p_name, ':');
+        if(NULL == p_dwell)
+        {
+            printf("Step %s has no dwell time\n", p_name);
+            ret = 1;
+            break;
+        }
+        *p_dwell            = '\0';
+        p_steps[i].dwell_ms = strtoul(p_dwell + 1, NULL, 10);
+
+        preset_lib_err_t err = preset_lib_load(p_name, &p_steps[i].config);
+        _preset_err_print(err, p_name);
+        ret = (PRESET_LIB_ERR_NONE == err) ? 0 : 1;
+    }
+
+    // Steps are checked as a whole, so a bad one or a short dwell time is refused before anything is output
+    if((0 == ret) && (FN_GEN_ERR_NONE != fn_gen_seq_start(p_steps, count, loops)))
+    {
+        printf("Sequence refused, every step has to fit channel 1 and last at least %d ms\n", FN_GEN_SEQ_MIN_DWELL_MS);
+        ret = 1;
+    }
+
+    free(p_steps);
+    return ret;
+}
+
+static void _preset_err_print(preset_lib_err_t err, const char *p_name)
+{
+    switch(err)
+    {
+        case PRESET_LIB_ERR_NONE:
+            break;
+        case PRESET_LIB_ERR_NOT_FOUND:
+            printf("No preset named %s\n", p_name);
+            break;
+        case PRESET_LIB_ERR_FULL:
+            printf("Preset library is full\n");
+            break;
+        case PRESET_LIB_ERR_NAME:
+            printf("Preset name has to be 1 to %d characters\n", PRESET_LIB_NAME_LEN - 1);
+            break;
+        default:
+            printf("Preset library error %d\n", err);
+            break;
+    }
+}
+
+static void _stress_ui_load(void)
+{
+    if(gui_lock(GUI_LOCK_WAIT_FOREVER))
+    {
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+        gui_unlock();
+    }
+}
+
 //---------------------------- INTERRUPT HANDLERS -----------------------------
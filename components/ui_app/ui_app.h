@@ -15,6 +15,7 @@ extern "C" {
 #endif
 
 //--------------------------------- INCLUDES ----------------------------------
+#include "fn_gen.h"
 
 //---------------------------------- MACROS -----------------------------------
 
@@ -40,6 +41,21 @@ void ui_turn_off_oscilloscope(void);
  */
 void ui_turn_on_oscilloscope(void);
 
+/**
+ * @brief Queues presets, active channel configs and oscilloscope view to be stored
+ *
+ */
+void ui_save_settings(void);
+
+/**
+ * @brief Calibrates DAC of channel through its loopback into the oscilloscope input and stores the correction.
+ * Oscilloscope sampling pauses meanwhile.
+ *
+ * @param channel Channel to calibrate, its pin has to be wired to the oscilloscope input of the same channel
+ * @return fn_gen_error_t
+ */
+fn_gen_error_t ui_calibrate(fn_channel_t channel);
+
 #ifdef __cplusplus
 }
 #endif
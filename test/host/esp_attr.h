@@ -0,0 +1,16 @@
+/**
+ * @file esp_attr.h
+ *
+ * @brief   Host stand-in for the ESP-IDF header, so ISR code builds into host tests and benchmarks
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __ESP_ATTR_H__
+#define __ESP_ATTR_H__
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#endif // __ESP_ATTR_H__
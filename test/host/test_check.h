@@ -0,0 +1,51 @@
+/**
+ * @file test_check.h
+ *
+ * @brief   Checks shared by the host tests, each of which is a single source file ending in test_check_result()
+ *
+ * COPYRIGHT NOTICE: (c) 2024 Byte Lab Grupa d.o.o.
+ * All rights reserved.
+ */
+
+#ifndef __TEST_CHECK_H__
+#define __TEST_CHECK_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//--------------------------------- INCLUDES ----------------------------------
+#include <stdio.h>
+
+//---------------------------------- MACROS -----------------------------------
+#define CHECK(cond)                                                \
+    do                                                             \
+    {                                                              \
+        if(!(cond))                                                \
+        {                                                          \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            _failures++;                                           \
+        }                                                          \
+    } while(0)
+
+//------------------------- STATIC DATA & CONSTANTS ---------------------------
+static int _failures = 0; // Failed checks, tests that report a failure themselves count it here too
+
+//---------------------- PUBLIC FUNCTION PROTOTYPES --------------------------
+
+/**
+ * @brief Prints outcome of all checks
+ *
+ * @return int Process exit code, 0 if no check failed
+ */
+static inline int test_check_result(void)
+{
+    printf("%s\n", (0 == _failures) ? "OK" : "FAILED");
+    return (0 == _failures) ? 0 : 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TEST_CHECK_H__